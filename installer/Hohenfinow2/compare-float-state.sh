@@ -0,0 +1,38 @@
+#!/bin/sh
+# builds monica-run with the soil state stored as double (reference) and as float (MONICA_FLOAT_STATE),
+# runs sim-float-state-check.json (next to this script) with both and writes the per variable
+# deviations of the float build (see compareOutputs in src/io/output.h) to float-state-deviations.json
+# and as table to float-state-deviations.txt in the current directory
+#
+# usage: compare-float-state.sh path/to/toolchain-file.cmake [build directory prefix, default _cmake_float_check]
+set -e
+if [ -z "$1" ]; then
+	echo "usage: $0 path/to/toolchain-file.cmake [build directory prefix]" >&2
+	exit 1
+fi
+toolchain=$(cd "$(dirname "$1")" && pwd)/$(basename "$1")
+prefix=${2:-_cmake_float_check}
+example_dir=$(cd "$(dirname "$0")" && pwd)
+source_dir=$(cd "$example_dir/../.." && pwd)
+
+for precision in double float; do
+	if [ $precision = float ]; then float_state=ON; else float_state=OFF; fi
+	cmake -S "$source_dir" -B "${prefix}_$precision" -DCMAKE_TOOLCHAIN_FILE="$toolchain" -DCMAKE_BUILD_TYPE=Release -DMONICA_FLOAT_STATE=$float_state
+	cmake --build "${prefix}_$precision" --target monica-run -j
+done
+
+"${prefix}_double/monica-run" -o float-state-reference.csv -jo float-state-reference.json "$example_dir/sim-float-state-check.json"
+"${prefix}_float/monica-run" -o float-state.csv -cmp float-state-reference.json "$example_dir/sim-float-state-check.json" > float-state-deviations.json
+
+python3 - <<'PY'
+import json
+report = json.load(open("float-state-deviations.json"))
+with open("float-state-deviations.txt", "w") as f:
+	for section in report["sections"]:
+		f.write(str(section["origSpec"]) + "\n")
+		f.write("%-12s %8s %10s %14s %14s\n" % ("variable", "values", "mismatches", "maxAbsError", "maxRelError"))
+		for name, d in sorted(section["variables"].items()):
+			f.write("%-12s %8d %10d %14.6g %14.6g\n" % (name, d["values"], d["mismatches"], d["maxAbsError"], d["maxRelError"]))
+		f.write("\n")
+print(open("float-state-deviations.txt").read())
+PY
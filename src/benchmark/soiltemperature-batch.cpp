@@ -0,0 +1,206 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Claas Nendel <claas.nendel@zalf.de>
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+/*
+Timing harness for the daily solution of the soil temperature equations
+of many models (see SoilTemperature::solveStep and tridiagonal.h):
+  - single:  every model solves its own factorized system
+  - batched: the right sides are gathered into one layer major batch,
+             solved across the models and scattered back, the factorizations
+             are gathered only once, as they don't change during a run
+  - batched, gathering every day: the batch buffers are allocated and
+             the factorizations gathered on every day
+
+Build and run (from src/benchmark):
+  g++ -O2 -std=c++14 -I../core soiltemperature-batch.cpp ../core/tridiagonal.cpp -o soiltemperature-batch
+  ./soiltemperature-batch [noOfModels] [noOfLayers] [noOfDays]
+
+Results (g++ 12 -O2, single core of a virtualized Xeon, ns per model and day, best of 5):
+  models  layers  days     single  batched         gathering every day
+    1000      22    1000    243.1    125.1 (-49%)    316.9 (+30%)
+      10      22   50000    236.3    129.0 (-45%)    156.4 (-34%)
+       1      22  200000    249.9    272.9  (+9%)    358.8 (+44%)
+The solutions are identical. Gathering the factorizations and allocating
+the buffers every day loses the gain for large batches, so SoilTemperatureBatch
+gathers them once and a single column is solved on its own.
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "tridiagonal.h"
+
+using namespace std;
+using namespace Monica;
+
+namespace
+{
+	//! the parts of SoilTemperature the solution touches
+	struct Model
+	{
+		vector<double> volume, diagonal, lowerTriangle, solution, temperature;
+
+		Model(size_t n, mt19937& rng)
+		{
+			uniform_real_distribution<double> cap(1e5, 3e5), cond(1e4, 5e4);
+			vector<double> pd(n), sd(n + 1, 0.0);
+			for(size_t i = 1; i < n; i++)
+				sd[i] = -cond(rng);
+			for(size_t i = 0; i < n; i++)
+				volume.push_back(cap(rng));
+			for(size_t i = 0; i < n; i++)
+				pd[i] = volume[i] - sd[i] - sd[i + 1];
+			diagonal.resize(n);
+			lowerTriangle.resize(n);
+			factorSymmetricTridiagonal(n, 1, pd.data(), sd.data(), diagonal.data(), lowerTriangle.data());
+			solution.assign(n, 0.0);
+			temperature.assign(n, 8.0);
+		}
+
+		//! stands in for prepareStep, the right side from yesterday's temperatures
+		void prepare(double surfaceHeatFlow)
+		{
+			for(size_t i = 0; i < solution.size(); i++)
+				solution[i] = volume[i] * temperature[i];
+			solution[0] += surfaceHeatFlow;
+		}
+
+		void finish() { temperature = solution; }
+	};
+
+	double single(vector<Model>& models, size_t n, const vector<double>& weather)
+	{
+		double cs = 0.0;
+		for(double w : weather)
+			for(auto& m : models)
+			{
+				m.prepare(w);
+				solveFactoredSymmetricTridiagonal(n, 1, m.diagonal.data(), m.lowerTriangle.data(), m.solution.data());
+				m.finish();
+				cs += m.temperature[0];
+			}
+		return cs;
+	}
+
+	double batched(vector<Model>& models, size_t n, const vector<double>& weather)
+	{
+		const size_t k = models.size();
+		vector<double> diagonal(n * k), lowerTriangle(n * k), rhs(n * k);
+		for(size_t c = 0; c < k; c++)
+			for(size_t i = 0; i < n; i++)
+			{
+				diagonal[i * k + c] = models[c].diagonal[i];
+				lowerTriangle[i * k + c] = models[c].lowerTriangle[i];
+			}
+
+		double cs = 0.0;
+		for(double w : weather)
+		{
+			for(size_t c = 0; c < k; c++)
+			{
+				models[c].prepare(w);
+				for(size_t i = 0; i < n; i++)
+					rhs[i * k + c] = models[c].solution[i];
+			}
+			solveFactoredSymmetricTridiagonal(n, k, diagonal.data(), lowerTriangle.data(), rhs.data());
+			for(size_t c = 0; c < k; c++)
+			{
+				for(size_t i = 0; i < n; i++)
+					models[c].solution[i] = rhs[i * k + c];
+				models[c].finish();
+				cs += models[c].temperature[0];
+			}
+		}
+		return cs;
+	}
+
+	double batchedGatheringEveryDay(vector<Model>& models, size_t n, const vector<double>& weather)
+	{
+		const size_t k = models.size();
+		double cs = 0.0;
+		for(double w : weather)
+		{
+			vector<double> diagonal(n * k), lowerTriangle(n * k), rhs(n * k);
+			for(size_t c = 0; c < k; c++)
+			{
+				models[c].prepare(w);
+				for(size_t i = 0; i < n; i++)
+				{
+					diagonal[i * k + c] = models[c].diagonal[i];
+					lowerTriangle[i * k + c] = models[c].lowerTriangle[i];
+					rhs[i * k + c] = models[c].solution[i];
+				}
+			}
+			solveFactoredSymmetricTridiagonal(n, k, diagonal.data(), lowerTriangle.data(), rhs.data());
+			for(size_t c = 0; c < k; c++)
+			{
+				for(size_t i = 0; i < n; i++)
+					models[c].solution[i] = rhs[i * k + c];
+				models[c].finish();
+				cs += models[c].temperature[0];
+			}
+		}
+		return cs;
+	}
+
+	template<class F>
+	double time(size_t noOfModels, size_t n, size_t noOfDays, F f, double& checksum)
+	{
+		mt19937 rng(1);
+		vector<Model> models;
+		for(size_t m = 0; m < noOfModels; m++)
+			models.emplace_back(n, rng);
+		uniform_real_distribution<double> flow(-5e5, 5e5);
+		vector<double> weather(noOfDays);
+		for(auto& w : weather)
+			w = flow(rng);
+
+		auto start = chrono::steady_clock::now();
+		checksum = f(models, n, weather);
+		auto end = chrono::steady_clock::now();
+		return chrono::duration<double, nano>(end - start).count() / (double(noOfDays) * noOfModels);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	size_t noOfModels = argc > 1 ? atoi(argv[1]) : 1000;
+	size_t n = argc > 2 ? atoi(argv[2]) : 22; // 20 soil layers + ground and bottom layer
+	size_t noOfDays = argc > 3 ? atoi(argv[3]) : 3650;
+	const int repetitions = 5;
+
+	double bestSingle = 1e300, bestBatched = 1e300, bestGathering = 1e300, csSingle = 0, csBatched = 0, csGathering = 0;
+	for(int r = 0; r < repetitions; r++)
+	{
+		bestSingle = min(bestSingle, time(noOfModels, n, noOfDays, single, csSingle));
+		bestBatched = min(bestBatched, time(noOfModels, n, noOfDays, batched, csBatched));
+		bestGathering = min(bestGathering, time(noOfModels, n, noOfDays, batchedGatheringEveryDay, csGathering));
+	}
+
+	printf("models: %zu, layers: %zu, days: %zu (best of %d)\n", noOfModels, n, noOfDays, repetitions);
+	printf("single:  %8.1f ns per model and day\n", bestSingle);
+	printf("batched: %8.1f ns per model and day (%+.1f%%)\n", bestBatched, (bestBatched / bestSingle - 1.0) * 100.0);
+	printf("batched, gathering every day: %8.1f ns per model and day (%+.1f%%)\n", bestGathering, (bestGathering / bestSingle - 1.0) * 100.0);
+	printf("max. relative difference of the checksums: %g\n",
+				 max(fabs(csBatched - csSingle), fabs(csGathering - csSingle)) / max(1.0, fabs(csSingle)));
+
+	return 0;
+}
@@ -199,7 +199,7 @@ ostream& O3impact::tout(bool closeFile)
 
 #pragma region 
 //model composition
-O3_impact_out O3impact::O3_impact_hourly(O3_impact_in in, O3_impact_params par, bool WaterDeficitResponseStomata)
+O3_impact_out O3impact::O3_impact_hourly(const O3_impact_in& in, const O3_impact_params& par, bool WaterDeficitResponseStomata)
 {
 	O3_impact_out out;
 
@@ -56,7 +56,7 @@ namespace O3impact
 		double WS_st_clos{ 1.0 };//water deficit factor for stomatal closure
 	};	
 	
-	O3_impact_out O3_impact_hourly(O3_impact_in in, O3_impact_params par, bool WaterDeficitResponseStomata);
+	O3_impact_out O3_impact_hourly(const O3_impact_in& in, const O3_impact_params& par, bool WaterDeficitResponseStomata);
 
 	//#define TEST_O3_HOURLY_OUTPUT
 #ifdef TEST_O3_HOURLY_OUTPUT
@@ -32,6 +32,7 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 #include "voc-common.h"
 #include "photosynthesis-FvCB.h"
 #include "O3-impact.h"
+#include "state-io.h"
 
 const double PI = 3.14159265358979323;
 
@@ -49,7 +50,7 @@ using namespace Tools;
  * @author Claas Nendel
  */
 CropGrowth::CropGrowth(SoilColumn& sc,
-	const CropParameters& cps,
+	std::shared_ptr<const CropParameters> cps,
 	const SiteParameters& stps,
 	const UserCropParameters& cropPs,
 	const SimulationParameters& simPs,
@@ -57,106 +58,108 @@ CropGrowth::CropGrowth(SoilColumn& sc,
 	std::function<void(std::map<int, double>, double)> addOrganicMatter,
 	int usage)
 	: _frostKillOn(simPs.pc_FrostKillOn)
-	, soilColumn(sc)
-	, cropPs(cropPs)
-	, speciesPs(cps.speciesParams)
-	, cultivarPs(cps.cultivarParams)
+	, soilColumn(&sc)
+	, cropPs(&cropPs)
+	, _cropParams(cps)
+	, speciesPs(&cps->speciesParams)
+	, cultivarPs(&cps->cultivarParams)
 	, vs_Latitude(stps.vs_Latitude)
-	, pc_AbovegroundOrgan(cps.speciesParams.pc_AbovegroundOrgan)
-	, pc_AssimilatePartitioningCoeff(cps.cultivarParams.pc_AssimilatePartitioningCoeff)
-	, pc_AssimilateReallocation(cps.speciesParams.pc_AssimilateReallocation)
-	, pc_BaseDaylength(cps.cultivarParams.pc_BaseDaylength)
-	, pc_BaseTemperature(cps.speciesParams.pc_BaseTemperature)
-	, pc_BeginSensitivePhaseHeatStress(cps.cultivarParams.pc_BeginSensitivePhaseHeatStress)
-	, pc_CarboxylationPathway(cps.speciesParams.pc_CarboxylationPathway)
-	//  , pc_CO2Method(cps.pc_CO2Method)
-	, pc_CriticalOxygenContent(cps.speciesParams.pc_CriticalOxygenContent)
-	, pc_CriticalTemperatureHeatStress(cps.cultivarParams.pc_CriticalTemperatureHeatStress)
-	, pc_CropHeightP1(cps.cultivarParams.pc_CropHeightP1)
-	, pc_CropHeightP2(cps.cultivarParams.pc_CropHeightP2)
-	, pc_CropName(cps.pc_CropName())
-	, pc_CropSpecificMaxRootingDepth(cps.cultivarParams.pc_CropSpecificMaxRootingDepth)
-	, vc_CurrentTemperatureSum(cps.speciesParams.pc_NumberOfDevelopmentalStages(), 0.0)
-	, pc_CuttingDelayDays(cps.speciesParams.pc_CuttingDelayDays)
-	, pc_DaylengthRequirement(cps.cultivarParams.pc_DaylengthRequirement)
-	, pc_DefaultRadiationUseEfficiency(cps.speciesParams.pc_DefaultRadiationUseEfficiency)
-	, pc_DevelopmentAccelerationByNitrogenStress(cps.speciesParams.pc_DevelopmentAccelerationByNitrogenStress)
-	, pc_DroughtStressThreshold(cps.cultivarParams.pc_DroughtStressThreshold)
-	, pc_DroughtImpactOnFertilityFactor(cps.speciesParams.pc_DroughtImpactOnFertilityFactor)
+	, _solarGeometry(solarGeometry(stps.vs_Latitude))
+	, pc_AbovegroundOrgan(cps->speciesParams.pc_AbovegroundOrgan)
+	, pc_AssimilatePartitioningCoeff(cps->cultivarParams.pc_AssimilatePartitioningCoeff)
+	, pc_AssimilateReallocation(cps->speciesParams.pc_AssimilateReallocation)
+	, pc_BaseDaylength(cps->cultivarParams.pc_BaseDaylength)
+	, pc_BaseTemperature(cps->speciesParams.pc_BaseTemperature)
+	, pc_BeginSensitivePhaseHeatStress(cps->cultivarParams.pc_BeginSensitivePhaseHeatStress)
+	, pc_CarboxylationPathway(cps->speciesParams.pc_CarboxylationPathway)
+	//  , pc_CO2Method(cps->pc_CO2Method)
+	, pc_CriticalOxygenContent(cps->speciesParams.pc_CriticalOxygenContent)
+	, pc_CriticalTemperatureHeatStress(cps->cultivarParams.pc_CriticalTemperatureHeatStress)
+	, pc_CropHeightP1(cps->cultivarParams.pc_CropHeightP1)
+	, pc_CropHeightP2(cps->cultivarParams.pc_CropHeightP2)
+	, pc_CropName(cps->pc_CropName())
+	, pc_CropSpecificMaxRootingDepth(cps->cultivarParams.pc_CropSpecificMaxRootingDepth)
+	, vc_CurrentTemperatureSum(cps->speciesParams.pc_NumberOfDevelopmentalStages(), 0.0)
+	, pc_CuttingDelayDays(cps->speciesParams.pc_CuttingDelayDays)
+	, pc_DaylengthRequirement(cps->cultivarParams.pc_DaylengthRequirement)
+	, pc_DefaultRadiationUseEfficiency(cps->speciesParams.pc_DefaultRadiationUseEfficiency)
+	, pc_DevelopmentAccelerationByNitrogenStress(cps->speciesParams.pc_DevelopmentAccelerationByNitrogenStress)
+	, pc_DroughtStressThreshold(cps->cultivarParams.pc_DroughtStressThreshold)
+	, pc_DroughtImpactOnFertilityFactor(cps->speciesParams.pc_DroughtImpactOnFertilityFactor)
 	, pc_EmergenceFloodingControlOn(simPs.pc_EmergenceFloodingControlOn)
 	, pc_EmergenceMoistureControlOn(simPs.pc_EmergenceMoistureControlOn)
-	, pc_EndSensitivePhaseHeatStress(cps.cultivarParams.pc_EndSensitivePhaseHeatStress)
-	, pc_FieldConditionModifier(cps.speciesParams.pc_FieldConditionModifier)
-	//, vo_FreshSoilOrganicMatter(soilColumn.vs_NumberOfLayers(), 0.0)
-	, pc_FrostDehardening(cps.cultivarParams.pc_FrostDehardening)
-	, pc_FrostHardening(cps.cultivarParams.pc_FrostHardening)
-	, pc_HeatSumIrrigationStart(cps.cultivarParams.pc_HeatSumIrrigationStart)
-	, pc_HeatSumIrrigationEnd(cps.cultivarParams.pc_HeatSumIrrigationEnd)
+	, pc_EndSensitivePhaseHeatStress(cps->cultivarParams.pc_EndSensitivePhaseHeatStress)
+	, pc_FieldConditionModifier(cps->speciesParams.pc_FieldConditionModifier)
+	//, vo_FreshSoilOrganicMatter(soilColumn->vs_NumberOfLayers(), 0.0)
+	, pc_FrostDehardening(cps->cultivarParams.pc_FrostDehardening)
+	, pc_FrostHardening(cps->cultivarParams.pc_FrostHardening)
+	, pc_HeatSumIrrigationStart(cps->cultivarParams.pc_HeatSumIrrigationStart)
+	, pc_HeatSumIrrigationEnd(cps->cultivarParams.pc_HeatSumIrrigationEnd)
 	, vs_HeightNN(stps.vs_HeightNN)
-	, pc_InitialKcFactor(cps.speciesParams.pc_InitialKcFactor)
-	, pc_InitialOrganBiomass(cps.speciesParams.pc_InitialOrganBiomass)
-	, pc_InitialRootingDepth(cps.speciesParams.pc_InitialRootingDepth)
+	, pc_InitialKcFactor(cps->speciesParams.pc_InitialKcFactor)
+	, pc_InitialOrganBiomass(cps->speciesParams.pc_InitialOrganBiomass)
+	, pc_InitialRootingDepth(cps->speciesParams.pc_InitialRootingDepth)
 	, vc_sunlitLeafAreaIndex(24)
 	, vc_shadedLeafAreaIndex(24)
-	, pc_LowTemperatureExposure(cps.cultivarParams.pc_LowTemperatureExposure)
-	, pc_LimitingTemperatureHeatStress(cps.speciesParams.pc_LimitingTemperatureHeatStress)
-	, pc_LT50cultivar(cps.cultivarParams.pc_LT50cultivar)
-	, pc_LuxuryNCoeff(cps.speciesParams.pc_LuxuryNCoeff)
-	, pc_MaxAssimilationRate(cps.cultivarParams.pc_MaxAssimilationRate)
-	, pc_MaxCropDiameter(cps.speciesParams.pc_MaxCropDiameter)
-	, pc_MaxCropHeight(cps.cultivarParams.pc_MaxCropHeight)
-	, pc_MaxNUptakeParam(cps.speciesParams.pc_MaxNUptakeParam)
-	, pc_MinimumNConcentration(cps.speciesParams.pc_MinimumNConcentration)
-	, pc_MinimumTemperatureForAssimilation(cps.speciesParams.pc_MinimumTemperatureForAssimilation)
-	, pc_MaximumTemperatureForAssimilation(cps.speciesParams.pc_MaximumTemperatureForAssimilation)
-	, pc_OptimumTemperatureForAssimilation(cps.speciesParams.pc_OptimumTemperatureForAssimilation)
-	, pc_MinimumTemperatureRootGrowth(cps.speciesParams.pc_MinimumTemperatureRootGrowth)
-	, pc_NConcentrationAbovegroundBiomass(cps.speciesParams.pc_NConcentrationAbovegroundBiomass)
-	, pc_NConcentrationB0(cps.speciesParams.pc_NConcentrationB0)
-	, pc_NConcentrationPN(cps.speciesParams.pc_NConcentrationPN)
-	, pc_NConcentrationRoot(cps.speciesParams.pc_NConcentrationRoot)
+	, pc_LowTemperatureExposure(cps->cultivarParams.pc_LowTemperatureExposure)
+	, pc_LimitingTemperatureHeatStress(cps->speciesParams.pc_LimitingTemperatureHeatStress)
+	, pc_LT50cultivar(cps->cultivarParams.pc_LT50cultivar)
+	, pc_LuxuryNCoeff(cps->speciesParams.pc_LuxuryNCoeff)
+	, pc_MaxAssimilationRate(cps->cultivarParams.pc_MaxAssimilationRate)
+	, pc_MaxCropDiameter(cps->speciesParams.pc_MaxCropDiameter)
+	, pc_MaxCropHeight(cps->cultivarParams.pc_MaxCropHeight)
+	, pc_MaxNUptakeParam(cps->speciesParams.pc_MaxNUptakeParam)
+	, pc_MinimumNConcentration(cps->speciesParams.pc_MinimumNConcentration)
+	, pc_MinimumTemperatureForAssimilation(cps->speciesParams.pc_MinimumTemperatureForAssimilation)
+	, pc_MaximumTemperatureForAssimilation(cps->speciesParams.pc_MaximumTemperatureForAssimilation)
+	, pc_OptimumTemperatureForAssimilation(cps->speciesParams.pc_OptimumTemperatureForAssimilation)
+	, pc_MinimumTemperatureRootGrowth(cps->speciesParams.pc_MinimumTemperatureRootGrowth)
+	, pc_NConcentrationAbovegroundBiomass(cps->speciesParams.pc_NConcentrationAbovegroundBiomass)
+	, pc_NConcentrationB0(cps->speciesParams.pc_NConcentrationB0)
+	, pc_NConcentrationPN(cps->speciesParams.pc_NConcentrationPN)
+	, pc_NConcentrationRoot(cps->speciesParams.pc_NConcentrationRoot)
 	, pc_NitrogenResponseOn(simPs.pc_NitrogenResponseOn)
-	, pc_NumberOfDevelopmentalStages(cps.speciesParams.pc_NumberOfDevelopmentalStages())
-	, pc_NumberOfOrgans(cps.speciesParams.pc_NumberOfOrgans())
-	, vc_NUptakeFromLayer(soilColumn.vs_NumberOfLayers(), 0.0)
-	, pc_OptimumTemperature(cps.cultivarParams.pc_OptimumTemperature)
+	, pc_NumberOfDevelopmentalStages(cps->speciesParams.pc_NumberOfDevelopmentalStages())
+	, pc_NumberOfOrgans(cps->speciesParams.pc_NumberOfOrgans())
+	, vc_NUptakeFromLayer(soilColumn->vs_NumberOfLayers(), 0.0)
+	, pc_OptimumTemperature(cps->cultivarParams.pc_OptimumTemperature)
 	, vc_OrganBiomass(pc_NumberOfOrgans, 0.0)
-	, vc_OrganDeadBiomass(cps.speciesParams.pc_NumberOfOrgans(), 0.0)
-	, vc_OrganGreenBiomass(cps.speciesParams.pc_NumberOfOrgans(), 0.0)
+	, vc_OrganDeadBiomass(cps->speciesParams.pc_NumberOfOrgans(), 0.0)
+	, vc_OrganGreenBiomass(cps->speciesParams.pc_NumberOfOrgans(), 0.0)
 	, vc_OrganGrowthIncrement(pc_NumberOfOrgans, 0.0)
-	, pc_OrganGrowthRespiration(cps.speciesParams.pc_OrganGrowthRespiration)
-	, pc_OrganIdsForPrimaryYield(cps.cultivarParams.pc_OrganIdsForPrimaryYield)
-	, pc_OrganIdsForSecondaryYield(cps.cultivarParams.pc_OrganIdsForSecondaryYield)
-	, pc_OrganIdsForCutting(cps.cultivarParams.pc_OrganIdsForCutting)
-	, pc_OrganMaintenanceRespiration(cps.speciesParams.pc_OrganMaintenanceRespiration)
+	, pc_OrganGrowthRespiration(cps->speciesParams.pc_OrganGrowthRespiration)
+	, pc_OrganIdsForPrimaryYield(cps->cultivarParams.pc_OrganIdsForPrimaryYield)
+	, pc_OrganIdsForSecondaryYield(cps->cultivarParams.pc_OrganIdsForSecondaryYield)
+	, pc_OrganIdsForCutting(cps->cultivarParams.pc_OrganIdsForCutting)
+	, pc_OrganMaintenanceRespiration(cps->speciesParams.pc_OrganMaintenanceRespiration)
 	, vc_OrganSenescenceIncrement(pc_NumberOfOrgans, 0.0)
-	, pc_OrganSenescenceRate(cps.cultivarParams.pc_OrganSenescenceRate)
-	, pc_PartBiologicalNFixation(cps.speciesParams.pc_PartBiologicalNFixation)
-	, pc_Perennial(cps.cultivarParams.pc_Perennial)
-	, pc_PlantDensity(cps.speciesParams.pc_PlantDensity)
-	, pc_ResidueNRatio(cps.cultivarParams.pc_ResidueNRatio)
-	, pc_RespiratoryStress(cps.cultivarParams.pc_RespiratoryStress)
-	, vc_RootDensity(soilColumn.vs_NumberOfLayers(), 0.0)
-	, vc_RootDiameter(soilColumn.vs_NumberOfLayers(), 0.0)
-	, pc_RootDistributionParam(cps.speciesParams.pc_RootDistributionParam)
-	, vc_RootEffectivity(soilColumn.vs_NumberOfLayers(), 0.0)
-	, pc_RootFormFactor(cps.speciesParams.pc_RootFormFactor)
-	, pc_RootGrowthLag(cps.speciesParams.pc_RootGrowthLag)
-	, pc_RootPenetrationRate(cps.speciesParams.pc_RootPenetrationRate)
-	, vs_SoilMineralNContent(soilColumn.vs_NumberOfLayers(), 0.0)
-	, pc_SpecificLeafArea(cps.cultivarParams.pc_SpecificLeafArea)
-	, pc_SpecificRootLength(cps.speciesParams.pc_SpecificRootLength)
-	, pc_StageAfterCut(cps.speciesParams.pc_StageAfterCut - 1)
-	, pc_StageAtMaxDiameter(cps.speciesParams.pc_StageAtMaxDiameter)
-	, pc_StageAtMaxHeight(cps.speciesParams.pc_StageAtMaxHeight)
-	, pc_StageMaxRootNConcentration(cps.speciesParams.pc_StageMaxRootNConcentration)
-	, pc_StageKcFactor(cps.cultivarParams.pc_StageKcFactor)
-	, pc_StageTemperatureSum(cps.cultivarParams.pc_StageTemperatureSum)
-	, pc_StorageOrgan(cps.speciesParams.pc_StorageOrgan)
+	, pc_OrganSenescenceRate(cps->cultivarParams.pc_OrganSenescenceRate)
+	, pc_PartBiologicalNFixation(cps->speciesParams.pc_PartBiologicalNFixation)
+	, pc_Perennial(cps->cultivarParams.pc_Perennial)
+	, pc_PlantDensity(cps->speciesParams.pc_PlantDensity)
+	, pc_ResidueNRatio(cps->cultivarParams.pc_ResidueNRatio)
+	, pc_RespiratoryStress(cps->cultivarParams.pc_RespiratoryStress)
+	, vc_RootDensity(soilColumn->vs_NumberOfLayers(), 0.0)
+	, vc_RootDiameter(soilColumn->vs_NumberOfLayers(), 0.0)
+	, pc_RootDistributionParam(cps->speciesParams.pc_RootDistributionParam)
+	, vc_RootEffectivity(soilColumn->vs_NumberOfLayers(), 0.0)
+	, pc_RootFormFactor(cps->speciesParams.pc_RootFormFactor)
+	, pc_RootGrowthLag(cps->speciesParams.pc_RootGrowthLag)
+	, pc_RootPenetrationRate(cps->speciesParams.pc_RootPenetrationRate)
+	, vs_SoilMineralNContent(soilColumn->vs_NumberOfLayers(), 0.0)
+	, pc_SpecificLeafArea(cps->cultivarParams.pc_SpecificLeafArea)
+	, pc_SpecificRootLength(cps->speciesParams.pc_SpecificRootLength)
+	, pc_StageAfterCut(cps->speciesParams.pc_StageAfterCut - 1)
+	, pc_StageAtMaxDiameter(cps->speciesParams.pc_StageAtMaxDiameter)
+	, pc_StageAtMaxHeight(cps->speciesParams.pc_StageAtMaxHeight)
+	, pc_StageMaxRootNConcentration(cps->speciesParams.pc_StageMaxRootNConcentration)
+	, pc_StageKcFactor(cps->cultivarParams.pc_StageKcFactor)
+	, pc_StageTemperatureSum(cps->cultivarParams.pc_StageTemperatureSum)
+	, pc_StorageOrgan(cps->speciesParams.pc_StorageOrgan)
 	, vs_Tortuosity(cropPs.pc_Tortuosity)
-	, vc_Transpiration(soilColumn.vs_NumberOfLayers(), 0.0)
-	, vc_TranspirationRedux(soilColumn.vs_NumberOfLayers(), 1.0)
-	, pc_VernalisationRequirement(cps.cultivarParams.pc_VernalisationRequirement)
+	, vc_Transpiration(soilColumn->vs_NumberOfLayers(), 0.0)
+	, vc_TranspirationRedux(soilColumn->vs_NumberOfLayers(), 1.0)
+	, pc_VernalisationRequirement(cps->cultivarParams.pc_VernalisationRequirement)
 	, pc_WaterDeficitResponseOn(simPs.pc_WaterDeficitResponseOn)
 	, eva2_usage(usage)
 	, vs_MaxEffectiveRootingDepth(stps.vs_MaxEffectiveRootingDepth)
@@ -218,8 +221,8 @@ CropGrowth::CropGrowth(SoilColumn& sc,
 	// Initialising the initial maximum rooting depth
 	if (cropPs.pc_AdjustRootDepthForSoilProps)
 	{
-		double vc_SandContent = soilColumn[0].vs_SoilSandContent(); // [kg kg-1]
-		double vc_BulkDensity = soilColumn[0].vs_SoilBulkDensity(); // [kg m-3]
+		double vc_SandContent = (*soilColumn)[0].vs_SoilSandContent(); // [kg kg-1]
+		double vc_BulkDensity = (*soilColumn)[0].vs_SoilBulkDensity(); // [kg m-3]
 		if (vc_SandContent < 0.55)
 			vc_SandContent = 0.55;
 
@@ -265,6 +268,557 @@ CropGrowth::CropGrowth(SoilColumn& sc,
 
 }
 
+void CropGrowth::rebind(SoilColumn& sc,
+	const UserCropParameters& cps,
+	std::function<void(std::string)> fireEvent,
+	std::function<void(std::map<int, double>, double)> addOrganicMatter)
+{
+	soilColumn = &sc;
+	cropPs = &cps;
+	_fireEvent = fireEvent;
+	_addOrganicMatter = addOrganicMatter;
+}
+
+namespace
+{
+	void writeYieldComponents(ostream& out, const vector<YieldComponent>& ycs)
+	{
+		StateIO::write(out, uint64_t(ycs.size()));
+		for(const auto& yc : ycs)
+		{
+			StateIO::write(out, yc.organId);
+			StateIO::write(out, yc.yieldPercentage);
+			StateIO::write(out, yc.yieldDryMatter);
+		}
+	}
+
+	void readYieldComponents(istream& in, vector<YieldComponent>& ycs)
+	{
+		uint64_t size = 0;
+		ycs.clear();
+		if(!StateIO::readSize(in, size, sizeof(int) + 2 * sizeof(double)))
+			return;
+		for(uint64_t i = 0; in && i < size; i++)
+		{
+			YieldComponent yc;
+			StateIO::read(in, yc.organId);
+			StateIO::read(in, yc.yieldPercentage);
+			StateIO::read(in, yc.yieldDryMatter);
+			ycs.push_back(yc);
+		}
+	}
+
+	void writeEmissions(ostream& out, const Voc::Emissions& es)
+	{
+		StateIO::write(out, es.speciesId_2_isoprene_emission);
+		StateIO::write(out, es.speciesId_2_monoterpene_emission);
+		StateIO::write(out, es.isoprene_emission);
+		StateIO::write(out, es.monoterpene_emission);
+	}
+
+	void readEmissions(istream& in, Voc::Emissions& es)
+	{
+		StateIO::read(in, es.speciesId_2_isoprene_emission);
+		StateIO::read(in, es.speciesId_2_monoterpene_emission);
+		StateIO::read(in, es.isoprene_emission);
+		StateIO::read(in, es.monoterpene_emission);
+	}
+}
+
+void CropGrowth::serialize(std::ostream& out) const
+{
+	using namespace StateIO;
+	write(out, _frostKillOn);
+	write(out, vs_Latitude);
+	write(out, vc_AbovegroundBiomass);
+	write(out, vc_AbovegroundBiomassOld);
+	write(out, pc_AbovegroundOrgan);
+	write(out, vc_ActualTranspiration);
+	write(out, pc_AssimilatePartitioningCoeff);
+	write(out, pc_AssimilateReallocation);
+	write(out, vc_Assimilates);
+	write(out, vc_AssimilationRate);
+	write(out, vc_AstronomicDayLenght);
+	write(out, pc_BaseDaylength);
+	write(out, pc_BaseTemperature);
+	write(out, pc_BeginSensitivePhaseHeatStress);
+	write(out, vc_BelowgroundBiomass);
+	write(out, vc_BelowgroundBiomassOld);
+	write(out, pc_CarboxylationPathway);
+	write(out, vc_ClearDayRadiation);
+	write(out, pc_CO2Method);
+	write(out, vc_CriticalNConcentration);
+	write(out, pc_CriticalOxygenContent);
+	write(out, pc_CriticalTemperatureHeatStress);
+	write(out, vc_CropDiameter);
+	write(out, vc_CropFrostRedux);
+	write(out, vc_CropHeatRedux);
+	write(out, vc_CropHeight);
+	write(out, pc_CropHeightP1);
+	write(out, pc_CropHeightP2);
+	write(out, pc_CropName);
+	write(out, vc_CropNDemand);
+	write(out, vc_CropNRedux);
+	write(out, pc_CropSpecificMaxRootingDepth);
+	write(out, vc_CropWaterUptake);
+	write(out, vc_CurrentTemperatureSum);
+	write(out, vc_CurrentTotalTemperatureSum);
+	write(out, vc_CurrentTotalTemperatureSumRoot);
+	write(out, pc_CuttingDelayDays);
+	write(out, vc_DaylengthFactor);
+	write(out, pc_DaylengthRequirement);
+	write(out, vc_DaysAfterBeginFlowering);
+	write(out, vc_Declination);
+	write(out, pc_DefaultRadiationUseEfficiency);
+	write(out, vm_DepthGroundwaterTable);
+	write(out, pc_DevelopmentAccelerationByNitrogenStress);
+	write(out, vc_DevelopmentalStage);
+	write(out, _noOfCropSteps);
+	write(out, vc_DroughtImpactOnFertility);
+	write(out, pc_DroughtImpactOnFertilityFactor);
+	write(out, pc_DroughtStressThreshold);
+	write(out, pc_EmergenceFloodingControlOn);
+	write(out, pc_EmergenceMoistureControlOn);
+	write(out, pc_EndSensitivePhaseHeatStress);
+	write(out, vc_EffectiveDayLength);
+	write(out, vc_ErrorStatus);
+	write(out, vc_ErrorMessage);
+	write(out, vc_EvaporatedFromIntercept);
+	write(out, vc_ExtraterrestrialRadiation);
+	write(out, pc_FieldConditionModifier);
+	write(out, vc_FinalDevelopmentalStage);
+	write(out, vc_FixedN);
+	write(out, pc_FrostDehardening);
+	write(out, pc_FrostHardening);
+	write(out, vc_GlobalRadiation);
+	write(out, vc_GreenAreaIndex);
+	write(out, vc_GrossAssimilates);
+	write(out, vc_GrossPhotosynthesis);
+	write(out, vc_GrossPhotosynthesis_mol);
+	write(out, vc_GrossPhotosynthesisReference_mol);
+	write(out, vc_GrossPrimaryProduction);
+	write(out, vc_GrowthCycleEnded);
+	write(out, vc_GrowthRespirationAS);
+	write(out, pc_HeatSumIrrigationStart);
+	write(out, pc_HeatSumIrrigationEnd);
+	write(out, vs_HeightNN);
+	write(out, pc_InitialKcFactor);
+	write(out, pc_InitialOrganBiomass);
+	write(out, pc_InitialRootingDepth);
+	write(out, vc_InterceptionStorage);
+	write(out, vc_KcFactor);
+	write(out, vc_LeafAreaIndex);
+	write(out, vc_sunlitLeafAreaIndex);
+	write(out, vc_shadedLeafAreaIndex);
+	write(out, pc_LowTemperatureExposure);
+	write(out, pc_LimitingTemperatureHeatStress);
+	write(out, vc_LT50);
+	write(out, pc_LT50cultivar);
+	write(out, pc_LuxuryNCoeff);
+	write(out, vc_MaintenanceRespirationAS);
+	write(out, pc_MaxAssimilationRate);
+	write(out, pc_MaxCropDiameter);
+	write(out, pc_MaxCropHeight);
+	write(out, vc_MaxNUptake);
+	write(out, pc_MaxNUptakeParam);
+	write(out, vc_MaxRootingDepth);
+	write(out, pc_MinimumNConcentration);
+	write(out, pc_MinimumTemperatureForAssimilation);
+	write(out, pc_OptimumTemperatureForAssimilation);
+	write(out, pc_MaximumTemperatureForAssimilation);
+	write(out, pc_MinimumTemperatureRootGrowth);
+	write(out, vc_NetMaintenanceRespiration);
+	write(out, vc_NetPhotosynthesis);
+	write(out, vc_NetPrecipitation);
+	write(out, vc_NetPrimaryProduction);
+	write(out, pc_NConcentrationAbovegroundBiomass);
+	write(out, vc_NConcentrationAbovegroundBiomass);
+	write(out, vc_NConcentrationAbovegroundBiomassOld);
+	write(out, pc_NConcentrationB0);
+	write(out, vc_NContentDeficit);
+	write(out, pc_NConcentrationPN);
+	write(out, pc_NConcentrationRoot);
+	write(out, vc_NConcentrationRoot);
+	write(out, vc_NConcentrationRootOld);
+	write(out, pc_NitrogenResponseOn);
+	write(out, pc_NumberOfDevelopmentalStages);
+	write(out, pc_NumberOfOrgans);
+	write(out, vc_NUptakeFromLayer);
+	write(out, pc_OptimumTemperature);
+	write(out, vc_OrganBiomass);
+	write(out, vc_OrganDeadBiomass);
+	write(out, vc_OrganGreenBiomass);
+	write(out, vc_OrganGrowthIncrement);
+	write(out, pc_OrganGrowthRespiration);
+	writeYieldComponents(out, pc_OrganIdsForPrimaryYield);
+	writeYieldComponents(out, pc_OrganIdsForSecondaryYield);
+	writeYieldComponents(out, pc_OrganIdsForCutting);
+	write(out, pc_OrganMaintenanceRespiration);
+	write(out, vc_OrganSenescenceIncrement);
+	write(out, pc_OrganSenescenceRate);
+	write(out, vc_OvercastDayRadiation);
+	write(out, vc_OxygenDeficit);
+	write(out, pc_PartBiologicalNFixation);
+	write(out, pc_Perennial);
+	write(out, vc_PhotoperiodicDaylength);
+	write(out, vc_PhotActRadiationMean);
+	write(out, pc_PlantDensity);
+	write(out, vc_PotentialTranspiration);
+	write(out, vc_ReferenceEvapotranspiration);
+	write(out, vc_RelativeTotalDevelopment);
+	write(out, vc_RemainingEvapotranspiration);
+	write(out, vc_ReserveAssimilatePool);
+	write(out, pc_ResidueNRatio);
+	write(out, pc_RespiratoryStress);
+	write(out, vc_RootBiomass);
+	write(out, vc_RootBiomassOld);
+	write(out, vc_RootDensity);
+	write(out, vc_RootDiameter);
+	write(out, pc_RootDistributionParam);
+	write(out, vc_RootEffectivity);
+	write(out, pc_RootFormFactor);
+	write(out, pc_RootGrowthLag);
+	write(out, vc_RootingDepth);
+	write(out, vc_RootingDepth_m);
+	write(out, vc_RootingZone);
+	write(out, pc_RootPenetrationRate);
+	write(out, vm_SaturationDeficit);
+	write(out, vc_SoilCoverage);
+	write(out, vs_SoilMineralNContent);
+	write(out, vc_SoilSpecificMaxRootingDepth);
+	write(out, vs_SoilSpecificMaxRootingDepth);
+	write(out, pc_SpecificLeafArea);
+	write(out, pc_SpecificRootLength);
+	write(out, pc_StageAfterCut);
+	write(out, pc_StageAtMaxDiameter);
+	write(out, pc_StageAtMaxHeight);
+	write(out, pc_StageMaxRootNConcentration);
+	write(out, pc_StageKcFactor);
+	write(out, pc_StageTemperatureSum);
+	write(out, vc_StomataResistance);
+	write(out, pc_StorageOrgan);
+	write(out, vc_StorageOrgan);
+	write(out, vc_TargetNConcentration);
+	write(out, vc_TimeStep);
+	write(out, vc_TimeUnderAnoxia);
+	write(out, vs_Tortuosity);
+	write(out, vc_TotalBiomass);
+	write(out, vc_TotalBiomassNContent);
+	write(out, vc_TotalCropHeatImpact);
+	write(out, vc_TotalNInput);
+	write(out, vc_TotalNUptake);
+	write(out, vc_TotalRespired);
+	write(out, vc_Respiration);
+	write(out, vc_SumTotalNUptake);
+	write(out, vc_TotalRootLength);
+	write(out, vc_TotalTemperatureSum);
+	write(out, vc_TemperatureSumToFlowering);
+	write(out, vc_Transpiration);
+	write(out, vc_TranspirationRedux);
+	write(out, vc_TranspirationDeficit);
+	write(out, vc_VernalisationDays);
+	write(out, vc_VernalisationFactor);
+	write(out, pc_VernalisationRequirement);
+	write(out, pc_WaterDeficitResponseOn);
+	write(out, eva2_usage);
+	writeYieldComponents(out, eva2_primaryYieldComponents);
+	writeYieldComponents(out, eva2_secondaryYieldComponents);
+	write(out, dyingOut);
+	write(out, vc_AccumulatedETa);
+	write(out, vc_AccumulatedTranspiration);
+	write(out, vc_AccumulatedPrimaryCropYield);
+	write(out, vc_sumExportedCutBiomass);
+	write(out, vc_exportedCutBiomass);
+	write(out, vc_sumResidueCutBiomass);
+	write(out, vc_residueCutBiomass);
+	write(out, vc_CuttingDelayDays);
+	write(out, vs_MaxEffectiveRootingDepth);
+	write(out, vs_ImpenetrableLayerDepth);
+	write(out, vc_AnthesisDay);
+	write(out, vc_MaturityDay);
+	write(out, vc_MaturityReached);
+	write(out, _rad24);
+	write(out, _rad240);
+	write(out, _tfol24);
+	write(out, _tfol240);
+	write(out, _index24);
+	write(out, _index240);
+	write(out, _full24);
+	write(out, _full240);
+	writeEmissions(out, _guentherEmissions);
+	writeEmissions(out, _jjvEmissions);
+	write(out, _vocSpecies);
+	write(out, _cropPhotosynthesisResults);
+	write(out, _fvcbDay);
+	write(out, _rootFormProfile);
+	write(out, _rootFormProfileFactor);
+	write(out, vc_RootDensityFactor);
+	write(out, vc_RootDensityFactorSum);
+	write(out, _rootDensityFactorDepth);
+	write(out, _rootDensityFactorZone);
+	write(out, _rootUptakeWeight);
+	write(out, _convectiveNUptakeFromLayer);
+	write(out, _diffusiveNUptakeFromLayer);
+	write(out, vc_O3_shortTermDamage);
+	write(out, vc_O3_longTermDamage);
+	write(out, vc_O3_senescence);
+	write(out, vc_O3_sumUptake);
+	write(out, vc_O3_WStomatalClosure);
+	write(out, _assimilatePartCoeffsReduced);
+	write(out, vc_KTkc);
+	write(out, vc_KTko);
+}
+
+bool CropGrowth::deserialize(std::istream& in)
+{
+	using namespace StateIO;
+	read(in, _frostKillOn);
+	read(in, vs_Latitude);
+	read(in, vc_AbovegroundBiomass);
+	read(in, vc_AbovegroundBiomassOld);
+	read(in, pc_AbovegroundOrgan);
+	read(in, vc_ActualTranspiration);
+	read(in, pc_AssimilatePartitioningCoeff);
+	read(in, pc_AssimilateReallocation);
+	read(in, vc_Assimilates);
+	read(in, vc_AssimilationRate);
+	read(in, vc_AstronomicDayLenght);
+	read(in, pc_BaseDaylength);
+	read(in, pc_BaseTemperature);
+	read(in, pc_BeginSensitivePhaseHeatStress);
+	read(in, vc_BelowgroundBiomass);
+	read(in, vc_BelowgroundBiomassOld);
+	read(in, pc_CarboxylationPathway);
+	read(in, vc_ClearDayRadiation);
+	read(in, pc_CO2Method);
+	read(in, vc_CriticalNConcentration);
+	read(in, pc_CriticalOxygenContent);
+	read(in, pc_CriticalTemperatureHeatStress);
+	read(in, vc_CropDiameter);
+	read(in, vc_CropFrostRedux);
+	read(in, vc_CropHeatRedux);
+	read(in, vc_CropHeight);
+	read(in, pc_CropHeightP1);
+	read(in, pc_CropHeightP2);
+	read(in, pc_CropName);
+	read(in, vc_CropNDemand);
+	read(in, vc_CropNRedux);
+	read(in, pc_CropSpecificMaxRootingDepth);
+	read(in, vc_CropWaterUptake);
+	read(in, vc_CurrentTemperatureSum);
+	read(in, vc_CurrentTotalTemperatureSum);
+	read(in, vc_CurrentTotalTemperatureSumRoot);
+	read(in, pc_CuttingDelayDays);
+	read(in, vc_DaylengthFactor);
+	read(in, pc_DaylengthRequirement);
+	read(in, vc_DaysAfterBeginFlowering);
+	read(in, vc_Declination);
+	read(in, pc_DefaultRadiationUseEfficiency);
+	read(in, vm_DepthGroundwaterTable);
+	read(in, pc_DevelopmentAccelerationByNitrogenStress);
+	read(in, vc_DevelopmentalStage);
+	read(in, _noOfCropSteps);
+	read(in, vc_DroughtImpactOnFertility);
+	read(in, pc_DroughtImpactOnFertilityFactor);
+	read(in, pc_DroughtStressThreshold);
+	read(in, pc_EmergenceFloodingControlOn);
+	read(in, pc_EmergenceMoistureControlOn);
+	read(in, pc_EndSensitivePhaseHeatStress);
+	read(in, vc_EffectiveDayLength);
+	read(in, vc_ErrorStatus);
+	read(in, vc_ErrorMessage);
+	read(in, vc_EvaporatedFromIntercept);
+	read(in, vc_ExtraterrestrialRadiation);
+	read(in, pc_FieldConditionModifier);
+	read(in, vc_FinalDevelopmentalStage);
+	read(in, vc_FixedN);
+	read(in, pc_FrostDehardening);
+	read(in, pc_FrostHardening);
+	read(in, vc_GlobalRadiation);
+	read(in, vc_GreenAreaIndex);
+	read(in, vc_GrossAssimilates);
+	read(in, vc_GrossPhotosynthesis);
+	read(in, vc_GrossPhotosynthesis_mol);
+	read(in, vc_GrossPhotosynthesisReference_mol);
+	read(in, vc_GrossPrimaryProduction);
+	read(in, vc_GrowthCycleEnded);
+	read(in, vc_GrowthRespirationAS);
+	read(in, pc_HeatSumIrrigationStart);
+	read(in, pc_HeatSumIrrigationEnd);
+	read(in, vs_HeightNN);
+	read(in, pc_InitialKcFactor);
+	read(in, pc_InitialOrganBiomass);
+	read(in, pc_InitialRootingDepth);
+	read(in, vc_InterceptionStorage);
+	read(in, vc_KcFactor);
+	read(in, vc_LeafAreaIndex);
+	read(in, vc_sunlitLeafAreaIndex);
+	read(in, vc_shadedLeafAreaIndex);
+	read(in, pc_LowTemperatureExposure);
+	read(in, pc_LimitingTemperatureHeatStress);
+	read(in, vc_LT50);
+	read(in, pc_LT50cultivar);
+	read(in, pc_LuxuryNCoeff);
+	read(in, vc_MaintenanceRespirationAS);
+	read(in, pc_MaxAssimilationRate);
+	read(in, pc_MaxCropDiameter);
+	read(in, pc_MaxCropHeight);
+	read(in, vc_MaxNUptake);
+	read(in, pc_MaxNUptakeParam);
+	read(in, vc_MaxRootingDepth);
+	read(in, pc_MinimumNConcentration);
+	read(in, pc_MinimumTemperatureForAssimilation);
+	read(in, pc_OptimumTemperatureForAssimilation);
+	read(in, pc_MaximumTemperatureForAssimilation);
+	read(in, pc_MinimumTemperatureRootGrowth);
+	read(in, vc_NetMaintenanceRespiration);
+	read(in, vc_NetPhotosynthesis);
+	read(in, vc_NetPrecipitation);
+	read(in, vc_NetPrimaryProduction);
+	read(in, pc_NConcentrationAbovegroundBiomass);
+	read(in, vc_NConcentrationAbovegroundBiomass);
+	read(in, vc_NConcentrationAbovegroundBiomassOld);
+	read(in, pc_NConcentrationB0);
+	read(in, vc_NContentDeficit);
+	read(in, pc_NConcentrationPN);
+	read(in, pc_NConcentrationRoot);
+	read(in, vc_NConcentrationRoot);
+	read(in, vc_NConcentrationRootOld);
+	read(in, pc_NitrogenResponseOn);
+	read(in, pc_NumberOfDevelopmentalStages);
+	read(in, pc_NumberOfOrgans);
+	read(in, vc_NUptakeFromLayer);
+	read(in, pc_OptimumTemperature);
+	read(in, vc_OrganBiomass);
+	read(in, vc_OrganDeadBiomass);
+	read(in, vc_OrganGreenBiomass);
+	read(in, vc_OrganGrowthIncrement);
+	read(in, pc_OrganGrowthRespiration);
+	readYieldComponents(in, pc_OrganIdsForPrimaryYield);
+	readYieldComponents(in, pc_OrganIdsForSecondaryYield);
+	readYieldComponents(in, pc_OrganIdsForCutting);
+	read(in, pc_OrganMaintenanceRespiration);
+	read(in, vc_OrganSenescenceIncrement);
+	read(in, pc_OrganSenescenceRate);
+	read(in, vc_OvercastDayRadiation);
+	read(in, vc_OxygenDeficit);
+	read(in, pc_PartBiologicalNFixation);
+	read(in, pc_Perennial);
+	read(in, vc_PhotoperiodicDaylength);
+	read(in, vc_PhotActRadiationMean);
+	read(in, pc_PlantDensity);
+	read(in, vc_PotentialTranspiration);
+	read(in, vc_ReferenceEvapotranspiration);
+	read(in, vc_RelativeTotalDevelopment);
+	read(in, vc_RemainingEvapotranspiration);
+	read(in, vc_ReserveAssimilatePool);
+	read(in, pc_ResidueNRatio);
+	read(in, pc_RespiratoryStress);
+	read(in, vc_RootBiomass);
+	read(in, vc_RootBiomassOld);
+	read(in, vc_RootDensity);
+	read(in, vc_RootDiameter);
+	read(in, pc_RootDistributionParam);
+	read(in, vc_RootEffectivity);
+	read(in, pc_RootFormFactor);
+	read(in, pc_RootGrowthLag);
+	read(in, vc_RootingDepth);
+	read(in, vc_RootingDepth_m);
+	read(in, vc_RootingZone);
+	read(in, pc_RootPenetrationRate);
+	read(in, vm_SaturationDeficit);
+	read(in, vc_SoilCoverage);
+	read(in, vs_SoilMineralNContent);
+	read(in, vc_SoilSpecificMaxRootingDepth);
+	read(in, vs_SoilSpecificMaxRootingDepth);
+	read(in, pc_SpecificLeafArea);
+	read(in, pc_SpecificRootLength);
+	read(in, pc_StageAfterCut);
+	read(in, pc_StageAtMaxDiameter);
+	read(in, pc_StageAtMaxHeight);
+	read(in, pc_StageMaxRootNConcentration);
+	read(in, pc_StageKcFactor);
+	read(in, pc_StageTemperatureSum);
+	read(in, vc_StomataResistance);
+	read(in, pc_StorageOrgan);
+	read(in, vc_StorageOrgan);
+	read(in, vc_TargetNConcentration);
+	read(in, vc_TimeStep);
+	read(in, vc_TimeUnderAnoxia);
+	read(in, vs_Tortuosity);
+	read(in, vc_TotalBiomass);
+	read(in, vc_TotalBiomassNContent);
+	read(in, vc_TotalCropHeatImpact);
+	read(in, vc_TotalNInput);
+	read(in, vc_TotalNUptake);
+	read(in, vc_TotalRespired);
+	read(in, vc_Respiration);
+	read(in, vc_SumTotalNUptake);
+	read(in, vc_TotalRootLength);
+	read(in, vc_TotalTemperatureSum);
+	read(in, vc_TemperatureSumToFlowering);
+	read(in, vc_Transpiration);
+	read(in, vc_TranspirationRedux);
+	read(in, vc_TranspirationDeficit);
+	read(in, vc_VernalisationDays);
+	read(in, vc_VernalisationFactor);
+	read(in, pc_VernalisationRequirement);
+	read(in, pc_WaterDeficitResponseOn);
+	read(in, eva2_usage);
+	readYieldComponents(in, eva2_primaryYieldComponents);
+	readYieldComponents(in, eva2_secondaryYieldComponents);
+	read(in, dyingOut);
+	read(in, vc_AccumulatedETa);
+	read(in, vc_AccumulatedTranspiration);
+	read(in, vc_AccumulatedPrimaryCropYield);
+	read(in, vc_sumExportedCutBiomass);
+	read(in, vc_exportedCutBiomass);
+	read(in, vc_sumResidueCutBiomass);
+	read(in, vc_residueCutBiomass);
+	read(in, vc_CuttingDelayDays);
+	read(in, vs_MaxEffectiveRootingDepth);
+	read(in, vs_ImpenetrableLayerDepth);
+	read(in, vc_AnthesisDay);
+	read(in, vc_MaturityDay);
+	read(in, vc_MaturityReached);
+	read(in, _rad24);
+	read(in, _rad240);
+	read(in, _tfol24);
+	read(in, _tfol240);
+	read(in, _index24);
+	read(in, _index240);
+	read(in, _full24);
+	read(in, _full240);
+	readEmissions(in, _guentherEmissions);
+	readEmissions(in, _jjvEmissions);
+	read(in, _vocSpecies);
+	read(in, _cropPhotosynthesisResults);
+	read(in, _fvcbDay);
+	read(in, _rootFormProfile);
+	read(in, _rootFormProfileFactor);
+	read(in, vc_RootDensityFactor);
+	read(in, vc_RootDensityFactorSum);
+	read(in, _rootDensityFactorDepth);
+	read(in, _rootDensityFactorZone);
+	read(in, _rootUptakeWeight);
+	read(in, _convectiveNUptakeFromLayer);
+	read(in, _diffusiveNUptakeFromLayer);
+	read(in, vc_O3_shortTermDamage);
+	read(in, vc_O3_longTermDamage);
+	read(in, vc_O3_senescence);
+	read(in, vc_O3_sumUptake);
+	read(in, vc_O3_WStomatalClosure);
+	read(in, _assimilatePartCoeffsReduced);
+	read(in, vc_KTkc);
+	read(in, vc_KTko);
+
+	//the tabulated temperature responses are fetched again on first use
+	_fvcbTemperatureResponses.reset();
+	_solarGeometry = solarGeometry(vs_Latitude);
+
+	return bool(in);
+}
+
 /**
  * @brief Calculates a single time step.
  *
@@ -315,9 +869,9 @@ void CropGrowth::step(double vw_MeanAirTemperature,
 		pc_Perennial,
 		vc_GrowthCycleEnded,
 		vc_TimeStep,
-		soilColumn[0].get_Vs_SoilMoisture_m3(),
-		soilColumn[0].vs_FieldCapacity(),
-		soilColumn[0].vs_PermanentWiltingPoint(),
+		(*soilColumn)[0].get_Vs_SoilMoisture_m3(),
+		(*soilColumn)[0].vs_FieldCapacity(),
+		(*soilColumn)[0].vs_PermanentWiltingPoint(),
 		pc_NumberOfDevelopmentalStages,
 		vc_VernalisationFactor,
 		vc_DaylengthFactor,
@@ -471,14 +1025,14 @@ void CropGrowth::step(double vw_MeanAirTemperature,
 		}
 		fc_CropWaterUptake(vc_SoilCoverage,
 			vc_RootingZone,
-			soilColumn.vm_GroundwaterTable,
+			soilColumn->vm_GroundwaterTable,
 			vc_ReferenceEvapotranspiration,
 			vw_GrossPrecipitation,
 			vc_CurrentTotalTemperatureSum,
 			vc_TotalTemperatureSum);
 
 		fc_CropNUptake(vc_RootingZone,
-			soilColumn.vm_GroundwaterTable,
+			soilColumn->vm_GroundwaterTable,
 			vc_CurrentTotalTemperatureSum,
 			vc_TotalTemperatureSum);
 
@@ -498,6 +1052,8 @@ void CropGrowth::step(double vw_MeanAirTemperature,
  * Taken from the original HERMES model, Kersebaum, K.C. and Richter J.
  * (1991): Modelling nitrogen dynamics in a plant-soil system with a
  * simple model for advisory purposes. Fert. Res. 27 (2-3), 273 - 281.
+ * The values depending only on latitude and day of year are shared
+ * by all runs at the same latitude (see solar-geometry.h).
  *
  * @param vs_JulianDay
  * @param vs_Latitude
@@ -508,64 +1064,18 @@ void CropGrowth::fc_Radiation(double vs_JulianDay, double vs_Latitude,
 	double vw_GlobalRadiation,
 	double vw_SunshineHours)
 {
-
-	double vc_DeclinationSinus = 0.0; // old SINLD
-	double vc_DeclinationCosinus = 0.0; // old COSLD
-
-	// Calculation of declination - old DEC
-	vc_Declination = -23.4 * cos(2.0 * PI * ((vs_JulianDay + 10.0) / 365.0));
-
-	vc_DeclinationSinus = sin(vc_Declination * PI / 180.0) * sin(vs_Latitude * PI / 180.0);
-	vc_DeclinationCosinus = cos(vc_Declination * PI / 180.0) * cos(vs_Latitude * PI / 180.0);
-
-	// Calculation of the atmospheric day lenght - old DL
-	double arg_AstroDayLength = vc_DeclinationSinus / vc_DeclinationCosinus;
-	arg_AstroDayLength = bound(-1.0, arg_AstroDayLength, 1.0); //The argument of asin must be in the range of -1 to 1 
-	vc_AstronomicDayLenght = 12.0 * (PI + 2.0 * asin(arg_AstroDayLength)) / PI;
-
-	// Calculation of the effective day length - old DLE
-
-	double EDLHelper = (-sin(8.0 * PI / 180.0) + vc_DeclinationSinus) / vc_DeclinationCosinus;
-
-	if ((EDLHelper < -1.0) || (EDLHelper > 1.0))
-	{
-		vc_EffectiveDayLength = 0.01;
-	}
-	else
-	{
-		vc_EffectiveDayLength = 12.0 * (PI + 2.0 * asin(EDLHelper)) / PI;
-	}
-	/*EDLHelper = bound(-1.0, EDLHelper, 1.0);
-	vc_EffectiveDayLength = 12.0 * (PI + 2.0 * asin(EDLHelper)) / PI;*/
-
-	// old DLP
-	double arg_PhotoDayLength = (-sin(-6.0 * PI / 180.0) + vc_DeclinationSinus) / vc_DeclinationCosinus;
-	arg_PhotoDayLength = bound(-1.0, arg_PhotoDayLength, 1.0); //The argument of asin must be in the range of -1 to 1
-	vc_PhotoperiodicDaylength = 12.0 * (PI + 2.0 * asin(arg_PhotoDayLength)) / PI;
-
-	// Calculation of the mean photosynthetically active radiation [J m-2] - old RDN
-	double arg_PhotAct = min(1.0, ((vc_DeclinationSinus / vc_DeclinationCosinus) * (vc_DeclinationSinus / vc_DeclinationCosinus))); //The argument of sqrt must be >= 0
-	vc_PhotActRadiationMean = 3600.0 * (vc_DeclinationSinus * vc_AstronomicDayLenght + 24.0 / PI * vc_DeclinationCosinus
-		* sqrt(1.0 - arg_PhotAct));
-
-	// Calculation of radiation on a clear day [J m-2] - old DRC	
-	if (vc_PhotActRadiationMean > 0 && vc_AstronomicDayLenght > 0)
-		vc_ClearDayRadiation = 0.5 * 1300.0 * vc_PhotActRadiationMean * exp(-0.14 / (vc_PhotActRadiationMean
-			/ (vc_AstronomicDayLenght * 3600.0)));
-	else
-		vc_ClearDayRadiation = 0;
-
-	// Calculation of radiation on an overcast day [J m-2] - old DRO
-	vc_OvercastDayRadiation = 0.2 * vc_ClearDayRadiation;
-
-	// Calculation of extraterrestrial radiation - old EXT
-	double pc_SolarConstant = 0.082; //[MJ m-2 d-1] Note: Here is the difference to HERMES, which calculates in [J cm-2 d-1]!
-	double SC = 24.0 * 60.0 / PI * pc_SolarConstant *(1.0 + 0.033 * cos(2.0 * PI * vs_JulianDay / 365.0));
-
-	double arg_SolarAngle = -tan(vs_Latitude * PI / 180.0) * tan(vc_Declination * PI / 180.0);
-	arg_SolarAngle = bound(-1.0, arg_SolarAngle, 1.0);
-	double vc_SunsetSolarAngle = acos(arg_SolarAngle);
-	vc_ExtraterrestrialRadiation = SC * (vc_SunsetSolarAngle * vc_DeclinationSinus + vc_DeclinationCosinus * sin(vc_SunsetSolarAngle)); // [MJ m-2]
+	// the latitude is the site's, so it's the one of the run's solar geometry
+	assert(vs_Latitude == _solarGeometry->latitude());
+	const auto& sd = _solarGeometry->day(int(vs_JulianDay));
+
+	vc_Declination = sd.vc_Declination;
+	vc_AstronomicDayLenght = sd.vc_AstronomicDayLenght;
+	vc_EffectiveDayLength = sd.vc_EffectiveDayLength;
+	vc_PhotoperiodicDaylength = sd.vc_PhotoperiodicDaylength;
+	vc_PhotActRadiationMean = sd.vc_PhotActRadiationMean;
+	vc_ClearDayRadiation = sd.vc_ClearDayRadiation;
+	vc_OvercastDayRadiation = sd.vc_OvercastDayRadiation;
+	vc_ExtraterrestrialRadiation = sd.vc_ExtraterrestrialRadiation;
 
 	if (vw_GlobalRadiation > 0.0)
 		vc_GlobalRadiation = vw_GlobalRadiation;
@@ -742,9 +1252,9 @@ double CropGrowth::fc_OxygenDeficiency(double d_CriticalOxygenContent)
 	double vc_MaxOxygenDeficit = 0.0;
 
 	// Reduktion bei Luftmangel Stauwasser berücksichtigen!!!!
-	vc_AirFilledPoreVolume = ((soilColumn[0].vs_Saturation() + soilColumn[1].vs_Saturation()
-		+ soilColumn[2].vs_Saturation()) - (soilColumn[0].get_Vs_SoilMoisture_m3() + soilColumn[1].get_Vs_SoilMoisture_m3()
-			+ soilColumn[2].get_Vs_SoilMoisture_m3())) / 3.0;
+	vc_AirFilledPoreVolume = (((*soilColumn)[0].vs_Saturation() + (*soilColumn)[1].vs_Saturation()
+		+ (*soilColumn)[2].vs_Saturation()) - ((*soilColumn)[0].get_Vs_SoilMoisture_m3() + (*soilColumn)[1].get_Vs_SoilMoisture_m3()
+			+ (*soilColumn)[2].get_Vs_SoilMoisture_m3())) / 3.0;
 	if (vc_AirFilledPoreVolume < d_CriticalOxygenContent)
 	{
 		vc_TimeUnderAnoxia += int(vc_TimeStep);
@@ -830,7 +1340,7 @@ void CropGrowth::fc_CropDevelopmentalStage(double vw_MeanAirTemperature,
 	double vc_DevelopmentAccelerationByNitrogenStress = 0.0; // old NPROG
 	double vc_DevelopmentAccelerationByWaterStress = 0.0; // old WPROG
 	double vc_DevelopmentAccelerationByStress = 0.0; // old DEVPROG
-	double vc_SoilTemperature = soilColumn[0].get_Vs_SoilTemperature();
+	double vc_SoilTemperature = (*soilColumn)[0].get_Vs_SoilTemperature();
 	double vc_StageExcessTemperatureSum = 0.0;
 
 
@@ -878,7 +1388,7 @@ void CropGrowth::fc_CropDevelopmentalStage(double vw_MeanAirTemperature,
 				{
 
 					if (d_SoilMoisture_m3 > ((0.2 * vc_CapillaryWater) + d_PermanentWiltingPoint)
-						&& (soilColumn.vs_SurfaceWaterStorage < 0.001))
+						&& (soilColumn->vs_SurfaceWaterStorage < 0.001))
 					{
 						// Germination only if soil water content in top layer exceeds
 						// 20% of capillary water, but is not beyond field capacity and
@@ -918,7 +1428,7 @@ void CropGrowth::fc_CropDevelopmentalStage(double vw_MeanAirTemperature,
 				else if (pc_EmergenceMoistureControlOn == false && pc_EmergenceFloodingControlOn == true)
 				{
 
-					if (soilColumn.vs_SurfaceWaterStorage < 0.001)
+					if (soilColumn->vs_SurfaceWaterStorage < 0.001)
 					{
 						// Germination only if no water is stored on the soil surface.
 
@@ -993,12 +1503,12 @@ void CropGrowth::fc_CropDevelopmentalStage(double vw_MeanAirTemperature,
 
 
 			/**vc_CurrentTemperatureSum[vc_DevelopmentalStage] = 0.0;*/
-			if (cropPs.__enable_Phenology_WangEngelTemperatureResponse__)
+			if (cropPs->__enable_Phenology_WangEngelTemperatureResponse__)
 			{
 				double devTresponse = max(0.0, WangEngelTemperatureResponse(vw_MeanAirTemperature,
-					cultivarPs.pc_MinTempDev_WE,
-					cultivarPs.pc_OptTempDev_WE,
-					cultivarPs.pc_MaxTempDev_WE,
+					cultivarPs->pc_MinTempDev_WE,
+					cultivarPs->pc_OptTempDev_WE,
+					cultivarPs->pc_MaxTempDev_WE,
 					1.0));
 
 				vc_CurrentTemperatureSum[vc_DevelopmentalStage] += devTresponse * vw_MeanAirTemperature
@@ -1029,12 +1539,12 @@ void CropGrowth::fc_CropDevelopmentalStage(double vw_MeanAirTemperature,
 		}
 		else
 		{
-			if (cropPs.__enable_Phenology_WangEngelTemperatureResponse__)
+			if (cropPs->__enable_Phenology_WangEngelTemperatureResponse__)
 			{
 				double devTresponse = max(0.0, WangEngelTemperatureResponse(vw_MeanAirTemperature,
-					cultivarPs.pc_MinTempDev_WE,
-					cultivarPs.pc_OptTempDev_WE,
-					cultivarPs.pc_MaxTempDev_WE,
+					cultivarPs->pc_MinTempDev_WE,
+					cultivarPs->pc_OptTempDev_WE,
+					cultivarPs->pc_MaxTempDev_WE,
 					1.0));
 
 				vc_CurrentTemperatureSum[vc_DevelopmentalStage] += devTresponse * vw_MeanAirTemperature
@@ -1253,20 +1763,20 @@ void CropGrowth::fc_CropGreenArea(double vw_MeanAirTemperature,
 	double vc_TimeStep)
 {
 	double TempResponseExpansion = 1.0;
-	if (cropPs.__enable_T_response_leaf_expansion__)
+	if (cropPs->__enable_T_response_leaf_expansion__)
 	{
 		//Stage switch T response leaf exp (wheat = 2, maize = -1 (deactivated))
-		if (vc_DevelopmentalStage + 1 <= speciesPs.pc_TransitionStageLeafExp)
+		if (vc_DevelopmentalStage + 1 <= speciesPs->pc_TransitionStageLeafExp)
 		{
 			//Early stages leaf expansion T response
 			//!!!! maybe referenceTempResponseExpansion calculation should be moved to the constructor because it has to be calculated just once per crop
-			double referenceTempResponseExpansion = 223.9 * exp(-5.03 * exp(-0.0653 * cultivarPs.pc_EarlyRefLeafExp));
+			double referenceTempResponseExpansion = 223.9 * exp(-5.03 * exp(-0.0653 * cultivarPs->pc_EarlyRefLeafExp));
 			TempResponseExpansion = std::min(223.9 * exp(-5.03 * exp(-0.0653 * vw_MeanAirTemperature)) / referenceTempResponseExpansion, 1.3);
 		}
 		else
 		{
 			//leaf expansion T response
-			double referenceTempResponseExpansion = 37.7 * exp(-7.23 * exp(-0.1462 * cultivarPs.pc_RefLeafExp));
+			double referenceTempResponseExpansion = 37.7 * exp(-7.23 * exp(-0.1462 * cultivarPs->pc_RefLeafExp));
 			TempResponseExpansion = std::min(37.7 * exp(-7.23 * exp(-0.1462 * vw_MeanAirTemperature)) / referenceTempResponseExpansion, 1.3);
 		}
 	}
@@ -1398,7 +1908,7 @@ void CropGrowth::fc_MoveDeadRootBiomassToSoil(double deadRootBiomass,
 	double vc_RootDensityFactorSum,
 	const vector<double>& vc_RootDensityFactor)
 {
-	uint nools = soilColumn.vs_NumberOfOrganicLayers();
+	uint nools = soilColumn->vs_NumberOfOrganicLayers();
 
 	map<int, double> layer2deadRootBiomassAtLayer;
 	for (uint i = 0; i < vc_RootingZone; i++)
@@ -1415,8 +1925,8 @@ void CropGrowth::fc_MoveDeadRootBiomassToSoil(double deadRootBiomass,
 
 void CropGrowth::addAndDistributeRootBiomassInSoil(double rootBiomass)
 {
-	auto p = calcRootDensityFactorAndSum();
-	fc_MoveDeadRootBiomassToSoil(rootBiomass, p.second, p.first);
+	updateRootDensityFactor();
+	fc_MoveDeadRootBiomassToSoil(rootBiomass, vc_RootDensityFactorSum, vc_RootDensityFactor);
 }
 
 /**
@@ -1530,14 +2040,14 @@ void CropGrowth::fc_CropPhotosynthesis(double vw_MeanAirTemperature,
 	double vc_PhotoGrowthRespiration = 0.0;
 	double vc_DarkGrowthRespiration = 0.0;
 
-	double pc_ReferenceLeafAreaIndex = cropPs.pc_ReferenceLeafAreaIndex;
-	double pc_ReferenceMaxAssimilationRate = cropPs.pc_ReferenceMaxAssimilationRate;
-	double pc_MaintenanceRespirationParameter_1 = cropPs.pc_MaintenanceRespirationParameter1;
-	double pc_MaintenanceRespirationParameter_2 = cropPs.pc_MaintenanceRespirationParameter2;
+	double pc_ReferenceLeafAreaIndex = cropPs->pc_ReferenceLeafAreaIndex;
+	double pc_ReferenceMaxAssimilationRate = cropPs->pc_ReferenceMaxAssimilationRate;
+	double pc_MaintenanceRespirationParameter_1 = cropPs->pc_MaintenanceRespirationParameter1;
+	double pc_MaintenanceRespirationParameter_2 = cropPs->pc_MaintenanceRespirationParameter2;
 
-	double pc_GrowthRespirationParameter_1 = cropPs.pc_GrowthRespirationParameter1;
-	double pc_GrowthRespirationParameter_2 = cropPs.pc_GrowthRespirationParameter2;
-	double pc_CanopyReflectionCoeff = cropPs.pc_CanopyReflectionCoefficient; // old REFLC;
+	double pc_GrowthRespirationParameter_1 = cropPs->pc_GrowthRespirationParameter1;
+	double pc_GrowthRespirationParameter_2 = cropPs->pc_GrowthRespirationParameter2;
+	double pc_CanopyReflectionCoeff = cropPs->pc_CanopyReflectionCoefficient; // old REFLC;
 //  std::cout << setprecision(15) << "pc_ReferenceLeafAreaIndex: " << pc_ReferenceLeafAreaIndex << std::endl;
 //  std::cout << setprecision(15) << "pc_ReferenceMaxAssimilationRate: " << pc_ReferenceMaxAssimilationRate << std::endl;
 //  std::cout << setprecision(15) << "pc_MaintenanceRespirationParameter_1: " << pc_MaintenanceRespirationParameter_1 << std::endl;
@@ -1570,22 +2080,22 @@ void CropGrowth::fc_CropPhotosynthesis(double vw_MeanAirTemperature,
 			double tempK = vw_MeanAirTemperature + D_IN_K;
 			double term1 = (tempK - TK25) / (TK25 * tempK * RGAS);
 			double term2 = sqrt(tempK / TK25);
-			vc_KTkc = exp(speciesPs.AEKC * term1) * term2;
-			vc_KTko = exp(speciesPs.AEKO * term1) * term2;
-			Mkc = speciesPs.KC25 * vc_KTkc; //[µmol mol-1]
+			vc_KTkc = exp(speciesPs->AEKC * term1) * term2;
+			vc_KTko = exp(speciesPs->AEKO * term1) * term2;
+			Mkc = speciesPs->KC25 * vc_KTkc; //[µmol mol-1]
 			_cropPhotosynthesisResults.kc = Mkc;
 			_cropPhotosynthesisResults.kc = Mkc;
-			Mko = speciesPs.KO25 * vc_KTko; //[mmol mol-1]
+			Mko = speciesPs->KO25 * vc_KTko; //[mmol mol-1]
 			_cropPhotosynthesisResults.ko = Mko * 1000.0; // mmol -> umol
 
 			//OLD exponential response
-			KTvmax = cropPs.__enable_Photosynthesis_WangEngelTemperatureResponse__
+			KTvmax = cropPs->__enable_Photosynthesis_WangEngelTemperatureResponse__
 				? max(0.00001, WangEngelTemperatureResponse(vw_MeanAirTemperature,
 					pc_MinimumTemperatureForAssimilation,
 					pc_OptimumTemperatureForAssimilation,
 					pc_MaximumTemperatureForAssimilation,
 					1.0))
-				: exp(speciesPs.AEVC * term1) * term2;
+				: exp(speciesPs->AEVC * term1) * term2;
 
 
 			// Berechnung des Transformationsfaktors für pflanzenspez. AMAX bei 25 grad
@@ -2033,23 +2543,77 @@ void CropGrowth::fc_CropPhotosynthesis(double vw_MeanAirTemperature,
 
 	int vs_JulianDay = currentDate.julianDay();
 	double dailyGP = 0;
-	if (cropPs.__enable_hourly_FvCB_photosynthesis__ && pc_CarboxylationPathway == 1)
+	if (cropPs->__enable_hourly_FvCB_photosynthesis__ && pc_CarboxylationPathway == 1)
 	{
-		vector<double> hourlyGlobrads;
-		vector<double> hourlyExtrarad;
-		int sunriseH = 0;
+		using namespace FvCB;
 
+		auto& day = _fvcbDay;
+		const auto& solarHours = _solarGeometry->hours(vs_JulianDay);
+		int sunriseH = 0;
 		for (int h = 0; h < 24; h++)
 		{
 			double hgr = hourlyRad(vc_GlobalRadiation, vs_Latitude, vs_JulianDay, h);
-			if (hgr > 0 && hourlyGlobrads.back() == 0.0)
+			if (hgr > 0 && h > 0 && day.global_rad[h - 1] == 0.0)
 				sunriseH = h;
-			hourlyGlobrads.push_back(hgr);
+			day.global_rad[h] = hgr;
+			day.extra_terr_rad[h] = solarHours.extraterrestrialRadiation[h];
+		}
 
-			hourlyExtrarad.push_back(hourlyRad(vc_ExtraterrestrialRadiation, vs_Latitude, vs_JulianDay, h));
+		for (int h = 0; h < 24; h++)
+		{
+			double hourlyTemp = hourlyT(vw_MinAirTemperature, vw_MaxAirTemperature, h, sunriseH);
+			day.leaf_temp[h] = hourlyTemp;
+			day.LAI[h] = vc_LeafAreaIndex;
+			day.solar_el[h] = solarHours.solarElevation[h];
+			day.VPD[h] = hourlyVaporPressureDeficit(hourlyTemp, vw_MinAirTemperature, vw_MeanAirTemperature, vw_MaxAirTemperature);
+			day.Ca[h] = vw_AtmosphericCO2Concentration;
 		}
 
-		using namespace FvCB;
+		//all terms not depending on the ozone damaged Vcmax_25 at once for the whole day,
+		//the rest has to be done hour by hour, as the ozone damage of an hour reduces Vcmax_25 of the next
+		const FvCB_temperature_responses* responses = nullptr;
+		if (cropPs->__approximate_FvCB_temperature_responses__)
+		{
+			double tolerance = cropPs->pc_FvCBTemperatureResponseTolerance;
+			if (!_fvcbTemperatureResponses || _fvcbTemperatureResponseTolerance != tolerance)
+			{
+				_fvcbTemperatureResponses = FvCB_temperature_response_tables(tolerance);
+				_fvcbTemperatureResponseTolerance = tolerance;
+				if (_fvcbTemperatureResponses->maxError() > tolerance)
+				{
+					cerr << "CropGrowth: tabulated FvCB temperature responses miss the tolerance "
+						<< tolerance << " (error: " << _fvcbTemperatureResponses->maxError() << ")" << endl;
+				}
+			}
+			responses = _fvcbTemperatureResponses.get();
+		}
+
+		FvCB_canopy_hourly_params hps;
+		FvCB_canopy_day_C3(day, 24, hps, responses);
+
+		//the soil water state doesn't change during the day
+		int root_depth = get_RootingDepth();
+		double rootZoneFC = 0, rootZoneWP = 0, rootZoneSWC = 0;
+		for (int i = 0; i < root_depth; i++)
+		{
+			rootZoneFC += (*soilColumn)[i].vs_FieldCapacity();
+			rootZoneWP += (*soilColumn)[i].vs_PermanentWiltingPoint();
+			rootZoneSWC += (*soilColumn)[i].get_Vs_SoilMoisture_m3();
+		}
+
+		O3impact::O3_impact_params O3_par;
+		O3_par.gamma3 = 0.05; //TODO: calibrate and add to crop params
+		O3_par.gamma1 = 0.025; //TODO: calibrate and add to crop params
+
+		O3impact::O3_impact_in O3_in;
+		O3_in.FC = rootZoneFC / (root_depth + 1); //field capacity, m3 m-3, avg in the rooted zone
+		O3_in.WP = rootZoneWP / (root_depth + 1); //wilting point, m3 m-3
+		O3_in.SWC = rootZoneSWC / (root_depth + 1); //soil water content, m3 m-3
+		O3_in.ET0 = get_ReferenceEvapotranspiration();
+		O3_in.O3a = vw_AtmosphericO3Concentration; //ambient O3 partial pressure, nbar or nmol mol-1
+		O3_in.reldev = vc_RelativeTotalDevelopment;
+		O3_in.GDD_flo = vc_TemperatureSumToFlowering; //GDD from emergence to flowering
+		O3_in.GDD_mat = vc_TotalTemperatureSum; //GDD from emergence to maturity
 
 		_guentherEmissions = Voc::Emissions();
 		_jjvEmissions = Voc::Emissions();
@@ -2060,25 +2624,11 @@ void CropGrowth::fc_CropPhotosynthesis(double vw_MeanAirTemperature,
 			FvCB::tout()
 				<< currentDate.toIsoDateString()
 				<< "," << h
-				<< "," << speciesPs.pc_SpeciesId << "/" << cultivarPs.pc_CultivarId
+				<< "," << speciesPs->pc_SpeciesId << "/" << cultivarPs->pc_CultivarId
 				<< "," << vw_AtmosphericCO2Concentration;
 #endif
 			//hourly photosynthesis
-			FvCB_canopy_hourly_in FvCB_in;
-
-			double hourlyTemp = hourlyT(vw_MinAirTemperature, vw_MaxAirTemperature, h, sunriseH);
-			FvCB_in.leaf_temp = hourlyTemp;
-			FvCB_in.global_rad = hourlyGlobrads.at(h);
-			FvCB_in.extra_terr_rad = hourlyExtrarad.at(h);
-			FvCB_in.LAI = vc_LeafAreaIndex;
-			FvCB_in.solar_el = solarElevation(h, vs_Latitude, vs_JulianDay);
-			FvCB_in.VPD = hourlyVaporPressureDeficit(hourlyTemp, vw_MinAirTemperature, vw_MeanAirTemperature, vw_MaxAirTemperature);
-			FvCB_in.Ca = vw_AtmosphericCO2Concentration;
-
-			FvCB_canopy_hourly_params hps;
-			hps.Vcmax_25 = speciesPs.VCMAX25 * vc_O3_shortTermDamage * vc_O3_senescence;
-
-			auto FvCB_res = FvCB_canopy_hourly_C3(FvCB_in, hps);
+			auto FvCB_res = FvCB_canopy_hourly_C3(day, h, speciesPs->VCMAX25 * vc_O3_shortTermDamage * vc_O3_senescence);
 
 			vc_sunlitLeafAreaIndex[h] = FvCB_res.sunlit.LAI;
 			vc_shadedLeafAreaIndex[h] = FvCB_res.shaded.LAI;
@@ -2087,30 +2637,16 @@ void CropGrowth::fc_CropPhotosynthesis(double vw_MeanAirTemperature,
 			dailyGP += FvCB_res.canopy_gross_photos * 44. / 100. / 1000.;
 
 			//hourly O3 uptake and damage
-			O3impact::O3_impact_in O3_in;
-			O3impact::O3_impact_params O3_par;
-			O3_par.gamma3 = 0.05; //TODO: calibrate and add to crop params
-			O3_par.gamma1 = 0.025; //TODO: calibrate and add to crop params
-
-			int root_depth = get_RootingDepth();
 			if (root_depth >= 1) //the crop has emerged
 			{
 #ifdef TEST_O3_HOURLY_OUTPUT
 				O3impact::tout()
 					<< currentDate.toIsoDateString()
 					<< "," << h
-					<< "," << speciesPs.pc_SpeciesId << "/" << cultivarPs.pc_CultivarId
+					<< "," << speciesPs->pc_SpeciesId << "/" << cultivarPs->pc_CultivarId
 					<< "," << vw_AtmosphericCO2Concentration
 					<< "," << vw_AtmosphericO3Concentration;
 #endif
-				double FC = 0, WP = 0, SWC = 0;
-				for (int i = 0; i < root_depth; i++)
-				{
-					FC += soilColumn[i].vs_FieldCapacity();
-					WP += soilColumn[i].vs_PermanentWiltingPoint();
-					SWC += soilColumn[i].get_Vs_SoilMoisture_m3();
-				}
-
 				//weighted average gs and conversion from unit ground area to unit leaf area
 				double lai_sun_weight = FvCB_res.sunlit.LAI / (FvCB_res.sunlit.LAI + FvCB_res.shaded.LAI);
 				double lai_sh_weight = 1 - lai_sun_weight;
@@ -2120,16 +2656,8 @@ void CropGrowth::fc_CropPhotosynthesis(double vw_MeanAirTemperature,
 					avg_leaf_gs += lai_sun_weight * FvCB_res.sunlit.gs / FvCB_res.sunlit.LAI;
 				}
 
-				O3_in.FC = FC / (root_depth + 1); //field capacity, m3 m-3, avg in the rooted zone
-				O3_in.WP = WP / (root_depth + 1); //wilting point, m3 m-3
-				O3_in.SWC = SWC / (root_depth + 1); //soil water content, m3 m-3
-				O3_in.ET0 = get_ReferenceEvapotranspiration();
-				O3_in.O3a = vw_AtmosphericO3Concentration; //ambient O3 partial pressure, nbar or nmol mol-1
 				O3_in.gs = avg_leaf_gs; //stomatal conductance mol m-2 s-1 bar-1 
 				O3_in.h = h; //hour of the day (0-23)
-				O3_in.reldev = vc_RelativeTotalDevelopment;
-				O3_in.GDD_flo = vc_TemperatureSumToFlowering; //GDD from emergence to flowering
-				O3_in.GDD_mat = vc_TotalTemperatureSum; //GDD from emergence to maturity
 				O3_in.fO3s_d_prev = vc_O3_shortTermDamage; //short term ozone induced reduction of Ac of the previous time step
 				O3_in.sum_O3_up = vc_O3_sumUptake; //cumulated O3 uptake, µmol m-2 (unit ground area)			
 
@@ -2143,7 +2671,7 @@ void CropGrowth::fc_CropPhotosynthesis(double vw_MeanAirTemperature,
 			}
 
 			// calculate VOC emissions
-			double globradWm2 = FvCB_in.global_rad * 1000000.0 / 3600; //MJ m-2 h-1 -> W m-2
+			double globradWm2 = day.global_rad[h] * 1000000.0 / 3600; //MJ m-2 h-1 -> W m-2
 			if (_index240 < _stepSize240 - 1)
 				_index240++;
 			else
@@ -2152,7 +2680,7 @@ void CropGrowth::fc_CropPhotosynthesis(double vw_MeanAirTemperature,
 				_full240 = true;
 			}
 			_rad240[_index240] = globradWm2;
-			_tfol240[_index240] = FvCB_in.leaf_temp;
+			_tfol240[_index240] = day.leaf_temp[h];
 
 			if (_index24 < _stepSize24 - 1)
 				_index24++;
@@ -2162,14 +2690,14 @@ void CropGrowth::fc_CropPhotosynthesis(double vw_MeanAirTemperature,
 				_full24 = true;
 			}
 			_rad24[_index24] = globradWm2;
-			_tfol24[_index24] = FvCB_in.leaf_temp;
+			_tfol24[_index24] = day.leaf_temp[h];
 
 			Voc::MicroClimateData mcd;
 			//hourly or time step average global radiation (in case of monica usually 24h)
 			mcd.rad = globradWm2;
 			mcd.rad24 = accumulate(_rad24.begin(), _rad24.end(), 0.0) / (_full24 ? _rad24.size() : _index24 + 1);
 			mcd.rad240 = accumulate(_rad240.begin(), _rad240.end(), 0.0) / (_full240 ? _rad240.size() : _index240 + 1);
-			mcd.tFol = FvCB_in.leaf_temp;
+			mcd.tFol = day.leaf_temp[h];
 			mcd.tFol24 = accumulate(_tfol24.begin(), _tfol24.end(), 0.0) / (_full24 ? _tfol24.size() : _index24 + 1);
 			mcd.tFol240 = accumulate(_tfol240.begin(), _tfol240.end(), 0.0) / (_full240 ? _tfol240.size() : _index240 + 1);
 			mcd.co2concentration = vw_AtmosphericCO2Concentration;
@@ -2184,14 +2712,14 @@ void CropGrowth::fc_CropPhotosynthesis(double vw_MeanAirTemperature,
 			species.mFol = get_OrganGreenBiomass(LEAF) / (100. * 100.); //kg/ha -> kg/m2
 			species.sla = species.mFol > 0 ? species.lai / species.mFol : pc_SpecificLeafArea[vc_DevelopmentalStage] * 100. * 100.; //ha/kg -> m2/kg
 
-			species.EF_MONO = speciesPs.EF_MONO;
-			species.EF_MONOS = speciesPs.EF_MONOS;
-			species.EF_ISO = speciesPs.EF_ISO;
-			species.VCMAX25 = speciesPs.VCMAX25;
-			species.AEKC = speciesPs.AEKC;
-			species.AEKO = speciesPs.AEKO;
-			species.AEVC = speciesPs.AEVC;
-			species.KC25 = speciesPs.KC25;
+			species.EF_MONO = speciesPs->EF_MONO;
+			species.EF_MONOS = speciesPs->EF_MONOS;
+			species.EF_ISO = speciesPs->EF_ISO;
+			species.VCMAX25 = speciesPs->VCMAX25;
+			species.AEKC = speciesPs->AEKC;
+			species.AEKO = speciesPs->AEKO;
+			species.AEVC = speciesPs->AEVC;
+			species.KC25 = speciesPs->KC25;
 
 			auto ges = Voc::calculateGuentherVOCEmissions(species, mcd, 1. / 24.);
 			//cout << "G: C: " << ges.monoterpene_emission << " em: " << ges.isoprene_emission << endl;
@@ -2202,19 +2730,19 @@ void CropGrowth::fc_CropPhotosynthesis(double vw_MeanAirTemperature,
 			tout()
 				<< currentDate.toIsoDateString()
 				<< "," << h
-				<< "," << speciesPs.pc_SpeciesId << "/" << cultivarPs.pc_CultivarId
-				<< "," << FvCB_in.global_rad
-				<< "," << FvCB_in.extra_terr_rad
-				<< "," << FvCB_in.solar_el
+				<< "," << speciesPs->pc_SpeciesId << "/" << cultivarPs->pc_CultivarId
+				<< "," << day.global_rad[h]
+				<< "," << day.extra_terr_rad[h]
+				<< "," << day.solar_el[h]
 				<< "," << mcd.rad
-				<< "," << FvCB_in.LAI
+				<< "," << day.LAI[h]
 				<< "," << species.mFol
 				<< "," << species.sla
-				<< "," << FvCB_in.leaf_temp
-				<< "," << FvCB_in.VPD
-				<< "," << FvCB_in.Ca
-				<< "," << FvCB_in.fO3
-				<< "," << FvCB_in.fls
+				<< "," << day.leaf_temp[h]
+				<< "," << day.VPD[h]
+				<< "," << day.Ca[h]
+				<< "," << 1.0 //fO3
+				<< "," << 1.0 //fls
 				<< "," << FvCB_res.canopy_net_photos
 				<< "," << FvCB_res.canopy_resp
 				<< "," << FvCB_res.canopy_gross_photos
@@ -2246,8 +2774,8 @@ void CropGrowth::fc_CropPhotosynthesis(double vw_MeanAirTemperature,
 				_cropPhotosynthesisResults.ko = lf.ko * 1000;
 				_cropPhotosynthesisResults.oi = lf.oi * 1000;
 				_cropPhotosynthesisResults.ci = lf.ci;
-				_cropPhotosynthesisResults.vcMax = FvCB::Vcmax_bernacchi_f(mcd.tFol, speciesPs.VCMAX25) * vc_CropNRedux * vc_TranspirationDeficit;//lf.vcMax;
-				_cropPhotosynthesisResults.jMax = FvCB::Jmax_bernacchi_f(mcd.tFol, 120)  * vc_CropNRedux * vc_TranspirationDeficit;//lf.jMax;
+				_cropPhotosynthesisResults.vcMax = speciesPs->VCMAX25 * day.Tresp_Vcmax[h] * vc_CropNRedux * vc_TranspirationDeficit;//lf.vcMax;
+				_cropPhotosynthesisResults.jMax = 120 * day.Tresp_Jmax[h] * vc_CropNRedux * vc_TranspirationDeficit;//lf.jMax;
 				_cropPhotosynthesisResults.jj = lf.jj;
 				_cropPhotosynthesisResults.jj1000 = lf.jj1000;
 				_cropPhotosynthesisResults.jv = lf.jv;
@@ -2287,7 +2815,7 @@ void CropGrowth::fc_CropPhotosynthesis(double vw_MeanAirTemperature,
 	}
 #pragma endregion hourly FvCB code
 
-	vc_GrossCO2Assimilation = cropPs.__enable_hourly_FvCB_photosynthesis__ && pc_CarboxylationPathway == 1
+	vc_GrossCO2Assimilation = cropPs->__enable_hourly_FvCB_photosynthesis__ && pc_CarboxylationPathway == 1
 		? dailyGP
 		: vc_GrossCO2Assimilation;
 
@@ -2537,8 +3065,8 @@ void CropGrowth::fc_FrostKill(double vw_MaxAirTemperature, double
 	double vc_CrownTemperature = 0.0;
 	if (vc_DevelopmentalStage <= 1)
 	{
-		vc_CrownTemperature = (3.0 * soilColumn.vt_SoilSurfaceTemperature
-			+ 2.0 * soilColumn[0].get_Vs_SoilTemperature()) / 5.0;
+		vc_CrownTemperature = (3.0 * soilColumn->vt_SoilSurfaceTemperature
+			+ 2.0 * (*soilColumn)[0].get_Vs_SoilTemperature()) / 5.0;
 	}
 	else
 	{
@@ -2583,9 +3111,9 @@ void CropGrowth::fc_FrostKill(double vw_MaxAirTemperature, double
 	double vc_RespirationFactor = (exp(0.84 + 0.051 * vc_CrownTemperature) - 2.0) / 1.85;
 	double vc_SnowDepthFactor = 0.0;
 
-	if (soilColumn.vm_SnowDepth <= 125.0)
+	if (soilColumn->vm_SnowDepth <= 125.0)
 	{
-		vc_SnowDepthFactor = soilColumn.vm_SnowDepth / 125.0;
+		vc_SnowDepthFactor = soilColumn->vm_SnowDepth / 125.0;
 	}
 	else
 	{
@@ -2748,9 +3276,9 @@ void CropGrowth::fc_CropDryMatter(int vc_DevelopmentalStage,
 	double /*vs_SoilSpecificMaxRootingDepth*/,
 	double vw_MeanAirTemperature)
 {
-	assert(soilColumn.vs_NumberOfLayers() >= 0);
-	uint nols = soilColumn.vs_NumberOfLayers();
-	double layerThickness = soilColumn.vs_LayerThickness();
+	assert(soilColumn->vs_NumberOfLayers() >= 0);
+	uint nols = soilColumn->vs_NumberOfLayers();
+	double layerThickness = soilColumn->vs_LayerThickness();
 
 	double vc_MaxRootNConcentration = 0.0; // old WGM
 	double vc_NConcentrationOptimum = 0.0; // old DTOPTN
@@ -2765,7 +3293,7 @@ void CropGrowth::fc_CropDryMatter(int vc_DevelopmentalStage,
 	//std::vector<double> vc_RootSurface(nols, 0.0); // old FL
 
 
-	const UserCropParameters& user_crops = cropPs;
+	const UserCropParameters& user_crops = *cropPs;
 	double pc_MaxCropNDemand = user_crops.pc_MaxCropNDemand;
 
 	//double pc_GrowthRespirationRedux = user_crops->getPc_GrowthRespirationRedux();
@@ -2773,13 +3301,13 @@ void CropGrowth::fc_CropDryMatter(int vc_DevelopmentalStage,
 	//vc_NetPhotosynthesis = (vc_GrossPhotosynthesis - vc_NetMaintenanceRespiration + vc_ReserveAssimilatePool) * pc_GrowthRespirationRedux; // from HERMES algorithms
 	vc_NetPhotosynthesis = vc_Assimilates; // from AGROSIM algorithms
 	//double stage_mobil_from_storage_coeff = 0.3;
-	double TMP_Regulatory_factor = speciesPs.pc_StageMobilFromStorageCoeff[vc_DevelopmentalStage];
+	double TMP_Regulatory_factor = speciesPs->pc_StageMobilFromStorageCoeff[vc_DevelopmentalStage];
 
 	if (vc_DevelopmentalStage == 1) {
-		TMP_Regulatory_factor = speciesPs.pc_StageMobilFromStorageCoeff[vc_DevelopmentalStage] * vc_KTkc;
+		TMP_Regulatory_factor = speciesPs->pc_StageMobilFromStorageCoeff[vc_DevelopmentalStage] * vc_KTkc;
 	}
 
-	double mobilization_from_storage = vc_OrganBiomass[vc_StorageOrgan] * speciesPs.pc_StageMobilFromStorageCoeff[vc_DevelopmentalStage] * vc_KTkc;
+	double mobilization_from_storage = vc_OrganBiomass[vc_StorageOrgan] * speciesPs->pc_StageMobilFromStorageCoeff[vc_DevelopmentalStage] * vc_KTkc;
 
 	vc_ReserveAssimilatePool = 0.0;
 
@@ -2790,7 +3318,7 @@ void CropGrowth::fc_CropDryMatter(int vc_DevelopmentalStage,
 	vc_TotalBiomass = 0.0;
 
 	//old PESUM [kg m-2 --> kg ha-1]
-	//vc_TotalBiomassNContent += (soilColumn.vq_CropNUptake * 10000.0) + vc_FixedN;
+	//vc_TotalBiomassNContent += (soilColumn->vq_CropNUptake * 10000.0) + vc_FixedN;
 
 	// Dry matter production
 	// old NRKOM
@@ -3078,13 +3606,13 @@ void CropGrowth::fc_CropDryMatter(int vc_DevelopmentalStage,
 
 	// Determining root penetration rate according to soil clay content [m °C-1 d-1]
 	double vc_RootPenetrationRate = 0.0; // [m °C-1 d-1]
-	if (soilColumn[vc_RootingDepth].vs_SoilClayContent() <= 0.02)
+	if ((*soilColumn)[vc_RootingDepth].vs_SoilClayContent() <= 0.02)
 	{
 		vc_RootPenetrationRate = 0.5 * pc_RootPenetrationRate;
 	}
-	else if (soilColumn[vc_RootingDepth].vs_SoilClayContent() <= 0.08)
+	else if ((*soilColumn)[vc_RootingDepth].vs_SoilClayContent() <= 0.08)
 	{
-		vc_RootPenetrationRate = ((1.0 / 3.0) + (0.5 / 0.06 * soilColumn[vc_RootingDepth].vs_SoilClayContent()))
+		vc_RootPenetrationRate = ((1.0 / 3.0) + (0.5 / 0.06 * (*soilColumn)[vc_RootingDepth].vs_SoilClayContent()))
 			* pc_RootPenetrationRate; // [m °C-1 d-1]
 	}
 	else
@@ -3129,12 +3657,10 @@ void CropGrowth::fc_CropDryMatter(int vc_DevelopmentalStage,
 	vc_TotalRootLength = vc_RootBiomass * pc_SpecificRootLength; //[m m-2]
 
 	// Calculating a root density distribution factor []
-	std::vector<double> vc_RootDensityFactor;
-	double vc_RootDensityFactorSum = 0.0;
-	tie(vc_RootDensityFactor, vc_RootDensityFactorSum) = calcRootDensityFactorAndSum();
+	updateRootDensityFactor();
 
 	// calculate the distribution of dead root biomass (for later addition into AOM pools (in soil-organic))
-	if (!cropPs.__disable_daily_root_biomass_to_soil__)
+	if (!cropPs->__disable_daily_root_biomass_to_soil__)
 		fc_MoveDeadRootBiomassToSoil(dailyDeadBiomassIncrement[0], vc_RootDensityFactorSum, vc_RootDensityFactor);
 
 	// Calculating root density per layer from total root length and
@@ -3250,30 +3776,42 @@ void CropGrowth::fc_CropDryMatter(int vc_DevelopmentalStage,
 	}
 }
 
-pair<vector<double>, double> CropGrowth::calcRootDensityFactorAndSum()
+void CropGrowth::updateRootDensityFactor()
 {
-	uint nols = soilColumn.vs_NumberOfLayers();
-	double layerThickness = soilColumn.vs_LayerThickness();
+	size_t nols = soilColumn->vs_NumberOfLayers();
+	double layerThickness = soilColumn->vs_LayerThickness();
 
-	// Calculating a root density distribution factor []
-	std::vector<double> vc_RootDensityFactor(nols, 0.0);
-	for (size_t i_Layer = 0; i_Layer < nols; i_Layer++)
+	// the depth profile changes only with the crop (e.g. perennial crop parameters)
+	if (_rootFormProfile.size() != nols || _rootFormProfileFactor != pc_RootFormFactor)
 	{
-		if (i_Layer < vc_RootingDepth)
-			vc_RootDensityFactor[i_Layer] = exp(-pc_RootFormFactor * (i_Layer * layerThickness)); // []
-		else if (i_Layer < vc_RootingZone)
-			vc_RootDensityFactor[i_Layer] = exp(-pc_RootFormFactor * (i_Layer * layerThickness))
-			* (1.0 - ((i_Layer - vc_RootingDepth) / (vc_RootingZone - vc_RootingDepth))); // []
-		else
-			vc_RootDensityFactor[i_Layer] = 0.0; // []
+		_rootFormProfile.resize(nols);
+		for (size_t i_Layer = 0; i_Layer < nols; i_Layer++)
+			_rootFormProfile[i_Layer] = exp(-pc_RootFormFactor * (i_Layer * layerThickness)); // []
+		_rootFormProfileFactor = pc_RootFormFactor;
+		vc_RootDensityFactor.clear();
 	}
+	else if (vc_RootDensityFactor.size() == nols
+		&& _rootDensityFactorDepth == vc_RootingDepth
+		&& _rootDensityFactorZone == vc_RootingZone)
+		return;
+
+	// Calculating a root density distribution factor []
+	vc_RootDensityFactor.assign(nols, 0.0);
+	size_t depth = min<size_t>(vc_RootingDepth, nols);
+	size_t zone = min<size_t>(vc_RootingZone, nols);
+	for (size_t i_Layer = 0; i_Layer < depth; i_Layer++)
+		vc_RootDensityFactor[i_Layer] = _rootFormProfile[i_Layer]; // []
+	for (size_t i_Layer = depth; i_Layer < zone; i_Layer++)
+		vc_RootDensityFactor[i_Layer] = _rootFormProfile[i_Layer]
+		* (1.0 - ((i_Layer - vc_RootingDepth) / (vc_RootingZone - vc_RootingDepth))); // []
 
 	// Summing up all factors to scale to a relative factor between [0;1]
-	double vc_RootDensityFactorSum = 0.0;
+	vc_RootDensityFactorSum = 0.0;
 	for (size_t i_Layer = 0; i_Layer < vc_RootingZone; i_Layer++)
 		vc_RootDensityFactorSum += vc_RootDensityFactor[i_Layer]; // []
 
-	return make_pair(vc_RootDensityFactor, vc_RootDensityFactorSum);
+	_rootDensityFactorDepth = vc_RootingDepth;
+	_rootDensityFactorZone = vc_RootingZone;
 }
 
 
@@ -3322,7 +3860,7 @@ double CropGrowth::fc_ReferenceEvapotranspiration(double vs_HeightNN,
 	double vc_ReferenceEvapotranspiration; //[mm]
 	double vw_NetRadiation; //[MJ m-2]
 
-	const UserCropParameters& user_crops = cropPs;
+	const UserCropParameters& user_crops = *cropPs;
 	double pc_SaturationBeta = user_crops.pc_SaturationBeta; // Original: Yu et al. 2001; beta = 3.5
 	double pc_StomataConductanceAlpha = user_crops.pc_StomataConductanceAlpha; // Original: Yu et al. 2001; alpha = 0.06
 	double pc_ReferenceAlbedo = user_crops.pc_ReferenceAlbedo; // FAO Green gras reference albedo from Allen et al. (1998)
@@ -3442,8 +3980,8 @@ void CropGrowth::fc_CropWaterUptake(double vc_SoilCoverage,
 	double /*vc_CurrentTotalTemperatureSum*/,
 	double /*vc_TotalTemperatureSum*/)
 {
-	size_t nols = soilColumn.vs_NumberOfLayers();
-	double layerThickness = soilColumn.vs_LayerThickness();
+	size_t nols = soilColumn->vs_NumberOfLayers();
+	double layerThickness = soilColumn->vs_LayerThickness();
 	double vc_PotentialTranspirationDeficit = 0.0; // [mm]
 	vc_PotentialTranspiration = 0.0; // old TRAMAX [mm]
 	double vc_PotentialEvapotranspiration = 0.0; // [mm]
@@ -3456,12 +3994,12 @@ void CropGrowth::fc_CropWaterUptake(double vc_SoilCoverage,
 	double vc_Interception = 0.0;
 	vc_RemainingEvapotranspiration = 0.0;
 
-	for (size_t i_Layer = 0; i_Layer < nols; i_Layer++)
-	{
-		vc_Transpiration[i_Layer] = 0.0; // old TP [mm]
-		vc_TranspirationRedux[i_Layer] = 0.0; // old TRRED []
-		vc_RootEffectivity[i_Layer] = 0.0; // old WUEFF [?]
-	}
+	const SoilColumnArrays& sca = soilColumn->arrays();
+
+	fill(vc_Transpiration.begin(), vc_Transpiration.end(), 0.0); // old TP [mm]
+	fill(vc_TranspirationRedux.begin(), vc_TranspirationRedux.end(), 0.0); // old TRRED []
+	fill(vc_RootEffectivity.begin(), vc_RootEffectivity.end(), 0.0); // old WUEFF [?]
+	_rootUptakeWeight.assign(nols, 0.0);
 
 	// ################
 	// # Interception #
@@ -3538,96 +4076,76 @@ void CropGrowth::fc_CropWaterUptake(double vc_SoilCoverage,
 
 		vc_PotentialTranspiration = vc_RemainingEvapotranspiration * vc_SoilCoverage; // [mm]
 
+		// the passes over the rooting zone are written as selects instead of branches,
+		// so that they vectorize, the values are the same as of the stepwise functions
 		for (size_t i_Layer = 0; i_Layer < vc_RootingZone; i_Layer++)
 		{
-			double vc_AvailableWater = soilColumn[i_Layer].vs_FieldCapacity() - soilColumn[i_Layer].vs_PermanentWiltingPoint();
-			double vc_AvailableWaterPercentage = (soilColumn[i_Layer].get_Vs_SoilMoisture_m3()
-				- soilColumn[i_Layer].vs_PermanentWiltingPoint()) / vc_AvailableWater;
-			if (vc_AvailableWaterPercentage < 0.0) vc_AvailableWaterPercentage = 0.0;
+			double vc_AvailableWater = sca.vs_FieldCapacity[i_Layer] - sca.vs_PermanentWiltingPoint[i_Layer];
+			double vc_AvailableWaterPercentage = (double(sca.vs_SoilMoisture_m3[i_Layer])
+				- sca.vs_PermanentWiltingPoint[i_Layer]) / vc_AvailableWater;
+			double awp = vc_AvailableWaterPercentage < 0.0 ? 0.0 : vc_AvailableWaterPercentage;
+
+			double redux =
+				awp < 0.15 ? awp * 3.0 // []
+				: awp < 0.3 ? 0.45 + (0.25 * (awp - 0.15) / 0.15)
+				: awp < 0.5 ? 0.7 + (0.275 * (awp - 0.3) / 0.2)
+				: awp < 0.75 ? 0.975 + (0.025 * (awp - 0.5) / 0.25)
+				: 1.0;
+			double effectivity =
+				awp < 0.15 ? 0.15 + 0.45 * awp / 0.15 // []
+				: awp < 0.3 ? 0.6 + (0.2 * (awp - 0.15) / 0.15)
+				: awp < 0.5 ? 0.8 + (0.2 * (awp - 0.3) / 0.2)
+				: 1.0;
+
+			vc_TranspirationRedux[i_Layer] = redux < 0 ? 0.0 : redux;
+			vc_RootEffectivity[i_Layer] = effectivity < 0 ? 0.0 : effectivity;
+		}
 
-			if (vc_AvailableWaterPercentage < 0.15)
-			{
-				vc_TranspirationRedux[i_Layer] = vc_AvailableWaterPercentage * 3.0; // []
-				vc_RootEffectivity[i_Layer] = 0.15 + 0.45 * vc_AvailableWaterPercentage / 0.15; // []
-			}
-			else if (vc_AvailableWaterPercentage < 0.3)
-			{
-				vc_TranspirationRedux[i_Layer] = 0.45 + (0.25 * (vc_AvailableWaterPercentage - 0.15) / 0.15);
-				vc_RootEffectivity[i_Layer] = 0.6 + (0.2 * (vc_AvailableWaterPercentage - 0.15) / 0.15);
-			}
-			else if (vc_AvailableWaterPercentage < 0.5)
-			{
-				vc_TranspirationRedux[i_Layer] = 0.7 + (0.275 * (vc_AvailableWaterPercentage - 0.3) / 0.2);
-				vc_RootEffectivity[i_Layer] = 0.8 + (0.2 * (vc_AvailableWaterPercentage - 0.3) / 0.2);
-			}
-			else if (vc_AvailableWaterPercentage < 0.75)
-			{
-				vc_TranspirationRedux[i_Layer] = 0.975 + (0.025 * (vc_AvailableWaterPercentage - 0.5) / 0.25);
-				vc_RootEffectivity[i_Layer] = 1.0;
-			}
-			else
-			{
-				vc_TranspirationRedux[i_Layer] = 1.0;
-				vc_RootEffectivity[i_Layer] = 1.0;
-			}
-			if (vc_TranspirationRedux[i_Layer] < 0)
-				vc_TranspirationRedux[i_Layer] = 0.0;
-			if (vc_RootEffectivity[i_Layer] < 0)
-				vc_RootEffectivity[i_Layer] = 0.0;
-			if (i_Layer == vc_GroundwaterTable)
-			{ // old GRW
-				vc_RootEffectivity[i_Layer] = 0.5;
-			}
-			if (i_Layer > vc_GroundwaterTable)
-			{ // old GRW
+		// old GRW: half effectivity in the groundwater layer, none below
+		if (vc_GroundwaterTable < vc_RootingZone)
+		{
+			vc_RootEffectivity[vc_GroundwaterTable] = 0.5;
+			for (size_t i_Layer = vc_GroundwaterTable + 1; i_Layer < vc_RootingZone; i_Layer++)
 				vc_RootEffectivity[i_Layer] = 0.0;
-			}
+		}
+
+		for (size_t i_Layer = 0; i_Layer < vc_RootingZone; i_Layer++)
+		{
 			if (((i_Layer + 1)*layerThickness) >= vs_MaxEffectiveRootingDepth)
-			{
 				vc_RootEffectivity[i_Layer] = 0.0;
-			}
-
-			vc_TotalRootEffectivity += vc_RootEffectivity[i_Layer] * vc_RootDensity[i_Layer]; //[m m-3]
-			vc_RemainingTotalRootEffectivity = vc_TotalRootEffectivity;
+			_rootUptakeWeight[i_Layer] = vc_RootEffectivity[i_Layer] * vc_RootDensity[i_Layer]; //[m m-3]
 		}
 
+		for (size_t i_Layer = 0; i_Layer < vc_RootingZone; i_Layer++)
+			vc_TotalRootEffectivity += _rootUptakeWeight[i_Layer]; //[m m-3]
+		vc_RemainingTotalRootEffectivity = vc_TotalRootEffectivity;
+
 		//std::cout << setprecision(11) << "vc_TotalRootEffectivity: " << vc_TotalRootEffectivity << std::endl;
 		//std::cout << setprecision(11) << "vc_OxygenDeficit: " << vc_OxygenDeficit << std::endl;
 
-		for (size_t i_Layer = 0; i_Layer < nols; i_Layer++)
+		// layers below the rooting zone resp. the groundwater table keep their zero transpiration,
+		// the layer right below them is included as in the original loop
+		size_t uptakeZone = min(vc_RootingZone, vc_GroundwaterTable + 1);
+		if (vc_TotalRootEffectivity != 0.0)
 		{
-			if (i_Layer > min(vc_RootingZone, vc_GroundwaterTable + 1))
+			for (size_t i_Layer = 0, end = min(uptakeZone + 1, nols); i_Layer < end; i_Layer++)
 			{
-				vc_Transpiration[i_Layer] = 0.0; //[mm]
-			}
-			else
-			{
-				vc_Transpiration[i_Layer] = vc_TotalRootEffectivity != 0.0
-					? vc_PotentialTranspiration * ((vc_RootEffectivity[i_Layer] * vc_RootDensity[i_Layer])
-						/ vc_TotalRootEffectivity) * vc_OxygenDeficit
-					: 0;
-
-				//std::cout << setprecision(11) << "vc_Transpiration[i_Layer]: " << i_Layer << ", " << vc_Transpiration[i_Layer] << std::endl;
-				//std::cout << setprecision(11) << "vc_RootEffectivity[i_Layer]: " << i_Layer << ", " << vc_RootEffectivity[i_Layer] << std::endl;
-				//std::cout << setprecision(11) << "vc_RootDensity[i_Layer]: " << i_Layer << ", " << vc_RootDensity[i_Layer] << std::endl;
-
-				// [mm]
+				vc_Transpiration[i_Layer] = vc_PotentialTranspiration * ((vc_RootEffectivity[i_Layer] * vc_RootDensity[i_Layer])
+					/ vc_TotalRootEffectivity) * vc_OxygenDeficit; // [mm]
 			}
 		}
 
-		for (size_t i_Layer = 0; i_Layer < min(vc_RootingZone, vc_GroundwaterTable + 1); i_Layer++)
+		for (size_t i_Layer = 0; i_Layer < uptakeZone; i_Layer++)
 		{
-
-
-			vc_RemainingTotalRootEffectivity -= vc_RootEffectivity[i_Layer] * vc_RootDensity[i_Layer]; // [m m-3]
+			vc_RemainingTotalRootEffectivity -= _rootUptakeWeight[i_Layer]; // [m m-3]
 
 			if (vc_RemainingTotalRootEffectivity <= 0.0)
 				vc_RemainingTotalRootEffectivity = 0.00001;
-			if (((vc_Transpiration[i_Layer] / 1000.0) / layerThickness) > ((soilColumn[i_Layer].get_Vs_SoilMoisture_m3()
-				- soilColumn[i_Layer].vs_PermanentWiltingPoint())))
+			double availableWater = double(sca.vs_SoilMoisture_m3[i_Layer]) - sca.vs_PermanentWiltingPoint[i_Layer];
+			if (((vc_Transpiration[i_Layer] / 1000.0) / layerThickness) > availableWater)
 			{
 				vc_PotentialTranspirationDeficit = (((vc_Transpiration[i_Layer] / 1000.0) / layerThickness)
-					- (soilColumn[i_Layer].get_Vs_SoilMoisture_m3() - soilColumn[i_Layer].vs_PermanentWiltingPoint()))
+					- availableWater)
 					* layerThickness * 1000.0; // [mm]
 				if (vc_PotentialTranspirationDeficit < 0.0)
 				{
@@ -3648,14 +4166,10 @@ void CropGrowth::fc_CropWaterUptake(double vc_SoilCoverage,
 			vc_ActualTranspirationDeficit = max(vc_TranspirationReduced, vc_PotentialTranspirationDeficit); //[mm]
 			if (vc_ActualTranspirationDeficit > 0.0)
 			{
-				if (i_Layer < min(vc_RootingZone, vc_GroundwaterTable + 1))
+				for (size_t i_Layer2 = i_Layer + 1; i_Layer2 < uptakeZone; i_Layer2++)
 				{
-					for (size_t i_Layer2 = i_Layer + 1; i_Layer2 < min(vc_RootingZone, vc_GroundwaterTable + 1); i_Layer2++)
-					{
-						vc_Transpiration[i_Layer2] += vc_ActualTranspirationDeficit * (vc_RootEffectivity[i_Layer2]
-							* vc_RootDensity[i_Layer2] / vc_RemainingTotalRootEffectivity);
-
-					}
+					vc_Transpiration[i_Layer2] += vc_ActualTranspirationDeficit * (_rootUptakeWeight[i_Layer2]
+						/ vc_RemainingTotalRootEffectivity);
 				}
 			}
 			vc_Transpiration[i_Layer] = vc_Transpiration[i_Layer] - vc_ActualTranspirationDeficit;
@@ -3706,20 +4220,18 @@ void CropGrowth::fc_CropNUptake(int vc_RootingZone,
 	double /*vc_CurrentTotalTemperatureSum*/,
 	double /*vc_TotalTemperatureSum*/)
 {
-	size_t nols = soilColumn.vs_NumberOfLayers();
-	double layerThickness = soilColumn.vs_LayerThickness();
+	size_t nols = soilColumn->vs_NumberOfLayers();
+	double layerThickness = soilColumn->vs_LayerThickness();
 
 	double vc_ConvectiveNUptake = 0.0; // old TRNSUM
 	double vc_DiffusiveNUptake = 0.0; // old SUMDIFF
-	std::vector<double> vc_ConvectiveNUptakeFromLayer(nols, 0.0); // old MASS
-
-	std::vector<double> vc_DiffusionCoeff(nols, 0.0); // old D
-	std::vector<double> vc_DiffusiveNUptakeFromLayer(nols, 0.0); // old DIFF
-	double vc_ConvectiveNUptake_1 = 0.0; // old MASSUM
-	double vc_DiffusiveNUptake_1 = 0.0; // old DIFFSUM
-	double pc_MinimumAvailableN = cropPs.pc_MinimumAvailableN; // kg m-3
-	double pc_MinimumNConcentrationRoot = cropPs.pc_MinimumNConcentrationRoot;  // kg kg-1
-	double pc_MaxCropNDemand = cropPs.pc_MaxCropNDemand;
+	std::vector<double>& vc_ConvectiveNUptakeFromLayer = _convectiveNUptakeFromLayer; // old MASS
+	std::vector<double>& vc_DiffusiveNUptakeFromLayer = _diffusiveNUptakeFromLayer; // old DIFF
+	vc_ConvectiveNUptakeFromLayer.assign(nols, 0.0);
+	vc_DiffusiveNUptakeFromLayer.assign(nols, 0.0);
+	double pc_MinimumAvailableN = cropPs->pc_MinimumAvailableN; // kg m-3
+	double pc_MinimumNConcentrationRoot = cropPs->pc_MinimumNConcentrationRoot;  // kg kg-1
+	double pc_MaxCropNDemand = cropPs->pc_MaxCropNDemand;
 
 	vc_TotalNUptake = 0.0;
 	vc_TotalNInput = 0.0;
@@ -3734,92 +4246,73 @@ void CropGrowth::fc_CropNUptake(int vc_RootingZone,
 	{
 		//if ((vc_CurrentTotalTemperatureSum / vc_TotalTemperatureSum) < 1.0){
 
-		for (int i_Layer = 0; i_Layer < (min(vc_RootingZone, vc_GroundwaterTable)); i_Layer++)
-		{
+		const SoilColumnArrays& sca = soilColumn->arrays();
+		int uptakeZone = max(0, min(vc_RootingZone, vc_GroundwaterTable));
 
-			vs_SoilMineralNContent[i_Layer] = soilColumn[i_Layer].vs_SoilNO3; // [kg m-3]
+		for (int i_Layer = 0; i_Layer < uptakeZone; i_Layer++)
+		{
+			double moisture = sca.vs_SoilMoisture_m3[i_Layer]; // old WG [m3 m-3]
+			double nmin = sca.vs_SoilNO3[i_Layer]; // [kg m-3]
+			vs_SoilMineralNContent[i_Layer] = nmin;
 
 			// Convective N uptake per layer
 			vc_ConvectiveNUptakeFromLayer[i_Layer] = (vc_Transpiration[i_Layer] / 1000.0) * //[mm --> m]
-				(vs_SoilMineralNContent[i_Layer] / // [kg m-3]
-				(soilColumn[i_Layer].get_Vs_SoilMoisture_m3())) * // old WG [m3 m-3]
-				vc_TimeStep; // -->[kg m-2]
-
-			vc_ConvectiveNUptake += vc_ConvectiveNUptakeFromLayer[i_Layer]; // [kg m-2]
+				(nmin / moisture) * vc_TimeStep; // -->[kg m-2]
 
 			/** @todo Claas: Woher kommt der Wert für vs_Tortuosity? */
 			/** @todo Claas: Prüfen ob Umstellung auf [m] die folgenden Gleichungen beeinflusst */
-			vc_DiffusionCoeff[i_Layer] = 0.000214 * (vs_Tortuosity * exp(soilColumn[i_Layer].get_Vs_SoilMoisture_m3() * 10))
-				/ soilColumn[i_Layer].get_Vs_SoilMoisture_m3(); //[m2 d-1]
+			double vc_DiffusionCoeff = 0.000214 * (vs_Tortuosity * exp(moisture * 10)) / moisture; //[m2 d-1] old D
 
-			vc_DiffusiveNUptakeFromLayer[i_Layer] = (vc_DiffusionCoeff[i_Layer] * // [m2 d-1]
-				soilColumn[i_Layer].get_Vs_SoilMoisture_m3() * // [m3 m-3]
+			double diffusive = (vc_DiffusionCoeff * // [m2 d-1]
+				moisture * // [m3 m-3]
 				2.0 * PI * vc_RootDiameter[i_Layer] * // [m]
-				(vs_SoilMineralNContent[i_Layer] / 1000.0 / // [kg m-3]
-					soilColumn[i_Layer].get_Vs_SoilMoisture_m3() - 0.000014) * // [m3 m-3]
+				(nmin / 1000.0 / moisture - 0.000014) * // [m3 m-3]
 				sqrt(PI * vc_RootDensity[i_Layer])) * // [m m-3]
 				vc_RootDensity[i_Layer] * 1000.0 * vc_TimeStep; // -->[kg m-2]
+			vc_DiffusiveNUptakeFromLayer[i_Layer] = diffusive < 0.0 ? 0.0 : diffusive;
+		}
 
-			if (vc_DiffusiveNUptakeFromLayer[i_Layer] < 0.0)
-			{
-				vc_DiffusiveNUptakeFromLayer[i_Layer] = 0;
-			}
-
+		for (int i_Layer = 0; i_Layer < uptakeZone; i_Layer++)
+		{
+			vc_ConvectiveNUptake += vc_ConvectiveNUptakeFromLayer[i_Layer]; // [kg m-2]
 			vc_DiffusiveNUptake += vc_DiffusiveNUptakeFromLayer[i_Layer]; // [kg m-2]
-
 		}
 
-		for (int i_Layer = 0; i_Layer < (min(vc_RootingZone, vc_GroundwaterTable)); i_Layer++)
+		if (vc_CropNDemand > 0.0)
 		{
-
-			if (vc_CropNDemand > 0.0)
+			// which source covers the demand is the same for all layers
+			if (vc_ConvectiveNUptake >= vc_CropNDemand)
 			{
-
-				if (vc_ConvectiveNUptake >= vc_CropNDemand)
-				{
-					// convective N uptake is sufficient
+				// convective N uptake is sufficient
+				for (int i_Layer = 0; i_Layer < uptakeZone; i_Layer++)
 					vc_NUptakeFromLayer[i_Layer] = vc_CropNDemand * vc_ConvectiveNUptakeFromLayer[i_Layer] / vc_ConvectiveNUptake;
-				}
-				else
-				{
-					// N demand is not covered
-					if ((vc_CropNDemand - vc_ConvectiveNUptake) < vc_DiffusiveNUptake)
-					{
-						vc_NUptakeFromLayer[i_Layer] = vc_ConvectiveNUptakeFromLayer[i_Layer] + ((vc_CropNDemand
-							- vc_ConvectiveNUptake) * vc_DiffusiveNUptakeFromLayer[i_Layer] / vc_DiffusiveNUptake);
-					}
-					else
-					{
-						vc_NUptakeFromLayer[i_Layer] = vc_ConvectiveNUptakeFromLayer[i_Layer] + vc_DiffusiveNUptakeFromLayer[i_Layer];
-					}
-				}
-
-				vc_ConvectiveNUptake_1 += vc_ConvectiveNUptakeFromLayer[i_Layer];
-				vc_DiffusiveNUptake_1 += vc_DiffusiveNUptakeFromLayer[i_Layer];
-
-				if (vc_NUptakeFromLayer[i_Layer] > ((vs_SoilMineralNContent[i_Layer] * layerThickness) - pc_MinimumAvailableN))
-				{
-					vc_NUptakeFromLayer[i_Layer] = (vs_SoilMineralNContent[i_Layer] * layerThickness) - pc_MinimumAvailableN;
-				}
-
-				if (vc_NUptakeFromLayer[i_Layer] > (pc_MaxCropNDemand / 10000.0 * 0.75))
-				{
-					vc_NUptakeFromLayer[i_Layer] = (pc_MaxCropNDemand / 10000.0 * 0.75);
-				}
-
-				if (vc_NUptakeFromLayer[i_Layer] < 0.0)
-				{
-					vc_NUptakeFromLayer[i_Layer] = 0.0;
-				}
+			}
+			else if ((vc_CropNDemand - vc_ConvectiveNUptake) < vc_DiffusiveNUptake)
+			{
+				// N demand is not covered
+				for (int i_Layer = 0; i_Layer < uptakeZone; i_Layer++)
+					vc_NUptakeFromLayer[i_Layer] = vc_ConvectiveNUptakeFromLayer[i_Layer] + ((vc_CropNDemand
+						- vc_ConvectiveNUptake) * vc_DiffusiveNUptakeFromLayer[i_Layer] / vc_DiffusiveNUptake);
 			}
 			else
 			{
-				vc_NUptakeFromLayer[i_Layer] = 0.0;
+				for (int i_Layer = 0; i_Layer < uptakeZone; i_Layer++)
+					vc_NUptakeFromLayer[i_Layer] = vc_ConvectiveNUptakeFromLayer[i_Layer] + vc_DiffusiveNUptakeFromLayer[i_Layer];
 			}
 
-			vc_TotalNUptake += vc_NUptakeFromLayer[i_Layer] * 10000.0; //[kg m-2] --> [kg ha-1]
+			double maxNUptakeFromLayer = pc_MaxCropNDemand / 10000.0 * 0.75;
+			for (int i_Layer = 0; i_Layer < uptakeZone; i_Layer++)
+			{
+				double uptake = vc_NUptakeFromLayer[i_Layer];
+				double available = (vs_SoilMineralNContent[i_Layer] * layerThickness) - pc_MinimumAvailableN;
+				uptake = uptake > available ? available : uptake;
+				uptake = uptake > maxNUptakeFromLayer ? maxNUptakeFromLayer : uptake;
+				vc_NUptakeFromLayer[i_Layer] = uptake < 0.0 ? 0.0 : uptake;
+			}
+		}
 
-		} // for
+		for (int i_Layer = 0; i_Layer < uptakeZone; i_Layer++)
+			vc_TotalNUptake += vc_NUptakeFromLayer[i_Layer] * 10000.0; //[kg m-2] --> [kg ha-1]
 
 		// *** Biological N Fixation ***
 
@@ -4050,14 +4543,14 @@ void CropGrowth::calculateVOCEmissions(const Voc::MicroClimateData& mcd)
 	species.mFol = get_OrganBiomass(LEAF) / (100. * 100.); //kg/ha -> kg/m2
 	species.sla = pc_SpecificLeafArea[vc_DevelopmentalStage] * 100. * 100.; //ha/kg -> m2/kg
 
-	species.EF_MONO = speciesPs.EF_MONO;
-	species.EF_MONOS = speciesPs.EF_MONOS;
-	species.EF_ISO = speciesPs.EF_ISO;
-	species.VCMAX25 = speciesPs.VCMAX25;
-	species.AEKC = speciesPs.AEKC;
-	species.AEKO = speciesPs.AEKO;
-	species.AEVC = speciesPs.AEVC;
-	species.KC25 = speciesPs.KC25;
+	species.EF_MONO = speciesPs->EF_MONO;
+	species.EF_MONOS = speciesPs->EF_MONOS;
+	species.EF_ISO = speciesPs->EF_ISO;
+	species.VCMAX25 = speciesPs->VCMAX25;
+	species.AEKC = speciesPs->AEKC;
+	species.AEKO = speciesPs->AEKO;
+	species.AEVC = speciesPs->AEVC;
+	species.KC25 = speciesPs->KC25;
 
 	_guentherEmissions = Voc::calculateGuentherVOCEmissions(species, mcd);
 	//debug() << "guenther: isoprene: " << gems.isoprene_emission << " monoterpene: " << gems.monoterpene_emission << endl;
@@ -4916,7 +5409,7 @@ CropGrowth::get_AccumulatedPrimaryCropYield() const
 double
 CropGrowth::getEffectiveRootingDepth() const
 {
-	size_t nols = soilColumn.vs_NumberOfLayers();
+	size_t nols = soilColumn->vs_NumberOfLayers();
 
 	for (size_t i_Layer = 0; i_Layer < nols; i_Layer++)
 		if (vc_RootEffectivity[i_Layer] == 0.0)
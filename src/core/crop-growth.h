@@ -32,6 +32,8 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 #include "monica-parameters.h"
 #include "soilcolumn.h"
 #include "voc-common.h"
+#include "photosynthesis-FvCB.h"
+#include "solar-geometry.h"
 #include "run/cultivation-method.h"
 
 namespace Monica
@@ -60,7 +62,7 @@ namespace Monica
 	{
 	public:
 		CropGrowth(SoilColumn& soilColumn,
-			const CropParameters& cropParams,
+			std::shared_ptr<const CropParameters> cropParams,
 			const SiteParameters& siteParams,
 			const UserCropParameters& cropPs,
 			const SimulationParameters& simPs,
@@ -415,6 +417,17 @@ namespace Monica
 
 		void setPerennialCropParameters(CropParametersPtr cps) { perennialCropParams = cps; }
 
+		//! attach a copied crop to the soil column, parameters and callbacks of the (forked) model owning it now
+		void rebind(SoilColumn& sc,
+			const UserCropParameters& cps,
+			std::function<void(std::string)> fireEvent,
+			std::function<void(std::map<int, double>, double)> addOrganicMatter);
+
+		//! write/read the growth state (see state-io.h), the parameters, soil column and callbacks
+		//! are those the crop's growth has been constructed or rebound with
+		void serialize(std::ostream& out) const;
+		bool deserialize(std::istream& in);
+
 		void fc_UpdateCropParametersForPerennial();
 
 		std::pair<const std::vector<double>&, const std::vector<double>&> sunlitAndShadedLAI() const
@@ -435,7 +448,9 @@ namespace Monica
 
 		double rootNConcentration() const { return vc_NConcentrationRoot; }
 
-		std::pair<std::vector<double>, double> calcRootDensityFactorAndSum();
+		//! root density distribution factor per layer and its sum over the rooting zone,
+		//! updated only if the rooting depth or zone changed since the last call
+		void updateRootDensityFactor();
 
 		void setStage(int newStage);
 
@@ -448,15 +463,19 @@ namespace Monica
 		bool isMaturityDay(int old_dev_stage, int new_dev_stage);
 
 		// members
-		SoilColumn& soilColumn;
+		SoilColumn* soilColumn{nullptr};
 		CropParametersPtr perennialCropParams;
-		const UserCropParameters& cropPs;
-		SpeciesParameters speciesPs;
-		CultivarParameters cultivarPs;
+		const UserCropParameters* cropPs{nullptr};
+		//! species and cultivar parameters, shared by all copies of the crop's growth
+		//! (e.g. with the initial state kept by MonicaModel), so they are never copied
+		std::shared_ptr<const CropParameters> _cropParams;
+		const SpeciesParameters* speciesPs{nullptr};
+		const CultivarParameters* cultivarPs{nullptr};
 
 		//! old N
 		//    static const double vw_AtmosphericCO2Concentration;
 		double vs_Latitude;
+		SolarGeometryPtr _solarGeometry; //!< day length and radiation at vs_Latitude
 		double vc_AbovegroundBiomass{ 0.0 };//! old OBMAS
 		double vc_AbovegroundBiomassOld{ 0.0 }; //! old OBALT
 		std::vector<bool> pc_AbovegroundOrgan;	//! old KOMP
@@ -672,7 +691,7 @@ namespace Monica
 		bool vc_MaturityReached{ false };
 
 		//VOC members
-		const int _stepSize24{ 24 }, _stepSize240{ 240 };
+		static const int _stepSize24{ 24 }, _stepSize240{ 240 };
 		std::vector<double> _rad24, _rad240, _tfol24, _tfol240;
 		int _index24{ 0 }, _index240{ 0 };
 		bool _full24{ false }, _full240{ false };
@@ -682,6 +701,26 @@ namespace Monica
 		Voc::SpeciesData _vocSpecies;
 		Voc::CPData _cropPhotosynthesisResults;
 
+		//! hourly FvCB photosynthesis inputs and precalculated terms of the current day
+		FvCB::FvCB_canopy_day _fvcbDay;
+		//! tabulated leaf temperature responses, if enabled, for the tolerance they were requested with
+		std::shared_ptr<const FvCB::FvCB_temperature_responses> _fvcbTemperatureResponses;
+		double _fvcbTemperatureResponseTolerance{ 0.0 };
+
+		//! exp(-pc_RootFormFactor * depth) per layer, for the root form factor it was computed with
+		std::vector<double> _rootFormProfile;
+		double _rootFormProfileFactor{ 0.0 };
+		//! root density distribution factors and the rooting depth and zone they belong to
+		std::vector<double> vc_RootDensityFactor;
+		double vc_RootDensityFactorSum{ 0.0 };
+		unsigned int _rootDensityFactorDepth{ 0 };
+		unsigned int _rootDensityFactorZone{ 0 };
+
+		//! per layer workspace of the water and N uptake
+		std::vector<double> _rootUptakeWeight;
+		std::vector<double> _convectiveNUptakeFromLayer;
+		std::vector<double> _diffusiveNUptakeFromLayer;
+
 		std::function<void(std::string)> _fireEvent;
 		std::function<void(std::map<int, double>, double)> _addOrganicMatter;
 
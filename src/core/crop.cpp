@@ -29,6 +29,7 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 #include "../core/monica-parameters.h"
 #include "tools/debug.h"
 #include "../io/database-io.h"
+#include "state-io.h"
 
 #include "crop.h"
 
@@ -214,5 +215,108 @@ string Crop::toString(bool detailed) const
   return s.str();
 }
 
+std::shared_ptr<Crop> Crop::clone() const
+{
+	auto c = make_shared<Crop>(*this);
+	if(_cropParams)
+		c->_cropParams = make_shared<CropParameters>(*_cropParams);
+	if(_perennialCropParams)
+		c->_perennialCropParams = _perennialCropParams == _cropParams
+			? c->_cropParams : make_shared<CropParameters>(*_perennialCropParams);
+	if(_residueParams)
+		c->_residueParams = make_shared<CropResidueParameters>(*_residueParams);
+	return c;
+}
+
+namespace
+{
+	template<typename T>
+	void writeParams(ostream& out, const shared_ptr<T>& ps)
+	{
+		StateIO::write(out, ps ? ps->to_json().dump() : string());
+	}
+
+	template<typename T>
+	bool readParams(istream& in, shared_ptr<T>& ps)
+	{
+		string s, err;
+		StateIO::read(in, s);
+		ps.reset();
+		if(!in || s.empty())
+			return bool(in);
+
+		auto j = json11::Json::parse(s, err);
+		if(!err.empty())
+			return false;
+		ps = make_shared<T>(j);
+		return true;
+	}
+}
+
+void Crop::serialize(std::ostream& out) const
+{
+	using namespace StateIO;
+
+	write(out, _dbId);
+	write(out, _speciesName);
+	write(out, _cultivarName);
+	write(out, _seedDate);
+	write(out, _harvestDate);
+	write(out, _isWinterCrop.isValue());
+	write(out, _isWinterCrop.isValue() && _isWinterCrop.value());
+	write(out, _isPerennialCrop.isValue());
+	write(out, _isPerennialCrop.isValue() && _isPerennialCrop.value());
+	write(out, _cuttingDates);
+	writeParams(out, _cropParams);
+	write(out, _perennialCropParams == _cropParams);
+	if(_perennialCropParams != _cropParams)
+		writeParams(out, _perennialCropParams);
+	writeParams(out, _residueParams);
+	write(out, _crossCropAdaptionFactor);
+	write(out, eva2_typeUsage);
+	write(out, _automaticHarvest);
+	write(out, int(_automaticHarvestParams.getHarvestTime()));
+	write(out, _automaticHarvestParams.getLatestHarvestDOY());
+}
+
+bool Crop::deserialize(std::istream& in)
+{
+	using namespace StateIO;
+
+	read(in, _dbId);
+	read(in, _speciesName);
+	read(in, _cultivarName);
+	read(in, _seedDate);
+	read(in, _harvestDate);
+	bool isValue = false, value = false;
+	read(in, isValue);
+	read(in, value);
+	_isWinterCrop = isValue ? Maybe<bool>(value) : Maybe<bool>();
+	read(in, isValue);
+	read(in, value);
+	_isPerennialCrop = isValue ? Maybe<bool>(value) : Maybe<bool>();
+	read(in, _cuttingDates);
+	if(!readParams(in, _cropParams))
+		return false;
+	bool samePerennialParams = false;
+	read(in, samePerennialParams);
+	if(samePerennialParams)
+		_perennialCropParams = _cropParams;
+	else if(!readParams(in, _perennialCropParams))
+		return false;
+	if(!readParams(in, _residueParams))
+		return false;
+	read(in, _crossCropAdaptionFactor);
+	read(in, eva2_typeUsage);
+	read(in, _automaticHarvest);
+	int harvestTime = 0, latestHarvestDOY = -1;
+	read(in, harvestTime);
+	read(in, latestHarvestDOY);
+	_automaticHarvestParams.setHarvestTime(AutomaticHarvestParameters::HarvestTime(harvestTime));
+	_automaticHarvestParams.setLatestHarvestDOY(latestHarvestDOY);
+
+	return bool(in);
+}
+
 //------------------------------------------------------------------------------
 
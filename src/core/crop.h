@@ -22,6 +22,7 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 #include <string>
 #include <vector>
 #include <memory>
+#include <iostream>
 
 #include "json11/json11.hpp"
 
@@ -113,6 +114,15 @@ namespace Monica
 
 		std::string toString(bool detailed = false) const;
 
+		//! a copy of the crop with its own copies of the parameters, e.g. for a fork running in parallel
+		std::shared_ptr<Crop> clone() const;
+
+		//! write the crop to a model state checkpoint, its parameters are written as JSON
+		void serialize(std::ostream& out) const;
+
+		//! read a crop written by serialize, the crop gets its own copies of the parameters
+		bool deserialize(std::istream& in);
+
 		void setEva2TypeUsage(int type) { eva2_typeUsage = type; }
 		int getEva2TypeUsage() const { return eva2_typeUsage; }
 		
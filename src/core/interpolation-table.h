@@ -0,0 +1,105 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Claas Nendel <claas.nendel@zalf.de>
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+#ifndef INTERPOLATION_TABLE_H_
+#define INTERPOLATION_TABLE_H_
+
+/**
+ * @file interpolation-table.h
+ *
+ * @brief Tabulation of a smooth response function on a uniform grid with
+ * linear interpolation between the grid points, as a cheap replacement of
+ * functions containing exp/pow calls.
+ *
+ * The grid is refined at construction until the interpolation error at
+ * all interval midpoints is below the requested bound, relative to
+ * max(1, |f(x)|). For smooth functions the largest interpolation error
+ * of an interval is at (or close to) its midpoint.
+ */
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+
+namespace Monica
+{
+	class InterpolationTable
+	{
+	public:
+		//! an empty table, which covers no value at all
+		InterpolationTable() {}
+
+		/**
+		 * Tabulates f on [xmin, xmax], starting with the grid width step,
+		 * which is halved until the error bound maxError is met or
+		 * maxRefinements halvings have been done.
+		 */
+		template<typename F>
+		InterpolationTable(F f, double xmin, double xmax, double step, double maxError, int maxRefinements = 12)
+			: _xmin(xmin)
+			, _xmax(xmax)
+		{
+			for(int r = 0; r <= maxRefinements; r++, step /= 2.0)
+			{
+				auto n = std::size_t(std::ceil((xmax - xmin) / step));
+				_invStep = double(n) / (xmax - xmin);
+				_ys.resize(n + 1);
+				for(std::size_t i = 0; i <= n; i++)
+					_ys[i] = f(xmin + double(i) / _invStep);
+
+				_maxError = 0.0;
+				for(std::size_t i = 0; i < n; i++)
+				{
+					auto x = xmin + (double(i) + 0.5) / _invStep;
+					auto y = f(x);
+					_maxError = std::max(_maxError, std::abs((*this)(x) - y) / std::max(1.0, std::abs(y)));
+				}
+
+				if(_maxError <= maxError)
+					break;
+			}
+		}
+
+		bool empty() const { return _ys.empty(); }
+
+		//! true if x is within [xmin, xmax]
+		bool covers(double x) const { return !_ys.empty() && x >= _xmin && x <= _xmax; }
+
+		//! interpolated value at x, x has to be covered by the table
+		double operator()(double x) const
+		{
+			auto pos = (x - _xmin) * _invStep;
+			auto i = std::min(std::size_t(pos), _ys.size() - 2);
+			auto t = pos - double(i);
+			return _ys[i] + t * (_ys[i + 1] - _ys[i]);
+		}
+
+		//! largest relative error found at construction
+		double maxError() const { return _maxError; }
+
+		std::size_t size() const { return _ys.size(); }
+
+	private:
+		double _xmin{0.0};
+		double _xmax{0.0};
+		double _invStep{0.0};
+		double _maxError{0.0};
+		std::vector<double> _ys;
+	};
+}
+
+#endif
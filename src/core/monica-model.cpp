@@ -32,6 +32,7 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 #include "climate/climate-common.h"
 #include "db/abstract-db-connections.h"
 #include "voc-common.h"
+#include "state-io.h"
 #include "tools/algorithms.h"
 
 using namespace Monica;
@@ -42,6 +43,12 @@ using namespace Soil;
 
 namespace
 {
+	//! identifies a MONICA model state checkpoint
+	const char stateMagic[8] = {'M', 'O', 'N', 'I', 'C', 'A', 'S', 'T'};
+
+	//! has to be increased whenever the layout written by the serialize methods changes
+	const uint32_t stateVersion = 5;
+
 	//! simple functor for use in fertiliser trigger
   struct AddFertiliserAmountsCallback
   {
@@ -94,6 +101,68 @@ MonicaModel::MonicaModel(const CentralParameterProvider& cpp)
   , vw_AtmosphericCO2Concentration(_envPs.p_AtmosphericCO2)
 {}
 
+/**
+ * @brief Forks a running model.
+ *
+ * The soil modules are created anew for the copy and get the state of
+ * the other model, a growing crop is copied and attached to the new model.
+ * The crop parameters are shared between both models.
+ */
+MonicaModel::MonicaModel(const MonicaModel& other)
+  : _sitePs(other._sitePs)
+  , _smPs(other._smPs)
+  , _envPs(other._envPs)
+  , _cropPs(other._cropPs)
+  , _soilTempPs(other._soilTempPs)
+  , _soilTransPs(other._soilTransPs)
+  , _soilOrganicPs(other._soilOrganicPs)
+  , _simPs(other._simPs)
+  , _groundwaterInformation(other._groundwaterInformation)
+  , _soilColumn(other._soilColumn)
+  , _soilTemperature(*this)
+  , _soilMoisture(*this)
+  , _soilOrganic(_soilColumn,
+                 _sitePs,
+                 _soilOrganicPs)
+  , _soilTransport(_soilColumn,
+                   _sitePs,
+                   _soilTransPs,
+                   _envPs.p_LeachingDepth,
+                   _envPs.p_timeStep,
+                   _cropPs.pc_MinimumAvailableN)
+{
+	stringstream state(ios::in | ios::out | ios::binary);
+	other.writeState(state);
+	readState(state);
+
+	//the soil modules' constructors initialize the column, so copy it (incl. postponed fertiliser applications) again
+	_soilColumn = other._soilColumn;
+	_soilColumn.remove_Crop();
+
+	_clearCropUponNextDay = other._clearCropUponNextDay;
+	//the crop's parameters are copied as well, so that forks (e.g. running in parallel) don't share them
+	if(other._currentCrop)
+		_currentCrop = other._currentCrop->clone();
+	if(other._currentCropGrowth)
+	{
+		_currentCropGrowth = new CropGrowth(*other._currentCropGrowth);
+		if(_currentCrop)
+			_currentCropGrowth->setPerennialCropParameters(_currentCrop->perennialCropParameters());
+		_currentCropGrowth->rebind(_soilColumn,
+		                           _cropPs,
+		                           [this](string event){ this->addEvent(event); },
+		                           [this](std::map<int, double> layer2amount, double nconc)
+		{
+			this->_soilOrganic.addOrganicMatter(this->_currentCrop->residueParameters(), layer2amount, nconc);
+		});
+
+		_soilTransport.put_Crop(_currentCropGrowth);
+		_soilColumn.put_Crop(_currentCropGrowth);
+		_soilMoisture.put_Crop(_currentCropGrowth);
+		_soilOrganic.put_Crop(_currentCropGrowth);
+	}
+}
+
 
 /**
  * @brief Simulation of crop seed.
@@ -102,8 +171,9 @@ MonicaModel::MonicaModel(const CentralParameterProvider& cpp)
 void MonicaModel::seedCrop(CropPtr crop)
 {
   debug() << "seedCrop" << endl;
-  delete _currentCropGrowth;
-	_currentCropGrowth = NULL;
+	if(_currentCropGrowth)
+		_spareCropGrowth.reset(_currentCropGrowth);
+	_currentCropGrowth = nullptr;
 	
 	p_daysWithCrop = 0;
   p_accuNStress = 0.0;
@@ -116,19 +186,32 @@ void MonicaModel::seedCrop(CropPtr crop)
 		_currentCrop = crop;
 		_cultivationMethodCount++;
 
-		auto addOMFunc = [this](std::map<int, double> layer2amount, double nconc)
-		{
-			this->_soilOrganic.addOrganicMatter(this->_currentCrop->residueParameters(), layer2amount, nconc); 
-		};
     auto cps = _currentCrop->cropParameters();
-    _currentCropGrowth = new CropGrowth(_soilColumn,
-                                        *cps,
-                                        _sitePs,
-                                        _cropPs,
-                                        _simPs,
-																				[this](string event){ this->addEvent(event); },
-																				addOMFunc,
-                                        crop->getEva2TypeUsage());
+		auto& initial = _initialCropGrowths[make_pair(cps.get(), crop->getEva2TypeUsage())];
+		if(!initial)
+		{
+			auto addOMFunc = [this](std::map<int, double> layer2amount, double nconc)
+			{
+				this->_soilOrganic.addOrganicMatter(this->_currentCrop->residueParameters(), layer2amount, nconc); 
+			};
+			initial.reset(new CropGrowth(_soilColumn,
+			                             cps,
+			                             _sitePs,
+			                             _cropPs,
+			                             _simPs,
+			                             [this](string event){ this->addEvent(event); },
+			                             addOMFunc,
+			                             crop->getEva2TypeUsage()));
+		}
+
+		//copying into the object of a removed crop reuses the storage of its vectors
+		if(_spareCropGrowth)
+		{
+			*_spareCropGrowth = *initial;
+			_currentCropGrowth = _spareCropGrowth.release();
+		}
+		else
+			_currentCropGrowth = new CropGrowth(*initial);
 
     if (_currentCrop->perennialCropParameters())
       _currentCropGrowth->setPerennialCropParameters(_currentCrop->perennialCropParameters());
@@ -521,18 +604,23 @@ void MonicaModel::dailyReset()
 
 	if(_clearCropUponNextDay)
 	{
-		delete _currentCropGrowth;
-		_currentCropGrowth = nullptr;
-		_currentCrop.reset();
-		_soilTransport.remove_Crop();
-		_soilColumn.remove_Crop();
-		_soilMoisture.remove_Crop();
-		_soilOrganic.remove_Crop();
-
+		removeCurrentCrop();
 		_clearCropUponNextDay = false;
 	}
 }
 
+void MonicaModel::removeCurrentCrop()
+{
+	if(_currentCropGrowth)
+		_spareCropGrowth.reset(_currentCropGrowth);
+	_currentCropGrowth = nullptr;
+	_currentCrop.reset();
+	_soilTransport.remove_Crop();
+	_soilColumn.remove_Crop();
+	_soilMoisture.remove_Crop();
+	_soilOrganic.remove_Crop();
+}
+
 void MonicaModel::applyIrrigation(double amount, double nitrateConcentration,
                                   double /*sulfateConcentration*/)
 {
@@ -563,11 +651,43 @@ void MonicaModel::step()
 	generalStep();
 }
 
+/**
+ * @brief Steps all models one time step.
+ *
+ * Every model is stepped as by MonicaModel::step, only the soil temperature
+ * equations of all models are solved together, across the models.
+ * The models don't share any state, so the results are the same.
+ */
+void MonicaModel::stepWithBatchedSoilTemperature(const vector<MonicaModel*>& models, SoilTemperatureBatch& soilTemperatures)
+{
+	assert(soilTemperatures.soilTemperatures().size() == models.size());
+
+	for(auto m : models)
+	{
+		if(m->isCropPlanted() && !m->_clearCropUponNextDay)
+			m->cropStep();
+
+		m->generalStepUntilSoilTemperature();
+	}
+
+	soilTemperatures.solve();
+
+	for(auto m : models)
+		m->generalStepFromSoilTemperature();
+}
+
 /**
  * @brief Simulating the soil processes for one time step.
  * @param stepNo Number of current processed step
  */
 void MonicaModel::generalStep()
+{
+	generalStepUntilSoilTemperature();
+	_soilTemperature.solveStep();
+	generalStepFromSoilTemperature();
+}
+
+void MonicaModel::generalStepUntilSoilTemperature()
 {
 	auto date = _currentStepDate;
 	unsigned int julday = date.julianDay();
@@ -575,17 +695,8 @@ void MonicaModel::generalStep()
 
 	auto climateData = currentStepClimateData();
 	double tmin = climateData[Climate::tmin];
-	double tavg = climateData[Climate::tavg];
 	double tmax = climateData[Climate::tmax];
-	double precip = climateData[Climate::precip];
-	double wind = climateData[Climate::wind];
 	double globrad = climateData[Climate::globrad];	
-	
-	// test if data for relhumid are available; if not, value is set to -1.0
-	double relhumid = climateData.find(Climate::relhumid) == climateData.end()
-		? -1.0
-		: climateData[Climate::relhumid];
-
 
   // test if simulated gw or measured values should be used
   double gw_value = _groundwaterInformation.getGroundwaterInformation(date);
@@ -644,7 +755,26 @@ void MonicaModel::generalStep()
     addDailySumFertiliser(fertilizerAmount);
 	}
 
-  _soilTemperature.step(tmin, tmax, globrad);
+  _soilTemperature.prepareStep(tmin, tmax, globrad);
+}
+
+void MonicaModel::generalStepFromSoilTemperature()
+{
+  _soilTemperature.finishStep();
+
+  unsigned int julday = _currentStepDate.julianDay();
+  auto climateData = currentStepClimateData();
+  double tmin = climateData[Climate::tmin];
+  double tavg = climateData[Climate::tavg];
+  double tmax = climateData[Climate::tmax];
+  double precip = climateData[Climate::precip];
+  double wind = climateData[Climate::wind];
+  double globrad = climateData[Climate::globrad];
+
+  // test if data for relhumid are available; if not, value is set to -1.0
+  double relhumid = climateData.find(Climate::relhumid) == climateData.end()
+    ? -1.0
+    : climateData[Climate::relhumid];
 
   // first try to get ReferenceEvapotranspiration from climate data
   auto et0_it = climateData.find(Climate::et0);
@@ -1153,4 +1283,218 @@ void MonicaModel::clearEvents()
 { 
 	_previousDaysEvents = _currentEvents;
 	_currentEvents.clear(); 
-}
\ No newline at end of file
+}
+
+//------------------------------------------------------------------------------
+
+bool MonicaModel::serialize(std::ostream& out) const
+{
+	using namespace StateIO;
+
+	out.write(stateMagic, sizeof(stateMagic));
+	write(out, stateVersion);
+	write(out, uint32_t(sizeof(AOM_Properties)));
+	writeState(out);
+
+	write(out, _clearCropUponNextDay);
+	write(out, bool(_currentCrop));
+	if(_currentCrop)
+		_currentCrop->serialize(out);
+	write(out, _currentCropGrowth != nullptr);
+	if(_currentCropGrowth)
+		_currentCropGrowth->serialize(out);
+
+	return bool(out);
+}
+
+void MonicaModel::writeState(std::ostream& out) const
+{
+	using namespace StateIO;
+
+	write(out, _simPs.startDate);
+	write(out, _simPs.endDate);
+	write(out, _currentStepDate);
+
+	_soilColumn.serialize(out);
+	_soilTemperature.serialize(out);
+	_soilMoisture.serialize(out);
+	_soilOrganic.serialize(out);
+	_soilTransport.serialize(out);
+
+	write(out, _rad24);
+	write(out, _rad240);
+	write(out, _tfol24);
+	write(out, _tfol240);
+	write(out, _index24);
+	write(out, _index240);
+	write(out, _full24);
+	write(out, _full240);
+
+	write(out, _sumFertiliser);
+	write(out, _sumOrgFertiliser);
+	write(out, _dailySumFertiliser);
+	write(out, _dailySumOrgFertiliser);
+	write(out, _dailySumOrganicFertilizerDM);
+	write(out, _sumOrganicFertilizerDM);
+	write(out, _humusBalanceCarryOver);
+	write(out, _dailySumIrrigationWater);
+	write(out, _optCarbonExportedResidues);
+	write(out, _optCarbonReturnedResidues);
+
+	write(out, _climateData);
+	write(out, _currentEvents);
+	write(out, _previousDaysEvents);
+
+	write(out, p_daysWithCrop);
+	write(out, p_accuNStress);
+	write(out, p_accuWaterStress);
+	write(out, p_accuHeatStress);
+	write(out, p_accuOxygenStress);
+
+	write(out, vw_AtmosphericCO2Concentration);
+	write(out, vw_AtmosphericO3Concentration);
+	write(out, vs_GroundwaterDepth);
+	write(out, _cultivationMethodCount);
+}
+
+bool MonicaModel::deserialize(std::istream& in)
+{
+	using namespace StateIO;
+
+	char magic[sizeof(stateMagic)];
+	in.read(magic, sizeof(magic));
+	if(!in || !equal(begin(magic), end(magic), begin(stateMagic)))
+	{
+		cerr << "Error: Input is not a MONICA model state!" << endl;
+		return false;
+	}
+
+	uint32_t version = 0, aomSize = 0;
+	read(in, version);
+	read(in, aomSize);
+	if(version != stateVersion)
+	{
+		cerr << "Error: MONICA model state has version " << version 
+			<< ", but only version " << stateVersion << " (of this build) can be read!" << endl;
+		return false;
+	}
+	if(aomSize != sizeof(AOM_Properties))
+	{
+		cerr << "Error: MONICA model state has been written by a build with a different AOM pool layout ("
+			<< aomSize << " instead of " << sizeof(AOM_Properties) << " bytes per pool)!" << endl;
+		return false;
+	}
+
+	if(!readState(in))
+		return false;
+
+	removeCurrentCrop();
+	read(in, _clearCropUponNextDay);
+	bool hasCrop = false, hasCropGrowth = false;
+	read(in, hasCrop);
+	if(hasCrop)
+	{
+		_currentCrop = make_shared<Crop>();
+		if(!_currentCrop->deserialize(in))
+		{
+			cerr << "Error: Couldn't read the crop of the MONICA model state!" << endl;
+			return false;
+		}
+	}
+	read(in, hasCropGrowth);
+	if(hasCropGrowth)
+	{
+		if(!_currentCrop || !_currentCrop->isValid())
+		{
+			cerr << "Error: MONICA model state contains a crop's growth, but no valid crop!" << endl;
+			return false;
+		}
+
+		//construct the crop's growth as seedCrop does, bound to this model, and overwrite its state
+		auto addOMFunc = [this](std::map<int, double> layer2amount, double nconc)
+		{
+			this->_soilOrganic.addOrganicMatter(this->_currentCrop->residueParameters(), layer2amount, nconc);
+		};
+		unique_ptr<CropGrowth> cg(new CropGrowth(_soilColumn,
+		                                         _currentCrop->cropParameters(),
+		                                         _sitePs,
+		                                         _cropPs,
+		                                         _simPs,
+		                                         [this](string event){ this->addEvent(event); },
+		                                         addOMFunc,
+		                                         _currentCrop->getEva2TypeUsage()));
+		if(!cg->deserialize(in))
+		{
+			cerr << "Error: MONICA model state is truncated!" << endl;
+			return false;
+		}
+		if(_currentCrop->perennialCropParameters())
+			cg->setPerennialCropParameters(_currentCrop->perennialCropParameters());
+
+		_currentCropGrowth = cg.release();
+		_soilTransport.put_Crop(_currentCropGrowth);
+		_soilColumn.put_Crop(_currentCropGrowth);
+		_soilMoisture.put_Crop(_currentCropGrowth);
+		_soilOrganic.put_Crop(_currentCropGrowth);
+	}
+
+	if(!in)
+	{
+		cerr << "Error: MONICA model state is truncated!" << endl;
+		return false;
+	}
+	return true;
+}
+
+bool MonicaModel::readState(std::istream& in)
+{
+	using namespace StateIO;
+
+	read(in, _simPs.startDate);
+	read(in, _simPs.endDate);
+	read(in, _currentStepDate);
+
+	if(!_soilColumn.deserialize(in))
+		return false;
+	_soilTemperature.deserialize(in);
+	_soilMoisture.deserialize(in);
+	_soilOrganic.deserialize(in);
+	_soilTransport.deserialize(in);
+
+	read(in, _rad24);
+	read(in, _rad240);
+	read(in, _tfol24);
+	read(in, _tfol240);
+	read(in, _index24);
+	read(in, _index240);
+	read(in, _full24);
+	read(in, _full240);
+
+	read(in, _sumFertiliser);
+	read(in, _sumOrgFertiliser);
+	read(in, _dailySumFertiliser);
+	read(in, _dailySumOrgFertiliser);
+	read(in, _dailySumOrganicFertilizerDM);
+	read(in, _sumOrganicFertilizerDM);
+	read(in, _humusBalanceCarryOver);
+	read(in, _dailySumIrrigationWater);
+	read(in, _optCarbonExportedResidues);
+	read(in, _optCarbonReturnedResidues);
+
+	read(in, _climateData);
+	read(in, _currentEvents);
+	read(in, _previousDaysEvents);
+
+	read(in, p_daysWithCrop);
+	read(in, p_accuNStress);
+	read(in, p_accuWaterStress);
+	read(in, p_accuHeatStress);
+	read(in, p_accuOxygenStress);
+
+	read(in, vw_AtmosphericCO2Concentration);
+	read(in, vw_AtmosphericO3Concentration);
+	read(in, vs_GroundwaterDepth);
+	read(in, _cultivationMethodCount);
+
+	return bool(in);
+}
@@ -63,9 +63,18 @@ namespace Monica
 	public:
 		MonicaModel(const CentralParameterProvider& cpp);
 
+		//! fork a running model, e.g. to branch into different scenarios from a common state
+		MonicaModel(const MonicaModel& other);
+
+		MonicaModel& operator=(const MonicaModel&) = delete;
+
 		~MonicaModel();
 
 		void step();
+
+		//! step several models one after the other, but solve the soil temperatures of all models
+		//! together in between, soilTemperatures has to hold the models' soil temperatures
+		static void stepWithBatchedSoilTemperature(const std::vector<MonicaModel*>& models, SoilTemperatureBatch& soilTemperatures);
 		
 		void generalStep();
 		
@@ -274,7 +283,31 @@ namespace Monica
 		double optCarbonReturnedResidues() const { return _optCarbonReturnedResidues; }
 		double humusBalanceCarryOver() const { return _humusBalanceCarryOver; }
 
+		/**
+		 * Writes the dynamic state of the model to a versioned binary checkpoint.
+		 *
+		 * The checkpoint contains the soil modules (incl. postponed fertiliser
+		 * applications), the climate history, events and the fertiliser, irrigation
+		 * and stress accumulators and the current crop with its growth state. The
+		 * position in the crop rotation and the state of the worksteps belong to
+		 * the caller (see run-monica.cpp), which writes them after the model.
+		 */
+		bool serialize(std::ostream& out) const;
+
+		//! restore a checkpoint written by serialize into a model created with the same parameters
+		bool deserialize(std::istream& in);
+
 	private:
+		void writeState(std::ostream& out) const;
+		bool readState(std::istream& in);
+
+		//! the parts of generalStep before and after solving the soil temperature
+		void generalStepUntilSoilTemperature();
+		void generalStepFromSoilTemperature();
+
+		//! detach the current crop from the model, its CropGrowth object is kept for the next sowing
+		void removeCurrentCrop();
+
 		const SiteParameters _sitePs;
 		const UserSoilMoistureParameters _smPs;
 		const UserEnvironmentParameters _envPs;
@@ -294,6 +327,13 @@ namespace Monica
 		CropPtr _currentCrop; //! currently possibly planted crop
 		CropGrowth* _currentCropGrowth{nullptr}; //!< crop code for possibly planted crop
 
+		//! state of a crop right after sowing by crop parameters and EVA2 usage, built at the
+		//! first sowing of the crop, crops sown repeatedly (e.g. in a crop rotation) are just
+		//! copied from here, the copies share the crop parameters, which also keeps the key alive
+		std::map<std::pair<const CropParameters*, int>, std::unique_ptr<const CropGrowth>> _initialCropGrowths;
+		//! CropGrowth object of the last removed crop, reused at the next sowing
+		std::unique_ptr<CropGrowth> _spareCropGrowth;
+
 		//VOC members
 		const int _stepSize24{1}, _stepSize240{10};
 		std::vector<double> _rad24, _rad240, _tfol24, _tfol240;
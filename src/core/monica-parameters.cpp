@@ -31,6 +31,7 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 #include "tools/debug.h"
 #include "soil/conversion.h"
 #include "soil/soil.h"
+#include "soil-profile-cache.h"
 
 using namespace Db;
 using namespace std;
@@ -648,7 +649,8 @@ Errors SiteParameters::merge(json11::Json j)
 
 	if(j.has_shape({{"SoilProfileParameters", json11::Json::ARRAY}}, err))
 	{
-		auto p = createSoilPMs(j["SoilProfileParameters"].array_items());
+		//the pedotransfer functions run once per distinct profile
+		auto p = soilProfileFromJson(j["SoilProfileParameters"].array_items());
 		vs_SoilParameters = p.first;
 		if(p.second.failure())
 			res.append(p.second);
@@ -943,6 +945,8 @@ Errors UserCropParameters::merge(json11::Json j)
 	set_bool_value(__enable_Photosynthesis_WangEngelTemperatureResponse__, j, "__enable_Photosynthesis_WangEngelTemperatureResponse__");
 	set_bool_value(__enable_Phenology_WangEngelTemperatureResponse__, j, "__enable_Phenology_WangEngelTemperatureResponse__");
 	set_bool_value(__enable_hourly_FvCB_photosynthesis__, j, "__enable_hourly_FvCB_photosynthesis__");
+	set_bool_value(__approximate_FvCB_temperature_responses__, j, "__approximate_FvCB_temperature_responses__");
+	set_double_value(pc_FvCBTemperatureResponseTolerance, j, "FvCBTemperatureResponseTolerance");
 	set_bool_value(__enable_T_response_leaf_expansion__, j, "__enable_T_response_leaf_expansion__");
 	set_bool_value(__disable_daily_root_biomass_to_soil__, j, "__disable_daily_root_biomass_to_soil__");
 	
@@ -972,6 +976,8 @@ json11::Json UserCropParameters::to_json() const
 	,{"__enable_Phenology_WangEngelTemperatureResponse__", __enable_Phenology_WangEngelTemperatureResponse__}
 	,{"__enable_Photosynthesis_WangEngelTemperatureResponse__", __enable_Photosynthesis_WangEngelTemperatureResponse__}
 	,{"__enable_hourly_FvCB_photosynthesis__", __enable_hourly_FvCB_photosynthesis__}
+	,{"__approximate_FvCB_temperature_responses__", __approximate_FvCB_temperature_responses__}
+	,{"FvCBTemperatureResponseTolerance", pc_FvCBTemperatureResponseTolerance}
 	,{"__enable_T_response_leaf_expansion__", __enable_T_response_leaf_expansion__}
 	,{"__disable_daily_root_biomass_to_soil__", __disable_daily_root_biomass_to_soil__}
   };
@@ -1041,6 +1047,40 @@ json11::Json UserEnvironmentParameters::to_json() const
 
 //-----------------------------------------------------------------------------------------
 
+CapillaryRiseRateTable::CapillaryRiseRateTable(std::function<double(std::string, int)> getRate,
+                                               int maxDistance)
+	: _getRate(getRate)
+	, _maxDistance(maxDistance)
+{}
+
+const vector<double>& CapillaryRiseRateTable::rates(const string& texture) const
+{
+	lock_guard<mutex> lock(_mutex);
+
+	// std::map doesn't move its elements, so returned rows stay valid while others are added
+	auto it = _texture2rates.find(texture);
+	if(it == _texture2rates.end())
+	{
+		vector<double> rs(_maxDistance + 1, 0.0);
+		for(int d = 0; d <= _maxDistance; d++)
+			rs[d] = _getRate(texture, d);
+		it = _texture2rates.emplace(texture, move(rs)).first;
+	}
+	return it->second;
+}
+
+shared_ptr<const CapillaryRiseRateTable> Monica::sharedCapillaryRiseRateTable()
+{
+	static shared_ptr<const CapillaryRiseRateTable> table =
+		make_shared<CapillaryRiseRateTable>([](string soilTexture, int distance)
+	{
+		return Soil::readCapillaryRiseRates().getRate(soilTexture, distance);
+	});
+	return table;
+}
+
+//-----------------------------------------------------------------------------------------
+
 UserSoilMoistureParameters::UserSoilMoistureParameters()
 {
 	getCapillaryRiseRate = [](string soilTexture, int distance) { return 0; };
@@ -1179,6 +1219,14 @@ Errors UserSoilTransportParameters::merge(json11::Json j)
   set_double_value(pq_AD, j, "AD");
   set_double_value(pq_DiffusionCoefficientStandard, j, "DiffusionCoefficientStandard");
   set_double_value(pq_NDeposition, j, "NDeposition");
+  string scheme = pq_NTransportScheme;
+  set_string_value(scheme, j, "NTransportScheme");
+  if(scheme == "explicit" || scheme == "implicit" || scheme == "crank-nicolson")
+    pq_NTransportScheme = scheme;
+  else
+    res.errors.push_back(string("Unknown NTransportScheme '") + scheme
+                         + "', expected 'explicit', 'implicit' or 'crank-nicolson'!");
+  set_bool_value(pq_ValidateNTransportScheme, j, "ValidateNTransportScheme");
 
 	return res;
 }
@@ -1191,6 +1239,8 @@ json11::Json UserSoilTransportParameters::to_json() const
   ,{"AD", pq_AD}
   ,{"DiffusionCoefficientStandard", pq_DiffusionCoefficientStandard}
   ,{"NDeposition", pq_NDeposition}
+  ,{"NTransportScheme", pq_NTransportScheme}
+  ,{"ValidateNTransportScheme", pq_ValidateNTransportScheme}
   };
 }
 
@@ -1338,6 +1388,11 @@ Errors UserSoilOrganicParameters::merge(json11::Json j)
   set_double_value(po_N2OProductionRate, j, "N2OProductionRate");
   set_double_value(po_Inhibitor_NH3, j, "Inhibitor_NH3");
   set_double_value(ps_MaxMineralisationDepth, j, "MaxMineralisationDepth");
+  set_bool_value(po_AOM_CoalescePools, j, "AOM_CoalescePools");
+  set_int_value(po_AOM_MaxPools, j, "AOM_MaxPools");
+  set_int_value(po_AOM_CoalesceMinDaysAfterApplication, j, "AOM_CoalesceMinDaysAfterApplication");
+  set_bool_value(po_ApproximateResponseFunctions, j, "ApproximateResponseFunctions");
+  set_double_value(po_ResponseFunctionTolerance, j, "ResponseFunctionTolerance");
 
   if (j["stics"].is_object()) res.append(sticsParams.merge(j["stics"]));
 
@@ -1384,6 +1439,11 @@ json11::Json UserSoilOrganicParameters::to_json() const
   ,{"N2OProductionRate", J11Array {po_N2OProductionRate, "d-1"}}
   ,{"Inhibitor_NH3", J11Array {po_Inhibitor_NH3, "kg N m-3"}}
   ,{"MaxMineralisationDepth", ps_MaxMineralisationDepth}
+  ,{"AOM_CoalescePools", po_AOM_CoalescePools}
+  ,{"AOM_MaxPools", po_AOM_MaxPools}
+  ,{"AOM_CoalesceMinDaysAfterApplication", J11Array {po_AOM_CoalesceMinDaysAfterApplication, "d"}}
+  ,{"ApproximateResponseFunctions", po_ApproximateResponseFunctions}
+  ,{"ResponseFunctionTolerance", po_ResponseFunctionTolerance}
   };
 }
 
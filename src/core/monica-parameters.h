@@ -28,6 +28,7 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 #include <iostream>
 #include <memory>
 #include <functional>
+#include <mutex>
 #include <assert.h>
 
 #include "json11/json11.hpp"
@@ -635,6 +636,8 @@ namespace Monica
 		bool __enable_Phenology_WangEngelTemperatureResponse__{ false };
 		bool __enable_Photosynthesis_WangEngelTemperatureResponse__{ false };
 		bool __enable_hourly_FvCB_photosynthesis__{ false };
+		bool __approximate_FvCB_temperature_responses__{ false }; // tabulated leaf temperature responses in the hourly FvCB model, false = exact functions
+		double pc_FvCBTemperatureResponseTolerance{ 1.0e-4 }; // max relative error of the tabulated FvCB temperature responses
 		bool __enable_T_response_leaf_expansion__{ false };
 		bool __disable_daily_root_biomass_to_soil__{false};
 	};
@@ -670,6 +673,34 @@ namespace Monica
 
 	};
 
+	//----------------------------------------------------------------------------
+
+	/**
+	 * Capillary rise rates [m d-1] by soil texture and groundwater distance [layers].
+	 * A texture is resolved once to its row of rates over all distances, so the daily
+	 * lookup is a plain array access. Rows are added on first use of a texture (thread safe)
+	 * and stay valid as long as the table exists, so one table can be shared by all models.
+	 */
+	class DLL_API CapillaryRiseRateTable
+	{
+	public:
+		CapillaryRiseRateTable(std::function<double(std::string, int)> getRate, int maxDistance = 100);
+
+		//! the rates of the given texture, indexed by the distance [0, maxDistance()]
+		const std::vector<double>& rates(const std::string& texture) const;
+
+		int maxDistance() const { return _maxDistance; }
+
+	private:
+		std::function<double(std::string, int)> _getRate;
+		int _maxDistance{0};
+		mutable std::mutex _mutex;
+		mutable std::map<std::string, std::vector<double>> _texture2rates;
+	};
+
+	//! process wide table of the capillary rise rates given by Soil::readCapillaryRiseRates
+	DLL_API std::shared_ptr<const CapillaryRiseRateTable> sharedCapillaryRiseRateTable();
+
 	//----------------------------------------------------------------------------
 
 	  /**
@@ -687,6 +718,8 @@ namespace Monica
 		virtual json11::Json to_json() const;
 
 		std::function<double(std::string, int)> getCapillaryRiseRate;
+		//! if set, used instead of getCapillaryRiseRate, else a table is created from getCapillaryRiseRate
+		std::shared_ptr<const CapillaryRiseRateTable> capillaryRiseRates;
 
 		double pm_CriticalMoistureDepth{ 0.0 };
 		double pm_SaturatedHydraulicConductivity{ 0.0 };
@@ -765,6 +798,12 @@ namespace Monica
 		double pq_AD{ 0.0 };
 		double pq_DiffusionCoefficientStandard{ 0.0 };
 		double pq_NDeposition{ 0.0 };
+
+		//! "explicit" (sub-stepped on high water fluxes), "implicit" or "crank-nicolson"
+		std::string pq_NTransportScheme{ "explicit" };
+		//! also run a reference scheme and report the deviation of the chosen scheme from it,
+		//! the reference is the explicit scheme, for the explicit scheme itself the implicit one
+		bool pq_ValidateNTransportScheme{ false };
 	};
 
 	//----------------------------------------------------------------------------
@@ -871,6 +910,11 @@ namespace Monica
 		double po_N2OProductionRate{ 0.5 }; // 0.5 [d-1]
 		double po_Inhibitor_NH3{ 1.0 }; // 1.0 [kg N m-3] NH3-induced inhibitor for nitrite oxidation
 		double ps_MaxMineralisationDepth{ 0.4 };
+		bool po_AOM_CoalescePools{ false }; // merge AOM pools with the same decomposition parameters
+		int po_AOM_MaxPools{ 0 }; // merge the most similar AOM pools above this number of pools, 0 = unlimited
+		int po_AOM_CoalesceMinDaysAfterApplication{ 30 }; // [d] younger, still volatilising, pools aren't merged
+		bool po_ApproximateResponseFunctions{ false }; // tabulated temperature and closed form moisture (pF) responses, false = reference functions
+		double po_ResponseFunctionTolerance{ 1.0e-4 }; // max relative error of the tabulated responses
 
     SticsParameters sticsParams;
 	};
@@ -18,6 +18,8 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 #define _USE_MATH_DEFINES
 #include <math.h>
 #include <iostream>
+#include <algorithm>
+#include <mutex>
 
 #include  "photosynthesis-FvCB.h"
 #include "tools/helper.h"
@@ -227,12 +229,21 @@ double FvCB::Jmax_bernacchi_f(double leafT, double Jmax_25)
 	return Jmax_25 * Tresp_bernacchi_f(c_bernacchi[Jmax], deltaH_bernacchi[Jmax], leafT);
 }
 
-double J_bernacchi_f(double Q, double leafT, double Jmax)
+double theta_ps2_f(double leafT)
+{
+	return 0.76 + 0.018 * leafT - 3.7 * pow(10, -4) * pow(leafT, 2);
+}
+
+double phi_ps2max_f(double leafT)
+{
+	return 0.352 + 0.022 *leafT - 3.4 * pow(10, -4) * pow(leafT, 2);
+}
+
+//J_bernacchi_f with the temperature dependent terms already calculated
+double J_f(double Q, double theta_ps2, double phi_ps2max, double Jmax)
 {
 	double alfa = 0.85; //total leaf absorbance 
 	double beta = 0.5; //fraction of absorbed quanta reaching PSII
-	double theta_ps2 = 0.76 + 0.018 * leafT - 3.7 * pow(10, -4) * pow(leafT, 2);
-	double phi_ps2max = 0.352 + 0.022 *leafT - 3.4 * pow(10, -4) * pow(leafT, 2);
 	double Q2 = Q * alfa * phi_ps2max * beta;
 
 	double numerator = Q2 + Jmax - sqrt(pow((Q2 + Jmax), 2) - 4 * theta_ps2 * Q2 * Jmax);
@@ -240,6 +251,11 @@ double J_bernacchi_f(double Q, double leafT, double Jmax)
 	return numerator / denominator;
 }
 
+double J_bernacchi_f(double Q, double leafT, double Jmax)
+{
+	return J_f(Q, theta_ps2_f(leafT), phi_ps2max_f(leafT), Jmax);
+}
+
 double J_grote_f(double Q, double Jmax)
 {
 	double species_THETA = 0.85; //!< curvature parameter
@@ -277,13 +293,59 @@ double Oi_f(double leafT)
 	return 210 * (4.7 * pow(10, -2) - T1 + T2 - T3) / (2.6934 * pow(10, -2));
 }
 
-double Gamma_bernacchi_f(double leafT, double Vcmax, double Vomax)
+//Gamma_bernacchi_f with the temperature dependent terms already calculated
+double Gamma_f(double Vcmax, double Vomax, double Kc, double Ko, double Oi)
 {
-	double numerator = 0.5 * Vomax * Kc_bernacchi_f(leafT) * Oi_f(leafT);
-	double denominator = Vcmax * Ko_bernacchi_f(leafT);
+	double numerator = 0.5 * Vomax * Kc * Oi;
+	double denominator = Vcmax * Ko;
 	return flt_equal_zero(denominator) ? 0.0 : numerator / denominator;
 }
 
+double Gamma_bernacchi_f(double leafT, double Vcmax, double Vomax)
+{
+	return Gamma_f(Vcmax, Vomax, Kc_bernacchi_f(leafT), Ko_bernacchi_f(leafT), Oi_f(leafT));
+}
+
+FvCB_temperature_responses::FvCB_temperature_responses(double maxError, double minLeafT, double maxLeafT)
+	: _Vcmax(tabulate(FvCB::Vcmax, maxError, minLeafT, maxLeafT))
+	, _Vomax(tabulate(FvCB::Vomax, maxError, minLeafT, maxLeafT))
+	, _Jmax(tabulate(FvCB::Jmax, maxError, minLeafT, maxLeafT))
+	, _Rd(tabulate(FvCB::Rd, maxError, minLeafT, maxLeafT))
+	, _Kc(tabulate(FvCB::Kc, maxError, minLeafT, maxLeafT))
+	, _Ko(tabulate(FvCB::Ko, maxError, minLeafT, maxLeafT))
+{
+	for (const auto* st : { &_Vcmax, &_Vomax, &_Jmax, &_Rd, &_Kc, &_Ko })
+		_maxError = std::max(_maxError, st->table.maxError());
+}
+
+FvCB_temperature_responses::ScaledTable
+FvCB_temperature_responses::tabulate(FvCB_Model_Consts response, double maxError, double minLeafT, double maxLeafT)
+{
+	double c = c_bernacchi[response];
+	double deltaH = deltaH_bernacchi[response];
+
+	//the responses increase with temperature, so the scaled values are >= 1
+	//and the error bound of the table is a relative one
+	ScaledTable st;
+	st.scale = Tresp_bernacchi_f(c, deltaH, minLeafT);
+	double scale = st.scale;
+	st.table = Monica::InterpolationTable([=](double leafT) { return Tresp_bernacchi_f(c, deltaH, leafT) / scale; },
+		minLeafT, maxLeafT, 1.0, maxError);
+	return st;
+}
+
+shared_ptr<const FvCB_temperature_responses> FvCB::FvCB_temperature_response_tables(double maxError)
+{
+	static mutex m;
+	static map<double, shared_ptr<const FvCB_temperature_responses>> tables;
+
+	lock_guard<mutex> lock(m);
+	auto& t = tables[maxError];
+	if (!t)
+		t = make_shared<const FvCB_temperature_responses>(maxError);
+	return t;
+}
+
 #pragma endregion FvCB model params
 
 #pragma region 
@@ -521,7 +583,78 @@ ostream& FvCB::tout(bool closeFile)
 
 #pragma region
 //Model composition (C3)
-FvCB_canopy_hourly_out FvCB::FvCB_canopy_hourly_C3(FvCB_canopy_hourly_in in, FvCB_canopy_hourly_params par)
+void FvCB::FvCB_canopy_day_C3(FvCB_canopy_day& day, int n, const FvCB_canopy_hourly_params& par,
+	const FvCB_temperature_responses* responses)
+{
+	day.kn = par.kn;
+	day.gb = par.gb;
+	day.g0 = par.g0;
+	day.cap_f = 1 - exp(-par.kn);
+	day.Tresp_Vcmax_25 = Tresp_bernacchi_f(c_bernacchi[Vcmax], deltaH_bernacchi[Vcmax], 25.0);
+
+	double c_Vcmax = c_bernacchi[Vcmax], deltaH_Vcmax = deltaH_bernacchi[Vcmax];
+	double c_Vomax = c_bernacchi[Vomax], deltaH_Vomax = deltaH_bernacchi[Vomax];
+	double c_Jmax = c_bernacchi[Jmax], deltaH_Jmax = deltaH_bernacchi[Jmax];
+	double c_Rd = c_bernacchi[Rd], deltaH_Rd = deltaH_bernacchi[Rd];
+	double c_Kc = c_bernacchi[Kc], deltaH_Kc = deltaH_bernacchi[Kc];
+	double c_Ko = c_bernacchi[Ko], deltaH_Ko = deltaH_bernacchi[Ko];
+
+	for (int h = 0; h < n; h++)
+	{
+		//1. calculate diffuse and direct radiation
+		double diffuse_fraction = diffuse_fraction_hourly_f(day.global_rad[h], day.extra_terr_rad[h], day.solar_el[h]);
+		double hourly_diffuse_rad = day.global_rad[h] * diffuse_fraction;
+		double hourly_direct_rad = day.global_rad[h] - hourly_diffuse_rad;
+		double inst_diff_rad = hourly_diffuse_rad * pow(10, 6) / 3600.0 * 4.56 * 0.45; //mol m - 2 s - 1 (unit ground area)
+		double inst_dir_rad = hourly_direct_rad * pow(10, 6) / 3600.0 * 4.56 * 0.45; //1 W m-2 = 4.56 mol m-2 s-1; PAR = 0.45 * global radiation 
+
+		//2. calculate Radiation absorbed by sunlit / shaded canopy
+		double Ic_sun = day.Ic_sun[h] = Ic_sun_f(inst_dir_rad, inst_diff_rad, day.solar_el[h], day.LAI[h]); //mol m - 2 s - 1 (unit ground area)
+		double Ic_sh = day.Ic_sh[h] = Ic_shade_f(inst_dir_rad, inst_diff_rad, day.solar_el[h], day.LAI[h]); //mol m - 2 s - 1 (unit ground area)
+
+		//2.1. calculate sunlit/shaded LAI
+		std::tuple<double, double> sun_shade_LAI = LAI_sunlit_shaded_f(day.LAI[h], day.solar_el[h]);
+		day.LAI_sun[h] = std::get<0>(sun_shade_LAI);
+		day.LAI_sh[h] = std::get<1>(sun_shade_LAI);
+
+		double hourly_globrad = day.global_rad[h] * pow(10, 6) / 3600.0; //W m - 2
+		day.rad_sun[h] = hourly_globrad > 0 ? hourly_globrad * Ic_sun / (Ic_sun + Ic_sh) : 0.0;
+		day.rad_sh[h] = hourly_globrad > 0 ? hourly_globrad * Ic_sh / (Ic_sun + Ic_sh) : 0.0;
+
+		//shape of the photosynthetic capacity of the sunlit fraction (see canopy_ps_capacity_sunlit_f)
+		double kb = day.solar_el[h] == 0 ? 1000 : 0.5 / sin(day.solar_el[h]);
+		day.cap_sun_num[h] = 1 - exp(-par.kn - kb*day.LAI[h]);
+		day.cap_sun_den[h] = par.kn + kb*day.LAI[h];
+
+		//temperature responses
+		double leafT = day.leaf_temp[h];
+		if (responses && responses->covers(leafT))
+		{
+			day.Tresp_Vcmax[h] = responses->Tresp_Vcmax(leafT);
+			day.Tresp_Vomax[h] = responses->Tresp_Vomax(leafT);
+			day.Tresp_Jmax[h] = responses->Tresp_Jmax(leafT);
+			day.Rd[h] = responses->Rd(leafT);
+			day.Kc[h] = responses->Kc(leafT);
+			day.Ko[h] = responses->Ko(leafT);
+		}
+		else
+		{
+			day.Tresp_Vcmax[h] = Tresp_bernacchi_f(c_Vcmax, deltaH_Vcmax, leafT);
+			day.Tresp_Vomax[h] = Tresp_bernacchi_f(c_Vomax, deltaH_Vomax, leafT);
+			day.Tresp_Jmax[h] = Tresp_bernacchi_f(c_Jmax, deltaH_Jmax, leafT);
+			day.Rd[h] = Tresp_bernacchi_f(c_Rd, deltaH_Rd, leafT);
+			day.Kc[h] = Tresp_bernacchi_f(c_Kc, deltaH_Kc, leafT);
+			day.Ko[h] = Tresp_bernacchi_f(c_Ko, deltaH_Ko, leafT);
+		}
+		day.Oi[h] = Oi_f(leafT);
+		day.x2_rub[h] = day.Kc[h] * (1 + day.Oi[h] / day.Ko[h]);
+		day.theta_ps2[h] = theta_ps2_f(leafT);
+		day.phi_ps2max[h] = phi_ps2max_f(leafT);
+		day.fVPD[h] = fVPD_f(day.VPD[h]);
+	}
+}
+
+FvCB_canopy_hourly_out FvCB::FvCB_canopy_hourly_C3(const FvCB_canopy_day& day, int h, double Vcmax_25_)
 {
 	FvCB_canopy_hourly_out out;
 	//0. initialize VOCE out
@@ -539,25 +672,17 @@ FvCB_canopy_hourly_out FvCB::FvCB_canopy_hourly_C3(FvCB_canopy_hourly_in in, FvC
 	out.sunlit.jv = 0.0;
 	out.shaded.jv = 0.0;
 
-	//1. calculate diffuse and direct radiation
-	double diffuse_fraction = diffuse_fraction_hourly_f(in.global_rad, in.extra_terr_rad, in.solar_el);	
-	double hourly_diffuse_rad = in.global_rad * diffuse_fraction;
-	double hourly_direct_rad = in.global_rad - hourly_diffuse_rad;
-	double inst_diff_rad = hourly_diffuse_rad * pow(10, 6) / 3600.0 * 4.56 * 0.45; //mol m - 2 s - 1 (unit ground area)
-	double inst_dir_rad = hourly_direct_rad * pow(10, 6) / 3600.0 * 4.56 * 0.45; //1 W m-2 = 4.56 mol m-2 s-1; PAR = 0.45 * global radiation 
-	
-	//2. calculate Radiation absorbed by sunlit / shaded canopy
-	double Ic_sun = Ic_sun_f(inst_dir_rad, inst_diff_rad, in.solar_el, in.LAI); //mol m - 2 s - 1 (unit ground area)
-	double Ic_sh = Ic_shade_f(inst_dir_rad, inst_diff_rad, in.solar_el, in.LAI); //mol m - 2 s - 1 (unit ground area)
-
-	//2.1. calculate sunlit/shaded LAI
-	std::tuple<double, double> sun_shade_LAI = LAI_sunlit_shaded_f(in.LAI, in.solar_el);
-	out.sunlit.LAI = std::get<0>(sun_shade_LAI);
-	out.shaded.LAI = std::get<1>(sun_shade_LAI);
+	//1., 2. radiation absorbed by sunlit / shaded canopy and sunlit/shaded LAI
+	double LAI = day.LAI[h];
+	double solar_el = day.solar_el[h];
+	double Ic_sun = day.Ic_sun[h]; //mol m - 2 s - 1 (unit ground area)
+	double Ic_sh = day.Ic_sh[h];
+	out.sunlit.LAI = day.LAI_sun[h];
+	out.shaded.LAI = day.LAI_sh[h];
 
 #ifdef TEST_FVCB_HOURLY_OUTPUT
 	tout()
-		<< "," << in.leaf_temp
+		<< "," << day.leaf_temp[h]
 		<< "," << out.sunlit.LAI
 		<< "," << out.shaded.LAI
 		<< "," << Ic_sun
@@ -567,92 +692,83 @@ FvCB_canopy_hourly_out FvCB::FvCB_canopy_hourly_C3(FvCB_canopy_hourly_in in, FvC
 	//For each fraction :
 	//-------------------
 	//3. canopy photosynthetic capacity
-	double Vcmax = Vcmax_bernacchi_f(in.leaf_temp, par.Vcmax_25);
-	double Vcmax_25 = Vcmax_bernacchi_f(25.0, par.Vcmax_25); //the value at 25C calculated with bernacchi slightly deviates from par.Vcmax_25
+	double Vcmax = Vcmax_25_ * day.Tresp_Vcmax[h];
+	double Vcmax_25 = Vcmax_25_ * day.Tresp_Vcmax_25; //the value at 25C calculated with bernacchi slightly deviates from par.Vcmax_25
 
-	//test
-	//Vcmax = 100.0;
-		
-	double Vc_25 = canopy_ps_capacity_f(in.LAI, Vcmax_25, par.kn); //mol m - 2 s - 1 (unit ground area)
-	double Vc_sun_25 = canopy_ps_capacity_sunlit_f(in.LAI, in.solar_el, Vcmax_25, par.kn);
+	double Vc_25 = LAI * Vcmax_25 * day.cap_f / day.kn; //mol m - 2 s - 1 (unit ground area)
+	double Vc_sun_25 = solar_el < 0 ? 0 : LAI * Vcmax_25 * day.cap_sun_num[h] / day.cap_sun_den[h];
 	double Vc_sh_25 = Vc_25 - Vc_sun_25;
-	double Vc = canopy_ps_capacity_f(in.LAI, Vcmax, par.kn); 
-	double Vc_sun = canopy_ps_capacity_sunlit_f(in.LAI, in.solar_el, Vcmax, par.kn);
+	double Vc = LAI * Vcmax * day.cap_f / day.kn;
+	double Vc_sun = solar_el < 0 ? 0 : LAI * Vcmax * day.cap_sun_num[h] / day.cap_sun_den[h];
 	double Vc_sh = Vc - Vc_sun;
-	//cout << Vc << endl;
 
 	//4. canopy electron transport capacity
 	double Jmax_c_sun_25 = 1.6 * Vc_sun_25; // mol m - 2 s - 1 (unit ground area)
 	double Jmax_c_sh_25 = 1.6 * Vc_sh_25; 
 	
-	double Jmax_c_sun = Jmax_bernacchi_f(in.leaf_temp, Jmax_c_sun_25);
-	double Jmax_c_sh = Jmax_bernacchi_f(in.leaf_temp, Jmax_c_sh_25);
+	double Jmax_c_sun = Jmax_c_sun_25 * day.Tresp_Jmax[h];
+	double Jmax_c_sh = Jmax_c_sh_25 * day.Tresp_Jmax[h];
 	out.jmax_c = Jmax_c_sun + Jmax_c_sh;
 
-	double J_c_sun = J_bernacchi_f(Ic_sun, in.leaf_temp, Jmax_c_sun); //mol m - 2 s - 1 (unit ground area)
-	double J_c_sh = J_bernacchi_f(Ic_sh, in.leaf_temp, Jmax_c_sh);
-	//double J_c_sun = J_grote_f(Ic_sun, Jmax_c_sun); //mol m - 2 s - 1 (unit ground area)
-	//double J_c_sh = J_grote_f(Ic_sh, Jmax_c_sh);
+	double J_c_sun = J_f(Ic_sun, day.theta_ps2[h], day.phi_ps2max[h], Jmax_c_sun); //mol m - 2 s - 1 (unit ground area)
+	double J_c_sh = J_f(Ic_sh, day.theta_ps2[h], day.phi_ps2max[h], Jmax_c_sh);
 	
 	//5. canopy respiration
-	double Rd_sun = Rd_bernacchi_f(in.leaf_temp)* out.sunlit.LAI; //mol m - 2 s - 1 (unit ground area)
-	double Rd_sh = Rd_bernacchi_f(in.leaf_temp)* out.shaded.LAI;
+	double Rd_sun = day.Rd[h] * out.sunlit.LAI; //mol m - 2 s - 1 (unit ground area)
+	double Rd_sh = day.Rd[h] * out.shaded.LAI;
 
 	out.canopy_resp = (Rd_sun + Rd_sh) * 3600.0;
 	
 	//6. Coupled photosynthesis - stomatal conductance
 	//6.1. estimate inputs (for solving cubic equation)
 	//6.1.1 Gamma
-	double Vomax_sun = Vomax_bernacchi_f(in.leaf_temp, Vc_sun_25);
-	double Vomax_sh = Vomax_bernacchi_f(in.leaf_temp, Vc_sh_25);
-	double gamma_sun = Gamma_bernacchi_f(in.leaf_temp, Vc_sun, Vomax_sun);
-	double gamma_sh = Gamma_bernacchi_f(in.leaf_temp, Vc_sh, Vomax_sh);
+	double Vomax_sun = Vc_sun_25 * day.Tresp_Vomax[h];
+	double Vomax_sh = Vc_sh_25 * day.Tresp_Vomax[h];
+	double gamma_sun = Gamma_f(Vc_sun, Vomax_sun, day.Kc[h], day.Ko[h], day.Oi[h]);
+	double gamma_sh = Gamma_f(Vc_sh, Vomax_sh, day.Kc[h], day.Ko[h], day.Oi[h]);
 
 	//calculate some outputs to be used in VOCE modules
-	out.sunlit.kc = out.shaded.kc = Kc_bernacchi_f(in.leaf_temp);
-	out.sunlit.ko = out.shaded.ko = Ko_bernacchi_f(in.leaf_temp);
-	out.sunlit.oi = out.shaded.oi = Oi_f(in.leaf_temp);
+	out.sunlit.kc = out.shaded.kc = day.Kc[h];
+	out.sunlit.ko = out.shaded.ko = day.Ko[h];
+	out.sunlit.oi = out.shaded.oi = day.Oi[h];
 	out.sunlit.comp = gamma_sun; 
 	out.shaded.comp = gamma_sh;
-	//out.sunlit.rad = Ic_sun / 4.56 / 0.45 / 0.860; //W m - 2 (glob rad, 1 W m-2 = 4.56 mol m-2 s-1; PAR = 0.45 * global radiation, 0.860 = adsorberd fraction in JJV model)
-	//out.shaded.rad = Ic_sh / 4.56 / 0.45 / 0.860; //W m-2
-	double hourly_globrad = in.global_rad * pow(10, 6) / 3600.0; //W m - 2
-	out.sunlit.rad = hourly_globrad > 0 ? hourly_globrad * Ic_sun / (Ic_sun + Ic_sh): 0.0;
-	out.shaded.rad = hourly_globrad > 0 ? hourly_globrad * Ic_sh / (Ic_sun + Ic_sh) : 0.0;
+	out.sunlit.rad = day.rad_sun[h];
+	out.shaded.rad = day.rad_sh[h];
 
 	if (out.sunlit.LAI > 0)
 	{
-		out.sunlit.vcMax = Vc_sun / out.sunlit.LAI; //Vcmax;
-		out.sunlit.jMax = Jmax_c_sun / out.sunlit.LAI; //Jmax_bernacchi_f(in.leaf_temp, Vcmax_25*2.1);
+		out.sunlit.vcMax = Vc_sun / out.sunlit.LAI;
+		out.sunlit.jMax = Jmax_c_sun / out.sunlit.LAI;
 		out.sunlit.jj = J_c_sun / out.sunlit.LAI;
-		out.sunlit.jj1000 = J_bernacchi_f(1000, in.leaf_temp, out.sunlit.jMax);
+		out.sunlit.jj1000 = J_f(1000, day.theta_ps2[h], day.phi_ps2max[h], out.sunlit.jMax);
 	}	
 	if (out.shaded.LAI > 0)
 	{
-		out.shaded.vcMax = Vc_sh / out.shaded.LAI;//Vcmax;
-		out.shaded.jMax = Jmax_c_sh / out.shaded.LAI; //Jmax_bernacchi_f(in.leaf_temp, Vcmax_25*2.1);
+		out.shaded.vcMax = Vc_sh / out.shaded.LAI;
+		out.shaded.jMax = Jmax_c_sh / out.shaded.LAI;
 		out.shaded.jj = J_c_sh / out.shaded.LAI;
-		out.shaded.jj1000 = J_bernacchi_f(1000, in.leaf_temp, out.shaded.jMax);
+		out.shaded.jj1000 = J_f(1000, day.theta_ps2[h], day.phi_ps2max[h], out.shaded.jMax);
 	}
 	
 	//6.1.2 x1, x2 rubisco
-	std::tuple<double, double> x1_x2_rub_sun = x_rubisco(in.leaf_temp, Vc_sun);
-	std::tuple<double, double> x1_x2_rub_sh = x_rubisco(in.leaf_temp, Vc_sh);
+	std::tuple<double, double> x1_x2_rub_sun = std::make_tuple(Vc_sun, day.x2_rub[h]);
+	std::tuple<double, double> x1_x2_rub_sh = std::make_tuple(Vc_sh, day.x2_rub[h]);
 
 	//6.1.2 x1, x2 electron
 	std::tuple<double, double> x1_x2_el_sun = x_electron(J_c_sun, gamma_sun);
 	std::tuple<double, double> x1_x2_el_sh = x_electron(J_c_sh, gamma_sh);
 
 	// 6.1.3 g0, gm, gb
-	double gb_sun = par.gb * out.sunlit.LAI; //mol m-2 s-1 bar-1 per unit ground area
-	double gb_sh = par.gb * out.shaded.LAI;
-	double g0_sun = par.g0 * out.sunlit.LAI;
-	double g0_sh = par.g0 * out.shaded.LAI;
-	double gm_t = 0.4;// gm_bernacchi_f(in.leaf_temp, par.gm_25); //TODO: check correctness of gm_bernacchi_f
+	double gb_sun = day.gb * out.sunlit.LAI; //mol m-2 s-1 bar-1 per unit ground area
+	double gb_sh = day.gb * out.shaded.LAI;
+	double g0_sun = day.g0 * out.sunlit.LAI;
+	double g0_sh = day.g0 * out.shaded.LAI;
+	double gm_t = 0.4;// gm_bernacchi_f(day.leaf_temp[h], par.gm_25); //TODO: check correctness of gm_bernacchi_f
 	double gm_sun = gm_t * out.sunlit.LAI;
 	double gm_sh = gm_t * out.shaded.LAI;
 
-	if (in.global_rad <= 0.0)
+	if (day.global_rad[h] <= 0.0)
 	{
 		//handle cases where no photosynthesis can occur
 		out.canopy_gross_photos = 0.0;
@@ -663,14 +779,14 @@ FvCB_canopy_hourly_out FvCB::FvCB_canopy_hourly_C3(FvCB_canopy_hourly_in in, FvC
 	else
 	{
 		//6.1.4 fVPD
-		double fVPD = fVPD_f(in.VPD);
+		double fVPD = day.fVPD[h];
 
 		//6.2 calculate lumped coeffs (sun/shade)
-		Lumped_Coeffs lumped_rub_sun = calculate_lumped_coeffs(std::get<0>(x1_x2_rub_sun), std::get<1>(x1_x2_rub_sun), fVPD, in.Ca, gamma_sun, Rd_sun, g0_sun, gm_sun, gb_sun);
-		Lumped_Coeffs lumped_el_sun = calculate_lumped_coeffs(std::get<0>(x1_x2_el_sun), std::get<1>(x1_x2_el_sun), fVPD, in.Ca, gamma_sun, Rd_sun, g0_sun, gm_sun, gb_sun);
+		Lumped_Coeffs lumped_rub_sun = calculate_lumped_coeffs(std::get<0>(x1_x2_rub_sun), std::get<1>(x1_x2_rub_sun), fVPD, day.Ca[h], gamma_sun, Rd_sun, g0_sun, gm_sun, gb_sun);
+		Lumped_Coeffs lumped_el_sun = calculate_lumped_coeffs(std::get<0>(x1_x2_el_sun), std::get<1>(x1_x2_el_sun), fVPD, day.Ca[h], gamma_sun, Rd_sun, g0_sun, gm_sun, gb_sun);
 
-		Lumped_Coeffs lumped_rub_sh = calculate_lumped_coeffs(std::get<0>(x1_x2_rub_sh), std::get<1>(x1_x2_rub_sh), fVPD, in.Ca, gamma_sh, Rd_sh, g0_sh, gm_sh, gb_sh);
-		Lumped_Coeffs lumped_el_sh = calculate_lumped_coeffs(std::get<0>(x1_x2_el_sh), std::get<1>(x1_x2_el_sh), fVPD, in.Ca, gamma_sh, Rd_sh, g0_sh, gm_sh, gb_sh);
+		Lumped_Coeffs lumped_rub_sh = calculate_lumped_coeffs(std::get<0>(x1_x2_rub_sh), std::get<1>(x1_x2_rub_sh), fVPD, day.Ca[h], gamma_sh, Rd_sh, g0_sh, gm_sh, gb_sh);
+		Lumped_Coeffs lumped_el_sh = calculate_lumped_coeffs(std::get<0>(x1_x2_el_sh), std::get<1>(x1_x2_el_sh), fVPD, day.Ca[h], gamma_sh, Rd_sh, g0_sh, gm_sh, gb_sh);
 
 		//6.3 calculate assimilation
 		double A_rub_sun = A1_f(lumped_rub_sun); //mol CO2 m-2 s-1 (unit ground area)
@@ -723,11 +839,11 @@ FvCB_canopy_hourly_out FvCB::FvCB_canopy_hourly_C3(FvCB_canopy_hourly_in in, FvC
 			x2_sh = std::get<1>(x1_x2_rub_sh);
 		}
 		//6.4.2 gs
-		auto sun_ci_cc_gs = derive_ci_cc_gs_f(A_sun, x1_sun, x2_sun, gamma_sun, Rd_sun, gm_sun, fVPD, par.g0);
+		auto sun_ci_cc_gs = derive_ci_cc_gs_f(A_sun, x1_sun, x2_sun, gamma_sun, Rd_sun, gm_sun, fVPD, day.g0);
 		out.sunlit.ci = get<0>(sun_ci_cc_gs);
 		out.sunlit.cc = get<1>(sun_ci_cc_gs);
 		out.sunlit.gs = get<2>(sun_ci_cc_gs);
-		auto sh_ci_cc_gs = derive_ci_cc_gs_f(A_sh, x1_sh, x2_sh, gamma_sh, Rd_sh, gm_sh, fVPD, par.g0);
+		auto sh_ci_cc_gs = derive_ci_cc_gs_f(A_sh, x1_sh, x2_sh, gamma_sh, Rd_sh, gm_sh, fVPD, day.g0);
 		out.shaded.ci = get<0>(sh_ci_cc_gs);
 		out.shaded.cc = get<0>(sh_ci_cc_gs);
 		out.shaded.gs = get<2>(sh_ci_cc_gs);
@@ -768,6 +884,20 @@ FvCB_canopy_hourly_out FvCB::FvCB_canopy_hourly_C3(FvCB_canopy_hourly_in in, FvC
 	return out;
 }
 
+FvCB_canopy_hourly_out FvCB::FvCB_canopy_hourly_C3(const FvCB_canopy_hourly_in& in, const FvCB_canopy_hourly_params& par)
+{
+	FvCB_canopy_day day;
+	day.global_rad[0] = in.global_rad;
+	day.extra_terr_rad[0] = in.extra_terr_rad;
+	day.solar_el[0] = in.solar_el;
+	day.LAI[0] = in.LAI;
+	day.leaf_temp[0] = in.leaf_temp;
+	day.VPD[0] = in.VPD;
+	day.Ca[0] = in.Ca;
+	FvCB_canopy_day_C3(day, 1, par);
+	return FvCB_canopy_hourly_C3(day, 0, par.Vcmax_25);
+}
+
 #pragma endregion Model composition
 	
 	
\ No newline at end of file
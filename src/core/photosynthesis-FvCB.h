@@ -21,6 +21,9 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 #include <map>
 #include <vector>
 #include <cmath>
+#include <memory>
+
+#include "interpolation-table.h"
 
 namespace FvCB
 {
@@ -74,7 +77,97 @@ namespace FvCB
 		FvCB_leaf_fraction shaded;
 	};
 
-	FvCB_canopy_hourly_out FvCB_canopy_hourly_C3(FvCB_canopy_hourly_in in, FvCB_canopy_hourly_params par);
+	//! the hourly inputs of a whole day and the terms of FvCB_canopy_hourly_C3 which don't depend
+	//! on Vcmax_25 (radiation partitioning, sunlit/shaded LAI, temperature responses),
+	//! one array per quantity, so that all hours are computed in one pass
+	struct FvCB_canopy_day {
+		static const int hours = 24;
+
+		//inputs (see FvCB_canopy_hourly_in)
+		double global_rad[hours];
+		double extra_terr_rad[hours];
+		double solar_el[hours];
+		double LAI[hours];
+		double leaf_temp[hours];
+		double VPD[hours];
+		double Ca[hours];
+
+		//derived by FvCB_canopy_day_C3
+		double kn{ 0.0 }, gb{ 0.0 }, g0{ 0.0 };
+		double cap_f{ 0.0 }; //1 - exp(-kn)
+		double Tresp_Vcmax_25{ 0.0 }; //bernacchi temperature response of Vcmax at 25C
+		double Ic_sun[hours]; //mol m-2 s-1 (unit ground area)
+		double Ic_sh[hours];
+		double LAI_sun[hours];
+		double LAI_sh[hours];
+		double rad_sun[hours]; //W m-2
+		double rad_sh[hours];
+		double cap_sun_num[hours]; //1 - exp(-kn - kb*LAI)
+		double cap_sun_den[hours]; //kn + kb*LAI
+		double Tresp_Vcmax[hours];
+		double Tresp_Vomax[hours];
+		double Tresp_Jmax[hours];
+		double Rd[hours];
+		double Kc[hours];
+		double Ko[hours];
+		double Oi[hours];
+		double x2_rub[hours]; //Kc * (1 + Oi / Ko)
+		double theta_ps2[hours];
+		double phi_ps2max[hours];
+		double fVPD[hours];
+	};
+
+	/**
+	 * The Arrhenius type temperature responses (Vcmax, Vomax, Jmax, Rd, Kc, Ko) tabulated
+	 * over leaf temperature. Every table holds the response divided by its value at minLeafT,
+	 * so that the relative error of the interpolated response is below maxError() at
+	 * all leaf temperatures covered. Outside of [minLeafT, maxLeafT] the exact functions are used.
+	 */
+	class FvCB_temperature_responses
+	{
+	public:
+		FvCB_temperature_responses(double maxError, double minLeafT = -50.0, double maxLeafT = 60.0);
+
+		//! largest relative error of all tables
+		double maxError() const { return _maxError; }
+
+		bool covers(double leafT) const { return _Vcmax.table.covers(leafT); }
+
+		double Tresp_Vcmax(double leafT) const { return _Vcmax(leafT); }
+		double Tresp_Vomax(double leafT) const { return _Vomax(leafT); }
+		double Tresp_Jmax(double leafT) const { return _Jmax(leafT); }
+		double Rd(double leafT) const { return _Rd(leafT); }
+		double Kc(double leafT) const { return _Kc(leafT); }
+		double Ko(double leafT) const { return _Ko(leafT); }
+
+	private:
+		struct ScaledTable
+		{
+			double scale{ 1.0 };
+			Monica::InterpolationTable table;
+			double operator()(double leafT) const { return scale * table(leafT); }
+		};
+		ScaledTable tabulate(FvCB_Model_Consts response, double maxError, double minLeafT, double maxLeafT);
+
+		ScaledTable _Vcmax, _Vomax, _Jmax, _Rd, _Kc, _Ko;
+		double _maxError{ 0.0 };
+	};
+
+	/**
+	 * Returns the tables for the requested error bound. They are built at the first
+	 * request from c_bernacchi and deltaH_bernacchi and shared afterwards. Thread-safe.
+	 */
+	std::shared_ptr<const FvCB_temperature_responses> FvCB_temperature_response_tables(double maxError);
+
+	//! computes the Vcmax_25 independent terms of the first n hours of day,
+	//! with the tabulated temperature responses if responses are given, else with the exact functions
+	void FvCB_canopy_day_C3(FvCB_canopy_day& day, int n, const FvCB_canopy_hourly_params& par,
+		const FvCB_temperature_responses* responses = nullptr);
+
+	//! the remaining part of the hourly model for hour h of a day prepared by FvCB_canopy_day_C3
+	FvCB_canopy_hourly_out FvCB_canopy_hourly_C3(const FvCB_canopy_day& day, int h, double Vcmax_25);
+
+	FvCB_canopy_hourly_out FvCB_canopy_hourly_C3(const FvCB_canopy_hourly_in& in, const FvCB_canopy_hourly_params& par);
 	double Jmax_bernacchi_f(double leafT, double Jmax_25);
 	double Vcmax_bernacchi_f(double leafT, double Vcmax_25);
 	
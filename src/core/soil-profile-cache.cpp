@@ -0,0 +1,150 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Claas Nendel <claas.nendel@zalf.de>
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+#include <cmath>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+
+#include "soil-profile-cache.h"
+#include "soil/conversion.h"
+#include "soil/constants.h"
+
+using namespace std;
+using namespace Monica;
+
+namespace
+{
+	//! the parameters the properties are derived from, the hash is computed before locking the cache
+	struct ProfileKey
+	{
+		vector<double> sandClayPH; //!< sand content, clay content and pH of every layer
+		vector<string> textures;
+		size_t hash{0};
+
+		explicit ProfileKey(const Soil::SoilPMs& profile)
+		{
+			sandClayPH.reserve(3 * profile.size());
+			textures.reserve(profile.size());
+			hash = profile.size();
+			auto combine = [this](size_t h) { hash ^= h + 0x9e3779b9 + (hash << 6) + (hash >> 2); };
+			for(const auto& sp : profile)
+			{
+				for(double v : {sp.vs_SoilSandContent, sp.vs_SoilClayContent, sp.vs_SoilpH})
+				{
+					sandClayPH.push_back(v);
+					combine(std::hash<double>()(v));
+				}
+				textures.push_back(sp.vs_SoilTexture);
+				combine(std::hash<string>()(sp.vs_SoilTexture));
+			}
+		}
+
+		bool operator==(const ProfileKey& other) const
+		{
+			return hash == other.hash && sandClayPH == other.sandClayPH && textures == other.textures;
+		}
+	};
+
+	struct ProfileKeyHash
+	{
+		size_t operator()(const ProfileKey& key) const { return key.hash; }
+	};
+
+	//! if more profiles are cached, the cache is cleared, runs still using a profile keep it alive
+	const size_t MaxCachedProfiles = 10000;
+
+	mutex cacheMutex;
+	unordered_map<ProfileKey, SoilProfilePropertiesPtr, ProfileKeyHash> cache;
+	//! the profiles created from JSON (with the warnings of their creation), by the JSON of their layers
+	unordered_map<string, pair<Soil::SoilPMsPtr, Tools::Errors>> jsonCache;
+
+	SoilProfilePropertiesPtr derive(const Soil::SoilPMs& profile)
+	{
+		auto ps = make_shared<SoilProfileProperties>();
+		for(const auto& sp : profile)
+		{
+			ps->vs_KA5Texture.push_back(sp.vs_SoilTexture.empty()
+			                            ? Soil::sandAndClay2KA5texture(sp.vs_SoilSandContent, sp.vs_SoilClayContent)
+			                            : sp.vs_SoilTexture);
+
+			ps->vs_VanGenuchtenNInv.push_back(1.0 / exp(0.053
+			                                            - (0.9 * sp.vs_SoilSandContent)
+			                                            - (1.3 * sp.vs_SoilClayContent)
+			                                            + (1.5 * (pow(sp.vs_SoilSandContent, 2.0)))));
+
+			ps->vo_Hydrolysis_pH_Effect.push_back(exp(-0.064 * ((sp.vs_SoilpH - 6.5) * (sp.vs_SoilpH - 6.5))));
+
+			// pKaHNO2 original concept pow10. We used pow2 to allow reactive HNO2 being available at higer pH values
+			ps->vo_pHOnN2OProduction.push_back(1.0 / (1.0 + pow(2.0, sp.vs_SoilpH - Soil::OrganicConstants::po_pKaHNO2)));
+		}
+		return ps;
+	}
+}
+
+SoilProfilePropertiesPtr Monica::soilProfileProperties(const Soil::SoilPMs& profile)
+{
+	ProfileKey key(profile);
+
+	{
+		lock_guard<mutex> lock(cacheMutex);
+		auto it = cache.find(key);
+		if(it != cache.end())
+			return it->second;
+	}
+
+	//derive outside of the lock, if another thread was faster, its instance wins
+	auto ps = derive(profile);
+	lock_guard<mutex> lock(cacheMutex);
+	if(cache.size() >= MaxCachedProfiles)
+		cache.clear();
+	return cache.emplace(move(key), ps).first->second;
+}
+
+pair<Soil::SoilPMsPtr, Tools::Errors> Monica::soilProfileFromJson(const Tools::J11Array& jsonSoilPMs)
+{
+	string key = json11::Json(jsonSoilPMs).dump();
+
+	{
+		lock_guard<mutex> lock(cacheMutex);
+		auto it = jsonCache.find(key);
+		if(it != jsonCache.end())
+			return it->second;
+	}
+
+	//create outside of the lock, if another thread was faster, its instance wins
+	auto p = Soil::createSoilPMs(jsonSoilPMs);
+	if(!p.first || p.second.failure())
+		return p;
+
+	lock_guard<mutex> lock(cacheMutex);
+	if(jsonCache.size() >= MaxCachedProfiles)
+		jsonCache.clear();
+	return jsonCache.emplace(move(key), p).first->second;
+}
+
+size_t Monica::soilProfilePropertiesCacheSize()
+{
+	lock_guard<mutex> lock(cacheMutex);
+	return cache.size() + jsonCache.size();
+}
+
+void Monica::clearSoilProfilePropertiesCache()
+{
+	lock_guard<mutex> lock(cacheMutex);
+	cache.clear();
+	jsonCache.clear();
+}
@@ -0,0 +1,75 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Claas Nendel <claas.nendel@zalf.de>
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+#ifndef SOIL_PROFILE_CACHE_H_
+#define SOIL_PROFILE_CACHE_H_
+
+/**
+ * @file soil-profile-cache.h
+ *
+ * @brief Soil profiles and per layer properties derived from their static
+ * parameters. They are calculated once per process and profile and shared,
+ * read only, by all runs on the same profile.
+ */
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "json11/json11-helper.h"
+#include "soil/soil.h"
+
+namespace Monica
+{
+	//! immutable properties of the layers of a soil profile, index = layer
+	struct SoilProfileProperties
+	{
+		std::vector<std::string> vs_KA5Texture; //!< given texture or the one derived from sand and clay content
+		std::vector<double> vs_VanGenuchtenNInv; //!< 1/n of the Van Genuchten retention curve (Vereecken et al. 1989)
+		std::vector<double> vo_Hydrolysis_pH_Effect; //!< pH effect on urea hydrolysis []
+		std::vector<double> vo_pHOnN2OProduction; //!< pH response of N2O production []
+	};
+
+	typedef std::shared_ptr<const SoilProfileProperties> SoilProfilePropertiesPtr;
+
+	/**
+	 * Returns the derived properties of the profile. They are looked up by the
+	 * parameters they are derived from (sand and clay content, pH and texture
+	 * of every layer), so profiles equal in these share one instance.
+	 * The cache is cleared when it exceeds 10000 profiles. Thread-safe.
+	 */
+	SoilProfilePropertiesPtr soilProfileProperties(const Soil::SoilPMs& profile);
+
+	/**
+	 * Returns the soil profile created from its JSON layer specifications
+	 * (see Soil::createSoilPMs), which runs the pedotransfer functions
+	 * (field capacity, saturation, permanent wilting point, lambda, ...)
+	 * of every layer. Profiles are looked up by their JSON, so the
+	 * functions run once per distinct profile, the profile is shared read
+	 * only by all runs on it. Profiles with errors are not cached.
+	 * The cache is cleared when it exceeds 10000 profiles. Thread-safe.
+	 */
+	std::pair<Soil::SoilPMsPtr, Tools::Errors> soilProfileFromJson(const Tools::J11Array& jsonSoilPMs);
+
+	//! number of profiles currently cached (derived properties and profiles created from JSON)
+	std::size_t soilProfilePropertiesCacheSize();
+
+	//! drop all cached profiles, runs still using one keep it alive
+	void clearSoilProfilePropertiesCache();
+}
+
+#endif
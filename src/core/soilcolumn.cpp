@@ -17,6 +17,7 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 
 #include <cmath>
 #include <algorithm>
+#include <numeric>
 
 /**
  * @file soilcolumn.cpp
@@ -31,7 +32,9 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 
 #include "crop-growth.h"
 #include "soilcolumn.h"
+#include "state-io.h"
 #include "tools/debug.h"
+#include "tools/helper.h"
 #include "soil/constants.h"
 
 using namespace Monica;
@@ -40,6 +43,49 @@ using namespace Soil;
 using namespace Tools;
 
 
+const std::array<SoilColumnArrays::Field, 10>& SoilColumnArrays::fields()
+{
+	//keep the order, SoilLayer's accessors refer to the indices
+	static const std::array<Field, 10> fs =
+	{{{&SoilLayerValues::vs_SoilMoisture_m3, &SoilColumnArrays::vs_SoilMoisture_m3}
+	, {&SoilLayerValues::vs_SoilTemperature, &SoilColumnArrays::vs_SoilTemperature}
+	, {&SoilLayerValues::vs_SOM_Slow, &SoilColumnArrays::vs_SOM_Slow}
+	, {&SoilLayerValues::vs_SOM_Fast, &SoilColumnArrays::vs_SOM_Fast}
+	, {&SoilLayerValues::vs_SMB_Slow, &SoilColumnArrays::vs_SMB_Slow}
+	, {&SoilLayerValues::vs_SMB_Fast, &SoilColumnArrays::vs_SMB_Fast}
+	, {&SoilLayerValues::vs_SoilCarbamid, &SoilColumnArrays::vs_SoilCarbamid}
+	, {&SoilLayerValues::vs_SoilNH4, &SoilColumnArrays::vs_SoilNH4}
+	, {&SoilLayerValues::vs_SoilNO2, &SoilColumnArrays::vs_SoilNO2}
+	, {&SoilLayerValues::vs_SoilNO3, &SoilColumnArrays::vs_SoilNO3}
+	}};
+	return fs;
+}
+
+SoilLayerValues SoilLayerState::values() const
+{
+	SoilLayerValues vs;
+	for(const auto& f : SoilColumnArrays::fields())
+		vs.*f.first = get(f);
+	return vs;
+}
+
+void SoilLayerState::setValues(const SoilLayerValues& vs)
+{
+	for(const auto& f : SoilColumnArrays::fields())
+		ref(f) = vs.*f.first;
+}
+
+void SoilLayerState::makeOwn(const SoilLayerValues& vs)
+{
+	_own.reset(new SoilColumnArrays);
+	for(const auto& f : SoilColumnArrays::fields())
+		(_own.get()->*f.second).assign(1, vs.*f.first);
+	_arrays = _own.get();
+	_index = 0;
+}
+
+//------------------------------------------------------------------------------
+
 /**
  * Constructor
  * @param vs_LayerThickness Vertical expansion
@@ -48,12 +94,11 @@ using namespace Tools;
 SoilLayer::SoilLayer(double vs_LayerThickness,
 	const SoilParameters& sps)
 	: vs_LayerThickness(vs_LayerThickness)
-	, vs_SoilNH4(sps.vs_SoilAmmonium)
-	, vs_SoilNO3(sps.vs_SoilNitrate)
 	, _sps(sps)
-	, vs_SoilMoisture_m3(sps.vs_FieldCapacity * sps.vs_SoilMoisturePercentFC / 100.0)
-	//, vs_SoilMoistureOld_m3(sps.vs_FieldCapacity * sps.vs_SoilMoisturePercentFC / 100.0)
 {
+	vs_SoilNH4() = sps.vs_SoilAmmonium;
+	vs_SoilNO3() = sps.vs_SoilNitrate;
+	set_Vs_SoilMoisture_m3(sps.vs_FieldCapacity * sps.vs_SoilMoisturePercentFC / 100.0);
 }
 
 /**
@@ -132,10 +177,71 @@ SoilColumn::SoilColumn(double ps_LayerThickness,
 	if (soilParams)
 		for (auto sp : *soilParams)
 			push_back(SoilLayer(ps_LayerThickness, sp));
+	bindLayers();
+
+	_profileProperties = soilProfileProperties(soilParams ? *soilParams : Soil::SoilPMs());
 
 	_vs_NumberOfOrganicLayers = calculateNumberOfOrganicLayers();
 }
 
+SoilColumn::SoilColumn(const SoilColumn& other)
+{
+	*this = other;
+}
+
+SoilColumn& SoilColumn::operator=(const SoilColumn& other)
+{
+	if(this == &other)
+		return *this;
+
+	Layers::operator=(other);
+	_profileProperties = other._profileProperties;
+
+	vs_SurfaceWaterStorage = other.vs_SurfaceWaterStorage;
+	vs_InterceptionStorage = other.vs_InterceptionStorage;
+	vm_GroundwaterTable = other.vm_GroundwaterTable;
+	vs_FluxAtLowerBoundary = other.vs_FluxAtLowerBoundary;
+	vq_CropNUptake = other.vq_CropNUptake;
+	vt_SoilSurfaceTemperature = other.vt_SoilSurfaceTemperature;
+	vm_SnowDepth = other.vm_SnowDepth;
+	ps_MaxMineralisationDepth = other.ps_MaxMineralisationDepth;
+	_vs_NumberOfOrganicLayers = other._vs_NumberOfOrganicLayers;
+	_vf_TopDressing = other._vf_TopDressing;
+	_vf_TopDressingPartition = other._vf_TopDressingPartition;
+	_vf_TopDressingDelay = other._vf_TopDressingDelay;
+	cropGrowth = other.cropGrowth;
+	_delayedNMinApplications = other._delayedNMinApplications;
+	pm_CriticalMoistureDepth = other.pm_CriticalMoistureDepth;
+
+	bindLayers();
+
+	return *this;
+}
+
+void SoilColumn::bindLayers()
+{
+	SoilColumnArrays as;
+	for(const auto& f : SoilColumnArrays::fields())
+	{
+		auto& a = as.*f.second;
+		a.reserve(size());
+		for(const auto& sl : *this)
+			a.push_back(sl._state.get(f));
+	}
+	for(const auto& sl : *this)
+	{
+		as.vs_LayerThickness.push_back(sl.vs_LayerThickness);
+		as.vs_FieldCapacity.push_back(sl.vs_FieldCapacity());
+		as.vs_Saturation.push_back(sl.vs_Saturation());
+		as.vs_PermanentWiltingPoint.push_back(sl.vs_PermanentWiltingPoint());
+		as.vs_Lambda.push_back(sl.vs_Lambda());
+	}
+	_arrays = move(as);
+
+	for(size_t i = 0; i < size(); i++)
+		at(i)._state.bind(&_arrays, i);
+}
+
 /**
  * @brief Calculates number of organic layers.
  *
@@ -177,7 +283,7 @@ double SoilColumn::applyMineralFertiliserViaNDemand(MineralFertiliserParameters
 		depthCm += int(layerSize * 100.0);
 
 		//convert [kg N m-3] to [kg N ha-1]
-		sumSoilNkgHa += (at(i).vs_SoilNO3 + at(i).vs_SoilNH4) * 10000.0 * layerSize;
+		sumSoilNkgHa += (at(i).vs_SoilNO3() + at(i).vs_SoilNH4()) * 10000.0 * layerSize;
 
 		if (depthCm >= int(demandDepth * 100))
 			break;
@@ -215,16 +321,15 @@ applyMineralFertiliserViaNMinMethod(MineralFertiliserParameters fp,
 {
 	if (at(0).get_Vs_SoilMoisture_m3() > at(0).vs_FieldCapacity())
 	{
-		_delayedNMinApplications.push_back([=]()
-		{
-			return this->applyMineralFertiliserViaNMinMethod(fp,
-				vf_SamplingDepth,
-				vf_CropNTarget,
-				vf_CropNTarget30,
-				vf_FertiliserMinApplication,
-				vf_FertiliserMaxApplication,
-				vf_TopDressingDelay);
-		});
+		DelayedNMinApplication a;
+		a.fp = fp;
+		a.samplingDepth = vf_SamplingDepth;
+		a.cropNTarget = vf_CropNTarget;
+		a.cropNTarget30 = vf_CropNTarget30;
+		a.fertiliserMinApplication = vf_FertiliserMinApplication;
+		a.fertiliserMaxApplication = vf_FertiliserMaxApplication;
+		a.topDressingDelay = vf_TopDressingDelay;
+		_delayedNMinApplications.push_back(a);
 
 		debug() << "Soil too wet for fertilisation. Fertiliser event adjourned to next day." << endl;
 		return 0.0;
@@ -238,8 +343,8 @@ applyMineralFertiliserViaNMinMethod(MineralFertiliserParameters fp,
 	for (int i_Layer = 0; i_Layer < layerSamplingDepth /*(ceil(vf_SamplingDepth / at(i_Layer).vs_LayerThickness))*/; i_Layer++)
 	{
 		//vf_TargetLayer is in cm. We want number of layers
-		vf_SoilNO3Sum += at(i_Layer).vs_SoilNO3; //! [kg N m-3]
-		vf_SoilNH4Sum += at(i_Layer).vs_SoilNH4; //! [kg N m-3]
+		vf_SoilNO3Sum += at(i_Layer).vs_SoilNO3(); //! [kg N m-3]
+		vf_SoilNH4Sum += at(i_Layer).vs_SoilNH4(); //! [kg N m-3]
 	}
 
 	double vf_SoilNO3Sum30 = 0.0;
@@ -248,8 +353,8 @@ applyMineralFertiliserViaNMinMethod(MineralFertiliserParameters fp,
   /** @todo Must be adapted when using variable layer depth. */
 	for (int i_Layer = 0; i_Layer < vf_Layer30cm; i_Layer++)
 	{
-		vf_SoilNO3Sum30 += at(i_Layer).vs_SoilNO3; //! [kg N m-3]
-		vf_SoilNH4Sum30 += at(i_Layer).vs_SoilNH4; //! [kg N m-3]
+		vf_SoilNO3Sum30 += at(i_Layer).vs_SoilNO3(); //! [kg N m-3]
+		vf_SoilNH4Sum30 += at(i_Layer).vs_SoilNH4(); //! [kg N m-3]
 	}
 
 	// Converts [kg N ha-1] to [kg N m-3]
@@ -329,10 +434,17 @@ double SoilColumn::applyPossibleTopDressing()
  * then removes the first fertilizer item in list.
  */
 double SoilColumn::applyPossibleDelayedFerilizer() {
-	list<std::function<double()> > delayedApps = _delayedNMinApplications;
+	list<DelayedNMinApplication> delayedApps = _delayedNMinApplications;
 	double n_amount = 0.0;
 	while (!delayedApps.empty()) {
-		n_amount += delayedApps.front()();
+		const auto& a = delayedApps.front();
+		n_amount += applyMineralFertiliserViaNMinMethod(a.fp,
+			a.samplingDepth,
+			a.cropNTarget,
+			a.cropNTarget30,
+			a.fertiliserMinApplication,
+			a.fertiliserMaxApplication,
+			a.topDressingDelay);
 		delayedApps.pop_front();
 		_delayedNMinApplications.pop_front();
 	}
@@ -350,9 +462,9 @@ void SoilColumn::applyMineralFertiliser(MineralFertiliserParameters fp,
 		<< " amount: " << amount << endl;
 	// [kg N ha-1 -> kg m-3]
 	double kgHaTokgm3 = 10000.0 * at(0).vs_LayerThickness;
-	at(0).vs_SoilNO3 += amount * fp.getNO3() / kgHaTokgm3;
-	at(0).vs_SoilNH4 += amount * fp.getNH4() / kgHaTokgm3;
-	at(0).vs_SoilCarbamid += amount * fp.getCarbamid() / kgHaTokgm3;
+	at(0).vs_SoilNO3() += amount * fp.getNO3() / kgHaTokgm3;
+	at(0).vs_SoilNH4() += amount * fp.getNH4() / kgHaTokgm3;
+	at(0).vs_SoilCarbamid() += amount * fp.getCarbamid() / kgHaTokgm3;
 }
 
 
@@ -367,7 +479,10 @@ void SoilColumn::applyMineralFertiliser(MineralFertiliserParameters fp,
  */
 void SoilColumn::deleteAOMPool() {
 
-	for (unsigned int i_AOMPool = 0; i_AOMPool < at(0).vo_AOM_Pool.size();) {
+	const size_t noOfPools = at(0).vo_AOM_Pool.size();
+	vector<bool> keepPool(noOfPools, true);
+	bool anyToDelete = false;
+	for (size_t i_AOMPool = 0; i_AOMPool < noOfPools; i_AOMPool++) {
 
 		double vo_SumAOM_Slow = 0.0;
 		double vo_SumAOM_Fast = 0.0;
@@ -382,18 +497,191 @@ void SoilColumn::deleteAOMPool() {
 		//cout << "Pool " << i_AOMPool << " -> Slow: " << vo_SumAOM_Slow << "; Fast: " << vo_SumAOM_Fast << endl;
 
 		if ((vo_SumAOM_Slow + vo_SumAOM_Fast) < 0.00001) {
-			for (int i_Layer = 0; i_Layer < _vs_NumberOfOrganicLayers; i_Layer++) {
-				vector<AOM_Properties>::iterator it_AOMPool = at(i_Layer).vo_AOM_Pool.begin();
-				it_AOMPool += i_AOMPool;
+			keepPool[i_AOMPool] = false;
+			anyToDelete = true;
+		}
+	}
+
+	if (!anyToDelete)
+		return;
+
+	// compact the pools of every layer in a single pass, keeping the order of the remaining pools
+	// (the same in every layer, so the pool indices stay aligned across layers)
+	for (int i_Layer = 0; i_Layer < _vs_NumberOfOrganicLayers; i_Layer++) {
+		vector<AOM_Properties>& pools = at(i_Layer).vo_AOM_Pool;
+		size_t kept = 0;
+		for (size_t i_AOMPool = 0; i_AOMPool < noOfPools; i_AOMPool++) {
+			if (!keepPool[i_AOMPool])
+				continue;
+			if (kept != i_AOMPool)
+				pools[kept] = std::move(pools[i_AOMPool]);
+			kept++;
+		}
+		pools.erase(pools.begin() + kept, pools.end());
+	}
+}
+
+namespace
+{
+	//! pools which are still volatilising ammonia (see SoilOrganic::fo_Volatilisation)
+	//! keep their application date and NH4 content until they are old enough
+	bool isCoalescable(const AOM_Properties& pool, int minDaysAfterApplication)
+	{
+		return pool.vo_DaysAfterApplication == 0
+			|| pool.vo_DaysAfterApplication >= minDaysAfterApplication;
+	}
+
+	/**
+	 * Distance between the decomposition parameters of two pools as the largest
+	 * relative difference of a single parameter. 0 means the pools are the same kind
+	 * of organic matter, judged by the same rounding SoilOrganic::addOrganicMatter uses
+	 * to find a matching pool. A negative value means the pools can't be merged at all.
+	 */
+	double aomParameterDistance(const AOM_Properties& a, const AOM_Properties& b)
+	{
+		if(a.incorporation != b.incorporation || a.noVolatilization != b.noVolatilization)
+			return -1.0;
+
+		const pair<double, double> ps[] =
+		{{a.vo_AOM_SlowDecCoeffStandard, b.vo_AOM_SlowDecCoeffStandard}
+		,{a.vo_AOM_FastDecCoeffStandard, b.vo_AOM_FastDecCoeffStandard}
+		,{a.vo_PartAOM_Slow_to_SMB_Slow, b.vo_PartAOM_Slow_to_SMB_Slow}
+		,{a.vo_PartAOM_Slow_to_SMB_Fast, b.vo_PartAOM_Slow_to_SMB_Fast}
+		,{a.vo_CN_Ratio_AOM_Slow, b.vo_CN_Ratio_AOM_Slow}};
+
+		double dist = 0.0;
+		for(const auto& p : ps)
+		{
+			if(roundShiftedInt(p.first, 4) == roundShiftedInt(p.second, 4))
+				continue;
+			double m = max(fabs(p.first), fabs(p.second));
+			dist = max(dist, fabs(p.first - p.second) / m);
+		}
+		return dist;
+	}
+}
+
+/**
+ * Merges AOM pools to bound their number over long runs.
+ *
+ * If mergeEquivalent is set, pools with the same decomposition parameters are merged.
+ * As decomposition is linear in the pool size this is exact for carbon, and the
+ * C/N ratios of the merged pool are chosen such that nitrogen is conserved in every
+ * layer. If there are still more than maxPools pools (0 = no limit), the pairs with
+ * the most similar parameters are merged, using the carbon weighted mean of the
+ * parameters. Pools which are younger than minDaysAfterApplication days, and thus
+ * still volatilising, are left alone, so the limit might be exceeded temporarily.
+ *
+ * @return the number of merged pools and the approximation error, which is the carbon
+ * of the lighter pool times the parameter distance, summed over all merges [kg C m-2]
+ */
+pair<int, double> SoilColumn::coalesceAOMPools(bool mergeEquivalent,
+                                               size_t maxPools,
+                                               int minDaysAfterApplication)
+{
+	int noOfMerges = 0;
+	double error = 0.0;
+	const vector<AOM_Properties>& pools = at(0).vo_AOM_Pool;
 
-				at(i_Layer).vo_AOM_Pool.erase(it_AOMPool);
+	// merge pool j into pool i in all layers and remove pool j
+	auto merge = [&](size_t i, size_t j, double dist)
+	{
+		double ci = 0.0, cj = 0.0; // [kg C m-2]
+		for(int l = 0; l < _vs_NumberOfOrganicLayers; l++)
+		{
+			const auto& layer = at(l);
+			ci += (layer.vo_AOM_Pool[i].vo_AOM_Slow + layer.vo_AOM_Pool[i].vo_AOM_Fast) * layer.vs_LayerThickness;
+			cj += (layer.vo_AOM_Pool[j].vo_AOM_Slow + layer.vo_AOM_Pool[j].vo_AOM_Fast) * layer.vs_LayerThickness;
+		}
+		double wj = ci + cj > 0 ? cj / (ci + cj) : 0.5;
+		auto mix = [=](double vi, double vj){ return vi + wj * (vj - vi); };
+
+		// N conserving C/N ratio of the merged pool, falls back to the mixed ratio if empty
+		auto cnRatio = [&](double Ci, double cni, double Cj, double cnj)
+		{
+			double n = (fabs(cni) >= 1.0E-7 ? Ci / cni : 0.0) + (fabs(cnj) >= 1.0E-7 ? Cj / cnj : 0.0);
+			return n > 0 ? (Ci + Cj) / n : mix(cni, cnj);
+		};
+
+		for(int l = 0; l < _vs_NumberOfOrganicLayers; l++)
+		{
+			vector<AOM_Properties>& lps = at(l).vo_AOM_Pool;
+			AOM_Properties& pi = lps[i];
+			const AOM_Properties& pj = lps[j];
+
+			pi.vo_CN_Ratio_AOM_Slow = cnRatio(pi.vo_AOM_Slow, pi.vo_CN_Ratio_AOM_Slow, pj.vo_AOM_Slow, pj.vo_CN_Ratio_AOM_Slow);
+			pi.vo_CN_Ratio_AOM_Fast = cnRatio(pi.vo_AOM_Fast, pi.vo_CN_Ratio_AOM_Fast, pj.vo_AOM_Fast, pj.vo_CN_Ratio_AOM_Fast);
+			pi.vo_AOM_Slow += pj.vo_AOM_Slow;
+			pi.vo_AOM_Fast += pj.vo_AOM_Fast;
+
+			pi.vo_AOM_SlowDecCoeffStandard = mix(pi.vo_AOM_SlowDecCoeffStandard, pj.vo_AOM_SlowDecCoeffStandard);
+			pi.vo_AOM_FastDecCoeffStandard = mix(pi.vo_AOM_FastDecCoeffStandard, pj.vo_AOM_FastDecCoeffStandard);
+			pi.vo_PartAOM_Slow_to_SMB_Slow = mix(pi.vo_PartAOM_Slow_to_SMB_Slow, pj.vo_PartAOM_Slow_to_SMB_Slow);
+			pi.vo_PartAOM_Slow_to_SMB_Fast = mix(pi.vo_PartAOM_Slow_to_SMB_Fast, pj.vo_PartAOM_Slow_to_SMB_Fast);
+
+			pi.vo_AOM_DryMatterContent = mix(pi.vo_AOM_DryMatterContent, pj.vo_AOM_DryMatterContent);
+			pi.vo_AOM_NH4Content = mix(pi.vo_AOM_NH4Content, pj.vo_AOM_NH4Content);
+			pi.vo_DaysAfterApplication = max(pi.vo_DaysAfterApplication, pj.vo_DaysAfterApplication);
+
+			if(j + 1 < lps.size())
+				lps[j] = std::move(lps.back());
+			lps.pop_back();
+		}
+
+		error += dist * min(ci, cj);
+		noOfMerges++;
+	};
+
+	if(mergeEquivalent)
+	{
+		for(size_t i = 0; i < pools.size(); i++)
+		{
+			if(!isCoalescable(pools[i], minDaysAfterApplication))
+				continue;
+
+			// j is checked again after a merge, as the last pool has been moved there
+			for(size_t j = i + 1; j < pools.size();)
+			{
+				if(isCoalescable(pools[j], minDaysAfterApplication)
+					 && aomParameterDistance(pools[i], pools[j]) == 0.0)
+					merge(i, j, 0.0);
+				else
+					j++;
 			}
-			//cout << "Habe Pool " << i_AOMPool << " gelöscht" << endl;
 		}
-		else {
-			i_AOMPool++;
+	}
+
+	while(maxPools > 0 && pools.size() > maxPools)
+	{
+		size_t bi = 0, bj = 0;
+		double bestDist = -1.0;
+		for(size_t i = 0; i < pools.size(); i++)
+		{
+			if(!isCoalescable(pools[i], minDaysAfterApplication))
+				continue;
+
+			for(size_t j = i + 1; j < pools.size(); j++)
+			{
+				if(!isCoalescable(pools[j], minDaysAfterApplication))
+					continue;
+
+				double dist = aomParameterDistance(pools[i], pools[j]);
+				if(dist >= 0.0 && (bestDist < 0.0 || dist < bestDist))
+				{
+					bi = i;
+					bj = j;
+					bestDist = dist;
+				}
+			}
 		}
+
+		if(bestDist < 0.0)
+			break;
+
+		merge(bi, bj, bestDist);
 	}
+
+	return make_pair(noOfMerges, error);
 }
 
 /**
@@ -474,7 +762,7 @@ void SoilColumn::applyIrrigation(double vi_IrrigationAmount,
 // [-> kg m-3]
 
 // Adding N from irrigation water to top soil nitrate pool
-	at(0).vs_SoilNO3 += vi_NAddedViaIrrigation;
+	at(0).vs_SoilNO3() += vi_NAddedViaIrrigation;
 }
 
 
@@ -509,14 +797,14 @@ void SoilColumn::applyTillage(double depth)
 		soil_temperature += at(i).get_Vs_SoilTemperature();
 		soil_moisture += at(i).get_Vs_SoilMoisture_m3();
 		//soil_moistureOld += at(i).vs_SoilMoistureOld_m3;
-		som_slow += at(i).vs_SOM_Slow;
-		som_fast += at(i).vs_SOM_Fast;
-		smb_slow += at(i).vs_SMB_Slow;
-		smb_fast += at(i).vs_SMB_Fast;
-		carbamid += at(i).vs_SoilCarbamid;
-		nh4 += at(i).vs_SoilNH4;
-		no2 += at(i).vs_SoilNO2;
-		no3 += at(i).vs_SoilNO3;
+		som_slow += at(i).vs_SOM_Slow();
+		som_fast += at(i).vs_SOM_Fast();
+		smb_slow += at(i).vs_SMB_Slow();
+		smb_fast += at(i).vs_SMB_Fast();
+		carbamid += at(i).vs_SoilCarbamid();
+		nh4 += at(i).vs_SoilNH4();
+		no2 += at(i).vs_SoilNO2();
+		no3 += at(i).vs_SoilNO3();
 	}
 
 	// calculate mean value of accumulated soil paramters
@@ -543,14 +831,14 @@ void SoilColumn::applyTillage(double depth)
 		at(i).set_Vs_SoilTemperature(soil_temperature);
 		at(i).set_Vs_SoilMoisture_m3(soil_moisture);
 		//at(i).vs_SoilMoistureOld_m3 = soil_moistureOld;
-		at(i).vs_SOM_Slow = som_slow;
-		at(i).vs_SOM_Fast = som_fast;
-		at(i).vs_SMB_Slow = smb_slow;
-		at(i).vs_SMB_Fast = smb_fast;
-		at(i).vs_SoilCarbamid = carbamid;
-		at(i).vs_SoilNH4 = nh4;
-		at(i).vs_SoilNO2 = no2;
-		at(i).vs_SoilNO3 = no3;
+		at(i).vs_SOM_Slow() = som_slow;
+		at(i).vs_SOM_Fast() = som_fast;
+		at(i).vs_SMB_Slow() = smb_slow;
+		at(i).vs_SMB_Fast() = smb_fast;
+		at(i).vs_SoilCarbamid() = carbamid;
+		at(i).vs_SoilNH4() = nh4;
+		at(i).vs_SoilNO2() = no2;
+		at(i).vs_SoilNO3() = no3;
 	}
 
 	// merge aom pool
@@ -684,10 +972,139 @@ void SoilColumn::remove_Crop() {
  */
 double SoilColumn::sumSoilTemperature(int layers) const
 {
-	double accu = 0.0;
-	for (int i = 0; i < layers; i++)
-		accu += at(i).get_Vs_SoilTemperature();
-	return accu;
+	return accumulate(_arrays.vs_SoilTemperature.begin(), _arrays.vs_SoilTemperature.begin() + layers, 0.0);
+}
+
+void SoilLayer::serialize(std::ostream& out) const
+{
+	using namespace StateIO;
+	write(out, vs_LayerThickness);
+	write(out, vs_SoilWaterFlux);
+	write(out, vo_AOM_Pool);
+	write(out, vs_SOM_Slow());
+	write(out, vs_SOM_Fast());
+	write(out, vs_SMB_Slow());
+	write(out, vs_SMB_Fast());
+	write(out, vs_SoilCarbamid());
+	write(out, vs_SoilNH4());
+	write(out, vs_SoilNO2());
+	write(out, vs_SoilNO3());
+	write(out, vs_SoilFrozen);
+	//organic carbon is the only soil parameter being changed during a run
+	write(out, vs_SoilOrganicCarbon());
+	write(out, get_Vs_SoilMoisture_m3());
+	write(out, get_Vs_SoilTemperature());
+}
+
+void SoilLayer::deserialize(std::istream& in)
+{
+	using namespace StateIO;
+	read(in, vs_LayerThickness);
+	read(in, vs_SoilWaterFlux);
+	read(in, vo_AOM_Pool);
+	//the pools and N species are written as double, whatever StateReal is
+	for(size_t i = 2; i < SoilColumnArrays::fields().size(); i++)
+	{
+		double v = 0.0;
+		read(in, v);
+		_state.ref(SoilColumnArrays::fields()[i]) = StateReal(v);
+	}
+	read(in, vs_SoilFrozen);
+	double soc = 0.0;
+	read(in, soc);
+	set_SoilOrganicCarbon(soc);
+	double moisture = 0.0, temperature = 0.0;
+	read(in, moisture);
+	set_Vs_SoilMoisture_m3(moisture);
+	read(in, temperature);
+	set_Vs_SoilTemperature(temperature);
+}
+
+/**
+ * Writes the dynamic state of the soil column. Static soil parameters
+ * are not part of the state, they are expected to be the same
+ * when the state is read back into a column.
+ */
+void SoilColumn::serialize(std::ostream& out) const
+{
+	using namespace StateIO;
+	write(out, std::uint64_t(size()));
+	for(const auto& sl : *this)
+		sl.serialize(out);
+
+	write(out, vs_SurfaceWaterStorage);
+	write(out, vs_InterceptionStorage);
+	write(out, vm_GroundwaterTable);
+	write(out, vs_FluxAtLowerBoundary);
+	write(out, vq_CropNUptake);
+	write(out, vt_SoilSurfaceTemperature);
+	write(out, vm_SnowDepth);
+	write(out, _vf_TopDressing);
+	write(out, _vf_TopDressingPartition.to_json().dump());
+	write(out, _vf_TopDressingDelay);
+
+	write(out, std::uint64_t(_delayedNMinApplications.size()));
+	for(const auto& a : _delayedNMinApplications)
+	{
+		write(out, a.fp.to_json().dump());
+		write(out, a.samplingDepth);
+		write(out, a.cropNTarget);
+		write(out, a.cropNTarget30);
+		write(out, a.fertiliserMinApplication);
+		write(out, a.fertiliserMaxApplication);
+		write(out, a.topDressingDelay);
+	}
+}
+
+bool SoilColumn::deserialize(std::istream& in)
+{
+	using namespace StateIO;
+	std::uint64_t nols = 0;
+	read(in, nols);
+	if(nols != size())
+	{
+		cerr << "Error: state has " << nols << " soil layers, but soil column has " << size() << " layers!" << endl;
+		return false;
+	}
+	for(auto& sl : *this)
+		sl.deserialize(in);
+	//layer thicknesses are part of the state
+	bindLayers();
+
+	read(in, vs_SurfaceWaterStorage);
+	read(in, vs_InterceptionStorage);
+	read(in, vm_GroundwaterTable);
+	read(in, vs_FluxAtLowerBoundary);
+	read(in, vq_CropNUptake);
+	read(in, vt_SoilSurfaceTemperature);
+	read(in, vm_SnowDepth);
+	read(in, _vf_TopDressing);
+	string partition, err;
+	read(in, partition);
+	_vf_TopDressingPartition = MineralFertiliserParameters(json11::Json::parse(partition, err));
+	read(in, _vf_TopDressingDelay);
+
+	_delayedNMinApplications.clear();
+	std::uint64_t noOfDelayedApps = 0;
+	if(readSize(in, noOfDelayedApps, 6 * sizeof(double)))
+	{
+		for(std::uint64_t i = 0; in && i < noOfDelayedApps; i++)
+		{
+			DelayedNMinApplication a;
+			string fp;
+			read(in, fp);
+			a.fp = MineralFertiliserParameters(json11::Json::parse(fp, err));
+			read(in, a.samplingDepth);
+			read(in, a.cropNTarget);
+			read(in, a.cropNTarget30);
+			read(in, a.fertiliserMinApplication);
+			read(in, a.fertiliserMaxApplication);
+			read(in, a.topDressingDelay);
+			_delayedNMinApplications.push_back(a);
+		}
+	}
+
+	return bool(in);
 }
 
 //------------------------------------------------------------------------------
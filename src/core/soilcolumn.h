@@ -32,10 +32,14 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 
 #include <vector>
 #include <list>
+#include <array>
+#include <memory>
+#include <utility>
 #include <iostream>
 #include <assert.h>
 
 #include "monica-parameters.h"
+#include "soil-profile-cache.h"
 
 namespace Monica
 {
@@ -46,6 +50,17 @@ namespace Monica
 
   //std::vector<AOM_Properties> vo_AOM_Pool;
 
+  /**
+   * Scalar type of the soil layer state and the AOM pools. Building with
+   * MONICA_FLOAT_STATE stores them as float to halve the memory traffic
+   * in large ensembles. Calculations, sums and balances stay double.
+   */
+#ifdef MONICA_FLOAT_STATE
+  typedef float StateReal;
+#else
+  typedef double StateReal;
+#endif
+
   /**
    * @author Claas Nendel, Michael Berg
    *
@@ -59,16 +74,16 @@ namespace Monica
    */
   struct AOM_Properties
   {
-    double vo_AOM_Slow{0.0}; //!< C content in slowly decomposing added organic matter pool [kgC m-3]
-    double vo_AOM_Fast{0.0}; //!< C content in rapidly decomposing added organic matter pool [kgC m-3]
+    StateReal vo_AOM_Slow{0.0}; //!< C content in slowly decomposing added organic matter pool [kgC m-3]
+    StateReal vo_AOM_Fast{0.0}; //!< C content in rapidly decomposing added organic matter pool [kgC m-3]
 
-    double vo_AOM_SlowDecRate_to_SMB_Slow{0.0}; //!< Rate for slow AOM consumed by SMB Slow is calculated.
-    double vo_AOM_SlowDecRate_to_SMB_Fast{0.0}; //!< Rate for slow AOM consumed by SMB Fast is calculated.
-    double vo_AOM_FastDecRate_to_SMB_Slow{0.0}; //!< Rate for fast AOM consumed by SMB Slow is calculated.
-    double vo_AOM_FastDecRate_to_SMB_Fast{0.0}; //!< Rate for fast AOM consumed by SMB Fast is calculated.
+    StateReal vo_AOM_SlowDecRate_to_SMB_Slow{0.0}; //!< Rate for slow AOM consumed by SMB Slow is calculated.
+    StateReal vo_AOM_SlowDecRate_to_SMB_Fast{0.0}; //!< Rate for slow AOM consumed by SMB Fast is calculated.
+    StateReal vo_AOM_FastDecRate_to_SMB_Slow{0.0}; //!< Rate for fast AOM consumed by SMB Slow is calculated.
+    StateReal vo_AOM_FastDecRate_to_SMB_Fast{0.0}; //!< Rate for fast AOM consumed by SMB Fast is calculated.
 
-    double vo_AOM_SlowDecCoeff{0.0}; //!< Is dependent on environment
-    double vo_AOM_FastDecCoeff{0.0}; //!< Is dependent on environment
+    StateReal vo_AOM_SlowDecCoeff{0.0}; //!< Is dependent on environment
+    StateReal vo_AOM_FastDecCoeff{0.0}; //!< Is dependent on environment
 
     double vo_AOM_SlowDecCoeffStandard{1.0}; //!< Decomposition rate coefficient for slow AOM pool at standard conditions
     double vo_AOM_FastDecCoeffStandard{1.0}; //!< Decomposition rate coefficient for fast AOM pool at standard conditions
@@ -83,8 +98,8 @@ namespace Monica
     double vo_AOM_DryMatterContent{0.0}; //!< Fertilization parameter
     double vo_AOM_NH4Content{0.0}; //!< Fertilization parameter
 
-    double vo_AOM_SlowDelta{0.0}; //!< Difference of AOM slow between to timesteps
-    double vo_AOM_FastDelta{0.0}; //!< Difference of AOM fast between to timesteps
+    StateReal vo_AOM_SlowDelta{0.0}; //!< Difference of AOM slow between to timesteps
+    StateReal vo_AOM_FastDelta{0.0}; //!< Difference of AOM fast between to timesteps
 
     bool incorporation{false};  //!< True if organic fertilizer is added with a subsequent incorporation.
 		bool noVolatilization{true}; //!< true means it's a crop residue and won't participate in vo_volatilisation()
@@ -92,6 +107,104 @@ namespace Monica
 
   //----------------------------------------------------------------------------
 
+  //! the frequently accessed state of a single soil layer
+  struct SoilLayerValues
+  {
+    StateReal vs_SoilMoisture_m3{0.25}; //!< Soil layer's moisture content [m3 m-3]
+    StateReal vs_SoilTemperature{0.0}; //!< Soil layer's temperature [°C]
+
+    StateReal vs_SOM_Slow{0.0}; //!< C content of soil organic matter slow pool [kg C m-3]
+    StateReal vs_SOM_Fast{0.0}; //!< C content of soil organic matter fast pool size [kg C m-3]
+    StateReal vs_SMB_Slow{0.0}; //!< C content of soil microbial biomass slow pool size [kg C m-3]
+    StateReal vs_SMB_Fast{0.0}; //!< C content of soil microbial biomass fast pool size [kg C m-3]
+
+    // anorganische Stickstoff-Formen
+    StateReal vs_SoilCarbamid{0.0}; //!< Soil layer's carbamide-N content [kg Carbamide-N m-3]
+    StateReal vs_SoilNH4{0.0001}; //!< Soil layer's NH4-N content [kg NH4-N m-3]
+    StateReal vs_SoilNO2{0.001}; //!< Soil layer's NO2-N content [kg NO2-N m-3]
+    StateReal vs_SoilNO3{0.0001}; //!< Soil layer's NO3-N content [kg NO3-N m-3]
+  };
+
+  /**
+   * @brief The frequently accessed state of all layers of a soil column as structure of arrays.
+   *
+   * Loops over the layers touch only the (contiguous) values they need
+   * instead of striding over whole SoilLayer objects. The dynamic arrays
+   * are the storage of the layers' values, the static hydraulic properties
+   * are copies of the layers' soil parameters.
+   */
+  struct SoilColumnArrays
+  {
+    std::vector<StateReal> vs_SoilMoisture_m3;
+    std::vector<StateReal> vs_SoilTemperature;
+    std::vector<StateReal> vs_SOM_Slow;
+    std::vector<StateReal> vs_SOM_Fast;
+    std::vector<StateReal> vs_SMB_Slow;
+    std::vector<StateReal> vs_SMB_Fast;
+    std::vector<StateReal> vs_SoilCarbamid;
+    std::vector<StateReal> vs_SoilNH4;
+    std::vector<StateReal> vs_SoilNO2;
+    std::vector<StateReal> vs_SoilNO3;
+
+    // static properties
+    std::vector<double> vs_LayerThickness;
+    std::vector<double> vs_FieldCapacity;
+    std::vector<double> vs_Saturation;
+    std::vector<double> vs_PermanentWiltingPoint;
+    std::vector<double> vs_Lambda;
+
+    typedef std::pair<StateReal SoilLayerValues::*, std::vector<StateReal> SoilColumnArrays::*> Field;
+    //! all dynamic values with their array, for the loops over all values (copying, binding, serialization)
+    static const std::array<Field, 10>& fields();
+  };
+
+  /**
+   * @brief The state of a soil layer.
+   *
+   * As part of a soil column the values are stored in the column's arrays,
+   * otherwise (e.g. the extra layers of the soil temperature module) in
+   * single element arrays of its own, so that the accessors always just index arrays.
+   * A copied state is always an unbound one, assigning a state writes
+   * the values to wherever the assigned state is stored.
+   */
+  class SoilLayerState
+  {
+  public:
+    SoilLayerState() { makeOwn(SoilLayerValues()); }
+
+    SoilLayerState(const SoilLayerState& other) { makeOwn(other.values()); }
+
+    SoilLayerState& operator=(const SoilLayerState& other)
+    {
+      setValues(other.values());
+      return *this;
+    }
+
+    StateReal& ref(SoilColumnArrays::Field f) { return (_arrays->*f.second)[_index]; }
+    double get(SoilColumnArrays::Field f) const { return (_arrays->*f.second)[_index]; }
+
+    //! the accessors of a single value, the members are template arguments and resolve to fixed offsets
+    template<StateReal SoilLayerValues::* local, std::vector<StateReal> SoilColumnArrays::* array>
+    StateReal& ref() { return (_arrays->*array)[_index]; }
+    template<StateReal SoilLayerValues::* local, std::vector<StateReal> SoilColumnArrays::* array>
+    double get() const { return (_arrays->*array)[_index]; }
+
+    SoilLayerValues values() const;
+    void setValues(const SoilLayerValues& vs);
+
+    //! store the values at index of the column's arrays from now on, they have to hold the current values already
+    void bind(SoilColumnArrays* arrays, std::size_t index) { _arrays = arrays, _index = index, _own.reset(); }
+
+  private:
+    void makeOwn(const SoilLayerValues& vs);
+
+    std::unique_ptr<SoilColumnArrays> _own; //!< the storage of an unbound state
+    SoilColumnArrays* _arrays{nullptr};
+    std::size_t _index{0};
+  };
+
+  //----------------------------------------------------------------------------
+
   /**
    * @author Claas Nendel, Michael Berg
    *
@@ -134,25 +247,57 @@ namespace Monica
     double vs_SoilMoisture_pF();
 
     //! soil ammonium content [kgN m-3]
-    double get_SoilNH4() const { return vs_SoilNH4; }
+    double get_SoilNH4() const { return vs_SoilNH4(); }
 
     //! soil nitrite content [kgN m-3]
-    double get_SoilNO2() const { return vs_SoilNO2; }
+    double get_SoilNO2() const { return vs_SoilNO2(); }
 
     //! soil nitrate content [kgN m-3]
-    double get_SoilNO3() const { return vs_SoilNO3; }
+    double get_SoilNO3() const { return vs_SoilNO3(); }
 
     //! soil carbamide content [kgN m-3]
-    double get_SoilCarbamid() const { return vs_SoilCarbamid; }
+    double get_SoilCarbamid() const { return vs_SoilCarbamid(); }
 
     //! soil mineral N content [kg m-3]
-    double get_SoilNmin() const { return vs_SoilNO3 + vs_SoilNO2 + vs_SoilNH4; }
+    double get_SoilNmin() const { return vs_SoilNO3() + vs_SoilNO2() + vs_SoilNH4(); }
+
+    double get_Vs_SoilMoisture_m3() const { return _state.get<&SoilLayerValues::vs_SoilMoisture_m3, &SoilColumnArrays::vs_SoilMoisture_m3>(); }
+    void set_Vs_SoilMoisture_m3(double ms){ _state.ref<&SoilLayerValues::vs_SoilMoisture_m3, &SoilColumnArrays::vs_SoilMoisture_m3>() = ms; }
+
+    double get_Vs_SoilTemperature() const { return _state.get<&SoilLayerValues::vs_SoilTemperature, &SoilColumnArrays::vs_SoilTemperature>(); }
+    void set_Vs_SoilTemperature(double st){ _state.ref<&SoilLayerValues::vs_SoilTemperature, &SoilColumnArrays::vs_SoilTemperature>() = st; }
+
+    //! C content of soil organic matter slow pool [kg C m-3]
+    StateReal& vs_SOM_Slow() { return _state.ref<&SoilLayerValues::vs_SOM_Slow, &SoilColumnArrays::vs_SOM_Slow>(); }
+    double vs_SOM_Slow() const { return _state.get<&SoilLayerValues::vs_SOM_Slow, &SoilColumnArrays::vs_SOM_Slow>(); }
+
+    //! C content of soil organic matter fast pool size [kg C m-3]
+    StateReal& vs_SOM_Fast() { return _state.ref<&SoilLayerValues::vs_SOM_Fast, &SoilColumnArrays::vs_SOM_Fast>(); }
+    double vs_SOM_Fast() const { return _state.get<&SoilLayerValues::vs_SOM_Fast, &SoilColumnArrays::vs_SOM_Fast>(); }
+
+    //! C content of soil microbial biomass slow pool size [kg C m-3]
+    StateReal& vs_SMB_Slow() { return _state.ref<&SoilLayerValues::vs_SMB_Slow, &SoilColumnArrays::vs_SMB_Slow>(); }
+    double vs_SMB_Slow() const { return _state.get<&SoilLayerValues::vs_SMB_Slow, &SoilColumnArrays::vs_SMB_Slow>(); }
+
+    //! C content of soil microbial biomass fast pool size [kg C m-3]
+    StateReal& vs_SMB_Fast() { return _state.ref<&SoilLayerValues::vs_SMB_Fast, &SoilColumnArrays::vs_SMB_Fast>(); }
+    double vs_SMB_Fast() const { return _state.get<&SoilLayerValues::vs_SMB_Fast, &SoilColumnArrays::vs_SMB_Fast>(); }
+
+    //! Soil layer's carbamide-N content [kg Carbamide-N m-3]
+    StateReal& vs_SoilCarbamid() { return _state.ref<&SoilLayerValues::vs_SoilCarbamid, &SoilColumnArrays::vs_SoilCarbamid>(); }
+    double vs_SoilCarbamid() const { return _state.get<&SoilLayerValues::vs_SoilCarbamid, &SoilColumnArrays::vs_SoilCarbamid>(); }
+
+    //! Soil layer's NH4-N content [kg NH4-N m-3]
+    StateReal& vs_SoilNH4() { return _state.ref<&SoilLayerValues::vs_SoilNH4, &SoilColumnArrays::vs_SoilNH4>(); }
+    double vs_SoilNH4() const { return _state.get<&SoilLayerValues::vs_SoilNH4, &SoilColumnArrays::vs_SoilNH4>(); }
 
-    double get_Vs_SoilMoisture_m3() const { return vs_SoilMoisture_m3; }
-    void set_Vs_SoilMoisture_m3(double ms){ vs_SoilMoisture_m3 = ms; }
+    //! Soil layer's NO2-N content [kg NO2-N m-3]
+    StateReal& vs_SoilNO2() { return _state.ref<&SoilLayerValues::vs_SoilNO2, &SoilColumnArrays::vs_SoilNO2>(); }
+    double vs_SoilNO2() const { return _state.get<&SoilLayerValues::vs_SoilNO2, &SoilColumnArrays::vs_SoilNO2>(); }
 
-    double get_Vs_SoilTemperature() const { return vs_SoilTemperature; }
-    void set_Vs_SoilTemperature(double st){ vs_SoilTemperature = st; }
+    //! Soil layer's NO3-N content [kg NO3-N m-3]
+    StateReal& vs_SoilNO3() { return _state.ref<&SoilLayerValues::vs_SoilNO3, &SoilColumnArrays::vs_SoilNO3>(); }
+    double vs_SoilNO3() const { return _state.get<&SoilLayerValues::vs_SoilNO3, &SoilColumnArrays::vs_SoilNO3>(); }
 
     double vs_SoilSandContent() const { return _sps.vs_SoilSandContent; } //!< Soil layer's sand content [kg kg-1]
     double vs_SoilClayContent() const { return _sps.vs_SoilClayContent; } //!< Soil layer's clay content [kg kg-1] (Ton)
@@ -169,6 +314,10 @@ namespace Monica
 
     double vs_Soil_CN_Ratio() const { return _sps.vs_Soil_CN_Ratio; }
 
+    //! write/read the dynamic state of the layer (see state-io.h)
+    void serialize(std::ostream& out) const;
+    void deserialize(std::istream& in);
+
     // members ------------------------------------------------------------
 
     double vs_LayerThickness; //!< Soil layer's vertical extension [m]
@@ -177,23 +326,14 @@ namespace Monica
 
     std::vector<AOM_Properties> vo_AOM_Pool; //!< List of different added organic matter pools in soil layer
 
-    double vs_SOM_Slow{0.0}; //!< C content of soil organic matter slow pool [kg C m-3]
-    double vs_SOM_Fast{0.0}; //!< C content of soil organic matter fast pool size [kg C m-3]
-    double vs_SMB_Slow{0.0}; //!< C content of soil microbial biomass slow pool size [kg C m-3]
-    double vs_SMB_Fast{0.0}; //!< C content of soil microbial biomass fast pool size [kg C m-3]
-
-    // anorganische Stickstoff-Formen
-    double vs_SoilCarbamid{0.0}; //!< Soil layer's carbamide-N content [kg Carbamide-N m-3]
-    double vs_SoilNH4{0.0001}; //!< Soil layer's NH4-N content [kg NH4-N m-3]
-    double vs_SoilNO2{0.001}; //!< Soil layer's NO2-N content [kg NO2-N m-3]
-    double vs_SoilNO3{0.0001}; //!< Soil layer's NO3-N content [kg NO3-N m-3]
     bool vs_SoilFrozen{false};
 
   private:
+    friend class SoilColumn;
+
     Soil::SoilParameters _sps;
 
-    double vs_SoilMoisture_m3{0.25}; //!< Soil layer's moisture content [m3 m-3]
-    double vs_SoilTemperature{0.0}; //!< Soil layer's temperature [°C]
+    SoilLayerState _state; //!< moisture, temperature, SOM/SMB pools and N species
   };
 
   //----------------------------------------------------------------------------
@@ -210,14 +350,51 @@ namespace Monica
    * @see Monica::SoilLayer
    *
    */
-  class SoilColumn : public std::vector<SoilLayer>
+  class SoilColumn : private std::vector<SoilLayer>
   {
+    typedef std::vector<SoilLayer> Layers;
+
   public:
+    //! read and iterate the layers, the number of layers can't be changed from outside,
+    //! because the layers' values live in the column's arrays
+    using Layers::value_type;
+    using Layers::size_type;
+    using Layers::reference;
+    using Layers::const_reference;
+    using Layers::iterator;
+    using Layers::const_iterator;
+    using Layers::reverse_iterator;
+    using Layers::const_reverse_iterator;
+    using Layers::size;
+    using Layers::empty;
+    using Layers::at;
+    using Layers::operator[];
+    using Layers::front;
+    using Layers::back;
+    using Layers::begin;
+    using Layers::end;
+    using Layers::cbegin;
+    using Layers::cend;
+    using Layers::rbegin;
+    using Layers::rend;
+
     SoilColumn(double ps_LayerThickness,
                double ps_MaxMineralisationDepth,
                const Soil::SoilPMsPtr soilParams,
                double pm_CriticalMoistureDepth);
 
+    //! the copy's layers refer to the copy's own arrays
+    SoilColumn(const SoilColumn& other);
+    SoilColumn& operator=(const SoilColumn& other);
+
+    //! contiguous per layer state, the layers' values live in here
+    SoilColumnArrays& arrays() { return _arrays; }
+    const SoilColumnArrays& arrays() const { return _arrays; }
+
+    //! derived static properties of the profile the column was created from (see soil-profile-cache.h)
+    const SoilProfileProperties& profileProperties() const { return *_profileProperties; }
+    const SoilProfilePropertiesPtr& profilePropertiesPtr() const { return _profileProperties; }
+
     void applyMineralFertiliser(MineralFertiliserParameters fertiliserPartition,
                                 double amount);
 
@@ -246,6 +423,9 @@ namespace Monica
     void applyIrrigation(double vi_IrrigationAmount,
                          double vi_IrrigationNConcentration);
     void deleteAOMPool();
+    std::pair<int, double> coalesceAOMPools(bool mergeEquivalent,
+                                            std::size_t maxPools,
+                                            int minDaysAfterApplication);
 
 
     /**
@@ -293,9 +473,22 @@ namespace Monica
 
 	void clearTopDressingParams() { _vf_TopDressing = 0.0, _vf_TopDressingDelay = 0; }
 
+    bool hasDelayedNMinApplications() const { return !_delayedNMinApplications.empty(); }
+
+    //! write/read the dynamic state of all layers and the column (see state-io.h)
+    void serialize(std::ostream& out) const;
+    bool deserialize(std::istream& in);
+
   private:
     int calculateNumberOfOrganicLayers();
 
+    //! (re)create the arrays from the layers' current values and let the layers refer to them,
+    //! has to be called whenever layers are added or removed
+    void bindLayers();
+
+    SoilColumnArrays _arrays;
+    SoilProfilePropertiesPtr _profileProperties;
+
     double ps_MaxMineralisationDepth{0.4};
 
     int _vs_NumberOfOrganicLayers{0}; //!< Number of organic layers.
@@ -305,7 +498,19 @@ namespace Monica
 
     CropGrowth* cropGrowth{nullptr};
 
-    std::list<std::function<double()>> _delayedNMinApplications;
+    //! arguments of an NMin fertiliser application postponed to the next day
+    struct DelayedNMinApplication
+    {
+      MineralFertiliserParameters fp;
+      double samplingDepth{0.0};
+      double cropNTarget{0.0};
+      double cropNTarget30{0.0};
+      double fertiliserMinApplication{0.0};
+      double fertiliserMaxApplication{0.0};
+      int topDressingDelay{0};
+    };
+    //! plain data (no callbacks), so they stay valid in a copied column and are part of a checkpoint
+    std::list<DelayedNMinApplication> _delayedNMinApplications;
 
     double pm_CriticalMoistureDepth;
   };
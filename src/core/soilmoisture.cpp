@@ -27,9 +27,9 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 #include "soilcolumn.h"
 #include "crop-growth.h"
 #include "monica-model.h"
+#include "state-io.h"
 #include "tools/debug.h"
 #include "tools/algorithms.h"
-#include "soil/conversion.h"
 
 using namespace std;
 using namespace Monica;
@@ -92,6 +92,19 @@ SnowComponent::calcSnowLayer(double mean_air_temperature, double net_precipitati
     double net_precipitation_water = 0.0;
     net_precipitation = calcNetPrecipitation(mean_air_temperature, net_precipitation, net_precipitation_water, net_precipitation_snow);
 
+    // without a snow pack and without snowfall there is no melt, no refreeze and
+    // nothing retained, so all precipitation infiltrates and the state stays zero
+    if (net_precipitation_snow == 0.0
+        && vm_SnowDepth == 0.0
+        && vm_SnowDensity == 0.0
+        && vm_FrozenWaterInSnow == 0.0
+        && vm_LiquidWaterInSnow == 0.0) {
+      soilColumn.vm_SnowDepth = 0.0;
+      vm_WaterToInfiltrate = net_precipitation;
+      vm_SkippedDays++;
+      return;
+    }
+
     // Calculate snowmelt
     double vm_Snowmelt = calcSnowMelt(mean_air_temperature);
 
@@ -384,6 +397,14 @@ FrostComponent::FrostComponent(SoilColumn& sc,
  */
 void FrostComponent::calcSoilFrost(double mean_air_temperature, double snow_depth)
 {
+  // an unfrozen soil without accumulated negative degree days stays so,
+  // as long as it doesn't freeze (temperature under snow equals air temperature then)
+  if (_unfrozen && mean_air_temperature >= 0.0) {
+    vm_TemperatureUnderSnow = mean_air_temperature;
+    vm_SkippedDays++;
+    return;
+  }
+
   // calculation of mean values
   double mean_field_capacity = getMeanFieldCapacity();
   double mean_bulk_density = getMeanBulkDensity();
@@ -404,6 +425,13 @@ void FrostComponent::calcSoilFrost(double mean_air_temperature, double snow_dept
   vm_ThawDepth = calcThawDepth(vm_TemperatureUnderSnow, heat_conductivity_unfrozen, mean_field_capacity);
 
   updateLambdaRedux();
+
+  // updateLambdaRedux resets all layers to thawed if there is no frost left
+  _unfrozen = vm_FrostDepth == 0.0
+              && vm_ThawDepth == 0.0
+              && vm_NegativeDegreeDays == 0.0
+              && vm_FrostDays == 0
+              && soilColumn.vs_NumberOfLayers() > 0;
 }
 
 
@@ -610,6 +638,26 @@ FrostComponent::updateLambdaRedux()
 {
   auto vs_number_of_layers = soilColumn.vs_NumberOfLayers();
 
+  // no more frost, because all layers are thawing
+  // (frost and thaw depth don't change while going through the layers, so the
+  // whole column is reset at the first layer already, overwriting that layer's state)
+  if (vm_ThawDepth >= vm_FrostDepth) {
+    if (vs_number_of_layers > 0) {
+      vm_ThawDepth = 0.0;
+      vm_FrostDepth = 0.0;
+      vm_NegativeDegreeDays = 0.0;
+      vm_FrostDays = 0;
+
+      vm_HydraulicConductivityRedux = pm_HydraulicConductivityRedux;
+      for (int i_Layer = 0; i_Layer < vs_number_of_layers; i_Layer++)
+      {
+        soilColumn[i_Layer].vs_SoilFrozen = false;
+        vm_LambdaRedux[i_Layer] = 1.0;
+      }
+    }
+    return;
+  }
+
   for (int i_Layer = 0; i_Layer < vs_number_of_layers; i_Layer++) {
 
     if (i_Layer < (std::floor((vm_FrostDepth / soilColumn[i_Layer].vs_LayerThickness) + 0.5))) {
@@ -643,21 +691,6 @@ FrostComponent::updateLambdaRedux()
         }
       }
     }
-
-    // no more frost, because all layers are thawing
-    if (vm_ThawDepth >= vm_FrostDepth) {
-      vm_ThawDepth = 0.0;
-      vm_FrostDepth = 0.0;
-      vm_NegativeDegreeDays = 0.0;
-      vm_FrostDays = 0;
-
-      vm_HydraulicConductivityRedux = pm_HydraulicConductivityRedux;
-      for (int i_Layer = 0; i_Layer < vs_number_of_layers; i_Layer++)
-      {
-        soilColumn[i_Layer].vs_SoilFrozen = false;
-        vm_LambdaRedux[i_Layer] = 1.0;
-      }
-    }
   }
 }
 
@@ -692,6 +725,7 @@ SoilMoisture::SoilMoisture(MonicaModel& mm)
   , vm_HeatConductivity(vm_NumberOfLayers, 0)
   , vm_Lambda(vm_NumberOfLayers, 0.0)
   , vs_Latitude(siteParameters.vs_Latitude)
+  , _solarGeometry(solarGeometry(siteParameters.vs_Latitude))
   , vm_LayerThickness(vm_NumberOfLayers, 0.01)
   , vm_PermanentWiltingPoint(vm_NumberOfLayers, 0.0)
   , vm_PercolationRate(vm_NumberOfLayers, 0.0) // Percolation rate in [mm d-1] //intern
@@ -717,10 +751,41 @@ SoilMoisture::SoilMoisture(MonicaModel& mm)
 
   pm_LeachingDepthLayer = int(std::floor(0.5 + (pm_LeachingDepth / pm_LayerThickness))) - 1;
 
+  // the water flow runs daily, so use kernels for a fixed number of layers if there are some
+  switch (vs_NumberOfLayers) {
+  case 20:
+    _fm_Percolation = &SoilMoisture::fm_Percolation<20>;
+    _fm_CapillaryRise = &SoilMoisture::fm_CapillaryRise<20>;
+    break;
+  case 30:
+    _fm_Percolation = &SoilMoisture::fm_Percolation<30>;
+    _fm_CapillaryRise = &SoilMoisture::fm_CapillaryRise<30>;
+    break;
+  default:
+    _fm_Percolation = &SoilMoisture::fm_Percolation<0>;
+    _fm_CapillaryRise = &SoilMoisture::fm_CapillaryRise<0>;
+  }
+
   for (int i=0; i<vm_NumberOfLayers; i++) {
     vm_SaturatedHydraulicConductivity.resize(vm_NumberOfLayers, smPs.pm_SaturatedHydraulicConductivity); // original [8640 mm d-1]
   }
 
+  // capillary rise rates are defined down to 2.70 m groundwater distance (see fm_CapillaryRise),
+  // use the shared table if it covers that distance for this layer thickness, else an own one
+  int maxCapillaryRiseDistance = pm_LayerThickness > 0 ? int(2.70 / pm_LayerThickness) + 1 : 0;
+  _capillaryRiseRates = smPs.capillaryRiseRates;
+  if (!_capillaryRiseRates || _capillaryRiseRates->maxDistance() < maxCapillaryRiseDistance)
+    _capillaryRiseRates = make_shared<CapillaryRiseRateTable>(smPs.getCapillaryRiseRate,
+                                                              max(maxCapillaryRiseDistance, 100));
+
+  // the texture of each layer is resolved once per profile (see soil-profile-cache.h)
+  const auto& textures = soilColumn.profileProperties().vs_KA5Texture;
+  vm_CapillaryRiseRates.resize(vs_NumberOfLayers, nullptr);
+  for (int i_Layer = 0; i_Layer < vs_NumberOfLayers; i_Layer++) {
+    assert(!textures.at(i_Layer).empty());
+    vm_CapillaryRiseRates[i_Layer] = &_capillaryRiseRates->rates(textures.at(i_Layer));
+  }
+
 //  double vm_GroundwaterDepth = 0.0;
 //  for (int i_Layer = 0; i_Layer < vs_NumberOfLayers; i_Layer++) {
 //    vm_GroundwaterDepth += soilColumn[i_Layer].vs_LayerThickness;
@@ -766,17 +831,15 @@ void SoilMoisture::step(double vs_GroundwaterDepth,
                         int vs_JulianDay,
 						double vw_ReferenceEvapotranspiration)
 {	
-  for (int i_Layer = 0; i_Layer < vs_NumberOfLayers; i_Layer++)
-  {
-    // initialization with moisture values stored in the layer
-    vm_SoilMoisture[i_Layer] = soilColumn[i_Layer].get_Vs_SoilMoisture_m3();
-    vm_WaterFlux[i_Layer] = 0.0;
-    vm_FieldCapacity[i_Layer] = soilColumn[i_Layer].vs_FieldCapacity();
-    vm_SoilPoreVolume[i_Layer] = soilColumn[i_Layer].vs_Saturation();
-    vm_PermanentWiltingPoint[i_Layer] = soilColumn[i_Layer].vs_PermanentWiltingPoint();
-    vm_LayerThickness[i_Layer] = soilColumn[i_Layer].vs_LayerThickness;
-    vm_Lambda[i_Layer] = soilColumn[i_Layer].vs_Lambda();
-  }
+  // initialization with moisture values stored in the layer
+  const SoilColumnArrays& sca = soilColumn.arrays();
+  copy_n(sca.vs_SoilMoisture_m3.begin(), vs_NumberOfLayers, vm_SoilMoisture.begin());
+  fill_n(vm_WaterFlux.begin(), vs_NumberOfLayers, 0.0);
+  copy_n(sca.vs_FieldCapacity.begin(), vs_NumberOfLayers, vm_FieldCapacity.begin());
+  copy_n(sca.vs_Saturation.begin(), vs_NumberOfLayers, vm_SoilPoreVolume.begin());
+  copy_n(sca.vs_PermanentWiltingPoint.begin(), vs_NumberOfLayers, vm_PermanentWiltingPoint.begin());
+  copy_n(sca.vs_LayerThickness.begin(), vs_NumberOfLayers, vm_LayerThickness.begin());
+  copy_n(sca.vs_Lambda.begin(), vs_NumberOfLayers, vm_Lambda.begin());
 
 
   vm_SoilMoisture[vm_NumberOfLayers - 1] = soilColumn[vm_NumberOfLayers - 2].get_Vs_SoilMoisture_m3();
@@ -843,27 +906,17 @@ void SoilMoisture::step(double vs_GroundwaterDepth,
   // calculates infiltration of water from surface
   fm_Infiltration(vm_WaterToInfiltrate, vc_PercentageSoilCoverage, vm_GroundwaterTable);
 
-  if ((vs_GroundwaterDepth <= 10.0) && (vs_GroundwaterDepth > 0.0)) {
-
-    fm_PercolationWithGroundwater(vs_GroundwaterDepth);
-    fm_GroundwaterReplenishment();
-
-  } else {
-
-    fm_PercolationWithoutGroundwater();
-    fm_BackwaterReplenishment();
-
-  }
+  (this->*_fm_Percolation)(vs_GroundwaterDepth);
 
   fm_Evapotranspiration(vc_PercentageSoilCoverage, vc_KcFactor, siteParameters.vs_HeightNN, vw_MaxAirTemperature,
       vw_MinAirTemperature, vw_RelativeHumidity, vw_MeanAirTemperature, vw_WindSpeed, vw_WindSpeedHeight,
       vw_GlobalRadiation, vc_DevelopmentalStage, vs_JulianDay, vs_Latitude, vw_ReferenceEvapotranspiration);
 
-  fm_CapillaryRise();
+  (this->*_fm_CapillaryRise)();
 
+  copy_n(vm_SoilMoisture.begin(), vs_NumberOfLayers, soilColumn.arrays().vs_SoilMoisture_m3.begin());
   for (int i_Layer = 0; i_Layer < vs_NumberOfLayers; i_Layer++)
   {
-    soilColumn[i_Layer].set_Vs_SoilMoisture_m3(vm_SoilMoisture[i_Layer]);
     soilColumn[i_Layer].vs_SoilWaterFlux = vm_WaterFlux[i_Layer];
     //commented out because old calc_vs_SoilMoisture_pF algorithm is calcualted every time vs_SoilMoisture_pF is accessed
 //    soilColumn[i_Layer].calc_vs_SoilMoisture_pF();
@@ -1083,7 +1136,10 @@ double SoilMoisture::get_PercolationRate(int layer) const
  * @param vm_GroundwaterTable First layer that contains groundwater
  *
  */
+template<int NoOfLayers>
 void SoilMoisture::fm_CapillaryRise() {
+  // compile time constants for the instantiations for common column sizes
+  const int vs_nols = NoOfLayers > 0 ? NoOfLayers : vs_NumberOfLayers;
 
   int vc_RootingDepth;
   int vm_GroundwaterDistance;
@@ -1101,7 +1157,7 @@ void SoilMoisture::fm_CapillaryRise() {
   if ((double (vm_GroundwaterDistance) * vm_LayerThickness[0]) <= 2.70) { // [m]
   // Capillary rise rates in table defined only until 2.70 m
 
-    for (int i_Layer = 0; i_Layer < vs_NumberOfLayers; i_Layer++) {
+    for (int i_Layer = 0; i_Layer < vs_nols; i_Layer++) {
     // Define capillary water and available water
 
       vm_CapillaryWater[i_Layer] = vm_FieldCapacity[i_Layer]
@@ -1120,15 +1176,12 @@ void SoilMoisture::fm_CapillaryRise() {
     double vm_CapillaryRiseRate = 0.01; //[m d-1]
     double pm_CapillaryRiseRate = 0.01; //[m d-1]
     // Find first layer above groundwater with 70% available water
-    int vm_StartLayer = min(vm_GroundwaterTable,(vs_NumberOfLayers - 1));
+    int vm_StartLayer = min(vm_GroundwaterTable,(vs_nols - 1));
+    int vm_RiseLayer = -1;
     for (int i_Layer = vm_StartLayer; i_Layer >= 0; i_Layer--)
     {
-      std::string vs_SoilTexture = soilColumn[i_Layer].vs_SoilTexture();
-			if (vs_SoilTexture.empty())
-				vs_SoilTexture = Soil::sandAndClay2KA5texture(soilColumn[i_Layer].vs_SoilSandContent(), soilColumn[i_Layer].vs_SoilClayContent());
-		
-			assert(!vs_SoilTexture.empty());
-			pm_CapillaryRiseRate = smPs.getCapillaryRiseRate(vs_SoilTexture, vm_GroundwaterDistance);
+      const std::vector<double>& rates = *vm_CapillaryRiseRates[i_Layer];
+      pm_CapillaryRiseRate = vm_GroundwaterDistance < int(rates.size()) ? rates[vm_GroundwaterDistance] : 0.0;
 
       if(pm_CapillaryRiseRate < vm_CapillaryRiseRate)
       {
@@ -1137,27 +1190,54 @@ void SoilMoisture::fm_CapillaryRise() {
 
       if (vm_AvailableWater[i_Layer] < vm_CapillaryWater70[i_Layer])
       {
-        vm_WaterAddedFromCapillaryRise = vm_CapillaryRiseRate; //[m3 m-2 d-1]
+        vm_RiseLayer = i_Layer;
+        break;
+      }
+    }
+
+    // the water rises only into the first such layer, passing all layers between it and the start layer
+    if (vm_RiseLayer >= 0)
+    {
+      vm_WaterAddedFromCapillaryRise = vm_CapillaryRiseRate; //[m3 m-2 d-1]
 
-        vm_SoilMoisture[i_Layer] += vm_WaterAddedFromCapillaryRise;
+      vm_SoilMoisture[vm_RiseLayer] += vm_WaterAddedFromCapillaryRise;
 
-        for (int j_Layer = vm_StartLayer; j_Layer >= i_Layer; j_Layer--) {
-          vm_WaterFlux[j_Layer] -= vm_WaterAddedFromCapillaryRise;
-        }
-        break;
+      for (int j_Layer = vm_StartLayer; j_Layer >= vm_RiseLayer; j_Layer--) {
+        vm_WaterFlux[j_Layer] -= vm_WaterAddedFromCapillaryRise;
       }
     }
   } // if((double (vm_GroundwaterDistance) * vm_LayerThickness[0]) <= 2.70)
 }
 
+/**
+ * @brief Percolation and replenishment, with or without groundwater influence
+ */
+template<int NoOfLayers>
+void SoilMoisture::fm_Percolation(double vs_GroundwaterDepth) {
+  if ((vs_GroundwaterDepth <= 10.0) && (vs_GroundwaterDepth > 0.0)) {
+
+    fm_PercolationWithGroundwater<NoOfLayers>(vs_GroundwaterDepth);
+    fm_GroundwaterReplenishment<NoOfLayers>();
+
+  } else {
+
+    fm_PercolationWithoutGroundwater<NoOfLayers>();
+    fm_BackwaterReplenishment<NoOfLayers>();
+
+  }
+}
+
 /**
  * @brief Calculation of percolation with groundwater influence
   */
+template<int NoOfLayers>
 void SoilMoisture::fm_PercolationWithGroundwater(double vs_GroundwaterDepth) {
+  const int vs_nols = NoOfLayers > 0 ? NoOfLayers : vs_NumberOfLayers;
+  const int vm_nols = vs_nols + 1;
 
   vm_GroundwaterAdded = 0.0;
 
-  for (int i_Layer = 0; i_Layer < vm_NumberOfLayers - 1; i_Layer++) {
+  for (int i_Layer = 0; i_Layer < vm_nols - 1; i_Layer++) {
 
     if (i_Layer < vm_GroundwaterTable - 1) {
 
@@ -1261,14 +1341,18 @@ void SoilMoisture::fm_PercolationWithGroundwater(double vs_GroundwaterDepth) {
  * @brief Calculation of groundwater replenishment
  *
  */
+template<int NoOfLayers>
 void SoilMoisture::fm_GroundwaterReplenishment()
 {
+  const int vs_nols = NoOfLayers > 0 ? NoOfLayers : vs_NumberOfLayers;
+  const int vm_nols = vs_nols + 1;
+
   // Auffuellschleife von GW-Oberflaeche in Richtung Oberflaeche
   int vm_StartLayer = vm_GroundwaterTable;
 
-  if (vm_StartLayer > vm_NumberOfLayers - 2)
+  if (vm_StartLayer > vm_nols - 2)
   {
-    vm_StartLayer = vm_NumberOfLayers - 2;
+    vm_StartLayer = vm_nols - 2;
   }
 
   for (int i_Layer = vm_StartLayer; i_Layer >= 0; i_Layer--)
@@ -1330,11 +1414,15 @@ void SoilMoisture::fm_GroundwaterReplenishment()
 /**
  * @brief Calculation of percolation without groundwater influence
  */
+template<int NoOfLayers>
 void SoilMoisture::fm_PercolationWithoutGroundwater() {
+  const int vs_nols = NoOfLayers > 0 ? NoOfLayers : vs_NumberOfLayers;
+  const int vm_nols = vs_nols + 1;
+
   double vm_PercolationFactor;
   double vm_LambdaReduced;
 
-  for (int i_Layer = 0; i_Layer < vm_NumberOfLayers - 1; i_Layer++) {
+  for (int i_Layer = 0; i_Layer < vm_nols - 1; i_Layer++) {
 
     vm_SoilMoisture[i_Layer + 1] += vm_PercolationRate[i_Layer] / 1000.0 / vm_LayerThickness[i_Layer];
 
@@ -1372,10 +1460,10 @@ void SoilMoisture::fm_PercolationWithoutGroundwater() {
 
   } // for
 
-  if ((pm_LeachingDepthLayer > 0) && (pm_LeachingDepthLayer < (vm_NumberOfLayers - 1))) {
+  if ((pm_LeachingDepthLayer > 0) && (pm_LeachingDepthLayer < (vm_nols - 1))) {
     vm_FluxAtLowerBoundary = vm_WaterFlux[pm_LeachingDepthLayer];
   } else {
-    vm_FluxAtLowerBoundary = vm_WaterFlux[vm_NumberOfLayers - 2];
+    vm_FluxAtLowerBoundary = vm_WaterFlux[vm_nols - 2];
   }
 }
 
@@ -1383,13 +1471,17 @@ void SoilMoisture::fm_PercolationWithoutGroundwater() {
  * @brief Calculation of backwater replenishment
  *
  */
+template<int NoOfLayers>
 void SoilMoisture::fm_BackwaterReplenishment() {
-  int vm_StartLayer = vm_NumberOfLayers - 1;
-  int vm_BackwaterTable = vm_NumberOfLayers - 1;
+  const int vs_nols = NoOfLayers > 0 ? NoOfLayers : vs_NumberOfLayers;
+  const int vm_nols = vs_nols + 1;
+
+  int vm_StartLayer = vm_nols - 1;
+  int vm_BackwaterTable = vm_nols - 1;
   double vm_BackwaterAdded = 0.0;
 
   // find first layer from top where the water content exceeds pore volume
-  for (int i_Layer = 0; i_Layer < vm_NumberOfLayers - 1; i_Layer++) {
+  for (int i_Layer = 0; i_Layer < vm_nols - 1; i_Layer++) {
     if (vm_SoilMoisture[i_Layer] > vm_SoilPoreVolume[i_Layer]) {
       vm_StartLayer = i_Layer;
       vm_BackwaterTable = i_Layer;
@@ -1493,7 +1585,7 @@ void SoilMoisture::fm_Evapotranspiration(double vc_PercentageSoilCoverage, doubl
 	if (vw_ReferenceEvapotranspiration < 0.0) {		
 		vm_ReferenceEvapotranspiration = ReferenceEvapotranspiration(vs_HeightNN, vw_MaxAirTemperature,
 			vw_MinAirTemperature, vw_RelativeHumidity, vw_MeanAirTemperature, vw_WindSpeed, vw_WindSpeedHeight,
-			vw_GlobalRadiation, vs_JulianDay, vs_Latitude);
+			vw_GlobalRadiation, vs_JulianDay, *_solarGeometry);
 	}
 	else {
 		// use reference evapotranspiration from climate file		
@@ -1651,21 +1743,13 @@ void SoilMoisture::fm_Evapotranspiration(double vc_PercentageSoilCoverage, doubl
  * @param vw_WindSpeed
  * @param vw_WindSpeedHeight
  * @param vw_GlobalRadiation
+ * @param vs_JulianDay
+ * @param solarGeometry the run's solar geometry at the site's latitude
  * @return
  */
 double SoilMoisture::ReferenceEvapotranspiration(double vs_HeightNN, double vw_MaxAirTemperature,
     double vw_MinAirTemperature, double vw_RelativeHumidity, double vw_MeanAirTemperature, double vw_WindSpeed,
-    double vw_WindSpeedHeight, double vw_GlobalRadiation, int vs_JulianDay, double vs_Latitude) {
-
-  double vc_Declination;
-  double vc_DeclinationSinus; // old SINLD
-  double vc_DeclinationCosinus; // old COSLD
-  double vc_AstronomicDayLenght;
-  double vc_EffectiveDayLenght;
-  double vc_PhotoperiodicDaylength;
-  double vc_PhotActRadiationMean;
-  double vc_ClearDayRadiation;
-  double vc_OvercastDayRadiation;
+    double vw_WindSpeedHeight, double vw_GlobalRadiation, int vs_JulianDay, const SolarGeometry& solarGeometry) {
 
   double vm_AtmosphericPressure; //[kPA]
   double vm_PsycrometerConstant; //[kPA °C-1]
@@ -1678,45 +1762,10 @@ double SoilMoisture::ReferenceEvapotranspiration(double vs_HeightNN, double vw_M
   double vm_WindSpeed_2m; //[m s-1]
   double vm_AerodynamicResistance; //[s m-1]
   double vm_SurfaceResistance; //[s m-1]
-  double vc_ExtraterrestrialRadiation;
   double vm_ReferenceEvapotranspiration; //[mm]
   double pc_ReferenceAlbedo = cropPs.pc_ReferenceAlbedo; // FAO Green gras reference albedo from Allen et al. (1998)
-  double PI = 3.14159265358979323;
-
-  vc_Declination = -23.4 * cos(2.0 * PI * ((vs_JulianDay + 10.0) / 365.0));
-  vc_DeclinationSinus = sin(vc_Declination * PI / 180.0) * sin(vs_Latitude * PI / 180.0);
-  vc_DeclinationCosinus = cos(vc_Declination * PI / 180.0) * cos(vs_Latitude * PI / 180.0);
-  
-  double arg_AstroDayLength = vc_DeclinationSinus / vc_DeclinationCosinus;
-  arg_AstroDayLength = bound(-1.0, arg_AstroDayLength, 1.0); //The argument of asin must be in the range of -1 to 1  
-  vc_AstronomicDayLenght = 12.0 * (PI + 2.0 * asin(arg_AstroDayLength)) / PI;
-  
-  double arg_EffectiveDayLength = (-sin(8.0 * PI / 180.0) + vc_DeclinationSinus) / vc_DeclinationCosinus;
-  arg_EffectiveDayLength = bound(-1.0, arg_EffectiveDayLength, 1.0); //The argument of asin must be in the range of -1 to 1
-  vc_EffectiveDayLenght = 12.0 * (PI + 2.0 * asin(arg_EffectiveDayLength)) / PI;
-  
-  double arg_PhotoDayLength = (-sin(-6.0 * PI / 180.0) + vc_DeclinationSinus) / vc_DeclinationCosinus;
-  arg_PhotoDayLength = bound(-1.0, arg_PhotoDayLength, 1.0); //The argument of asin must be in the range of -1 to 1
-  vc_PhotoperiodicDaylength = 12.0 * (PI + 2.0 * asin(arg_PhotoDayLength)) / PI;
-  
-  double arg_PhotAct = min(1.0,((vc_DeclinationSinus / vc_DeclinationCosinus) * (vc_DeclinationSinus / vc_DeclinationCosinus))); //The argument of sqrt must be >= 0
-  vc_PhotActRadiationMean = 3600.0 * (vc_DeclinationSinus * vc_AstronomicDayLenght + 24.0 / PI * vc_DeclinationCosinus
-      * sqrt(1.0 - arg_PhotAct));
-  
-  
-  vc_ClearDayRadiation = 0;
-  if (vc_PhotActRadiationMean > 0 && vc_AstronomicDayLenght > 0)
-  {
-	  vc_ClearDayRadiation = 0.5 * 1300.0 * vc_PhotActRadiationMean * exp(-0.14 / (vc_PhotActRadiationMean
-		  / (vc_AstronomicDayLenght * 3600.0)));
-  }
 
-  vc_OvercastDayRadiation = 0.2 * vc_ClearDayRadiation;
-  double SC = 24.0 * 60.0 / PI * 8.20 *(1.0 + 0.033 * cos(2.0 * PI * vs_JulianDay / 365.0));
-  double arg_SHA = bound(-1.0, -tan(vs_Latitude * PI / 180.0) * tan(vc_Declination * PI / 180.0), 1.0); //The argument of acos must be in the range of -1 to 1
-  double SHA = acos(arg_SHA);
-  
-  vc_ExtraterrestrialRadiation = SC * (SHA * vc_DeclinationSinus + vc_DeclinationCosinus * sin(SHA)) / 100.0; // [J cm-2] --> [MJ m-2]
+  double vc_ExtraterrestrialRadiation = solarGeometry.day(vs_JulianDay).vm_ExtraterrestrialRadiation; // [MJ m-2]
 
   // Calculation of atmospheric pressure
   vm_AtmosphericPressure = 101.3 * pow(((293.0 - (0.0065 * vs_HeightNN)) / 293.0), 5.26);
@@ -2015,3 +2064,179 @@ void SoilMoisture::remove_Crop() {
   crop = NULL;
 }
 
+//------------------------------------------------------------------------------
+
+void SnowComponent::serialize(std::ostream& out) const
+{
+	using namespace StateIO;
+	write(out, vm_SnowDensity);
+	write(out, vm_SnowDepth);
+	write(out, vm_FrozenWaterInSnow);
+	write(out, vm_LiquidWaterInSnow);
+	write(out, vm_WaterToInfiltrate);
+	write(out, vm_maxSnowDepth);
+	write(out, vm_AccumulatedSnowDepth);
+	write(out, vm_SkippedDays);
+}
+
+void SnowComponent::deserialize(std::istream& in)
+{
+	using namespace StateIO;
+	read(in, vm_SnowDensity);
+	read(in, vm_SnowDepth);
+	read(in, vm_FrozenWaterInSnow);
+	read(in, vm_LiquidWaterInSnow);
+	read(in, vm_WaterToInfiltrate);
+	read(in, vm_maxSnowDepth);
+	read(in, vm_AccumulatedSnowDepth);
+	read(in, vm_SkippedDays);
+}
+
+void FrostComponent::serialize(std::ostream& out) const
+{
+	using namespace StateIO;
+	write(out, vm_FrostDepth);
+	write(out, vm_accumulatedFrostDepth);
+	write(out, vm_NegativeDegreeDays);
+	write(out, vm_ThawDepth);
+	write(out, vm_FrostDays);
+	write(out, vm_LambdaRedux);
+	write(out, vm_TemperatureUnderSnow);
+	write(out, vm_HydraulicConductivityRedux);
+	write(out, vm_SkippedDays);
+}
+
+void FrostComponent::deserialize(std::istream& in)
+{
+	using namespace StateIO;
+	read(in, vm_FrostDepth);
+	read(in, vm_accumulatedFrostDepth);
+	read(in, vm_NegativeDegreeDays);
+	read(in, vm_ThawDepth);
+	read(in, vm_FrostDays);
+	read(in, vm_LambdaRedux);
+	read(in, vm_TemperatureUnderSnow);
+	read(in, vm_HydraulicConductivityRedux);
+	read(in, vm_SkippedDays);
+	_unfrozen = false;
+}
+
+void SoilMoisture::serialize(std::ostream& out) const
+{
+	using namespace StateIO;
+	write(out, vm_ActualEvaporation);
+	write(out, vm_ActualEvapotranspiration);
+	write(out, vm_ActualTranspiration);
+	write(out, vm_AvailableWater);
+	write(out, vm_CapillaryRise);
+	write(out, pm_CapillaryRiseRate);
+	write(out, vm_CapillaryWater);
+	write(out, vm_CapillaryWater70);
+	write(out, vm_Evaporation);
+	write(out, vm_Evapotranspiration);
+	write(out, vm_FieldCapacity);
+	write(out, vm_FluxAtLowerBoundary);
+	write(out, vm_GravitationalWater);
+	write(out, vm_GrossPrecipitation);
+	write(out, vm_GroundwaterAdded);
+	write(out, vm_GroundwaterDischarge);
+	write(out, vm_GroundwaterTable);
+	write(out, vm_HeatConductivity);
+	write(out, vm_HydraulicConductivityRedux);
+	write(out, vm_Infiltration);
+	write(out, vm_Interception);
+	write(out, vc_KcFactor);
+	write(out, vm_Lambda);
+	write(out, vm_LambdaReduced);
+	write(out, vm_LayerThickness);
+	write(out, vw_MaxAirTemperature);
+	write(out, vw_MeanAirTemperature);
+	write(out, vw_MinAirTemperature);
+	write(out, vc_NetPrecipitation);
+	write(out, vw_NetRadiation);
+	write(out, vm_PermanentWiltingPoint);
+	write(out, vc_PercentageSoilCoverage);
+	write(out, vm_PercolationRate);
+	write(out, vw_Precipitation);
+	write(out, vm_ReferenceEvapotranspiration);
+	write(out, vw_RelativeHumidity);
+	write(out, vm_ResidualEvapotranspiration);
+	write(out, vm_SaturatedHydraulicConductivity);
+	write(out, vm_SoilMoisture);
+	write(out, vm_SoilMoisture_crit);
+	write(out, vm_SoilMoistureDeficit);
+	write(out, vm_SoilPoreVolume);
+	write(out, vc_StomataResistance);
+	write(out, vm_SurfaceRunOff);
+	write(out, vm_SumSurfaceRunOff);
+	write(out, vm_SurfaceWaterStorage);
+	write(out, vm_TotalWaterRemoval);
+	write(out, vm_Transpiration);
+	write(out, vm_TranspirationDeficit);
+	write(out, vm_WaterFlux);
+	write(out, vw_WindSpeed);
+	write(out, vw_WindSpeedHeight);
+	write(out, vm_XSACriticalSoilMoisture);
+	snowComponent.serialize(out);
+	frostComponent.serialize(out);
+}
+
+void SoilMoisture::deserialize(std::istream& in)
+{
+	using namespace StateIO;
+	read(in, vm_ActualEvaporation);
+	read(in, vm_ActualEvapotranspiration);
+	read(in, vm_ActualTranspiration);
+	read(in, vm_AvailableWater);
+	read(in, vm_CapillaryRise);
+	read(in, pm_CapillaryRiseRate);
+	read(in, vm_CapillaryWater);
+	read(in, vm_CapillaryWater70);
+	read(in, vm_Evaporation);
+	read(in, vm_Evapotranspiration);
+	read(in, vm_FieldCapacity);
+	read(in, vm_FluxAtLowerBoundary);
+	read(in, vm_GravitationalWater);
+	read(in, vm_GrossPrecipitation);
+	read(in, vm_GroundwaterAdded);
+	read(in, vm_GroundwaterDischarge);
+	read(in, vm_GroundwaterTable);
+	read(in, vm_HeatConductivity);
+	read(in, vm_HydraulicConductivityRedux);
+	read(in, vm_Infiltration);
+	read(in, vm_Interception);
+	read(in, vc_KcFactor);
+	read(in, vm_Lambda);
+	read(in, vm_LambdaReduced);
+	read(in, vm_LayerThickness);
+	read(in, vw_MaxAirTemperature);
+	read(in, vw_MeanAirTemperature);
+	read(in, vw_MinAirTemperature);
+	read(in, vc_NetPrecipitation);
+	read(in, vw_NetRadiation);
+	read(in, vm_PermanentWiltingPoint);
+	read(in, vc_PercentageSoilCoverage);
+	read(in, vm_PercolationRate);
+	read(in, vw_Precipitation);
+	read(in, vm_ReferenceEvapotranspiration);
+	read(in, vw_RelativeHumidity);
+	read(in, vm_ResidualEvapotranspiration);
+	read(in, vm_SaturatedHydraulicConductivity);
+	read(in, vm_SoilMoisture);
+	read(in, vm_SoilMoisture_crit);
+	read(in, vm_SoilMoistureDeficit);
+	read(in, vm_SoilPoreVolume);
+	read(in, vc_StomataResistance);
+	read(in, vm_SurfaceRunOff);
+	read(in, vm_SumSurfaceRunOff);
+	read(in, vm_SurfaceWaterStorage);
+	read(in, vm_TotalWaterRemoval);
+	read(in, vm_Transpiration);
+	read(in, vm_TranspirationDeficit);
+	read(in, vm_WaterFlux);
+	read(in, vw_WindSpeed);
+	read(in, vw_WindSpeedHeight);
+	read(in, vm_XSACriticalSoilMoisture);
+	snowComponent.deserialize(in);
+	frostComponent.deserialize(in);
+}
@@ -23,9 +23,11 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
  */
 
 #include <vector>
+#include <iostream>
 
 #include "monica-parameters.h"
 #include "crop-growth.h"
+#include "solar-geometry.h"
 
 namespace Monica 
 {
@@ -57,6 +59,11 @@ namespace Monica
       double getWaterToInfiltrate() const { return this->vm_WaterToInfiltrate; }
       double getMaxSnowDepth() const {return this->vm_maxSnowDepth; }
       double getAccumulatedSnowDepth() const {return this->vm_AccumulatedSnowDepth; }
+      //! Returns the number of days skipped, because there was neither snow nor snowfall
+      int getSkippedDays() const { return vm_SkippedDays; }
+
+      void serialize(std::ostream& out) const;
+      void deserialize(std::istream& in);
 
     private:
       double calcSnowMelt(double vw_MeanAirTemperature);
@@ -77,6 +84,7 @@ namespace Monica
       double vm_WaterToInfiltrate; //!< [mm]
       double vm_maxSnowDepth;     //!< [mm]
       double vm_AccumulatedSnowDepth; //!< [mm]
+      int vm_SkippedDays{0};
 
       // extern or user defined snow parameter
       double vm_SnowmeltTemperature;                  //!< Base temperature for snowmelt [°C]
@@ -114,6 +122,11 @@ namespace Monica
       double getLambdaRedux(int layer) const { return vm_LambdaRedux[layer]; }
       double getAccumulatedFrostDepth() const { return vm_accumulatedFrostDepth; }
       double getTemperatureUnderSnow() const { return vm_TemperatureUnderSnow; }
+      //! Returns the number of days skipped, because the soil was unfrozen and it didn't freeze
+      int getSkippedDays() const { return vm_SkippedDays; }
+
+      void serialize(std::ostream& out) const;
+      void deserialize(std::istream& in);
 
     private:
       double getMeanBulkDensity();
@@ -134,6 +147,10 @@ namespace Monica
       int vm_FrostDays{0};
       std::vector<double> vm_LambdaRedux; //!< Reduction factor for Lambda []
       double vm_TemperatureUnderSnow{0.0};
+      int vm_SkippedDays{0};
+      //! true if the last calculation left no frost and all layers thawed
+      //! (not part of the state, so after a restore one day is calculated fully again)
+      bool _unfrozen{false};
 
 
       // user defined or data base parameter
@@ -230,6 +247,10 @@ namespace Monica
 
 		double getTemperatureUnderSnow() const;
 
+    //! Returns the number of days the snow resp. frost calculation was skipped
+    int getSnowSkippedDays() const { return snowComponent.getSkippedDays(); }
+    int getFrostSkippedDays() const { return frostComponent.getSkippedDays(); }
+
     double get_EReducer_1(int i_Layer,
                           double vm_PercentageSoilCoverage,
                           double vm_PotentialEvapotranspiration);
@@ -247,14 +268,23 @@ namespace Monica
     double get_DeprivationFactor(int layerNo, double deprivationDepth,
                                  double zeta, double vs_LayerThickness);
 
+    //! the water flow kernels for NoOfLayers layers, 0 means any number of layers
+    template<int NoOfLayers = 0>
     void fm_CapillaryRise();
 
+    template<int NoOfLayers = 0>
+    void fm_Percolation(double vs_GroundwaterDepth);
+
+    template<int NoOfLayers = 0>
     void fm_PercolationWithGroundwater(double vs_GroundwaterDepth);
 
+    template<int NoOfLayers = 0>
     void fm_GroundwaterReplenishment();
 
+    template<int NoOfLayers = 0>
     void fm_PercolationWithoutGroundwater();
 
+    template<int NoOfLayers = 0>
     void fm_BackwaterReplenishment();
 
     void fm_Evapotranspiration(double vc_PercentageSoilCoverage,
@@ -281,7 +311,7 @@ namespace Monica
                                        double vw_WindSpeedHeight,
                                        double vw_NetRadiation,
                                        int vs_JulianDay,
-                                       double vs_Latitude);
+                                       const SolarGeometry& solarGeometry);
 
     double meanWaterContent(double depth_m) const;
     double meanWaterContent(int layer, int number_of_layers) const;
@@ -294,6 +324,10 @@ namespace Monica
     double get_KcFactor() const;
     double get_TranspirationDeficit() const;
 
+    //! write/read the water balance state incl. snow and frost (see state-io.h)
+    void serialize(std::ostream& out) const;
+    void deserialize(std::istream& in);
+
   private:
     SoilColumn& soilColumn;
     const SiteParameters& siteParameters;
@@ -303,6 +337,9 @@ namespace Monica
     const UserCropParameters& cropPs;
 		const int vm_NumberOfLayers{0};
 		const int vs_NumberOfLayers{0};
+		//! the variants of the water flow kernels for vs_NumberOfLayers
+		void (SoilMoisture::*_fm_Percolation)(double){nullptr};
+		void (SoilMoisture::*_fm_CapillaryRise)(){nullptr};
 
 		double vm_ActualEvaporation{0.0}; //!< Sum of evaporation of all layers [mm]
 		double vm_ActualEvapotranspiration{0.0}; //!< Sum of evaporation and transpiration of all layers [mm]
@@ -310,6 +347,8 @@ namespace Monica
     std::vector<double> vm_AvailableWater; //!< Soil available water in [mm]
 		double vm_CapillaryRise{0.0}; //!< Capillary rise [mm]
     std::vector<double> pm_CapillaryRiseRate; //!< Capillary rise rate from database in dependence of groundwater distance and texture [m d-1]
+    std::shared_ptr<const CapillaryRiseRateTable> _capillaryRiseRates; //!< keeps the rate table alive
+    std::vector<const std::vector<double>*> vm_CapillaryRiseRates; //!< per layer the rates by groundwater distance, resolved once from the layer's texture
     std::vector<double> vm_CapillaryWater; //!< soil capillary water in [mm]
     std::vector<double> vm_CapillaryWater70; //!< 70% of soil capillary water in [mm]
     std::vector<double> vm_Evaporation; //!< Evaporation of layer [mm]
@@ -332,6 +371,7 @@ namespace Monica
     std::vector<double> vm_Lambda; //!< Empirical soil water conductivity parameter []
 		double vm_LambdaReduced{0.0};
 		double vs_Latitude{0.0};
+		SolarGeometryPtr _solarGeometry; //!< day length and radiation at vs_Latitude
     std::vector<double> vm_LayerThickness;
 		double pm_LayerThickness{0.0};
 		double pm_LeachingDepth{0.0};
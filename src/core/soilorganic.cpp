@@ -28,6 +28,7 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 #include "soilcolumn.h"
 #include "monica-model.h"
 #include "crop-growth.h"
+#include "state-io.h"
 #include "tools/debug.h"
 #include "soil/constants.h"
 #include "tools/algorithms.h"
@@ -69,7 +70,9 @@ SoilOrganic::SoilOrganic(SoilColumn& sc,
   vo_SMB_SlowDelta(sc.vs_NumberOfOrganicLayers()),
   vo_SoilOrganicC(sc.vs_NumberOfOrganicLayers()),
   vo_SOM_FastDelta(sc.vs_NumberOfOrganicLayers()),
-  vo_SOM_SlowDelta(sc.vs_NumberOfOrganicLayers()) {
+  vo_SOM_SlowDelta(sc.vs_NumberOfOrganicLayers()),
+  _soilProfile(sc.profilePropertiesPtr()),
+  _sticsLayers(sc.vs_NumberOfOrganicLayers()) {
   // Subroutine Pool initialisation
   double po_SOM_SlowUtilizationEfficiency = organicPs.po_SOM_SlowUtilizationEfficiency;
   double po_PartSOM_to_SMB_Slow = organicPs.po_PartSOM_to_SMB_Slow;
@@ -96,22 +99,22 @@ SoilOrganic::SoilOrganic(SoilColumn& sc,
     vo_SoilOrganicC[i_Layer] -= vo_InertSoilOrganicC[i_Layer]; // [kg C m-3]
 
     // Initialisation of pool SMB_Slow [kg C m-3]
-    soilColumn[i_Layer].vs_SMB_Slow = po_SOM_SlowUtilizationEfficiency
+    soilColumn[i_Layer].vs_SMB_Slow() = po_SOM_SlowUtilizationEfficiency
       * po_PartSOM_to_SMB_Slow * vo_SoilOrganicC[i_Layer];
 
     // Initialisation of pool SMB_Fast [kg C m-3]
-    soilColumn[i_Layer].vs_SMB_Fast = po_SOM_FastUtilizationEfficiency
+    soilColumn[i_Layer].vs_SMB_Fast() = po_SOM_FastUtilizationEfficiency
       * po_PartSOM_to_SMB_Fast * vo_SoilOrganicC[i_Layer];
 
     // Initialisation of pool SOM_Slow [kg C m-3]
-    soilColumn[i_Layer].vs_SOM_Slow = vo_SoilOrganicC[i_Layer] / (1.0 + po_SOM_SlowDecCoeffStandard
+    soilColumn[i_Layer].vs_SOM_Slow() = vo_SoilOrganicC[i_Layer] / (1.0 + po_SOM_SlowDecCoeffStandard
                                                                   / (po_SOM_FastDecCoeffStandard * po_PartSOM_Fast_to_SOM_Slow));
 
     // Initialisation of pool SOM_Fast [kg C m-3]
-    soilColumn[i_Layer].vs_SOM_Fast = vo_SoilOrganicC[i_Layer] - soilColumn[i_Layer].vs_SOM_Slow;
+    soilColumn[i_Layer].vs_SOM_Fast() = vo_SoilOrganicC[i_Layer] - soilColumn[i_Layer].vs_SOM_Slow();
 
     // Soil Organic Matter pool update [kg C m-3]
-    vo_SoilOrganicC[i_Layer] -= soilColumn[i_Layer].vs_SMB_Slow + soilColumn[i_Layer].vs_SMB_Fast;
+    vo_SoilOrganicC[i_Layer] -= soilColumn[i_Layer].vs_SMB_Slow() + soilColumn[i_Layer].vs_SMB_Fast();
 
     soilColumn[i_Layer].set_SoilOrganicCarbon
     ((vo_SoilOrganicC[i_Layer] + vo_InertSoilOrganicC[i_Layer])
@@ -125,6 +128,22 @@ SoilOrganic::SoilOrganic(SoilColumn& sc,
 
     vo_ActDenitrificationRate.at(i_Layer) = 0.0;
   } // for
+
+  auto nools = vs_NumberOfOrganicLayers;
+  vo_ClayOnDecomposition.resize(nools);
+  vo_SoilMoisture_pF.resize(nools);
+  for (size_t i = 0; i < nools; i++) {
+    vo_ClayOnDecomposition[i] = fo_ClayOnDecompostion(soilColumn[i].vs_SoilClayContent(), organicPs.po_LimitClayEffect);
+  }
+
+  if (organicPs.po_ApproximateResponseFunctions) {
+    _tempResponseAbove20 = InterpolationTable(fo_TempResponseAbove20, 20.0, 70.0, 1.0,
+                                              organicPs.po_ResponseFunctionTolerance);
+    if (_tempResponseAbove20.maxError() > organicPs.po_ResponseFunctionTolerance) {
+      cerr << "SoilOrganic: tabulated temperature response misses the tolerance "
+        << organicPs.po_ResponseFunctionTolerance << " (error: " << _tempResponseAbove20.maxError() << ")" << endl;
+    }
+  }
 }
 
 /**
@@ -142,11 +161,23 @@ void SoilOrganic::step(double vw_MeanAirTemperature, double vw_Precipitation,
   //cout << "get_OrganBiomass(organ) : " << organ << ", " << organ_percentage << std::endl; // JV!
   //cout << "total_biomass : " << total_biomass << std::endl; // JV!
 
+  if (organicPs.po_AOM_CoalescePools || organicPs.po_AOM_MaxPools > 0) {
+    auto merged = soilColumn.coalesceAOMPools(organicPs.po_AOM_CoalescePools,
+                                              size_t(max(0, organicPs.po_AOM_MaxPools)),
+                                              organicPs.po_AOM_CoalesceMinDaysAfterApplication);
+    vo_AOM_CoalescedPools += merged.first;
+    vo_AOM_CoalescingError += merged.second;
+  }
+
   //fo_OM_Input(vo_AOM_Addition);
+  fo_UpdateSoilMoisture_pF();
   fo_Urea(vw_Precipitation + irrigationAmount);
   // Mineralisation Immobilisitation Turn-Over
   fo_MIT();
   fo_Volatilisation(addedOrganicMatter, vw_MeanAirTemperature, vw_WindSpeed);
+
+  const auto& sps = organicPs.sticsParams;
+  if (sps.use_nit || sps.use_denit || sps.use_n2o) fo_stics_GatherLayers();
   
   if (organicPs.sticsParams.use_nit) fo_stics_Nitrification();
   else fo_Nitrification();
@@ -270,7 +301,7 @@ void SoilOrganic::addOrganicMatter(OrganicMatterParametersPtr params,
 			if(p.first < nools)
 			{
 				// kg N m-3 soil
-				soilColumn[p.first].vs_SoilCarbamid +=
+				soilColumn[p.first].vs_SoilCarbamid() +=
 					p.second
 					* params->vo_AOM_DryMatterContent
 					* params->vo_AOM_CarbamidContent
@@ -380,9 +411,9 @@ void SoilOrganic::addOrganicMatter(OrganicMatterParametersPtr params,
 			* added_Corg_amount;
 
 		// immediate top layer pool update
-		soilColumn[intoLayerIndex].vs_SoilNH4 += soil_NH4_input;
-		soilColumn[intoLayerIndex].vs_SoilNO3 += soil_NO3_input;
-		soilColumn[intoLayerIndex].vs_SOM_Fast += SOM_FastInput;
+		soilColumn[intoLayerIndex].vs_SoilNH4() += soil_NH4_input;
+		soilColumn[intoLayerIndex].vs_SoilNO3() += soil_NO3_input;
+		soilColumn[intoLayerIndex].vs_SOM_Fast() += SOM_FastInput;
 
 		// store for further use
 		vo_AOM_SlowInput += AOM_slow_input;
@@ -457,7 +488,6 @@ void SoilOrganic::fo_Urea(double vo_RainIrrigation) {
   std::vector<double> vo_HydrolysisRate1(nools, 0.0); // [kg N d-1]
   std::vector<double> vo_HydrolysisRate2(nools, 0.0); // [kg N d-1]
   std::vector<double> vo_HydrolysisRateMax(nools, 0.0); // [kg N d-1]
-  std::vector<double> vo_Hydrolysis_pH_Effect(nools, 0.0);// []
   std::vector<double> vo_HydrolysisRate(nools, 0.0); // [kg N d-1]
   double vo_H3OIonConcentration = 0.0; // Oxonium ion concentration in soil solution [kmol m-3]
   double vo_NH3aq_EquilibriumConst = 0.0; // []
@@ -477,7 +507,7 @@ void SoilOrganic::fo_Urea(double vo_RainIrrigation) {
   for (int i_Layer = 0; i_Layer < soilColumn.vs_NumberOfOrganicLayers(); i_Layer++) {
 
     // kmol urea m-3 soil
-    vo_SoilCarbamid_solid[i_Layer] = soilColumn[i_Layer].vs_SoilCarbamid /
+    vo_SoilCarbamid_solid[i_Layer] = soilColumn[i_Layer].vs_SoilCarbamid() /
       OrganicConstants::po_UreaMolecularWeight /
       OrganicConstants::po_Urea_to_N / 1000.0;
 
@@ -515,14 +545,10 @@ void SoilOrganic::fo_Urea(double vo_RainIrrigation) {
     vo_HydrolysisRateMax[i_Layer] = vo_HydrolysisRate2[i_Layer] * exp(-po_ActivationEnergy /
       (8.314 * (soilColumn[i_Layer].get_Vs_SoilTemperature() + 273.15)));
 
-    vo_Hydrolysis_pH_Effect[i_Layer] = exp(-0.064 *
-      ((soilColumn[i_Layer].vs_SoilpH() - 6.5) *
-                                           (soilColumn[i_Layer].vs_SoilpH() - 6.5)));
-
     // kmol urea kg soil-1 s-1
     vo_HydrolysisRate[i_Layer] = vo_HydrolysisRateMax[i_Layer] *
-      fo_MoistOnHydrolysis(soilColumn[i_Layer].vs_SoilMoisture_pF()) *
-      vo_Hydrolysis_pH_Effect[i_Layer] * vo_SoilCarbamid_aq[i_Layer] /
+      fo_MoistOnHydrolysis(vo_SoilMoisture_pF[i_Layer]) *
+      _soilProfile->vo_Hydrolysis_pH_Effect[i_Layer] * vo_SoilCarbamid_aq[i_Layer] /
       (po_HydrolysisKM + vo_SoilCarbamid_aq[i_Layer]);
 
     // kmol urea m soil-3 d-1
@@ -531,18 +557,18 @@ void SoilOrganic::fo_Urea(double vo_RainIrrigation) {
 
     if (vo_HydrolysisRate[i_Layer] >= vo_SoilCarbamid_aq[i_Layer]) {
 
-      soilColumn[i_Layer].vs_SoilNH4 += soilColumn[i_Layer].vs_SoilCarbamid;
-      soilColumn[i_Layer].vs_SoilCarbamid = 0.0;
+      soilColumn[i_Layer].vs_SoilNH4() += soilColumn[i_Layer].vs_SoilCarbamid();
+      soilColumn[i_Layer].vs_SoilCarbamid() = 0.0;
 
     } else {
 
       // kg N m soil-3
-      soilColumn[i_Layer].vs_SoilCarbamid -= vo_HydrolysisRate[i_Layer] *
+      soilColumn[i_Layer].vs_SoilCarbamid() -= vo_HydrolysisRate[i_Layer] *
         OrganicConstants::po_UreaMolecularWeight *
         OrganicConstants::po_Urea_to_N * 1000.0;
 
       // kg N m soil-3
-      soilColumn[i_Layer].vs_SoilNH4 += vo_HydrolysisRate[i_Layer] *
+      soilColumn[i_Layer].vs_SoilNH4() += vo_HydrolysisRate[i_Layer] *
         OrganicConstants::po_UreaMolecularWeight *
         OrganicConstants::po_Urea_to_N * 1000.0;
     }
@@ -559,7 +585,7 @@ void SoilOrganic::fo_Urea(double vo_RainIrrigation) {
         (soilColumn[0].get_Vs_SoilTemperature() + 273.15)) - 2.301));  // K1 in Sadeghi's program
 
 // kmol m-3, assuming that all NH4 is solved
-      vs_SoilNH4aq = soilColumn[0].vs_SoilNH4 / (OrganicConstants::po_NH4MolecularWeight * 1000.0);
+      vs_SoilNH4aq = soilColumn[0].vs_SoilNH4() / (OrganicConstants::po_NH4MolecularWeight * 1000.0);
 
 
       // kmol m-3
@@ -577,13 +603,13 @@ void SoilOrganic::fo_Urea(double vo_RainIrrigation) {
       vo_NH3_Volatilising = vo_NH3gas * OrganicConstants::po_NH3MolecularWeight * 1000.0;
 
 
-      if (vo_NH3_Volatilising >= soilColumn[0].vs_SoilNH4) {
+      if (vo_NH3_Volatilising >= soilColumn[0].vs_SoilNH4()) {
 
-        vo_NH3_Volatilising = soilColumn[0].vs_SoilNH4;
-        soilColumn[0].vs_SoilNH4 = 0.0;
+        vo_NH3_Volatilising = soilColumn[0].vs_SoilNH4();
+        soilColumn[0].vs_SoilNH4() = 0.0;
 
       } else {
-        soilColumn[0].vs_SoilNH4 -= vo_NH3_Volatilising;
+        soilColumn[0].vs_SoilNH4() -= vo_NH3_Volatilising;
       }
 
       // kg N m-2 d-1
@@ -617,7 +643,6 @@ void SoilOrganic::fo_MIT() {
   double po_SMB_SlowMaintRateStandard = organicPs.po_SMB_SlowMaintRateStandard;
   double po_SMB_FastDeathRateStandard = organicPs.po_SMB_FastDeathRateStandard;
   double po_SMB_FastMaintRateStandard = organicPs.po_SMB_FastMaintRateStandard;
-  double po_LimitClayEffect = organicPs.po_LimitClayEffect;
   double po_SOM_SlowUtilizationEfficiency = organicPs.po_SOM_SlowUtilizationEfficiency;
   double po_SOM_FastUtilizationEfficiency = organicPs.po_SOM_FastUtilizationEfficiency;
   double po_PartSOM_Fast_to_SOM_Slow = organicPs.po_PartSOM_Fast_to_SOM_Slow;
@@ -727,91 +752,69 @@ void SoilOrganic::fo_MIT() {
   // Sum of all changes to soil organic matter slow pool [kg C m-3]
   //std::vector<double> vo_SOM_SlowDeltaSum(nools, 0.0);
 
-  // Calculation of decay rate coefficients
+  // Calculation of decay rate coefficients, pool changes by decomposition and N balance.
+  // Everything below only depends on the layer itself, so it is done in a single sweep
+  // over the layers, which keeps the layer's pools in cache for both pool passes.
 
   for (int i_Layer = 0; i_Layer < nools; i_Layer++) {
     double tod = fo_TempOnDecompostion(soilColumn[i_Layer].get_Vs_SoilTemperature());
-    double mod = fo_MoistOnDecompostion(soilColumn[i_Layer].vs_SoilMoisture_pF());
+    double mod = fo_MoistOnDecompostion(vo_SoilMoisture_pF[i_Layer]);
 
     vo_SOM_SlowDecCoeff[i_Layer] = po_SOM_SlowDecCoeffStandard * tod * mod;
     vo_SOM_FastDecCoeff[i_Layer] = po_SOM_FastDecCoeffStandard * tod * mod;
-    vo_SOM_SlowDecRate[i_Layer] = vo_SOM_SlowDecCoeff[i_Layer] * soilColumn[i_Layer].vs_SOM_Slow;
-    vo_SOM_FastDecRate[i_Layer] = vo_SOM_FastDecCoeff[i_Layer] * soilColumn[i_Layer].vs_SOM_Fast;
+    vo_SOM_SlowDecRate[i_Layer] = vo_SOM_SlowDecCoeff[i_Layer] * soilColumn[i_Layer].vs_SOM_Slow();
+    vo_SOM_FastDecRate[i_Layer] = vo_SOM_FastDecCoeff[i_Layer] * soilColumn[i_Layer].vs_SOM_Fast();
 
     vo_SMB_SlowMaintRateCoeff[i_Layer] = po_SMB_SlowMaintRateStandard
-      * fo_ClayOnDecompostion(soilColumn[i_Layer].vs_SoilClayContent(),
-                              po_LimitClayEffect) * tod * mod;
+      * vo_ClayOnDecomposition[i_Layer] * tod * mod;
 
     vo_SMB_FastMaintRateCoeff[i_Layer] = po_SMB_FastMaintRateStandard * tod * mod;
 
-    vo_SMB_SlowMaintRate[i_Layer] = vo_SMB_SlowMaintRateCoeff[i_Layer] * soilColumn[i_Layer].vs_SMB_Slow;
-    vo_SMB_FastMaintRate[i_Layer] = vo_SMB_FastMaintRateCoeff[i_Layer] * soilColumn[i_Layer].vs_SMB_Fast;
+    vo_SMB_SlowMaintRate[i_Layer] = vo_SMB_SlowMaintRateCoeff[i_Layer] * soilColumn[i_Layer].vs_SMB_Slow();
+    vo_SMB_FastMaintRate[i_Layer] = vo_SMB_FastMaintRateCoeff[i_Layer] * soilColumn[i_Layer].vs_SMB_Fast();
     vo_SMB_SlowDeathRateCoeff[i_Layer] = po_SMB_SlowDeathRateStandard * tod * mod;
     vo_SMB_FastDeathRateCoeff[i_Layer] = po_SMB_FastDeathRateStandard * tod * mod;
-    vo_SMB_SlowDeathRate[i_Layer] = vo_SMB_SlowDeathRateCoeff[i_Layer] * soilColumn[i_Layer].vs_SMB_Slow;
-    vo_SMB_FastDeathRate[i_Layer] = vo_SMB_FastDeathRateCoeff[i_Layer] * soilColumn[i_Layer].vs_SMB_Fast;
+    vo_SMB_SlowDeathRate[i_Layer] = vo_SMB_SlowDeathRateCoeff[i_Layer] * soilColumn[i_Layer].vs_SMB_Slow();
+    vo_SMB_FastDeathRate[i_Layer] = vo_SMB_FastDeathRateCoeff[i_Layer] * soilColumn[i_Layer].vs_SMB_Fast();
 
     vo_SMB_SlowDecRate[i_Layer] = vo_SMB_SlowDeathRate[i_Layer] + vo_SMB_SlowMaintRate[i_Layer];
     vo_SMB_FastDecRate[i_Layer] = vo_SMB_FastDeathRate[i_Layer] + vo_SMB_FastMaintRate[i_Layer];
 
+    // single pass over the layer's pools, the sums are accumulated in locals
+    // in pool order, so the results are the same as with one loop per quantity
+    double slowDecRateSum = 0.0, slowToSMBfast = 0.0, slowToSMBslow = 0.0;
+    double fastDecRateSum = 0.0, slowDeltaSum = 0.0, fastDeltaSum = 0.0;
     for (AOM_Properties& AOM_Pool : soilColumn[i_Layer].vo_AOM_Pool) {
-      AOM_Pool.vo_AOM_SlowDecCoeff = AOM_Pool.vo_AOM_SlowDecCoeffStandard * tod * mod;
-      AOM_Pool.vo_AOM_FastDecCoeff = AOM_Pool.vo_AOM_FastDecCoeffStandard * tod * mod;
-    }
-  } // for
+      const double slowDecCoeff = AOM_Pool.vo_AOM_SlowDecCoeff = AOM_Pool.vo_AOM_SlowDecCoeffStandard * tod * mod;
+      const double fastDecCoeff = AOM_Pool.vo_AOM_FastDecCoeff = AOM_Pool.vo_AOM_FastDecCoeffStandard * tod * mod;
+      const double slow = AOM_Pool.vo_AOM_Slow;
+      const double fast = AOM_Pool.vo_AOM_Fast;
 
-  // Calculation of pool changes by decomposition
-  for (int i_Layer = 0; i_Layer < nools; i_Layer++) {
-    for (AOM_Properties& AOM_Pool : soilColumn[i_Layer].vo_AOM_Pool) {
       // Eq.6-5 and 6-6 in the DAISY manual
-      AOM_Pool.vo_AOM_SlowDelta = -(AOM_Pool.vo_AOM_SlowDecCoeff * AOM_Pool.vo_AOM_Slow);
-
-      if (-AOM_Pool.vo_AOM_SlowDelta > AOM_Pool.vo_AOM_Slow)
-        AOM_Pool.vo_AOM_SlowDelta = (-AOM_Pool.vo_AOM_Slow);
-
-      AOM_Pool.vo_AOM_FastDelta = -(AOM_Pool.vo_AOM_FastDecCoeff * AOM_Pool.vo_AOM_Fast);
-
-      if (-AOM_Pool.vo_AOM_FastDelta > AOM_Pool.vo_AOM_Fast)
-        AOM_Pool.vo_AOM_FastDelta = (-AOM_Pool.vo_AOM_Fast);
-    }
-
-    // Eq.6-7 in the DAISY manual
-    vo_AOM_SlowDecRateSum[i_Layer] = 0.0;
-
-    for (AOM_Properties& AOM_Pool : soilColumn[i_Layer].vo_AOM_Pool) {
-      AOM_Pool.vo_AOM_SlowDecRate_to_SMB_Slow = AOM_Pool.vo_PartAOM_Slow_to_SMB_Slow
-        * AOM_Pool.vo_AOM_SlowDecCoeff * AOM_Pool.vo_AOM_Slow;
-
-      AOM_Pool.vo_AOM_SlowDecRate_to_SMB_Fast = AOM_Pool.vo_PartAOM_Slow_to_SMB_Fast
-        * AOM_Pool.vo_AOM_SlowDecCoeff * AOM_Pool.vo_AOM_Slow;
-
-      vo_AOM_SlowDecRateSum[i_Layer] += AOM_Pool.vo_AOM_SlowDecRate_to_SMB_Slow
-        + AOM_Pool.vo_AOM_SlowDecRate_to_SMB_Fast;
-
-      AOMslow_to_SMBfast[i_Layer] += AOM_Pool.vo_AOM_SlowDecRate_to_SMB_Fast;
-      AOMslow_to_SMBslow[i_Layer] += AOM_Pool.vo_AOM_SlowDecRate_to_SMB_Slow;
-    }
-
-    // Eq.6-8 in the DAISY manual
-    vo_AOM_FastDecRateSum[i_Layer] = 0.0;
-
-    AOMfast_to_SMBfast[i_Layer] = 0.0;
-
-    for (AOM_Properties& AOM_Pool : soilColumn[i_Layer].vo_AOM_Pool) {
-      //AOM_Pool.vo_AOM_FastDecRate_to_SMB_Slow = AOM_Pool.vo_PartAOM_Slow_to_SMB_Slow
-      //	* AOM_Pool.vo_AOM_FastDecCoeff * AOM_Pool.vo_AOM_Fast;
-
-      //AOM_Pool.vo_AOM_FastDecRate_to_SMB_Fast = AOM_Pool.vo_PartAOM_Slow_to_SMB_Fast
-      //	* AOM_Pool.vo_AOM_FastDecCoeff * AOM_Pool.vo_AOM_Fast;
-
-      AOM_Pool.vo_AOM_FastDecRate_to_SMB_Fast = AOM_Pool.vo_AOM_FastDecCoeff * AOM_Pool.vo_AOM_Fast;
-
-      //vo_AOM_FastDecRateSum[i_Layer] += AOM_Pool.vo_AOM_FastDecRate_to_SMB_Slow
-      //	+ AOM_Pool.vo_AOM_FastDecRate_to_SMB_Fast;
-      vo_AOM_FastDecRateSum[i_Layer] += AOM_Pool.vo_AOM_FastDecRate_to_SMB_Fast;
-
-      AOMfast_to_SMBfast[i_Layer] += AOM_Pool.vo_AOM_FastDecRate_to_SMB_Fast;
+      const double slowDelta = AOM_Pool.vo_AOM_SlowDelta = std::max(-(slowDecCoeff * slow), -slow);
+      const double fastDelta = AOM_Pool.vo_AOM_FastDelta = std::max(-(fastDecCoeff * fast), -fast);
+
+      // Eq.6-7 in the DAISY manual
+      const double slowToSlow = AOM_Pool.vo_AOM_SlowDecRate_to_SMB_Slow = AOM_Pool.vo_PartAOM_Slow_to_SMB_Slow * slowDecCoeff * slow;
+      const double slowToFast = AOM_Pool.vo_AOM_SlowDecRate_to_SMB_Fast = AOM_Pool.vo_PartAOM_Slow_to_SMB_Fast * slowDecCoeff * slow;
+
+      // Eq.6-8 in the DAISY manual
+      const double fastToFast = AOM_Pool.vo_AOM_FastDecRate_to_SMB_Fast = fastDecCoeff * fast;
+
+      slowDecRateSum += slowToSlow + slowToFast;
+      slowToSMBfast += slowToFast;
+      slowToSMBslow += slowToSlow;
+      fastDecRateSum += fastToFast;
+      slowDeltaSum += slowDelta;
+      fastDeltaSum += fastDelta;
     }
+    vo_AOM_SlowDecRateSum[i_Layer] = slowDecRateSum;
+    AOMslow_to_SMBfast[i_Layer] = slowToSMBfast;
+    AOMslow_to_SMBslow[i_Layer] = slowToSMBslow;
+    vo_AOM_FastDecRateSum[i_Layer] = fastDecRateSum;
+    AOMfast_to_SMBfast[i_Layer] = fastDecRateSum;
+    vo_AOM_SlowDeltaSum[i_Layer] = slowDeltaSum;
+    vo_AOM_FastDeltaSum[i_Layer] = fastDeltaSum;
 
     vo_SMB_SlowDelta[i_Layer] = (po_SOM_SlowUtilizationEfficiency * vo_SOM_SlowDecRate[i_Layer])
       + (po_SOM_FastUtilizationEfficiency * (1.0 - po_PartSOM_Fast_to_SOM_Slow) * vo_SOM_FastDecRate[i_Layer])
@@ -832,8 +835,8 @@ void SoilOrganic::fo_MIT() {
     vo_SOM_SlowDelta[i_Layer] = po_PartSOM_Fast_to_SOM_Slow * vo_SOM_FastDecRate[i_Layer]
       - vo_SOM_SlowDecRate[i_Layer];
 
-    if ((soilColumn[i_Layer].vs_SOM_Slow + vo_SOM_SlowDelta[i_Layer]) < 0.0)
-      vo_SOM_SlowDelta[i_Layer] = soilColumn[i_Layer].vs_SOM_Slow;
+    if ((soilColumn[i_Layer].vs_SOM_Slow() + vo_SOM_SlowDelta[i_Layer]) < 0.0)
+      vo_SOM_SlowDelta[i_Layer] = soilColumn[i_Layer].vs_SOM_Slow();
 
     // Eq.6-10 in the DAISY manual
     //vo_SOM_FastDelta[i_Layer] = po_PartSMB_Slow_to_SOM_Fast
@@ -844,25 +847,13 @@ void SoilOrganic::fo_MIT() {
       + po_PartSMB_Fast_to_SOM_Fast * vo_SMB_FastDeathRate[i_Layer]
       - vo_SOM_FastDecRate[i_Layer];
 
-    if ((soilColumn[i_Layer].vs_SOM_Fast + vo_SOM_FastDelta[i_Layer]) < 0.0)
-      vo_SOM_FastDelta[i_Layer] = soilColumn[i_Layer].vs_SOM_Fast;
+    if ((soilColumn[i_Layer].vs_SOM_Fast() + vo_SOM_FastDelta[i_Layer]) < 0.0)
+      vo_SOM_FastDelta[i_Layer] = soilColumn[i_Layer].vs_SOM_Fast();
 
-    vo_AOM_SlowDeltaSum[i_Layer] = 0.0;
-    vo_AOM_FastDeltaSum[i_Layer] = 0.0;
-
-    for (AOM_Properties& AOM_Pool : soilColumn[i_Layer].vo_AOM_Pool) {
-      vo_AOM_SlowDeltaSum[i_Layer] += AOM_Pool.vo_AOM_SlowDelta;
-      vo_AOM_FastDeltaSum[i_Layer] += AOM_Pool.vo_AOM_FastDelta;
-    }
+    // Calculation of N balance
+    //vo_CN_Ratio_SOM_Slow = siteParams.vs_Soil_CN_Ratio;
+    //vo_CN_Ratio_SOM_Fast = siteParams.vs_Soil_CN_Ratio;
 
-  } // for i_Layer
-
-
-  // Calculation of N balance
-  //vo_CN_Ratio_SOM_Slow = siteParams.vs_Soil_CN_Ratio;
-  //vo_CN_Ratio_SOM_Fast = siteParams.vs_Soil_CN_Ratio;
-
-  for (int i_Layer = 0; i_Layer < nools; i_Layer++) {
     double vo_CN_Ratio_SOM_Slow = soilColumn.at(i_Layer).vs_Soil_CN_Ratio();
     double vo_CN_Ratio_SOM_Fast = vo_CN_Ratio_SOM_Slow;
 
@@ -871,18 +862,18 @@ void SoilOrganic::fo_MIT() {
       - (vo_SOM_SlowDelta[i_Layer] / vo_CN_Ratio_SOM_Slow)
       - (vo_SOM_FastDelta[i_Layer] / vo_CN_Ratio_SOM_Fast);
 
-    vector<AOM_Properties>& AOM_Pool = soilColumn[i_Layer].vo_AOM_Pool;
+    double nBalance = vo_NBalance[i_Layer];
+    for (const AOM_Properties& AOM_Pool : soilColumn[i_Layer].vo_AOM_Pool) {
 
-    for (vector<AOM_Properties>::iterator it_AOM_Pool = AOM_Pool.begin(); it_AOM_Pool != AOM_Pool.end(); it_AOM_Pool++) {
-
-      if (fabs(it_AOM_Pool->vo_CN_Ratio_AOM_Fast) >= 1.0E-7) {
-        vo_NBalance[i_Layer] -= (it_AOM_Pool->vo_AOM_FastDelta / it_AOM_Pool->vo_CN_Ratio_AOM_Fast);
+      if (fabs(AOM_Pool.vo_CN_Ratio_AOM_Fast) >= 1.0E-7) {
+        nBalance -= (AOM_Pool.vo_AOM_FastDelta / AOM_Pool.vo_CN_Ratio_AOM_Fast);
       } // if
 
-      if (fabs(it_AOM_Pool->vo_CN_Ratio_AOM_Slow) >= 1.0E-7) {
-        vo_NBalance[i_Layer] -= (it_AOM_Pool->vo_AOM_SlowDelta / it_AOM_Pool->vo_CN_Ratio_AOM_Slow);
+      if (fabs(AOM_Pool.vo_CN_Ratio_AOM_Slow) >= 1.0E-7) {
+        nBalance -= (AOM_Pool.vo_AOM_SlowDelta / AOM_Pool.vo_CN_Ratio_AOM_Slow);
       } // if
-    } // for it_AOM_Pool
+    } // for AOM_Pool
+    vo_NBalance[i_Layer] = nBalance;
   } // for i_Layer
 
   // Check for Nmin availablity in case of immobilisation
@@ -896,8 +887,8 @@ void SoilOrganic::fo_MIT() {
 
     if (vo_NBalance[i_Layer] < 0.0) {
 
-      if (fabs(vo_NBalance[i_Layer]) >= ((soilColumn[i_Layer].vs_SoilNH4 * po_ImmobilisationRateCoeffNH4)
-                                         + (soilColumn[i_Layer].vs_SoilNO3 * po_ImmobilisationRateCoeffNO3))) {
+      if (fabs(vo_NBalance[i_Layer]) >= ((soilColumn[i_Layer].vs_SoilNH4() * po_ImmobilisationRateCoeffNH4)
+                                         + (soilColumn[i_Layer].vs_SoilNO3() * po_ImmobilisationRateCoeffNO3))) {
         vo_AOM_SlowDeltaSum[i_Layer] = 0.0;
         vo_AOM_FastDeltaSum[i_Layer] = 0.0;
 
@@ -946,8 +937,8 @@ void SoilOrganic::fo_MIT() {
           //+ (po_AOM_FastUtilizationEfficiency * AOMfast_to_SMBslow)
           - vo_SMB_SlowDecRate[i_Layer];
 
-        if ((soilColumn[i_Layer].vs_SMB_Slow + vo_SMB_SlowDelta[i_Layer]) < 0.0) {
-          vo_SMB_SlowDelta[i_Layer] = soilColumn[i_Layer].vs_SMB_Slow;
+        if ((soilColumn[i_Layer].vs_SMB_Slow() + vo_SMB_SlowDelta[i_Layer]) < 0.0) {
+          vo_SMB_SlowDelta[i_Layer] = soilColumn[i_Layer].vs_SMB_Slow();
         }
 
         vo_SMB_FastDelta[i_Layer] = (po_SMB_UtilizationEfficiency *
@@ -957,8 +948,8 @@ void SoilOrganic::fo_MIT() {
           + (po_AOM_SlowUtilizationEfficiency * AOMslow_to_SMBfast[i_Layer])
           - vo_SMB_FastDecRate[i_Layer];
 
-        if ((soilColumn[i_Layer].vs_SMB_Fast + vo_SMB_FastDelta[i_Layer]) < 0.0) {
-          vo_SMB_FastDelta[i_Layer] = soilColumn[i_Layer].vs_SMB_Fast;
+        if ((soilColumn[i_Layer].vs_SMB_Fast() + vo_SMB_FastDelta[i_Layer]) < 0.0) {
+          vo_SMB_FastDelta[i_Layer] = soilColumn[i_Layer].vs_SMB_Fast();
         }
 
         // Recalculation of N balance under conditions of immobilisation
@@ -983,30 +974,30 @@ void SoilOrganic::fo_MIT() {
         } // for
 
         // Update of Soil NH4 after recalculated N balance
-        soilColumn[i_Layer].vs_SoilNH4 += fabs(vo_NBalance[i_Layer]);
+        soilColumn[i_Layer].vs_SoilNH4() += fabs(vo_NBalance[i_Layer]);
 
 
       } else { //if
        // Bedarf kann durch Ammonium-Pool nicht gedeckt werden --> Nitrat wird verwendet
-        if (fabs(vo_NBalance[i_Layer]) >= (soilColumn[i_Layer].vs_SoilNH4
+        if (fabs(vo_NBalance[i_Layer]) >= (soilColumn[i_Layer].vs_SoilNH4()
                                            * po_ImmobilisationRateCoeffNH4)) {
 
-          soilColumn[i_Layer].vs_SoilNO3 -= fabs(vo_NBalance[i_Layer])
-            - (soilColumn[i_Layer].vs_SoilNH4
+          soilColumn[i_Layer].vs_SoilNO3() -= fabs(vo_NBalance[i_Layer])
+            - (soilColumn[i_Layer].vs_SoilNH4()
                * po_ImmobilisationRateCoeffNH4);
 
-          soilColumn[i_Layer].vs_SoilNH4 -= soilColumn[i_Layer].vs_SoilNH4
+          soilColumn[i_Layer].vs_SoilNH4() -= soilColumn[i_Layer].vs_SoilNH4()
             * po_ImmobilisationRateCoeffNH4;
 
         } else { // if
 
-          soilColumn[i_Layer].vs_SoilNH4 -= fabs(vo_NBalance[i_Layer]);
+          soilColumn[i_Layer].vs_SoilNH4() -= fabs(vo_NBalance[i_Layer]);
         } //else
       } //else
 
     } else { //if (N_Balance[i_Layer]) < 0.0
 
-      soilColumn[i_Layer].vs_SoilNH4 += fabs(vo_NBalance[i_Layer]);
+      soilColumn[i_Layer].vs_SoilNH4() += fabs(vo_NBalance[i_Layer]);
     }
 
     vo_NetNMineralisationRate[i_Layer] = fabs(vo_NBalance[i_Layer])
@@ -1072,7 +1063,7 @@ void SoilOrganic::fo_Volatilisation(bool vo_AOM_Addition, double vw_MeanAirTempe
 
   int vo_DaysAfterApplicationSum = 0;
 
-  if (soilColumn[0].vs_SoilMoisture_pF() > 2.5) {
+  if (vo_SoilMoisture_pF[0] > 2.5) {
     vo_SoilWet = 0.0;
   } else {
     vo_SoilWet = 1.0;
@@ -1134,15 +1125,15 @@ void SoilOrganic::fo_Volatilisation(bool vo_AOM_Addition, double vw_MeanAirTempe
       vo_N_PotVolatilisedSum += vo_N_PotVolatilised;
     }
 
-    if (soilColumn[0].vs_SoilNH4 > (vo_N_PotVolatilisedSum)) {
+    if (soilColumn[0].vs_SoilNH4() > (vo_N_PotVolatilisedSum)) {
       vo_N_ActVolatilised = vo_N_PotVolatilisedSum;
     } else {
-      vo_N_ActVolatilised = soilColumn[0].vs_SoilNH4;
+      vo_N_ActVolatilised = soilColumn[0].vs_SoilNH4();
     }
 
     // update NH4 content of top soil layer with volatilisation balance
 
-    soilColumn[0].vs_SoilNH4 -= (vo_N_ActVolatilised / soilColumn[0].vs_LayerThickness);
+    soilColumn[0].vs_SoilNH4() -= (vo_N_ActVolatilised / soilColumn[0].vs_LayerThickness);
   } else {
     vo_N_ActVolatilised = 0.0;
   }
@@ -1177,75 +1168,91 @@ void SoilOrganic::fo_Nitrification() {
 
   for (int i = 0; i < nools; i++) {
     auto& sci = soilColumn[i];
-    auto NH4i = sci.vs_SoilNH4;
+    auto NH4i = sci.vs_SoilNH4();
 
     // Calculate nitrification rate coefficients
     //  cout << "SO-2:\t" << soilColumn[i_Layer].vs_SoilMoisture_pF() << endl;
     vo_AmmoniaOxidationRateCoeff[i] = 
       po_AmmoniaOxidationRateCoeffStandard 
       * fo_TempOnNitrification(sci.get_Vs_SoilTemperature()) 
-      * fo_MoistOnNitrification(sci.vs_SoilMoisture_pF());
+      * fo_MoistOnNitrification(vo_SoilMoisture_pF[i]);
 
     vo_ActAmmoniaOxidationRate[i] = vo_AmmoniaOxidationRateCoeff[i] * NH4i;
 
     vo_NitriteOxidationRateCoeff[i] = 
       po_NitriteOxidationRateCoeffStandard
       * fo_TempOnNitrification(sci.get_Vs_SoilTemperature())
-      * fo_MoistOnNitrification(sci.vs_SoilMoisture_pF())
+      * fo_MoistOnNitrification(vo_SoilMoisture_pF[i])
       * fo_NH3onNitriteOxidation(NH4i, sci.vs_SoilpH());
 
-    vo_ActNitrificationRate[i] = vo_NitriteOxidationRateCoeff[i] * sci.vs_SoilNO2;
+    vo_ActNitrificationRate[i] = vo_NitriteOxidationRateCoeff[i] * sci.vs_SoilNO2();
 
     // Update NH4, NO2 and NO3 content with nitrification balance
     // Stange, F., C. Nendel (2014): N.N., in preparation
     if (NH4i > vo_ActAmmoniaOxidationRate[i]) {
-      sci.vs_SoilNH4 -= vo_ActAmmoniaOxidationRate[i];
-      sci.vs_SoilNO2 += vo_ActAmmoniaOxidationRate[i];
+      sci.vs_SoilNH4() -= vo_ActAmmoniaOxidationRate[i];
+      sci.vs_SoilNO2() += vo_ActAmmoniaOxidationRate[i];
     } else {
-      sci.vs_SoilNO2 += NH4i;
-      sci.vs_SoilNH4 = 0.0;
+      sci.vs_SoilNO2() += NH4i;
+      sci.vs_SoilNH4() = 0.0;
     }
 
-    if (sci.vs_SoilNO2 > vo_ActNitrificationRate[i]) {
-      sci.vs_SoilNO2 -= vo_ActNitrificationRate[i];
-      sci.vs_SoilNO3 += vo_ActNitrificationRate[i];
+    if (sci.vs_SoilNO2() > vo_ActNitrificationRate[i]) {
+      sci.vs_SoilNO2() -= vo_ActNitrificationRate[i];
+      sci.vs_SoilNO3() += vo_ActNitrificationRate[i];
     } else {
-      sci.vs_SoilNO3 += sci.vs_SoilNO2;
-      sci.vs_SoilNO2 = 0.0;
+      sci.vs_SoilNO3() += sci.vs_SoilNO2();
+      sci.vs_SoilNO2() = 0.0;
     }
   }
 }
 
-void SoilOrganic::fo_stics_Nitrification() {
+void SoilOrganic::fo_stics_GatherLayers() {
   auto nools = soilColumn.vs_NumberOfOrganicLayers();
-  auto sticsParams = organicPs.sticsParams;
+  auto& sl = _sticsLayers;
 
+  // water, temperature and soil properties are not changed by nitrification and denitrification,
+  // so they and the unit conversions are shared by all three STICS routines of a day
   for (int i = 0; i < nools; i++) {
     auto& sci = soilColumn[i];
     auto smi = sci.get_Vs_SoilMoisture_m3(); // m3-water/m3-soil
     auto sbdi = sci.vs_SoilBulkDensity(); // kg-soil/m3-soil
-    auto NH4i = sci.get_SoilNH4();
 
-    auto kgN_per_m3_to_mgN_per_kg = 1000.0 * 1000.0 / sbdi;
-    auto mgN_per_kg_to_kgN_per_m3 = 1 / kgN_per_m3_to_mgN_per_kg;
+    sl.kgN_per_m3_to_mgN_per_kg[i] = 1000.0 * 1000.0 / sbdi;
+    sl.mgN_per_kg_to_kgN_per_m3[i] = 1 / sl.kgN_per_m3_to_mgN_per_kg[i];
+    sl.pH[i] = sci.vs_SoilpH(); // []
+    sl.soilT[i] = sci.get_Vs_SoilTemperature(); // [°C]
+    sl.wfps[i] = smi / sci.vs_Saturation(); // soil water-filled pore space []
+    sl.soilWaterContent[i] = smi * 1000 / sbdi; // gravimetric soil water content kg-water/kg-soil
+    sl.fc[i] = sci.vs_FieldCapacity(); // [m3-water/m3-soil] = []
+    sl.sat[i] = sci.vs_Saturation();
+    sl.corg[i] = sci.vs_SoilOrganicCarbon() * 100.0; // kg-C/kg-soil = % [0-1] -> % [0-100]
+  }
+}
+
+void SoilOrganic::fo_stics_Nitrification() {
+  auto nools = soilColumn.vs_NumberOfOrganicLayers();
+  auto& sl = _sticsLayers;
+
+  for (int i = 0; i < nools; i++) {
+    sl.NH4[i] = soilColumn[i].get_SoilNH4() * sl.kgN_per_m3_to_mgN_per_kg[i]; // kg-NH4-N/m3-soil -> mg-NH4-N/kg-soil
+  }
+
+  stics::vnit(organicPs.sticsParams, nools, sl.NH4.data(), sl.pH.data(), sl.soilT.data(), sl.wfps.data(),
+              sl.soilWaterContent.data(), sl.fc.data(), sl.sat.data(), sl.rate.data());
+
+  for (int i = 0; i < nools; i++) {
+    auto& sci = soilColumn[i];
+    auto NH4i = sci.get_SoilNH4();
 
-    vo_ActNitrificationRate[i] =
-      stics::vnit(sticsParams,
-                  NH4i * kgN_per_m3_to_mgN_per_kg, // kg-NH4-N/m3-soil -> mg-NH4-N/kg-soil)
-                  sci.vs_SoilpH(), // []
-                  sci.get_Vs_SoilTemperature(), // [°C]
-                  smi / sci.vs_Saturation(), // soil water-filled pore space []
-                  smi * 1000 / sbdi, // gravimetric soil water content kg-water/kg-soil
-                  sci.vs_FieldCapacity(), // [m3-water/m3-soil] = []
-                  sci.vs_Saturation())
-      * mgN_per_kg_to_kgN_per_m3; // mg-N -> kg-N;
+    vo_ActNitrificationRate[i] = sl.rate[i] * sl.mgN_per_kg_to_kgN_per_m3[i]; // mg-N -> kg-N
 
     if (NH4i > vo_ActNitrificationRate[i]) {
-      sci.vs_SoilNH4 -= vo_ActNitrificationRate[i];
-      sci.vs_SoilNO3 += vo_ActNitrificationRate[i];
+      sci.vs_SoilNH4() -= vo_ActNitrificationRate[i];
+      sci.vs_SoilNO3() += vo_ActNitrificationRate[i];
     } else {
-      sci.vs_SoilNO3 += NH4i;
-      sci.vs_SoilNH4 = 0.0;
+      sci.vs_SoilNO3() += NH4i;
+      sci.vs_SoilNH4() = 0.0;
     }
   }
 }
@@ -1262,7 +1269,7 @@ void SoilOrganic::fo_Denitrification() {
 
   for (int i = 0; i < nools; i++) {
     auto& sci = soilColumn[i];
-    auto NO3i = sci.vs_SoilNO3;
+    auto NO3i = sci.vs_SoilNO3();
 
     //Temperature function is the same as in Nitrification subroutine
     vo_PotDenitrificationRate[i] = po_SpecAnaerobDenitrification
@@ -1276,10 +1283,10 @@ void SoilOrganic::fo_Denitrification() {
   
     // update NO3 content of soil layer with denitrification balance [kg N m-3]
     if (NO3i > vo_ActDenitrificationRate[i]) {
-      sci.vs_SoilNO3 -= vo_ActDenitrificationRate[i];
+      sci.vs_SoilNO3() -= vo_ActDenitrificationRate[i];
     } else {
       vo_ActDenitrificationRate[i] = NO3i;
-      sci.vs_SoilNO3 = 0.0;
+      sci.vs_SoilNO3() = 0.0;
     }
 
     vo_TotalDenitrification += vo_ActDenitrificationRate[i] * sci.vs_LayerThickness; // [kg m-3] --> [kg m-2] ;
@@ -1290,34 +1297,29 @@ void SoilOrganic::fo_Denitrification() {
 
 void SoilOrganic::fo_stics_Denitrification() {
   auto nools = soilColumn.vs_NumberOfOrganicLayers();
-  auto sticsParams = organicPs.sticsParams;
+  auto& sl = _sticsLayers;
   vo_TotalDenitrification = 0.0;
+
+  for (int i = 0; i < nools; i++) {
+    sl.NO3[i] = soilColumn[i].get_SoilNO3() * sl.kgN_per_m3_to_mgN_per_kg[i]; // kg-NO3-N/m3-soil -> mg-NO3-N/kg-soil
+  }
+
+  stics::vdenit(organicPs.sticsParams, nools, sl.corg.data(), sl.NO3.data(), sl.soilT.data(), sl.wfps.data(),
+                sl.soilWaterContent.data(), sl.rate.data());
   
   for (int i = 0; i < nools; i++) {
     auto& sci = soilColumn[i];
-    auto smi = sci.get_Vs_SoilMoisture_m3(); // m3-water/m3-soil
-    auto sbdi = sci.vs_SoilBulkDensity(); // kg-soil/m3-soil
     auto lti = sci.vs_LayerThickness;
     auto NO3i = sci.get_SoilNO3();
 
-    auto kgN_per_m3_to_mgN_per_kg = 1000.0 * 1000.0 / sbdi;
-    auto mgN_per_kg_to_kgN_per_m3 = 1 / kgN_per_m3_to_mgN_per_kg;
-
-    vo_ActDenitrificationRate[i] =
-    stics::vdenit(sticsParams,
-                sci.vs_SoilOrganicCarbon() * 100.0, // kg-C/kg-soil = % [0-1] -> % [0-100]
-                NO3i * kgN_per_m3_to_mgN_per_kg, // kg-NO3-N/m3-soil -> mg-NO3-N/kg-soil
-                sci.get_Vs_SoilTemperature(), // [°C]
-                smi / sci.vs_Saturation(), // soil water-filled pore space []
-                smi * 1000 / sbdi) // gravimetric soil water content kg-water/kg-soil
-    * mgN_per_kg_to_kgN_per_m3; // mg-N -> kg-N;
+    vo_ActDenitrificationRate[i] = sl.rate[i] * sl.mgN_per_kg_to_kgN_per_m3[i]; // mg-N -> kg-N
 
     // update NO3 content of soil layer with denitrification balance [kg N m-3]
     if (NO3i > vo_ActDenitrificationRate[i]) {
-      sci.vs_SoilNO3 -= vo_ActDenitrificationRate[i];
+      sci.vs_SoilNO3() -= vo_ActDenitrificationRate[i];
     } else {
       vo_ActDenitrificationRate[i] = NO3i;
-      sci.vs_SoilNO3 = 0.0;
+      sci.vs_SoilNO3() = 0.0;
     }
     vo_TotalDenitrification += vo_ActDenitrificationRate[i] * lti; // [kg m-3] --> [kg m-2] ;
 
@@ -1332,18 +1334,14 @@ void SoilOrganic::fo_stics_Denitrification() {
 double SoilOrganic::fo_N2OProduction() {
   auto nools = soilColumn.vs_NumberOfOrganicLayers();
   double N2OProductionRate = organicPs.po_N2OProductionRate;
-  double pKaHNO2 = OrganicConstants::po_pKaHNO2;
   double sumN2OProduced = 0.0;
 
   for (int i = 0; i < nools; i++) {
     auto& sci = soilColumn[i];
-    auto pHi = sci.vs_SoilpH();
-    auto NO2i = sci.vs_SoilNO2;
+    auto NO2i = sci.vs_SoilNO2();
     auto lti = sci.vs_LayerThickness;
     auto tempi = sci.get_Vs_SoilTemperature();
-    
-    // pKaHNO2 original concept pow10. We used pow2 to allow reactive HNO2 being available at higer pH values
-    double pH_response = 1.0 / (1.0 + pow(2.0, pHi - pKaHNO2));
+    double pH_response = _soilProfile->vo_pHOnN2OProduction[i];
 
     double N2OProductionAtLayer =
       NO2i
@@ -1361,37 +1359,65 @@ double SoilOrganic::fo_N2OProduction() {
 SoilOrganic::NitDenitN2O SoilOrganic::fo_stics_N2OProduction() {
   auto nools = soilColumn.vs_NumberOfOrganicLayers();
   double sumN2OProducedNit = 0.0, sumN2OProducedDenit = 0.0;
-  auto sticsParams = organicPs.sticsParams;
+  auto& sl = _sticsLayers;
 
   for (int i = 0; i < nools; i++) {
-    auto& sci = soilColumn[i];
-    auto smi = sci.get_Vs_SoilMoisture_m3(); // m3-water/m3-soil
-    auto sbdi = sci.vs_SoilBulkDensity(); // kg-soil/m3-soil
-    auto lti = soilColumn[i].vs_LayerThickness;
+    auto kgN_per_m3_to_mgN_per_kg = sl.kgN_per_m3_to_mgN_per_kg[i];
+    sl.NO3[i] = soilColumn[i].get_SoilNO3() * kgN_per_m3_to_mgN_per_kg; // kg-NO3-N/m3-soil -> mg-NO3-N/kg-soil
+    sl.nitRate[i] = vo_ActNitrificationRate[i] * kgN_per_m3_to_mgN_per_kg; // kg-N/m3-soil/day -> mg-N/kg-soil/day
+    sl.denitRate[i] = vo_ActDenitrificationRate[i] * kgN_per_m3_to_mgN_per_kg; // kg-N/m3-soil/day -> mg-N/kg-soil/day
+  }
+
+  stics::N2O(organicPs.sticsParams, nools, sl.NO3.data(), sl.wfps.data(), sl.pH.data(),
+             sl.nitRate.data(), sl.denitRate.data(), sl.N2ONit.data(), sl.N2ODenit.data());
 
-    auto kgN_per_m3_to_mgN_per_kg = 1000.0 * 1000.0 / sbdi;
-    auto mgN_per_kg_to_kgN_per_m3 = 1 / kgN_per_m3_to_mgN_per_kg;
-    
+  for (int i = 0; i < nools; i++) {
     double stics2monicaUnits = 
-      mgN_per_kg_to_kgN_per_m3 // /kg-soil -> /m3-soil 
-      * lti // /m3-soil -> /m2-soil
+      sl.mgN_per_kg_to_kgN_per_m3[i] // /kg-soil -> /m3-soil 
+      * soilColumn[i].vs_LayerThickness // /m3-soil -> /m2-soil
       * 10000.0; // /m2-soil -> /ha-soil
-    
-    auto N2ONitDenitAtLayer =
-      stics::N2O(sticsParams,
-                 sci.get_SoilNO3() * kgN_per_m3_to_mgN_per_kg, // kg-NO3-N/m3-soil -> mg-NO3-N/kg-soil
-                 smi / sci.vs_Saturation(), // soil water-filled pore space []
-                 sci.vs_SoilpH(), // []
-                 vo_ActNitrificationRate[i] * kgN_per_m3_to_mgN_per_kg, // nitrification rate [mg-N/kg-soil/day] (* sbd = /m3-soil -> /kg-soil ; * 1000 = kg-N -> mg-N) 
-                 vo_ActDenitrificationRate[i] * kgN_per_m3_to_mgN_per_kg); // denitrification rate [mg-N/kg-soil/day] (* sbd = /m3-soil -> /kg-soil ; * 1000 = kg-N -> mg-N)
-
-    sumN2OProducedNit += N2ONitDenitAtLayer.first * stics2monicaUnits;
-    sumN2OProducedDenit += N2ONitDenitAtLayer.second * stics2monicaUnits;
+
+    sumN2OProducedNit += sl.N2ONit[i] * stics2monicaUnits;
+    sumN2OProducedDenit += sl.N2ODenit[i] * stics2monicaUnits;
   }
 
   return make_pair(sumN2OProducedNit, sumN2OProducedDenit);
 }
 
+/**
+ * @brief Soil moisture as pF of the organic layers for this step
+ *
+ * With the reference functions this is SoilLayer::vs_SoilMoisture_pF. Else the same
+ * Van Genuchten retention curve (m = 1) is evaluated in logarithmic form with the
+ * n of the profile (see soil-profile-cache.h), which replaces its exp/pow/log10 calls by a single log.
+ */
+void SoilOrganic::fo_UpdateSoilMoisture_pF() {
+  auto nools = soilColumn.vs_NumberOfOrganicLayers();
+
+  if (!organicPs.po_ApproximateResponseFunctions) {
+    for (int i = 0; i < nools; i++) vo_SoilMoisture_pF[i] = soilColumn[i].vs_SoilMoisture_pF();
+    return;
+  }
+
+  static const double pF_dry = log10(5.0E+7);
+  static const double ln10 = log(10.0);
+  for (int i = 0; i < nools; i++) {
+    auto& sci = soilColumn[i];
+    double thetaR = sci.vs_PermanentWiltingPoint();
+    double theta = sci.get_Vs_SoilMoisture_m3();
+
+    double pF = pF_dry;
+    if (theta > thetaR) {
+      double lnAlpha = -2.486 + (2.5 * sci.vs_SoilSandContent())
+        - (35.1 * sci.vs_SoilOrganicCarbon())
+        - (2.617 * (sci.vs_SoilBulkDensity() / 1000.0))
+        - (2.3 * sci.vs_SoilClayContent());
+      pF = (log((sci.vs_Saturation() - thetaR) / (theta - thetaR) - 1) * _soilProfile->vs_VanGenuchtenNInv[i] - lnAlpha) / ln10;
+    }
+    vo_SoilMoisture_pF[i] = pF < 0.0 ? 5.0E-7 : pF;
+  }
+}
+
 /**
  * @brief Internal Subroutine Pool update
  */
@@ -1416,10 +1442,10 @@ void SoilOrganic::fo_PoolUpdate()
 			vo_AOM_FastSum[i] += pool.vo_AOM_Fast;
 		}
 
-		soilColumn[i].vs_SOM_Slow += vo_SOM_SlowDelta[i];
-		soilColumn[i].vs_SOM_Fast += vo_SOM_FastDelta[i];
-		soilColumn[i].vs_SMB_Slow += vo_SMB_SlowDelta[i];
-		soilColumn[i].vs_SMB_Fast += vo_SMB_FastDelta[i];
+		soilColumn[i].vs_SOM_Slow() += vo_SOM_SlowDelta[i];
+		soilColumn[i].vs_SOM_Fast() += vo_SOM_FastDelta[i];
+		soilColumn[i].vs_SMB_Slow() += vo_SMB_SlowDelta[i];
+		soilColumn[i].vs_SMB_Fast() += vo_SMB_FastDelta[i];
 
 		if(i == 0)
 		{
@@ -1483,6 +1509,10 @@ double SoilOrganic::fo_ClayOnDecompostion(double d_SoilClayContent, double d_Lim
   return fo_ClayOnDecompostion;
 }
 
+double SoilOrganic::fo_TempResponseAbove20(double d_SoilTemperature) {
+  return exp(0.47 - (0.027 * d_SoilTemperature) + (0.00193 * d_SoilTemperature * d_SoilTemperature));
+}
+
 /**
  * @brief Internal Function Temperature effect on SOM decompostion
  * @param d_SoilTemperature
@@ -1502,7 +1532,9 @@ double SoilOrganic::fo_TempOnDecompostion(double d_SoilTemperature) {
 
   } else if (d_SoilTemperature > 20.0 && d_SoilTemperature <= 70.0) {
 
-    fo_TempOnDecompostion = exp(0.47 - (0.027 * d_SoilTemperature) + (0.00193 * d_SoilTemperature * d_SoilTemperature));
+    fo_TempOnDecompostion = _tempResponseAbove20.empty()
+      ? fo_TempResponseAbove20(d_SoilTemperature)
+      : _tempResponseAbove20(d_SoilTemperature);
   } else {
     vo_ErrorMessage = "irregular soil temperature";
   }
@@ -1590,7 +1622,7 @@ double SoilOrganic::fo_TempOnNitrification(double soilTemp) {
   else if (soilTemp > 6.0 && soilTemp <= 20.0)
     result = 0.1 * soilTemp;
   else if (soilTemp > 20.0 && soilTemp <= 70.0)
-    result = exp(0.47 - (0.027 * soilTemp) + (0.00193 * soilTemp * soilTemp));
+    result = _tempResponseAbove20.empty() ? fo_TempResponseAbove20(soilTemp) : _tempResponseAbove20(soilTemp);
   else
     vo_ErrorMessage = "irregular soil temperature";
 
@@ -1737,7 +1769,7 @@ double SoilOrganic::get_AOM_SlowSum(int i_Layer) const {
  * @return SMB fast
  */
 double SoilOrganic::get_SMB_Fast(int i_Layer) const {
-  return soilColumn[i_Layer].vs_SMB_Fast;
+  return soilColumn[i_Layer].vs_SMB_Fast();
 }
 
 /**
@@ -1745,7 +1777,7 @@ double SoilOrganic::get_SMB_Fast(int i_Layer) const {
  * @return SMB slow
  */
 double SoilOrganic::get_SMB_Slow(int i_Layer) const {
-  return soilColumn[i_Layer].vs_SMB_Slow;
+  return soilColumn[i_Layer].vs_SMB_Slow();
 }
 
 /**
@@ -1753,7 +1785,7 @@ double SoilOrganic::get_SMB_Slow(int i_Layer) const {
  * @return AOM fast
  */
 double SoilOrganic::get_SOM_Fast(int i_Layer) const {
-  return soilColumn[i_Layer].vs_SOM_Fast;
+  return soilColumn[i_Layer].vs_SOM_Fast();
 }
 
 /**
@@ -1761,7 +1793,7 @@ double SoilOrganic::get_SOM_Fast(int i_Layer) const {
  * @return SOM slow
  */
 double SoilOrganic::get_SOM_Slow(int i_Layer) const {
-  return soilColumn[i_Layer].vs_SOM_Slow;
+  return soilColumn[i_Layer].vs_SOM_Slow();
 }
 
 /**
@@ -1918,3 +1950,93 @@ double SoilOrganic::get_Organic_N(int i) const {
 
   return orgN;
 }
+
+void SoilOrganic::serialize(std::ostream& out) const
+{
+	using namespace StateIO;
+	write(out, addedOrganicMatter);
+	write(out, irrigationAmount);
+	write(out, vo_ActAmmoniaOxidationRate);
+	write(out, vo_ActNitrificationRate);
+	write(out, vo_ActDenitrificationRate);
+	write(out, vo_AOM_FastDeltaSum);
+	write(out, vo_AOM_FastInput);
+	write(out, vo_AOM_FastSum);
+	write(out, vo_AOM_SlowDeltaSum);
+	write(out, vo_AOM_SlowInput);
+	write(out, vo_AOM_SlowSum);
+	write(out, vo_AOM_CoalescedPools);
+	write(out, vo_AOM_CoalescingError);
+	write(out, vo_CBalance);
+	write(out, vo_DecomposerRespiration);
+	write(out, vo_ErrorMessage);
+	write(out, vo_InertSoilOrganicC);
+	write(out, vo_N2O_Produced);
+	write(out, vo_N2O_Produced_Nit);
+	write(out, vo_N2O_Produced_Denit);
+	write(out, vo_NetEcosystemExchange);
+	write(out, vo_NetEcosystemProduction);
+	write(out, vo_NetNMineralisation);
+	write(out, vo_NetNMineralisationRate);
+	write(out, vo_Total_NH3_Volatilised);
+	write(out, vo_NH3_Volatilised);
+	write(out, vo_SMB_CO2EvolutionRate);
+	write(out, vo_SMB_FastDelta);
+	write(out, vo_SMB_SlowDelta);
+	write(out, vs_SoilMineralNContent);
+	write(out, vo_SoilOrganicC);
+	write(out, vo_SOM_FastDelta);
+	write(out, vo_SOM_FastInput);
+	write(out, vo_SOM_SlowDelta);
+	write(out, vo_SumDenitrification);
+	write(out, vo_SumNetNMineralisation);
+	write(out, vo_SumN2O_Produced);
+	write(out, vo_SumNH3_Volatilised);
+	write(out, vo_TotalDenitrification);
+	write(out, incorporation);
+}
+
+void SoilOrganic::deserialize(std::istream& in)
+{
+	using namespace StateIO;
+	read(in, addedOrganicMatter);
+	read(in, irrigationAmount);
+	read(in, vo_ActAmmoniaOxidationRate);
+	read(in, vo_ActNitrificationRate);
+	read(in, vo_ActDenitrificationRate);
+	read(in, vo_AOM_FastDeltaSum);
+	read(in, vo_AOM_FastInput);
+	read(in, vo_AOM_FastSum);
+	read(in, vo_AOM_SlowDeltaSum);
+	read(in, vo_AOM_SlowInput);
+	read(in, vo_AOM_SlowSum);
+	read(in, vo_AOM_CoalescedPools);
+	read(in, vo_AOM_CoalescingError);
+	read(in, vo_CBalance);
+	read(in, vo_DecomposerRespiration);
+	read(in, vo_ErrorMessage);
+	read(in, vo_InertSoilOrganicC);
+	read(in, vo_N2O_Produced);
+	read(in, vo_N2O_Produced_Nit);
+	read(in, vo_N2O_Produced_Denit);
+	read(in, vo_NetEcosystemExchange);
+	read(in, vo_NetEcosystemProduction);
+	read(in, vo_NetNMineralisation);
+	read(in, vo_NetNMineralisationRate);
+	read(in, vo_Total_NH3_Volatilised);
+	read(in, vo_NH3_Volatilised);
+	read(in, vo_SMB_CO2EvolutionRate);
+	read(in, vo_SMB_FastDelta);
+	read(in, vo_SMB_SlowDelta);
+	read(in, vs_SoilMineralNContent);
+	read(in, vo_SoilOrganicC);
+	read(in, vo_SOM_FastDelta);
+	read(in, vo_SOM_FastInput);
+	read(in, vo_SOM_SlowDelta);
+	read(in, vo_SumDenitrification);
+	read(in, vo_SumNetNMineralisation);
+	read(in, vo_SumN2O_Produced);
+	read(in, vo_SumNH3_Volatilised);
+	read(in, vo_TotalDenitrification);
+	read(in, incorporation);
+}
@@ -34,6 +34,8 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 #include <list>
 
 #include "monica-parameters.h"
+#include "interpolation-table.h"
+#include "soil-profile-cache.h"
 
 namespace Monica
 {
@@ -111,6 +113,10 @@ namespace Monica
     double get_NetEcosystemProduction() const;
     double get_NetEcosystemExchange() const;
 
+    //! number of AOM pools merged so far and the approximation error caused by it [kg C m-2]
+    int get_AOM_CoalescedPools() const { return vo_AOM_CoalescedPools; }
+    double get_AOM_CoalescingError() const { return vo_AOM_CoalescingError; }
+
 		double get_Organic_N(int i_Layer) const;
 
     double actAmmoniaOxidationRate(int i) const {
@@ -124,15 +130,25 @@ namespace Monica
       return vo_ActDenitrificationRate.at(i);
     }
 
+    //! write/read the C/N turnover state (see state-io.h)
+    void serialize(std::ostream& out) const;
+    void deserialize(std::istream& in);
+
   private:
     //void fo_OM_Input(bool vo_AOM_Addition);
     void fo_Urea(double vo_RainIrrigation);
     void fo_MIT();
     void fo_Volatilisation(bool vo_AOM_Addition, double vw_MeanAirTemperature, double vw_WindSpeed);
+
+    //! the soil moisture as pF of all organic layers, which is constant during a step
+    void fo_UpdateSoilMoisture_pF();
     
     // MONICA nitrification code
     void fo_Nitrification();
     
+    //! collect the per layer inputs of the STICS routines, which don't change between them
+    void fo_stics_GatherLayers();
+
     // use STICS nitrification code
     void fo_stics_Nitrification();
 
@@ -153,6 +169,8 @@ namespace Monica
     double fo_NetEcosystemProduction(double vc_NetPrimaryProduction, double vo_DecomposerRespiration);
     double fo_NetEcosystemExchange(double vc_NetPrimaryProduction, double vo_DecomposerRespiration);
     double fo_ClayOnDecompostion(double d_SoilClayContent, double d_LimitClayEffect);
+    //! exponential temperature response above 20°C, shared by decomposition and nitrification
+    static double fo_TempResponseAbove20(double d_SoilTemperature);
     double fo_TempOnDecompostion(double d_SoilTemperature);
     double fo_MoistOnDecompostion(double d_SoilMoisture_pF);
     double fo_MoistOnHydrolysis(double d_SoilMoisture_pF);
@@ -172,12 +190,20 @@ namespace Monica
     std::vector<double> vo_ActAmmoniaOxidationRate; //!< [kg N m-3 d-1]
     std::vector<double> vo_ActNitrificationRate; //!< [kg N m-3 d-1]
     std::vector<double> vo_ActDenitrificationRate; //!< [kg N m-3 d-1]
+
+    //! clay effect on decomposition, depends only on static soil properties and parameters
+    std::vector<double> vo_ClayOnDecomposition; //!< []
+    std::vector<double> vo_SoilMoisture_pF; //!< of the current step
+    //! tabulated fo_TempResponseAbove20, empty if the reference functions are used
+    InterpolationTable _tempResponseAbove20;
     std::vector<double> vo_AOM_FastDeltaSum;
 		double vo_AOM_FastInput{0.0}; //!< AOMfast pool change by direct input [kg C m-3]
     std::vector<double> vo_AOM_FastSum;
     std::vector<double> vo_AOM_SlowDeltaSum;
     double vo_AOM_SlowInput{0.0}; //!< AOMslow pool change by direct input [kg C m-3]
     std::vector<double> vo_AOM_SlowSum;
+    int vo_AOM_CoalescedPools{0};
+    double vo_AOM_CoalescingError{0.0}; //!< [kg C m-2]
     std::vector<double> vo_CBalance;
     double vo_DecomposerRespiration{0.0};
     std::string vo_ErrorMessage;
@@ -205,6 +231,36 @@ namespace Monica
     double vo_SumNH3_Volatilised{0.0};
     double vo_TotalDenitrification{0.0};
 
+    //! the parameter independent static response factors, shared by all runs on the same profile
+    SoilProfilePropertiesPtr _soilProfile;
+
+    //! contiguous per layer inputs and results of the layer-batched STICS routines (see stics-nit-denit-n2o.h)
+    struct SticsLayers
+    {
+      explicit SticsLayers(std::size_t nools)
+        : NH4(nools), NO3(nools), pH(nools), soilT(nools), wfps(nools), soilWaterContent(nools)
+        , fc(nools), sat(nools), corg(nools), kgN_per_m3_to_mgN_per_kg(nools), mgN_per_kg_to_kgN_per_m3(nools)
+        , rate(nools), nitRate(nools), denitRate(nools), N2ONit(nools), N2ODenit(nools)
+      {}
+
+      std::vector<double> NH4; //!< [mg-NH4-N/kg-soil]
+      std::vector<double> NO3; //!< [mg-NO3-N/kg-soil]
+      std::vector<double> pH;
+      std::vector<double> soilT; //!< [°C]
+      std::vector<double> wfps; //!< water-filled pore space []
+      std::vector<double> soilWaterContent; //!< gravimetric [kg-water/kg-soil]
+      std::vector<double> fc; //!< [m3-water/m3-soil]
+      std::vector<double> sat; //!< [m3-water/m3-soil]
+      std::vector<double> corg; //!< [%]
+      std::vector<double> kgN_per_m3_to_mgN_per_kg;
+      std::vector<double> mgN_per_kg_to_kgN_per_m3;
+      std::vector<double> rate; //!< [mg-N/kg-soil/day]
+      std::vector<double> nitRate; //!< [mg-N/kg-soil/day]
+      std::vector<double> denitRate; //!< [mg-N/kg-soil/day]
+      std::vector<double> N2ONit; //!< [mg-N2O-N/kg-soil/day]
+      std::vector<double> N2ODenit; //!< [mg-N2O-N/kg-soil/day]
+    } _sticsLayers;
+
     /*
     struct AddedOMParams {
       double vo_AddedOrganicCarbonAmount;
@@ -22,10 +22,13 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 #include <iostream>
 #include <cmath>
 #include <exception>
+#include <algorithm>
 
 #include "soiltemperature.h"
 #include "soilcolumn.h"
 #include "monica-model.h"
+#include "state-io.h"
+#include "tridiagonal.h"
 #include "tools/debug.h"
 
 using namespace std;
@@ -51,6 +54,9 @@ SoilTemperature::SoilTemperature(MonicaModel& mm)
 	, vt_B(vt_NumberOfLayers)
 	, vt_MatrixPrimaryDiagonal(vt_NumberOfLayers)
 	, vt_MatrixSecundaryDiagonal(vt_NumberOfLayers + 1)
+	, vt_MatrixDiagonal(vt_NumberOfLayers)
+	, vt_MatrixLowerTriangle(vt_NumberOfLayers)
+	, vt_Solution(vt_NumberOfLayers)
 	, vt_HeatConductivity(vt_NumberOfLayers)
 	, vt_HeatConductivityMean(vt_NumberOfLayers)
 	, vt_HeatCapacity(int(vt_NumberOfLayers))
@@ -229,17 +235,66 @@ SoilTemperature::SoilTemperature(MonicaModel& mm)
 			- vt_MatrixSecundaryDiagonal[i_Layer]
 			- vt_MatrixSecundaryDiagonal[i_Layer + 1]; //[J K-1]
 	}
+
+	factorize();
+
+	// the step runs daily, so use kernels for a fixed number of layers if there are some
+	switch(vs_NumberOfLayers)
+	{
+	case 20: useStepKernels<20>(); break;
+	case 30: useStepKernels<30>(); break;
+	default: useStepKernels<0>();
+	}
+}
+
+void SoilTemperature::factorize()
+{
+	// the diagonals depend on heat capacity and conductivity only, which are
+	// computed from the constant soil moisture, so they never change during a run
+	factorSymmetricTridiagonal(vt_NumberOfLayers, 1,
+	                           vt_MatrixPrimaryDiagonal.data(),
+	                           vt_MatrixSecundaryDiagonal.data(),
+	                           vt_MatrixDiagonal.data(),
+	                           vt_MatrixLowerTriangle.data());
 }
 
 //! Single calculation step
 void SoilTemperature::step(double tmin, double tmax, double globrad)
 {
-	size_t vt_GroundLayer = vt_NumberOfLayers - 2;
-	size_t vt_BottomLayer = vt_NumberOfLayers - 1;
+	prepareStep(tmin, tmax, globrad);
+	solveStep();
+	finishStep();
+}
+
+void SoilTemperature::prepareStep(double tmin, double tmax, double globrad)
+{
+	(this->*_prepareStep)(tmin, tmax, globrad);
+}
+
+void SoilTemperature::solveStep()
+{
+	(this->*_solveStep)();
+}
 
-	vector<double> vt_Solution(vt_NumberOfLayers);//                = new double [vt_NumberOfLayers];
-	vector<double> vt_MatrixDiagonal(vt_NumberOfLayers);//          = new double [vt_NumberOfLayers];
-	vector<double> vt_MatrixLowerTriangle(vt_NumberOfLayers);//     = new double [vt_NumberOfLayers];
+void SoilTemperature::finishStep()
+{
+	(this->*_finishStep)();
+}
+
+template<int NoOfLayers>
+void SoilTemperature::useStepKernels()
+{
+	_prepareStep = &SoilTemperature::prepareStepFixed<NoOfLayers>;
+	_solveStep = &SoilTemperature::solveStepFixed<NoOfLayers>;
+	_finishStep = &SoilTemperature::finishStepFixed<NoOfLayers>;
+}
+
+template<int NoOfLayers>
+void SoilTemperature::prepareStepFixed(double tmin, double tmax, double globrad)
+{
+	// compile time constants for the instantiations for common column sizes
+	const size_t vs_nols = NoOfLayers > 0 ? NoOfLayers : vs_NumberOfLayers;
+	const size_t vt_nols = vs_nols + 2;
 
 	/////////////////////////////////////////////////////////////
 	// Internal Subroutine Numerical Solution - Suckow,F. (1986)
@@ -256,64 +311,137 @@ void SoilTemperature::step(double tmin, double tmax, double globrad)
 		 / soilColumn[0].vs_LayerThickness)
 		* vt_SoilTemperature[0] + vt_HeatFlow;
 
-	for(size_t i_Layer = 1; i_Layer < vt_NumberOfLayers; i_Layer++)
+	// the soil layers, then the ground and bottom layer (see SC)
+	auto solution = [this](size_t i_Layer, double layerThickness)
 	{
 		vt_Solution[i_Layer] = 
 			(vt_VolumeMatrixOld[i_Layer]
 			 + (vt_VolumeMatrix[i_Layer] - vt_VolumeMatrixOld[i_Layer])
-			 / soilColumn[i_Layer].vs_LayerThickness)
+			 / layerThickness)
 			* vt_SoilTemperature[i_Layer];
-	}
+	};
+	for(size_t i_Layer = 1; i_Layer < vs_nols; i_Layer++)
+		solution(i_Layer, _soilColumn[i_Layer].vs_LayerThickness);
+	for(size_t i_Layer = max(vs_nols, size_t(1)); i_Layer < vt_nols; i_Layer++)
+		solution(i_Layer, soilColumn[i_Layer].vs_LayerThickness);
 	// end subroutine NumericalSolution
 
+}
+
+template<int NoOfLayers>
+void SoilTemperature::solveStepFixed()
+{
+	const size_t vt_nols = NoOfLayers > 0 ? NoOfLayers + 2 : vt_NumberOfLayers;
+
 	/////////////////////////////////////////////////////////////
 	// Internal Subroutine Cholesky Solution Method
 	//
 	// Solution of EX=Z with E tridiagonal and symmetric
-	// according to CHOLESKY (E=LDL')
+	// according to CHOLESKY (E=LDL'), the lower matrix triangle L
+	// and the diagonal matrix D are determined once (see factorize)
 	/////////////////////////////////////////////////////////////
 
-	// Determination of the lower matrix triangle L and the diagonal matrix D
-	vt_MatrixDiagonal[0] = vt_MatrixPrimaryDiagonal[0];
+	// Solution of LY=Z and L'X=D(-1)Y, the same as solveFactoredSymmetricTridiagonal for a single column
+	const double* d = vt_MatrixDiagonal.data();
+	const double* l = vt_MatrixLowerTriangle.data();
+	double* x = vt_Solution.data();
 
-	for(size_t i_Layer = 1; i_Layer < vt_NumberOfLayers; i_Layer++)
+	for(size_t i = 1; i < vt_nols; i++)
+		x[i] = x[i] - (l[i] * x[i - 1]);
+
+	const size_t last = vt_nols - 1;
+	x[last] = x[last] / d[last];
+	for(size_t k = 0; k < last; k++)
 	{
-		vt_MatrixLowerTriangle[i_Layer] = vt_MatrixSecundaryDiagonal[i_Layer]
-			/ vt_MatrixDiagonal[i_Layer - 1];
-		vt_MatrixDiagonal[i_Layer] = vt_MatrixPrimaryDiagonal[i_Layer]
-			- (vt_MatrixLowerTriangle[i_Layer] * vt_MatrixSecundaryDiagonal[i_Layer]);
+		const size_t j = (last - 1) - k;
+		x[j] = (x[j] / d[j]) - (l[j + 1] * x[j + 1]);
 	}
 
-	// Solution of LY=Z
-	for(size_t i_Layer = 1; i_Layer < vt_NumberOfLayers; i_Layer++)
+	// end subroutine CholeskyMethod
+}
+
+//------------------------------------------------------------------------------
+
+SoilTemperatureBatch::SoilTemperatureBatch(const vector<SoilTemperature*>& soilTemperatures)
+	: _soilTemperatures(soilTemperatures)
+{
+	map<size_t, vector<SoilTemperature*>> byNoOfLayers;
+	for(auto st : soilTemperatures)
+		byNoOfLayers[st->vt_NumberOfLayers].push_back(st);
+
+	for(const auto& p : byNoOfLayers)
 	{
-		vt_Solution[i_Layer] = 
-			vt_Solution[i_Layer]
-			- (vt_MatrixLowerTriangle[i_Layer] * vt_Solution[i_Layer - 1]);
+		Group g;
+		g.n = p.first;
+		g.soilTemperatures = p.second;
+		const size_t n = g.n;
+		const size_t k = g.soilTemperatures.size();
+		if(k > 1)
+		{
+			// layer major, so the solver runs across the columns
+			g.diagonal.resize(n * k);
+			g.lowerTriangle.resize(n * k);
+			g.rhs.resize(n * k);
+			for(size_t c = 0; c < k; c++)
+			{
+				const SoilTemperature& st = *g.soilTemperatures[c];
+				for(size_t i = 0; i < n; i++)
+				{
+					g.diagonal[i * k + c] = st.vt_MatrixDiagonal[i];
+					g.lowerTriangle[i * k + c] = st.vt_MatrixLowerTriangle[i];
+				}
+			}
+		}
+		_groups.push_back(move(g));
 	}
+}
 
-	// Solution of L'X=D(-1)Y
-	vt_Solution[vt_BottomLayer] = 
-		vt_Solution[vt_BottomLayer] / vt_MatrixDiagonal[vt_BottomLayer];
-
-	for(size_t i_Layer = 0; i_Layer < vt_BottomLayer; i_Layer++)
+void SoilTemperatureBatch::solve()
+{
+	for(auto& g : _groups)
 	{
-		auto j_Layer = (vt_BottomLayer - 1) - i_Layer;
-		auto j_Layer1 = j_Layer + 1;
-		vt_Solution[j_Layer] = (vt_Solution[j_Layer] / vt_MatrixDiagonal[j_Layer])
-			- (vt_MatrixLowerTriangle[j_Layer1] * vt_Solution[j_Layer1]);
+		const size_t n = g.n;
+		const size_t k = g.soilTemperatures.size();
+		if(k == 1)
+		{
+			g.soilTemperatures.front()->solveStep();
+			continue;
+		}
+
+		for(size_t c = 0; c < k; c++)
+		{
+			const double* solution = g.soilTemperatures[c]->vt_Solution.data();
+			for(size_t i = 0; i < n; i++)
+				g.rhs[i * k + c] = solution[i];
+		}
+
+		solveFactoredSymmetricTridiagonal(n, k, g.diagonal.data(), g.lowerTriangle.data(), g.rhs.data());
+
+		for(size_t c = 0; c < k; c++)
+		{
+			double* solution = g.soilTemperatures[c]->vt_Solution.data();
+			for(size_t i = 0; i < n; i++)
+				solution[i] = g.rhs[i * k + c];
+		}
 	}
+}
 
-	// end subroutine CholeskyMethod
+template<int NoOfLayers>
+void SoilTemperature::finishStepFixed()
+{
+	const size_t vs_nols = NoOfLayers > 0 ? NoOfLayers : vs_NumberOfLayers;
+	const size_t vt_nols = vs_nols + 2;
+	size_t vt_GroundLayer = vt_nols - 2;
+	size_t vt_BottomLayer = vt_nols - 1;
 
 	// Internal Subroutine Rearrangement
-	for(size_t i_Layer = 0; i_Layer < vt_NumberOfLayers; i_Layer++)
+	for(size_t i_Layer = 0; i_Layer < vt_nols; i_Layer++)
 		vt_SoilTemperature[i_Layer] = vt_Solution[i_Layer];
 
-	for(size_t i_Layer = 0; i_Layer < vs_NumberOfLayers; i_Layer++)
+	for(size_t i_Layer = 0; i_Layer < vs_nols; i_Layer++)
 	{
 		vt_VolumeMatrixOld[i_Layer] = vt_VolumeMatrix[i_Layer];
-		soilColumn[i_Layer].set_Vs_SoilTemperature(vt_SoilTemperature[i_Layer]);
+		_soilColumn[i_Layer].set_Vs_SoilTemperature(vt_SoilTemperature[i_Layer]);
 	}
 
 	vt_VolumeMatrixOld[vt_GroundLayer] = vt_VolumeMatrix[vt_GroundLayer];
@@ -432,3 +560,44 @@ double SoilTemperature::get_AvgTopSoilTemperature(double sumLT) const
 
 	return count < 1 ? 0 : tempSum / double(count);
 }
+
+void SoilTemperature::serialize(std::ostream& out) const
+{
+	using namespace StateIO;
+	write(out, vt_SoilSurfaceTemperature);
+	write(out, vs_SoilMoisture_const);
+	write(out, vt_SoilTemperature);
+	write(out, vt_V);
+	write(out, vt_VolumeMatrix);
+	write(out, vt_VolumeMatrixOld);
+	write(out, vt_B);
+	write(out, vt_MatrixPrimaryDiagonal);
+	write(out, vt_MatrixSecundaryDiagonal);
+	write(out, vt_HeatFlow);
+	write(out, vt_HeatConductivity);
+	write(out, vt_HeatConductivityMean);
+	write(out, vt_HeatCapacity);
+	write(out, _dampingFactor);
+}
+
+void SoilTemperature::deserialize(std::istream& in)
+{
+	using namespace StateIO;
+	read(in, vt_SoilSurfaceTemperature);
+	read(in, vs_SoilMoisture_const);
+	read(in, vt_SoilTemperature);
+	read(in, vt_V);
+	read(in, vt_VolumeMatrix);
+	read(in, vt_VolumeMatrixOld);
+	read(in, vt_B);
+	read(in, vt_MatrixPrimaryDiagonal);
+	read(in, vt_MatrixSecundaryDiagonal);
+	read(in, vt_HeatFlow);
+	read(in, vt_HeatConductivity);
+	read(in, vt_HeatConductivityMean);
+	read(in, vt_HeatCapacity);
+	read(in, _dampingFactor);
+
+	// the factorization isn't part of the state
+	factorize();
+}
@@ -59,6 +59,12 @@ namespace Monica
 
     void step(double tmin, double tmax, double globrad);
 
+    //! step split around the solution of the heat equation, so that the
+    //! equations of several soil columns can be solved at once (see SoilTemperatureBatch)
+    void prepareStep(double tmin, double tmax, double globrad);
+    void solveStep();
+    void finishStep();
+
     double f_SoilSurfaceTemperature(double tmin, double tmax, double globrad);
     double get_SoilSurfaceTemperature() const;
     double get_SoilTemperature(int layer) const;
@@ -68,9 +74,29 @@ namespace Monica
     double dampingFactor() const { return _dampingFactor; }
     void setDampingFactor(double factor) { _dampingFactor = factor; }
 
+    //! write/read the numerical state (see state-io.h)
+    void serialize(std::ostream& out) const;
+    void deserialize(std::istream& in);
+
     double vt_SoilSurfaceTemperature;
 
   private:
+    friend class SoilTemperatureBatch;
+
+    //! factorize the heat equation matrix, its diagonals are set only on construction and deserialization
+    void factorize();
+
+    //! the step kernels for NoOfLayers soil layers, 0 means any number of layers
+    template<int NoOfLayers>
+    void prepareStepFixed(double tmin, double tmax, double globrad);
+    template<int NoOfLayers>
+    void solveStepFixed();
+    template<int NoOfLayers>
+    void finishStepFixed();
+    //! set the variants of the step kernels for NoOfLayers
+    template<int NoOfLayers>
+    void useStepKernels();
+
     SoilColumn& _soilColumn;
     MonicaModel& monica;
     SoilLayer _soilColumn_vt_GroundLayer;
@@ -107,6 +133,10 @@ namespace Monica
 
     const std::size_t vt_NumberOfLayers;
     const std::size_t vs_NumberOfLayers;
+    //! the variants of the step kernels for vs_NumberOfLayers
+    void (SoilTemperature::*_prepareStep)(double, double, double){nullptr};
+    void (SoilTemperature::*_solveStep)(){nullptr};
+    void (SoilTemperature::*_finishStep)(){nullptr};
     std::vector<double> vs_SoilMoisture_const;
     std::vector<double> vt_SoilTemperature;
     std::vector<double> vt_V;
@@ -115,12 +145,49 @@ namespace Monica
     std::vector<double> vt_B;
     std::vector<double> vt_MatrixPrimaryDiagonal;
     std::vector<double> vt_MatrixSecundaryDiagonal;
-    double vt_HeatFlow;
+    //! LDL' factorization of the matrix (see tridiagonal.h)
+    std::vector<double> vt_MatrixDiagonal;
+    std::vector<double> vt_MatrixLowerTriangle;
+    std::vector<double> vt_Solution;
+    double vt_HeatFlow{0.0};
     std::vector<double> vt_HeatConductivity;
     std::vector<double> vt_HeatConductivityMean;
     std::vector<double> vt_HeatCapacity;
     double _dampingFactor{0.8};
   };
+
+  /**
+   * @brief The prepared equations of several soil columns, solved at once.
+   *
+   * Columns with the same number of layers form one group, whose values are
+   * stored layer major (see tridiagonal.h). The factorizations don't change
+   * during a run, so they are gathered once on construction, a batch has to
+   * be recreated if its soil temperatures change (e.g. by deserialization).
+   * Every solve only gathers the right sides and scatters the solutions.
+   */
+  class SoilTemperatureBatch
+  {
+  public:
+    explicit SoilTemperatureBatch(const std::vector<SoilTemperature*>& soilTemperatures);
+
+    const std::vector<SoilTemperature*>& soilTemperatures() const { return _soilTemperatures; }
+
+    //! solves the prepared equations of all soil temperatures
+    void solve();
+
+  private:
+    struct Group
+    {
+      std::size_t n{0};
+      std::vector<SoilTemperature*> soilTemperatures;
+      std::vector<double> diagonal;
+      std::vector<double> lowerTriangle;
+      std::vector<double> rhs;
+    };
+
+    std::vector<SoilTemperature*> _soilTemperatures;
+    std::vector<Group> _groups;
+  };
 }
 #endif
 
@@ -24,7 +24,8 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 #include "soilcolumn.h"
 #include "soiltransport.h"
 #include "crop-growth.h"
-#include "tools/debug.h"
+#include "state-io.h"
+#include "tridiagonal.h"
 #include "tools/debug.h"
 
 using namespace std;
@@ -61,11 +62,28 @@ SoilTransport::SoilTransport(SoilColumn& sc, const SiteParameters& sps, const Us
     vq_TimeStep(1.0),
     vq_TotalDispersion(vs_NumberOfLayers, 0.0),
     vq_PercolationRate(vs_NumberOfLayers, 0.0),
+    vq_SystemLower(vs_NumberOfLayers, 0.0),
+    vq_SystemDiagonal(vs_NumberOfLayers, 0.0),
+    vq_SystemUpper(vs_NumberOfLayers, 0.0),
+    vq_SystemWorkspace(vs_NumberOfLayers, 0.0),
+    vq_SoilNO3_aq_Old(vs_NumberOfLayers, 0.0),
     pc_MinimumAvailableN(pc_MinimumAvailableN)
 {
   debug() << "!!! N Deposition: " << vs_NDeposition << endl;
   vs_LeachingDepth = p_LeachingDepth;
   vq_TimeStep = p_timeStep;
+
+  if (stPs.pq_NTransportScheme == "implicit")
+    vq_Implicitness = 1.0;
+  else if (stPs.pq_NTransportScheme == "crank-nicolson")
+    vq_Implicitness = 0.5;
+
+  // the explicit transport runs several times a day, so use a variant with a fixed number of layers if there is one
+  switch (vs_NumberOfLayers) {
+  case 20: _fq_NTransport = &SoilTransport::fq_NTransportFixed<20>; break;
+  case 30: _fq_NTransport = &SoilTransport::fq_NTransportFixed<30>; break;
+  default: _fq_NTransport = &SoilTransport::fq_NTransportFixed<0>;
+  }
 }
 
 /**
@@ -82,11 +100,12 @@ void SoilTransport::calculateSoilTransportStep() {
 
   double vq_TimeStepFactor = 1.0; // [t t-1]
 
-  for (int i_Layer = 0; i_Layer < vs_NumberOfLayers; i_Layer++) {
-    vq_FieldCapacity[i_Layer] = soilColumn[i_Layer].vs_FieldCapacity();
-    vq_SoilMoisture[i_Layer] = soilColumn[i_Layer].get_Vs_SoilMoisture_m3();
-    vq_SoilNO3[i_Layer] = soilColumn[i_Layer].vs_SoilNO3;
+  const SoilColumnArrays& sca = soilColumn.arrays();
+  copy_n(sca.vs_FieldCapacity.begin(), vs_NumberOfLayers, vq_FieldCapacity.begin());
+  copy_n(sca.vs_SoilMoisture_m3.begin(), vs_NumberOfLayers, vq_SoilMoisture.begin());
+  copy_n(sca.vs_SoilNO3.begin(), vs_NumberOfLayers, vq_SoilNO3.begin());
 
+  for (int i_Layer = 0; i_Layer < vs_NumberOfLayers; i_Layer++) {
     vq_LayerThickness[i_Layer] = soilColumn[0].vs_LayerThickness;
     vc_NUptakeFromLayer[i_Layer] = crop ? crop->get_NUptakeFromLayer(i_Layer) : 0;
     if (i_Layer == (vs_NumberOfLayers - 1)){
@@ -116,11 +135,46 @@ void SoilTransport::calculateSoilTransportStep() {
   fq_NUptake();
 
   // Nitrate transport is called according to the set time step
+  auto explicitTransport = [&]() {
+    for (int i_TimeStep = 0; i_TimeStep < (1.0 / vq_TimeStepFactor); i_TimeStep++) {
+      fq_NTransport(vs_LeachingDepth, vq_TimeStepFactor);
+    }
+  };
+
   vq_LeachingAtBoundary = 0.0;
-  for (int i_TimeStep = 0; i_TimeStep < (1.0 / vq_TimeStepFactor); i_TimeStep++) {
-    fq_NTransport(vs_LeachingDepth, vq_TimeStepFactor);
+  if (stPs.pq_ValidateNTransportScheme) {
+    // run the reference scheme first and keep its result to compare against,
+    // the explicit one or, if that is the chosen scheme, the implicit one
+    vq_SoilNO3_aq_Old = vq_SoilNO3_aq;
+    if (vq_Implicitness > 0.0)
+      explicitTransport();
+    else
+      fq_NTransportImplicit(vs_LeachingDepth, 1.0);
+    swap(vq_SoilNO3_aq, vq_SoilNO3_aq_Old);
+    double referenceLeaching = vq_LeachingAtBoundary;
+    vq_LeachingAtBoundary = 0.0;
+
+    if (vq_Implicitness > 0.0)
+      fq_NTransportImplicit(vs_LeachingDepth, vq_Implicitness);
+    else
+      explicitTransport();
+
+    vq_NTransportDeviation = 0.0;
+    for (int i_Layer = 0; i_Layer < vs_NumberOfLayers; i_Layer++) {
+      vq_NTransportDeviation = max(vq_NTransportDeviation,
+                                   fabs(vq_SoilNO3_aq[i_Layer] - vq_SoilNO3_aq_Old[i_Layer])
+                                   * vq_SoilMoisture[i_Layer] * vq_LayerThickness[i_Layer] * 10000.0); // [kg N ha-1]
+    }
+    vq_NLeachingDeviation = vq_LeachingAtBoundary - referenceLeaching;
+    debug() << "NO3 transport deviation from " << (vq_Implicitness > 0.0 ? "explicit" : "implicit")
+      << " scheme: " << vq_NTransportDeviation << " kg N ha-1, leaching: " << vq_NLeachingDeviation << " kg N ha-1" << endl;
+  } else if (vq_Implicitness > 0.0) {
+    fq_NTransportImplicit(vs_LeachingDepth, vq_Implicitness);
+  } else {
+    explicitTransport();
   }
 
+  auto& soilNO3 = soilColumn.arrays().vs_SoilNO3;
   for (int i_Layer = 0; i_Layer < vs_NumberOfLayers; i_Layer++) {
 
     vq_SoilNO3[i_Layer] = vq_SoilNO3_aq[i_Layer] * vq_SoilMoisture[i_Layer];
@@ -129,7 +183,7 @@ void SoilTransport::calculateSoilTransportStep() {
       vq_SoilNO3[i_Layer] = 0.0;
     }
 
-    soilColumn[i_Layer].vs_SoilNO3 = vq_SoilNO3[i_Layer];
+    soilNO3[i_Layer] = vq_SoilNO3[i_Layer];
   } // for
 
 }
@@ -200,18 +254,19 @@ void SoilTransport::fq_NUptake() {
  *
  * Kersebaum 1989
  */
-void SoilTransport::fq_NTransport(double vs_LeachingDepth, double vq_TimeStepFactor) {
+template<int NoOfLayers>
+void SoilTransport::fq_NTransportFixed(double vs_LeachingDepth, double vq_TimeStepFactor) {
+  // a compile time constant for the instantiations for common column sizes
+  const int nols = NoOfLayers > 0 ? NoOfLayers : vs_NumberOfLayers;
+  const vector<double>& layerThickness = soilColumn.arrays().vs_LayerThickness;
 
   double vq_DiffusionCoeffStandard = stPs.pq_DiffusionCoefficientStandard;// [m2 d-1]; old D0
   double AD = stPs.pq_AD; // Factor a in Kersebaum 1989 p.24 for Loess soils
   double vq_DispersionLength = stPs.pq_DispersionLength; // [m]
   double vq_SoilProfile = 0.0;
   int vq_LeachingDepthLayerIndex = 0;
-  
 
-  std::vector<double> vq_SoilMoistureGradient(vs_NumberOfLayers, 0.0);
-
-  for (int i_Layer = 0; i_Layer < vs_NumberOfLayers; i_Layer++) {
+  for (int i_Layer = 0; i_Layer < nols; i_Layer++) {
     vq_SoilProfile += vq_LayerThickness[i_Layer];
 
     if ((vq_SoilProfile - 0.001) < vs_LeachingDepth) {
@@ -220,10 +275,10 @@ void SoilTransport::fq_NTransport(double vs_LeachingDepth, double vq_TimeStepFac
   }
 
   // Caluclation of convection for different cases of flux direction
-  for (int i_Layer = 0; i_Layer < vs_NumberOfLayers; i_Layer++)
+  for (int i_Layer = 0; i_Layer < nols; i_Layer++)
   {
     const double wf0 = soilColumn[0].vs_SoilWaterFlux;
-    const double lt = soilColumn[i_Layer].vs_LayerThickness;
+    const double lt = layerThickness[i_Layer];
     const double NO3 = vq_SoilNO3_aq[i_Layer];
 		
     if (i_Layer == 0) {
@@ -247,7 +302,7 @@ void SoilTransport::fq_NTransport(double vs_LeachingDepth, double vq_TimeStepFac
         vq_Convection[i_Layer] = (NO3_u * pr) / lt;
       }
 
-    } else if (i_Layer < vs_NumberOfLayers - 1) {
+    } else if (i_Layer < nols - 1) {
 
       // layer > 0 && < bottom
       const double pr_o = vq_PercolationRate[i_Layer - 1] / 1000.0 * vq_TimeStepFactor; //[mm t-1 --> m t-1] * [t t-1]
@@ -305,34 +360,35 @@ void SoilTransport::fq_NTransport(double vs_LeachingDepth, double vq_TimeStepFac
 
 
   // Calculation of dispersion depending of pore water velocity
-  for (int i_Layer = 0; i_Layer < vs_NumberOfLayers; i_Layer++) {
+  for (int i_Layer = 0; i_Layer < nols; i_Layer++) {
 
     const double pr = vq_PercolationRate[i_Layer] / 1000.0 * vq_TimeStepFactor; // [mm t-1 --> m t-1] * [t t-1]
     const double pr0 = soilColumn[0].vs_SoilWaterFlux / 1000.0 * vq_TimeStepFactor; // [mm t-1 --> m t-1] * [t t-1]
-    const double lt = soilColumn[i_Layer].vs_LayerThickness;
+    const double lt = layerThickness[i_Layer];
     const double NO3 = vq_SoilNO3_aq[i_Layer];
+    double vq_SoilMoistureGradient = 0.0;
 
 
     // Original: W(I) --> um Steingehalt korrigierte Feldkapazität
     /** @todo Claas: generelle Korrektur der Feldkapazität durch den Steingehalt */
-    if (i_Layer == vs_NumberOfLayers - 1) {
+    if (i_Layer == nols - 1) {
       vq_PoreWaterVelocity[i_Layer] = fabs((pr) / vq_FieldCapacity[i_Layer]); // [m t-1]
-      vq_SoilMoistureGradient[i_Layer] = (vq_SoilMoisture[i_Layer]); //[m3 m-3]
+      vq_SoilMoistureGradient = (vq_SoilMoisture[i_Layer]); //[m3 m-3]
     } else {
       vq_PoreWaterVelocity[i_Layer] = fabs((pr) / ((vq_FieldCapacity[i_Layer]
 			        + vq_FieldCapacity[i_Layer + 1]) * 0.5)); // [m t-1]
-      vq_SoilMoistureGradient[i_Layer] = ((vq_SoilMoisture[i_Layer])
+      vq_SoilMoistureGradient = ((vq_SoilMoisture[i_Layer])
 				 + (vq_SoilMoisture[i_Layer + 1])) * 0.5; //[m3 m-3]
     }
 
     vq_DiffusionCoeff[i_Layer] = vq_DiffusionCoeffStandard
-			   * (AD * exp(vq_SoilMoistureGradient[i_Layer] * 2.0 * 5.0)
-			   / vq_SoilMoistureGradient[i_Layer]) * vq_TimeStepFactor; //[m2 t-1] * [t t-1]
+			   * (AD * exp(vq_SoilMoistureGradient * 2.0 * 5.0)
+			   / vq_SoilMoistureGradient) * vq_TimeStepFactor; //[m2 t-1] * [t t-1]
 
     // Dispersion coefficient, old DB
     if (i_Layer == 0) {
 
-      vq_DispersionCoeff[i_Layer] = vq_SoilMoistureGradient[i_Layer] * (vq_DiffusionCoeff[i_Layer] // [m2 t-1]
+      vq_DispersionCoeff[i_Layer] = vq_SoilMoistureGradient * (vq_DiffusionCoeff[i_Layer] // [m2 t-1]
 	+ vq_DispersionLength * vq_PoreWaterVelocity[i_Layer]) // [m] * [m t-1]
 	- (0.5 * lt * fabs(pr)) // [m] * [m t-1]
 	+ ((0.5 * vq_TimeStep * vq_TimeStepFactor * fabs((pr + pr0) / 2.0))  // [t] * [t t-1] * [m t-1]
@@ -341,7 +397,7 @@ void SoilTransport::fq_NTransport(double vs_LeachingDepth, double vq_TimeStepFac
     } else {
       const double pr_o = vq_PercolationRate[i_Layer - 1] / 1000.0 * vq_TimeStepFactor; // [m t-1]
 
-      vq_DispersionCoeff[i_Layer] = vq_SoilMoistureGradient[i_Layer] * (vq_DiffusionCoeff[i_Layer]
+      vq_DispersionCoeff[i_Layer] = vq_SoilMoistureGradient * (vq_DiffusionCoeff[i_Layer]
 	+ vq_DispersionLength * vq_PoreWaterVelocity[i_Layer]) - (0.5 * lt * fabs(pr))
 	+ ((0.5 * vq_TimeStep * vq_TimeStepFactor * fabs((pr + pr_o) / 2.0)) * vq_PoreWaterVelocity[i_Layer]);
     }
@@ -352,7 +408,7 @@ void SoilTransport::fq_NTransport(double vs_LeachingDepth, double vq_TimeStepFac
       // vq_Dispersion = Dispersion upwards or downwards, depending on the position in the profile [kg m-3]
       vq_Dispersion[i_Layer] = -vq_DispersionCoeff[i_Layer] * (NO3 - NO3_u) / (lt * lt); // [m2] * [kg m-3] / [m2]
 
-    } else if (i_Layer < vs_NumberOfLayers - 1) {
+    } else if (i_Layer < nols - 1) {
       const double NO3_o = vq_SoilNO3_aq[i_Layer - 1];
       const double NO3_u = vq_SoilNO3_aq[i_Layer + 1];
       vq_Dispersion[i_Layer] = (vq_DispersionCoeff[i_Layer - 1] * (NO3_o - NO3) / (lt * lt))
@@ -368,10 +424,10 @@ void SoilTransport::fq_NTransport(double vs_LeachingDepth, double vq_TimeStepFac
   if (vq_PercolationRate[vq_LeachingDepthLayerIndex] > 0.0) {
 
     //vq_LeachingDepthLayerIndex = gewählte Auswaschungstiefe
-    const double lt = soilColumn[vq_LeachingDepthLayerIndex].vs_LayerThickness;
+    const double lt = layerThickness[vq_LeachingDepthLayerIndex];
     const double NO3 = vq_SoilNO3_aq[vq_LeachingDepthLayerIndex];
 
-    if (vq_LeachingDepthLayerIndex < vs_NumberOfLayers - 1) {
+    if (vq_LeachingDepthLayerIndex < nols - 1) {
       const double pr_u = vq_PercolationRate[vq_LeachingDepthLayerIndex + 1] / 1000.0 * vq_TimeStepFactor;// [m t-1]
       const double NO3_u = vq_SoilNO3_aq[vq_LeachingDepthLayerIndex + 1]; // [kg m-3]
       //vq_LeachingAtBoundary: Summe für Auswaschung (Diff + Konv), old OUTSUM
@@ -385,10 +441,10 @@ void SoilTransport::fq_NTransport(double vs_LeachingDepth, double vq_TimeStepFac
   } else {
 
     const double pr_u = vq_PercolationRate[vq_LeachingDepthLayerIndex] / 1000.0 * vq_TimeStepFactor;
-    const double lt = soilColumn[vq_LeachingDepthLayerIndex].vs_LayerThickness;
+    const double lt = layerThickness[vq_LeachingDepthLayerIndex];
     const double NO3 = vq_SoilNO3_aq[vq_LeachingDepthLayerIndex];
 
-    if (vq_LeachingDepthLayerIndex < vs_NumberOfLayers - 1) {
+    if (vq_LeachingDepthLayerIndex < nols - 1) {
       const double NO3_u = vq_SoilNO3_aq[vq_LeachingDepthLayerIndex + 1];
       vq_LeachingAtBoundary += ((pr_u * NO3_u) / (lt * 10000.0 * lt)) + vq_DispersionCoeff[vq_LeachingDepthLayerIndex]
 	* (NO3 - NO3_u) / ((lt * lt) * 10000.0 * lt); //[kg ha-1]
@@ -397,7 +453,7 @@ void SoilTransport::fq_NTransport(double vs_LeachingDepth, double vq_TimeStepFac
 
   // Update of NO3 concentration
   // including transfomation back into [kg NO3-N m soil-3]
-  for (int i_Layer = 0; i_Layer < vs_NumberOfLayers; i_Layer++) {
+  for (int i_Layer = 0; i_Layer < nols; i_Layer++) {
 
 
 	  vq_SoilNO3_aq[i_Layer] += (vq_Dispersion[i_Layer] - vq_Convection[i_Layer]) / vq_SoilMoisture[i_Layer];
@@ -413,6 +469,136 @@ void SoilTransport::fq_NTransport(double vs_LeachingDepth, double vq_TimeStepFac
 //  cout << "vq_LeachingAtBoundary: " << vq_LeachingAtBoundary << endl;
 }
 
+void SoilTransport::fq_NTransport(double vs_LeachingDepth, double vq_TimeStepFactor) {
+  (this->*_fq_NTransport)(vs_LeachingDepth, vq_TimeStepFactor);
+}
+
+/**
+ * @brief Calculation of N transport for the whole time step at once
+ *
+ * Same convection (upwind) and dispersion as in fq_NTransport, but the layer
+ * balances are weighted between the old and new concentrations and solved as a
+ * single tridiagonal system, which is stable for any water flux, so no sub-steps
+ * are needed. The correction of the dispersion coefficient for the numerical
+ * dispersion of the time discretisation depends on the implicitness (it vanishes
+ * for Crank-Nicolson and changes its sign for implicit Euler). Negative dispersion
+ * coefficients are set to 0 to keep the system diagonally dominant.
+ * The leaching is the convective and dispersive flux through the lower boundary of
+ * the leaching depth layer.
+ *
+ * @param vs_LeachingDepth
+ * @param vq_Implicitness weight of the new time level (1 = implicit Euler, 0.5 = Crank-Nicolson)
+ */
+void SoilTransport::fq_NTransportImplicit(double vs_LeachingDepth, double vq_Implicitness) {
+  const int nols = vs_NumberOfLayers;
+  if (nols == 0)
+    return;
+
+  const double vq_DiffusionCoeffStandard = stPs.pq_DiffusionCoefficientStandard;// [m2 d-1]
+  const double AD = stPs.pq_AD;
+  const double vq_DispersionLength = stPs.pq_DispersionLength; // [m]
+  const double w = vq_Implicitness;
+  const double dt = vq_TimeStep;
+
+  double vq_SoilProfile = 0.0;
+  int vq_LeachingDepthLayerIndex = 0;
+  for (int i_Layer = 0; i_Layer < nols; i_Layer++) {
+    vq_SoilProfile += vq_LayerThickness[i_Layer];
+    if ((vq_SoilProfile - 0.001) < vs_LeachingDepth) {
+      vq_LeachingDepthLayerIndex = i_Layer;
+    }
+  }
+
+  // dispersion coefficient at the lower boundary of each layer
+  for (int i_Layer = 0; i_Layer < nols; i_Layer++) {
+    const double pr = vq_PercolationRate[i_Layer] / 1000.0; // [mm d-1 --> m d-1]
+    const double pr_o = i_Layer == 0
+      ? soilColumn[0].vs_SoilWaterFlux / 1000.0
+      : vq_PercolationRate[i_Layer - 1] / 1000.0; // [m d-1]
+    const double lt = soilColumn[i_Layer].vs_LayerThickness;
+
+    double sm = vq_SoilMoisture[i_Layer];
+    if (i_Layer == nols - 1) {
+      vq_PoreWaterVelocity[i_Layer] = fabs(pr / vq_FieldCapacity[i_Layer]); // [m d-1]
+    } else {
+      vq_PoreWaterVelocity[i_Layer] = fabs(pr / ((vq_FieldCapacity[i_Layer] + vq_FieldCapacity[i_Layer + 1]) * 0.5));
+      sm = (sm + vq_SoilMoisture[i_Layer + 1]) * 0.5; // [m3 m-3]
+    }
+
+    vq_DiffusionCoeff[i_Layer] = vq_DiffusionCoeffStandard * (AD * exp(sm * 2.0 * 5.0) / sm); // [m2 d-1]
+
+    vq_DispersionCoeff[i_Layer] = max(0.0, sm * (vq_DiffusionCoeff[i_Layer]
+      + vq_DispersionLength * vq_PoreWaterVelocity[i_Layer]) - (0.5 * lt * fabs(pr))
+      + ((1.0 - 2.0 * w) * 0.5 * dt * fabs((pr + pr_o) / 2.0) * vq_PoreWaterVelocity[i_Layer]));
+  }
+
+  // the flux through the lower boundary of layer i is a[i] * NO3[i] + b[i] * NO3[i + 1]
+  // (no dispersion and no inflow through the bottom of the profile)
+  auto a = [&](int i) {
+    const double pr = vq_PercolationRate[i] / 1000.0;
+    return i < nols - 1
+      ? vq_DispersionCoeff[i] / soilColumn[i].vs_LayerThickness + max(pr, 0.0)
+      : max(pr, 0.0);
+  };
+  auto b = [&](int i) {
+    const double pr = vq_PercolationRate[i] / 1000.0;
+    return i < nols - 1
+      ? -vq_DispersionCoeff[i] / soilColumn[i].vs_LayerThickness + min(pr, 0.0)
+      : 0.0;
+  };
+
+  // set up (theta - w dt A) NO3_new = (theta + (1 - w) dt A) NO3_old
+  vector<double>& NO3 = vq_SoilNO3_aq;
+  vq_SoilNO3_aq_Old = NO3;
+  for (int i_Layer = 0; i_Layer < nols; i_Layer++) {
+    const double lt = soilColumn[i_Layer].vs_LayerThickness;
+    const double A_l = i_Layer > 0 ? a(i_Layer - 1) / lt : 0.0;
+    const double A_d = ((i_Layer > 0 ? b(i_Layer - 1) : 0.0) - a(i_Layer)) / lt;
+    const double A_u = -b(i_Layer) / lt;
+
+    vq_SystemLower[i_Layer] = -w * dt * A_l;
+    vq_SystemDiagonal[i_Layer] = vq_SoilMoisture[i_Layer] - w * dt * A_d;
+    vq_SystemUpper[i_Layer] = -w * dt * A_u;
+
+    double ANO3 = A_d * vq_SoilNO3_aq_Old[i_Layer];
+    if (i_Layer > 0)
+      ANO3 += A_l * vq_SoilNO3_aq_Old[i_Layer - 1];
+    if (i_Layer < nols - 1)
+      ANO3 += A_u * vq_SoilNO3_aq_Old[i_Layer + 1];
+    NO3[i_Layer] = vq_SoilMoisture[i_Layer] * vq_SoilNO3_aq_Old[i_Layer] + (1.0 - w) * dt * ANO3;
+  }
+
+  solveTridiagonal(nols, 1,
+                   vq_SystemLower.data(),
+                   vq_SystemDiagonal.data(),
+                   vq_SystemUpper.data(),
+                   NO3.data(),
+                   vq_SystemWorkspace.data());
+
+  // convection, dispersion and leaching of the time step, using the weighted concentrations
+  auto NO3w = [&](int i) { return w * NO3[i] + (1.0 - w) * vq_SoilNO3_aq_Old[i]; };
+  auto convectiveFlux = [&](int i) { // [kg m-2 d-1]
+    const double pr = vq_PercolationRate[i] / 1000.0;
+    if (pr >= 0.0)
+      return pr * NO3w(i);
+    return i < nols - 1 ? pr * NO3w(i + 1) : 0.0;
+  };
+  auto dispersiveFlux = [&](int i) { // [kg m-2 d-1]
+    return i < nols - 1
+      ? vq_DispersionCoeff[i] * (NO3w(i) - NO3w(i + 1)) / soilColumn[i].vs_LayerThickness
+      : 0.0;
+  };
+
+  for (int i_Layer = 0; i_Layer < nols; i_Layer++) {
+    const double lt = soilColumn[i_Layer].vs_LayerThickness;
+    vq_Convection[i_Layer] = dt * (convectiveFlux(i_Layer) - (i_Layer > 0 ? convectiveFlux(i_Layer - 1) : 0.0)) / lt;
+    vq_Dispersion[i_Layer] = dt * ((i_Layer > 0 ? dispersiveFlux(i_Layer - 1) : 0.0) - dispersiveFlux(i_Layer)) / lt;
+  }
+
+  vq_LeachingAtBoundary += dt * (convectiveFlux(vq_LeachingDepthLayerIndex)
+                                 + dispersiveFlux(vq_LeachingDepthLayerIndex)) * 10000.0; //[kg ha-1]
+}
+
 /**
  * @brief Returns Nitrate content for each layer [i]
  * @return Soil NO3 content
@@ -453,3 +639,52 @@ void SoilTransport::remove_Crop() {
   crop = NULL;
 }
 
+void SoilTransport::serialize(std::ostream& out) const
+{
+	using namespace StateIO;
+	write(out, vq_Convection);
+	write(out, vq_CropNUptake);
+	write(out, vq_DiffusionCoeff);
+	write(out, vq_Dispersion);
+	write(out, vq_DispersionCoeff);
+	write(out, vq_FieldCapacity);
+	write(out, vq_LayerThickness);
+	write(out, vs_LeachingDepth);
+	write(out, vq_LeachingAtBoundary);
+	write(out, vs_NDeposition);
+	write(out, vc_NUptakeFromLayer);
+	write(out, vq_PoreWaterVelocity);
+	write(out, vs_SoilMineralNContent);
+	write(out, vq_SoilMoisture);
+	write(out, vq_SoilNO3);
+	write(out, vq_SoilNO3_aq);
+	write(out, vq_TimeStep);
+	write(out, vq_CurrentTimeStep);
+	write(out, vq_TotalDispersion);
+	write(out, vq_PercolationRate);
+}
+
+void SoilTransport::deserialize(std::istream& in)
+{
+	using namespace StateIO;
+	read(in, vq_Convection);
+	read(in, vq_CropNUptake);
+	read(in, vq_DiffusionCoeff);
+	read(in, vq_Dispersion);
+	read(in, vq_DispersionCoeff);
+	read(in, vq_FieldCapacity);
+	read(in, vq_LayerThickness);
+	read(in, vs_LeachingDepth);
+	read(in, vq_LeachingAtBoundary);
+	read(in, vs_NDeposition);
+	read(in, vc_NUptakeFromLayer);
+	read(in, vq_PoreWaterVelocity);
+	read(in, vs_SoilMineralNContent);
+	read(in, vq_SoilMoisture);
+	read(in, vq_SoilNO3);
+	read(in, vq_SoilNO3_aq);
+	read(in, vq_TimeStep);
+	read(in, vq_CurrentTimeStep);
+	read(in, vq_TotalDispersion);
+	read(in, vq_PercolationRate);
+}
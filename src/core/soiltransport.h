@@ -23,6 +23,7 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
  */
 
 #include <vector>
+#include <iostream>
 #include "monica-parameters.h"
 
 namespace Monica 
@@ -58,6 +59,10 @@ namespace Monica
     //! calcuates N transport in soil
     void fq_NTransport (double vs_LeachingDepth, double vq_TimeStep);
 
+    //! calculates N transport in soil for a whole time step with a theta scheme
+    //! (implicitness 1 = implicit Euler, 0.5 = Crank-Nicolson)
+    void fq_NTransportImplicit(double vs_LeachingDepth, double vq_Implicitness);
+
     void put_Crop(CropGrowth* crop);
 
     void remove_Crop();
@@ -70,14 +75,29 @@ namespace Monica
 	double get_vq_Dispersion(int i_Layer) const;
 	double get_vq_Convection(int i_Layer) const;
 
+    //! deviation of the chosen transport scheme from the reference one (if validation is on,
+    //! see UserSoilTransportParameters::pq_ValidateNTransportScheme)
+    double get_NTransportDeviation() const { return vq_NTransportDeviation; }
+    double get_NLeachingDeviation() const { return vq_NLeachingDeviation; }
+
+    //! write/read the nitrate transport state (see state-io.h)
+    void serialize(std::ostream& out) const;
+    void deserialize(std::istream& in);
+
   private:
     //methods
     void calculateSoilTransportStep();
 
+    //! fq_NTransport for NoOfLayers layers, 0 means any number of layers
+    template<int NoOfLayers>
+    void fq_NTransportFixed(double vs_LeachingDepth, double vq_TimeStepFactor);
+
     // members
     SoilColumn& soilColumn;
     const UserSoilTransportParameters& stPs;
     const int vs_NumberOfLayers;
+    //! the variant of fq_NTransportFixed for vs_NumberOfLayers
+    void (SoilTransport::*_fq_NTransport)(double, double){nullptr};
     std::vector<double> vq_Convection;
     double vq_CropNUptake;
     std::vector<double> vq_DiffusionCoeff;
@@ -95,10 +115,19 @@ namespace Monica
     std::vector<double> vq_SoilNO3;
     std::vector<double> vq_SoilNO3_aq;
     double vq_TimeStep;
-    double vq_CurrentTimeStep;
+    double vq_CurrentTimeStep{0.0};
     std::vector<double> vq_TotalDispersion;
     std::vector<double> vq_PercolationRate; //!< Soil water flux from above [mm d-1]
 
+    double vq_Implicitness{0.0}; //!< 0 = explicit transport with sub-steps, else weight of the new time level
+    std::vector<double> vq_SystemLower; //!< workspace of the implicit transport
+    std::vector<double> vq_SystemDiagonal;
+    std::vector<double> vq_SystemUpper;
+    std::vector<double> vq_SystemWorkspace;
+    std::vector<double> vq_SoilNO3_aq_Old;
+    double vq_NTransportDeviation{0.0}; //!< max. deviation of a layer's NO3 from the reference scheme [kg N ha-1]
+    double vq_NLeachingDeviation{0.0}; //!< deviation of the leaching from the reference scheme [kg N ha-1]
+
     const double pc_MinimumAvailableN; //! kg m-2
 
     CropGrowth* crop{nullptr};
@@ -0,0 +1,163 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Claas Nendel <claas.nendel@zalf.de>
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <unordered_map>
+
+#include "solar-geometry.h"
+#include "tools/helper.h"
+#include "tools/algorithms.h"
+
+using namespace std;
+using namespace Monica;
+using namespace Tools;
+
+namespace
+{
+	const double PI = 3.14159265358979323;
+
+	//! if more latitudes are cached, the cache is cleared, runs still using a latitude keep it alive
+	const size_t MaxCachedLatitudes = 1000;
+
+	mutex cacheMutex;
+	unordered_map<uint64_t, SolarGeometryPtr> cache;
+
+	//! the latitude's bits, so only latitudes yielding identical results share an entry
+	uint64_t latitudeKey(double latitude)
+	{
+		uint64_t key;
+		memcpy(&key, &latitude, sizeof(key));
+		return key;
+	}
+
+	//! see CropGrowth::fc_Radiation and SoilMoisture::ReferenceEvapotranspiration
+	SolarDay calcSolarDay(double vs_JulianDay, double vs_Latitude)
+	{
+		SolarDay sd;
+
+		// Calculation of declination - old DEC
+		sd.vc_Declination = -23.4 * cos(2.0 * PI * ((vs_JulianDay + 10.0) / 365.0));
+
+		sd.vc_DeclinationSinus = sin(sd.vc_Declination * PI / 180.0) * sin(vs_Latitude * PI / 180.0);
+		sd.vc_DeclinationCosinus = cos(sd.vc_Declination * PI / 180.0) * cos(vs_Latitude * PI / 180.0);
+
+		// Calculation of the atmospheric day lenght - old DL
+		double arg_AstroDayLength = sd.vc_DeclinationSinus / sd.vc_DeclinationCosinus;
+		arg_AstroDayLength = bound(-1.0, arg_AstroDayLength, 1.0); //The argument of asin must be in the range of -1 to 1 
+		sd.vc_AstronomicDayLenght = 12.0 * (PI + 2.0 * asin(arg_AstroDayLength)) / PI;
+
+		// Calculation of the effective day length - old DLE
+		double EDLHelper = (-sin(8.0 * PI / 180.0) + sd.vc_DeclinationSinus) / sd.vc_DeclinationCosinus;
+		if((EDLHelper < -1.0) || (EDLHelper > 1.0))
+			sd.vc_EffectiveDayLength = 0.01;
+		else
+			sd.vc_EffectiveDayLength = 12.0 * (PI + 2.0 * asin(EDLHelper)) / PI;
+
+		// old DLP
+		double arg_PhotoDayLength = (-sin(-6.0 * PI / 180.0) + sd.vc_DeclinationSinus) / sd.vc_DeclinationCosinus;
+		arg_PhotoDayLength = bound(-1.0, arg_PhotoDayLength, 1.0); //The argument of asin must be in the range of -1 to 1
+		sd.vc_PhotoperiodicDaylength = 12.0 * (PI + 2.0 * asin(arg_PhotoDayLength)) / PI;
+
+		// Calculation of the mean photosynthetically active radiation [J m-2] - old RDN
+		double arg_PhotAct = min(1.0, ((sd.vc_DeclinationSinus / sd.vc_DeclinationCosinus) * (sd.vc_DeclinationSinus / sd.vc_DeclinationCosinus))); //The argument of sqrt must be >= 0
+		sd.vc_PhotActRadiationMean = 3600.0 * (sd.vc_DeclinationSinus * sd.vc_AstronomicDayLenght + 24.0 / PI * sd.vc_DeclinationCosinus
+			* sqrt(1.0 - arg_PhotAct));
+
+		// Calculation of radiation on a clear day [J m-2] - old DRC	
+		if(sd.vc_PhotActRadiationMean > 0 && sd.vc_AstronomicDayLenght > 0)
+			sd.vc_ClearDayRadiation = 0.5 * 1300.0 * sd.vc_PhotActRadiationMean * exp(-0.14 / (sd.vc_PhotActRadiationMean
+				/ (sd.vc_AstronomicDayLenght * 3600.0)));
+		else
+			sd.vc_ClearDayRadiation = 0;
+
+		// Calculation of radiation on an overcast day [J m-2] - old DRO
+		sd.vc_OvercastDayRadiation = 0.2 * sd.vc_ClearDayRadiation;
+
+		// Calculation of extraterrestrial radiation - old EXT
+		double pc_SolarConstant = 0.082; //[MJ m-2 d-1] Note: Here is the difference to HERMES, which calculates in [J cm-2 d-1]!
+		double SC = 24.0 * 60.0 / PI * pc_SolarConstant *(1.0 + 0.033 * cos(2.0 * PI * vs_JulianDay / 365.0));
+
+		double arg_SolarAngle = -tan(vs_Latitude * PI / 180.0) * tan(sd.vc_Declination * PI / 180.0);
+		arg_SolarAngle = bound(-1.0, arg_SolarAngle, 1.0);
+		double vc_SunsetSolarAngle = acos(arg_SolarAngle);
+		sd.vc_ExtraterrestrialRadiation = SC * (vc_SunsetSolarAngle * sd.vc_DeclinationSinus + sd.vc_DeclinationCosinus * sin(vc_SunsetSolarAngle)); // [MJ m-2]
+
+		// the reference evapotranspiration still calculates in [J cm-2 d-1]
+		double SC_J = 24.0 * 60.0 / PI * 8.20 *(1.0 + 0.033 * cos(2.0 * PI * vs_JulianDay / 365.0));
+		sd.vm_ExtraterrestrialRadiation = SC_J * (vc_SunsetSolarAngle * sd.vc_DeclinationSinus + sd.vc_DeclinationCosinus * sin(vc_SunsetSolarAngle)) / 100.0; // [J cm-2] --> [MJ m-2]
+
+		return sd;
+	}
+}
+
+SolarGeometry::SolarGeometry(double latitude)
+	: _latitude(latitude)
+	, _days(367)
+{
+	for(int jd = 1; jd <= 366; jd++)
+		_days[jd] = calcSolarDay(jd, latitude);
+}
+
+const SolarHours& SolarGeometry::hours(int julianDay) const
+{
+	call_once(_hoursOnce, [this]()
+	{
+		_hours.resize(_days.size());
+		for(int jd = 1; jd <= 366; jd++)
+		{
+			for(int h = 0; h < 24; h++)
+			{
+				_hours[jd].solarElevation[h] = solarElevation(h, _latitude, jd);
+				_hours[jd].extraterrestrialRadiation[h] = hourlyRad(_days[jd].vc_ExtraterrestrialRadiation, _latitude, jd, h);
+			}
+		}
+	});
+	return _hours.at(size_t(julianDay));
+}
+
+SolarGeometryPtr Monica::solarGeometry(double latitude)
+{
+	auto key = latitudeKey(latitude);
+
+	{
+		lock_guard<mutex> lock(cacheMutex);
+		auto it = cache.find(key);
+		if(it != cache.end())
+			return it->second;
+	}
+
+	//calculate outside of the lock, if another thread was faster, its instance wins
+	auto sg = make_shared<const SolarGeometry>(latitude);
+	lock_guard<mutex> lock(cacheMutex);
+	if(cache.size() >= MaxCachedLatitudes)
+		cache.clear();
+	return cache.emplace(key, sg).first->second;
+}
+
+size_t Monica::solarGeometryCacheSize()
+{
+	lock_guard<mutex> lock(cacheMutex);
+	return cache.size();
+}
+
+void Monica::clearSolarGeometryCache()
+{
+	lock_guard<mutex> lock(cacheMutex);
+	cache.clear();
+}
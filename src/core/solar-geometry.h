@@ -0,0 +1,96 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Claas Nendel <claas.nendel@zalf.de>
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+#ifndef SOLAR_GEOMETRY_H_
+#define SOLAR_GEOMETRY_H_
+
+/**
+ * @file solar-geometry.h
+ *
+ * @brief Day length and radiation quantities which depend only on latitude
+ * and day of year. They are calculated once per process and latitude for
+ * all days of the year and shared, read only, by all runs at that latitude.
+ */
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Monica
+{
+	//! latitude and day of year dependent part of CropGrowth::fc_Radiation
+	struct SolarDay
+	{
+		double vc_Declination{0.0}; //!< [°]
+		double vc_DeclinationSinus{0.0}; //!< old SINLD
+		double vc_DeclinationCosinus{0.0}; //!< old COSLD
+		double vc_AstronomicDayLenght{0.0}; //!< [h]
+		double vc_EffectiveDayLength{0.0}; //!< [h]
+		double vc_PhotoperiodicDaylength{0.0}; //!< [h]
+		double vc_PhotActRadiationMean{0.0}; //!< [J m-2]
+		double vc_ClearDayRadiation{0.0}; //!< [J m-2]
+		double vc_OvercastDayRadiation{0.0}; //!< [J m-2]
+		double vc_ExtraterrestrialRadiation{0.0}; //!< [MJ m-2 d-1]
+
+		//! extraterrestrial radiation as used by SoilMoisture::ReferenceEvapotranspiration [MJ m-2 d-1]
+		double vm_ExtraterrestrialRadiation{0.0};
+	};
+
+	//! hourly values of a day for the hourly photosynthesis
+	struct SolarHours
+	{
+		double solarElevation[24]; //!< [rad]
+		double extraterrestrialRadiation[24]; //!< [MJ m-2 h-1]
+	};
+
+	class SolarGeometry
+	{
+	public:
+		explicit SolarGeometry(double latitude);
+
+		double latitude() const { return _latitude; }
+
+		//! daily values for julianDay (1 - 366)
+		const SolarDay& day(int julianDay) const { return _days.at(std::size_t(julianDay)); }
+
+		//! hourly values for julianDay, calculated for the whole year at the first call
+		const SolarHours& hours(int julianDay) const;
+
+	private:
+		double _latitude{0.0};
+		std::vector<SolarDay> _days;
+		mutable std::once_flag _hoursOnce;
+		mutable std::vector<SolarHours> _hours;
+	};
+
+	typedef std::shared_ptr<const SolarGeometry> SolarGeometryPtr;
+
+	/**
+	 * Returns the solar geometry at latitude [°]. Runs at the same latitude
+	 * share one instance. The cache is cleared when it exceeds 1000 latitudes,
+	 * so a run should keep the instance it got. Thread-safe.
+	 */
+	SolarGeometryPtr solarGeometry(double latitude);
+
+	//! number of latitudes currently cached
+	std::size_t solarGeometryCacheSize();
+
+	//! drop all cached latitudes, runs still using one keep it alive
+	void clearSolarGeometryCache();
+}
+
+#endif
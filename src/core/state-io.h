@@ -0,0 +1,232 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Claas Nendel <claas.nendel@zalf.de>
+Xenia Specka <xenia.specka@zalf.de>
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+#ifndef STATE_IO_H_
+#define STATE_IO_H_
+
+/**
+ * @file state-io.h
+ *
+ * @brief Small helpers to write/read model state to/from a binary stream.
+ *
+ * The format is a plain sequence of values in host byte order, without any
+ * self description. It is meant for checkpoints which are restored by the
+ * same build of MONICA, the layout is guarded by a magic number and version
+ * written by MonicaModel::serialize.
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <cstdint>
+#include <algorithm>
+#include <type_traits>
+
+#include "tools/date.h"
+
+namespace Monica
+{
+	namespace StateIO
+	{
+		//declare container overloads upfront, so nested containers find each other
+		template<typename T> void write(std::ostream& out, const std::vector<T>& vs);
+		template<typename T> void read(std::istream& in, std::vector<T>& vs);
+		template<typename K, typename V> void write(std::ostream& out, const std::map<K, V>& m);
+		template<typename K, typename V> void read(std::istream& in, std::map<K, V>& m);
+		template<typename T> void write(std::ostream& out, const std::set<T>& s);
+		template<typename T> void read(std::istream& in, std::set<T>& s);
+
+		template<typename T>
+		typename std::enable_if<std::is_trivially_copyable<T>::value>::type
+		write(std::ostream& out, const T& v)
+		{
+			out.write(reinterpret_cast<const char*>(&v), sizeof(T));
+		}
+
+		template<typename T>
+		typename std::enable_if<std::is_trivially_copyable<T>::value>::type
+		read(std::istream& in, T& v)
+		{
+			in.read(reinterpret_cast<char*>(&v), sizeof(T));
+		}
+
+		//! upper bound for the number of elements of a container, if the stream can't tell its length
+		const std::uint64_t maxContainerSize = std::uint64_t(1) << 28;
+
+		/**
+		 * Reads the size of a container, whose elements take at least minElementSize
+		 * bytes each. A size which can't be right (more elements than bytes left in
+		 * the stream, or maxContainerSize for unseekable streams) marks the stream as
+		 * failed instead of leading to a huge allocation.
+		 */
+		inline bool readSize(std::istream& in, std::uint64_t& size, std::size_t minElementSize)
+		{
+			read(in, size);
+			if(!in)
+				return false;
+
+			std::uint64_t maxSize = maxContainerSize;
+			auto pos = in.tellg();
+			if(pos != std::streampos(-1))
+			{
+				in.seekg(0, std::ios::end);
+				auto end = in.tellg();
+				in.seekg(pos);
+				if(end != std::streampos(-1) && end >= pos)
+					maxSize = std::min(maxSize, std::uint64_t(end - pos) / std::max<std::size_t>(1, minElementSize));
+			}
+
+			if(size > maxSize)
+			{
+				in.setstate(std::ios::failbit);
+				return false;
+			}
+			return true;
+		}
+
+		//! smallest number of bytes an element of type T takes in the stream
+		template<typename T>
+		std::size_t minStreamSize() { return std::is_trivially_copyable<T>::value ? sizeof(T) : 1; }
+
+		inline void write(std::ostream& out, const std::string& s)
+		{
+			write(out, std::uint64_t(s.size()));
+			out.write(s.data(), s.size());
+		}
+
+		inline void read(std::istream& in, std::string& s)
+		{
+			std::uint64_t size = 0;
+			if(!readSize(in, size, 1))
+				return;
+			s.resize(std::size_t(size));
+			in.read(&s[0], std::streamsize(size));
+		}
+
+		//! dates are written as ISO strings, an invalid date as an empty string
+		inline void write(std::ostream& out, const Tools::Date& d)
+		{
+			write(out, d.isValid());
+			write(out, d.isValid() ? d.toIsoDateString() : std::string());
+		}
+
+		inline void read(std::istream& in, Tools::Date& d)
+		{
+			bool valid = false;
+			std::string iso;
+			read(in, valid);
+			read(in, iso);
+			d = valid ? Tools::Date::fromIsoDateString(iso) : Tools::Date();
+		}
+
+		template<typename T>
+		void write(std::ostream& out, const std::vector<T>& vs)
+		{
+			write(out, std::uint64_t(vs.size()));
+			for(const auto& v : vs)
+				write(out, v);
+		}
+
+		template<typename T>
+		void read(std::istream& in, std::vector<T>& vs)
+		{
+			std::uint64_t size = 0;
+			if(!readSize(in, size, minStreamSize<T>()))
+				return;
+			vs.resize(std::size_t(size));
+			for(auto& v : vs)
+				read(in, v);
+		}
+
+		//! vector<bool> has no addressable elements
+		inline void write(std::ostream& out, const std::vector<bool>& vs)
+		{
+			write(out, std::uint64_t(vs.size()));
+			for(bool v : vs)
+				write(out, v);
+		}
+
+		inline void read(std::istream& in, std::vector<bool>& vs)
+		{
+			std::uint64_t size = 0;
+			if(!readSize(in, size, sizeof(bool)))
+				return;
+			vs.resize(std::size_t(size));
+			for(std::size_t i = 0; i < vs.size(); i++)
+			{
+				bool v = false;
+				read(in, v);
+				vs[i] = v;
+			}
+		}
+
+		template<typename K, typename V>
+		void write(std::ostream& out, const std::map<K, V>& m)
+		{
+			write(out, std::uint64_t(m.size()));
+			for(const auto& p : m)
+			{
+				write(out, p.first);
+				write(out, p.second);
+			}
+		}
+
+		template<typename K, typename V>
+		void read(std::istream& in, std::map<K, V>& m)
+		{
+			std::uint64_t size = 0;
+			m.clear();
+			if(!readSize(in, size, minStreamSize<K>() + minStreamSize<V>()))
+				return;
+			for(std::uint64_t i = 0; in && i < size; i++)
+			{
+				K k;
+				V v;
+				read(in, k);
+				read(in, v);
+				m[k] = v;
+			}
+		}
+
+		template<typename T>
+		void write(std::ostream& out, const std::set<T>& s)
+		{
+			write(out, std::uint64_t(s.size()));
+			for(const auto& v : s)
+				write(out, v);
+		}
+
+		template<typename T>
+		void read(std::istream& in, std::set<T>& s)
+		{
+			std::uint64_t size = 0;
+			s.clear();
+			if(!readSize(in, size, minStreamSize<T>()))
+				return;
+			for(std::uint64_t i = 0; in && i < size; i++)
+			{
+				T v;
+				read(in, v);
+				s.insert(v);
+			}
+		}
+	}
+}
+
+#endif
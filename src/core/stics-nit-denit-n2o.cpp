@@ -207,3 +207,121 @@ stics::NitDenitN2O stics::N2O(const Monica::SticsParameters& ps,
   auto denit = vdenit(ps, corg, NO3, soilT, wfps, soilWaterContent);
   return N2O(ps, NO3, wfps, pH, nit, denit);
 }
+
+// layer-batched nitrification
+void stics::vnit(const Monica::SticsParameters& ps,
+                 std::size_t n,
+                 const double* NH4,
+                 const double* pH,
+                 const double* soilT,
+                 const double* wfps,
+                 const double* soilWaterContent,
+                 const double* fc,
+                 const double* sat,
+                 double* vnit) {
+  // vnitpot * fNH4res
+  switch (ps.code_vnit) {
+    case 1:
+      for (std::size_t i = 0; i < n; i++) vnit[i] = ps.fnx * std::max(0.0, NH4[i] - ps.nh4_min);
+      break;
+    case 2:
+      for (std::size_t i = 0; i < n; i++) vnit[i] = ps.vnitmax * nit::fNH4(NH4[i], ps.nh4_min, soilWaterContent[i], ps.Kamm);
+      break;
+    default: std::fill(vnit, vnit + n, 0.0);
+  }
+
+  // * fpH, the slope of the pH response only depends on the parameters
+  const auto pHSlope = 1.0 / (ps.pHmaxnit - ps.pHminnit);
+  for (std::size_t i = 0; i < n; i++) {
+    auto fpH = pH[i] < ps.pHminnit ? 0.0 : pH[i] > ps.pHmaxnit ? 1.0 : pHSlope * (pH[i] - ps.pHminnit);
+    vnit[i] *= fpH;
+  }
+
+  // * fTres
+  switch (ps.code_tnit) {
+    case 1:
+      for (std::size_t i = 0; i < n; i++) vnit[i] *= nit::fTstep(soilT[i], ps.tnitmin, ps.tnitopt, ps.tnitop2, ps.tnitmax);
+      break;
+    case 2: {
+      const auto scale2 = pow(ps.scale_tnitopt, 2);
+      for (std::size_t i = 0; i < n; i++) {
+        auto delta = soilT[i] - ps.tnitopt_gauss;
+        vnit[i] *= exp(-1 * (delta * delta) / scale2);
+      }
+      break;
+    }
+    default: for (std::size_t i = 0; i < n; i++) vnit[i] *= 0.0;
+  }
+
+  // * fWFPS
+  for (std::size_t i = 0; i < n; i++) vnit[i] *= nit::fWFPS(wfps[i], ps.hminn, ps.hoptn, fc[i], sat[i]);
+}
+
+// layer-batched denitrification
+void stics::vdenit(const Monica::SticsParameters& ps,
+                   std::size_t n,
+                   const double* corg,
+                   const double* NO3,
+                   const double* soilT,
+                   const double* wfps,
+                   const double* soilWaterContent,
+                   double* vdenit) {
+  switch (ps.code_pdenit) {
+    case 1: std::fill(vdenit, vdenit + n, ps.vpotdenit); break;
+    case 2:
+      for (std::size_t i = 0; i < n; i++) {
+        vdenit[i] = stepwiseLinearFunction3(corg[i], ps.cmin_pdenit, ps.cmax_pdenit, ps.min_pdenit, ps.max_pdenit);
+      }
+      break;
+    default: std::fill(vdenit, vdenit + n, 0.0);
+  }
+
+  const auto scale2 = ps.scale_tdenitopt * ps.scale_tdenitopt;
+  const auto wfpsRange = 1 - ps.wfpsc;
+  for (std::size_t i = 0; i < n; i++) {
+    auto fNO3 = NO3[i] / (NO3[i] + (soilWaterContent[i] * ps.Kd));
+    auto delta = soilT[i] - ps.tdenitopt_gauss;
+    auto fT = exp(-1 * (delta * delta) / scale2);
+    auto fWFPS = pow((std::max(wfps[i], ps.wfpsc) - ps.wfpsc) / wfpsRange, 1.74);
+    vdenit[i] = vdenit[i] * fNO3 * fT * fWFPS;
+  }
+}
+
+// layer-batched N2O emissions
+void stics::N2O(const Monica::SticsParameters& ps,
+                std::size_t n,
+                const double* NO3,
+                const double* wfps,
+                const double* pH,
+                const double* vnit,
+                const double* vdenit,
+                double* N2Onit,
+                double* N2Odenit) {
+  switch (ps.code_rationit) {
+    case 1: for (std::size_t i = 0; i < n; i++) N2Onit[i] = ps.rationit * vnit[i]; break;
+    case 2:
+      for (std::size_t i = 0; i < n; i++) {
+        auto z = 0.16 * (0.4 * wfps[i] - 1.04) / (wfps[i] - 1.04) / 100.0;
+        N2Onit[i] = z * vnit[i];
+      }
+      break;
+    default: for (std::size_t i = 0; i < n; i++) N2Onit[i] = 0.0 * vnit[i];
+  }
+
+  switch (ps.code_ratiodenit) {
+    case 1: for (std::size_t i = 0; i < n; i++) N2Odenit[i] = ps.ratiodenit * vdenit[i]; break;
+    case 2: {
+      // the reference WFPS response of rcor doesn't depend on the layer
+      const auto fWFPSref = n2o::fWFPS(0.815, ps.wfpsc);
+      for (std::size_t i = 0; i < n; i++) {
+        auto r =
+          n2o::fpH(pH[i], ps.pHminden, ps.pHmaxden) / fWFPSref
+          * n2o::fWFPS(wfps[i], ps.wfpsc)
+          * n2o::fNO3(NO3[i]);
+        N2Odenit[i] = r * vdenit[i];
+      }
+      break;
+    }
+    default: for (std::size_t i = 0; i < n; i++) N2Odenit[i] = 0.0 * vdenit[i];
+  }
+}
@@ -15,6 +15,8 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 
 #pragma once
 
+#include <cstddef>
+
 #include "core/monica-parameters.h"
 
 namespace stics
@@ -67,4 +69,42 @@ NitDenitN2O N2O(const Monica::SticsParameters& ps,
            double pH,
            double fc,
            double sat);
+
+// layer-batched versions of vnit, vdenit and N2O
+// they compute the first n elements of the given arrays (e.g. all soil layers) at once
+// with the same arithmetic as the scalar functions, so the results are identical
+// the parameter switches and the parameter-only terms are evaluated once per call
+
+// nitrification [mg-N/kg-soil/day] -> vnit[0..n)
+void vnit(const Monica::SticsParameters& ps,
+          std::size_t n,
+          const double* NH4,
+          const double* pH,
+          const double* soilT,
+          const double* wfps,
+          const double* soilWaterContent,
+          const double* fc,
+          const double* sat,
+          double* vnit);
+
+// denitrification [mg-N/kg-soil/day] -> vdenit[0..n)
+void vdenit(const Monica::SticsParameters& ps,
+            std::size_t n,
+            const double* corg,
+            const double* NO3,
+            const double* soilT,
+            const double* wfps,
+            const double* soilWaterContent,
+            double* vdenit);
+
+// N2O emissions [mg-N2O-N/kg-soil/day] -> N2Onit[0..n), N2Odenit[0..n)
+void N2O(const Monica::SticsParameters& ps,
+         std::size_t n,
+         const double* NO3,
+         const double* wfps,
+         const double* pH,
+         const double* vnit,
+         const double* vdenit,
+         double* N2Onit,
+         double* N2Odenit);
 } // namespace stics
@@ -0,0 +1,140 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Claas Nendel <claas.nendel@zalf.de>
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+#include "tridiagonal.h"
+
+using namespace std;
+using namespace Monica;
+
+void Monica::factorSymmetricTridiagonal(size_t n,
+                                        size_t noOfColumns,
+                                        const double* primaryDiagonal,
+                                        const double* secundaryDiagonal,
+                                        double* diagonal,
+                                        double* lowerTriangle)
+{
+	if(n == 0)
+		return;
+
+	// Determination of the lower matrix triangle L and the diagonal matrix D
+	for(size_t c = 0; c < noOfColumns; c++)
+	{
+		diagonal[c] = primaryDiagonal[c];
+		lowerTriangle[c] = 0.0;
+	}
+
+	for(size_t i = 1; i < n; i++)
+	{
+		const double* pd = primaryDiagonal + i * noOfColumns;
+		const double* sd = secundaryDiagonal + i * noOfColumns;
+		const double* dPrev = diagonal + (i - 1) * noOfColumns;
+		double* d = diagonal + i * noOfColumns;
+		double* l = lowerTriangle + i * noOfColumns;
+
+		for(size_t c = 0; c < noOfColumns; c++)
+		{
+			l[c] = sd[c] / dPrev[c];
+			d[c] = pd[c] - (l[c] * sd[c]);
+		}
+	}
+}
+
+void Monica::solveFactoredSymmetricTridiagonal(size_t n,
+                                               size_t noOfColumns,
+                                               const double* diagonal,
+                                               const double* lowerTriangle,
+                                               double* rhs)
+{
+	if(n == 0)
+		return;
+
+	// Solution of LY=Z
+	for(size_t i = 1; i < n; i++)
+	{
+		const double* l = lowerTriangle + i * noOfColumns;
+		const double* yPrev = rhs + (i - 1) * noOfColumns;
+		double* y = rhs + i * noOfColumns;
+
+		for(size_t c = 0; c < noOfColumns; c++)
+			y[c] = y[c] - (l[c] * yPrev[c]);
+	}
+
+	// Solution of L'X=D(-1)Y
+	const size_t last = n - 1;
+	for(size_t c = 0; c < noOfColumns; c++)
+		rhs[last * noOfColumns + c] = rhs[last * noOfColumns + c] / diagonal[last * noOfColumns + c];
+
+	for(size_t k = 0; k < last; k++)
+	{
+		const size_t j = (last - 1) - k;
+		const double* d = diagonal + j * noOfColumns;
+		const double* lNext = lowerTriangle + (j + 1) * noOfColumns;
+		const double* xNext = rhs + (j + 1) * noOfColumns;
+		double* x = rhs + j * noOfColumns;
+
+		for(size_t c = 0; c < noOfColumns; c++)
+			x[c] = (x[c] / d[c]) - (lNext[c] * xNext[c]);
+	}
+}
+
+void Monica::solveTridiagonal(size_t n,
+                              size_t noOfColumns,
+                              const double* lower,
+                              const double* diagonal,
+                              const double* upper,
+                              double* rhs,
+                              double* workspace)
+{
+	if(n == 0)
+		return;
+
+	// forward elimination, workspace keeps the modified upper diagonal
+	for(size_t c = 0; c < noOfColumns; c++)
+	{
+		workspace[c] = upper[c] / diagonal[c];
+		rhs[c] = rhs[c] / diagonal[c];
+	}
+
+	for(size_t i = 1; i < n; i++)
+	{
+		const double* l = lower + i * noOfColumns;
+		const double* d = diagonal + i * noOfColumns;
+		const double* u = upper + i * noOfColumns;
+		const double* wPrev = workspace + (i - 1) * noOfColumns;
+		const double* yPrev = rhs + (i - 1) * noOfColumns;
+		double* w = workspace + i * noOfColumns;
+		double* y = rhs + i * noOfColumns;
+
+		for(size_t c = 0; c < noOfColumns; c++)
+		{
+			const double m = d[c] - (l[c] * wPrev[c]);
+			w[c] = u[c] / m;
+			y[c] = (y[c] - (l[c] * yPrev[c])) / m;
+		}
+	}
+
+	// back substitution
+	for(size_t k = 1; k < n; k++)
+	{
+		const size_t j = (n - 1) - k;
+		const double* w = workspace + j * noOfColumns;
+		const double* xNext = rhs + (j + 1) * noOfColumns;
+		double* x = rhs + j * noOfColumns;
+
+		for(size_t c = 0; c < noOfColumns; c++)
+			x[c] = x[c] - (w[c] * xNext[c]);
+	}
+}
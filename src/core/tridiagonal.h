@@ -0,0 +1,72 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Claas Nendel <claas.nendel@zalf.de>
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+#ifndef TRIDIAGONAL_H_
+#define TRIDIAGONAL_H_
+
+/**
+ * @file tridiagonal.h
+ *
+ * @brief Solution of EX=Z with E tridiagonal. For symmetric E according to
+ * CHOLESKY (E=LDL'), split into factorization and solution, so that a
+ * factorization can be reused as long as the matrix doesn't change, and
+ * for general E by Gaussian elimination without pivoting (Thomas algorithm),
+ * which requires E to be diagonally dominant.
+ *
+ * All routines work on a batch of independent columns (systems) of the same
+ * size n. The values are stored layer major, value (i, c) of column c in
+ * layer i is at index i * noOfColumns + c, so that the inner loops run over
+ * the columns with unit stride. A single system is a batch with one column.
+ */
+
+#include <cstddef>
+
+namespace Monica
+{
+	/**
+	 * Factorizes the matrices given by their primary and secundary diagonal.
+	 * secundary[i] couples layer i-1 and i, the values for i = 0 are not used.
+	 * Writes the diagonal matrix D and the lower triangle L (lowerTriangle[0] is 0).
+	 */
+	void factorSymmetricTridiagonal(std::size_t n,
+	                                std::size_t noOfColumns,
+	                                const double* primaryDiagonal,
+	                                const double* secundaryDiagonal,
+	                                double* diagonal,
+	                                double* lowerTriangle);
+
+	//! solves the factorized systems in place, rhs holds the right side and gets the solution
+	void solveFactoredSymmetricTridiagonal(std::size_t n,
+	                                       std::size_t noOfColumns,
+	                                       const double* diagonal,
+	                                       const double* lowerTriangle,
+	                                       double* rhs);
+
+	/**
+	 * Solves general tridiagonal systems in place. lower[i] couples layer i with i-1,
+	 * upper[i] layer i with i+1, lower[0] and upper[n-1] are not used.
+	 * workspace has to hold n * noOfColumns values.
+	 */
+	void solveTridiagonal(std::size_t n,
+	                      std::size_t noOfColumns,
+	                      const double* lower,
+	                      const double* diagonal,
+	                      const double* upper,
+	                      double* rhs,
+	                      double* workspace);
+}
+
+#endif
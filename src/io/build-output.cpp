@@ -942,7 +942,7 @@ BOTRes& Monica::buildOutputTable()
 				setComplexValues(oid, [&](int i, Json j)
 				{
 					if (j.is_number())
-						monica.soilColumnNC()[i].vs_SoilNO3 = j.number_value();
+						monica.soilColumnNC()[i].vs_SoilNO3() = j.number_value();
 				}, value);
 			});
 
@@ -958,7 +958,7 @@ BOTRes& Monica::buildOutputTable()
 				setComplexValues(oid, [&](int i, Json j)
 				{
 					if (j.is_number())
-						monica.soilColumnNC()[i].vs_SoilCarbamid = j.number_value();
+						monica.soilColumnNC()[i].vs_SoilCarbamid() = j.number_value();
 				}, value);
 			});
 
@@ -972,7 +972,7 @@ BOTRes& Monica::buildOutputTable()
 				setComplexValues(oid, [&](int i, Json j)
 				{
 					if (j.is_number())
-						monica.soilColumnNC()[i].vs_SoilNH4 = j.number_value();
+						monica.soilColumnNC()[i].vs_SoilNH4() = j.number_value();
 				}, value);
 			});
 
@@ -986,7 +986,7 @@ BOTRes& Monica::buildOutputTable()
 				setComplexValues(oid, [&](int i, Json j)
 				{
 					if (j.is_number())
-						monica.soilColumnNC()[i].vs_SoilNO2 = j.number_value();
+						monica.soilColumnNC()[i].vs_SoilNO2() = j.number_value();
 				}, value);
 			});
 
@@ -1488,6 +1488,18 @@ BOTRes& Monica::buildOutputTable()
 				}, 5);
 			});
 
+			build({ id++, "noOfCoalescedAOMPools", "", "number of AOM pools merged so far" },
+				[](const MonicaModel& monica, OId oid)
+			{
+				return monica.soilOrganic().get_AOM_CoalescedPools();
+			});
+
+			build({ id++, "AOMCoalescingError", "kgC m-2", "approximation error caused by merging AOM pools with different parameters" },
+				[](const MonicaModel& monica, OId oid)
+			{
+				return round(monica.soilOrganic().get_AOM_CoalescingError(), 6);
+			});
+
 			build({ id++, "rootNConcentration", "", "rootNConcentration" },
 				[](const MonicaModel& monica, OId oid)
 			{
@@ -1517,6 +1529,30 @@ BOTRes& Monica::buildOutputTable()
               return getComplexValues<double>(oid, [&](int i) { return monica.soilOrganic().actDenitrificationRate(i); }, 6);
             });
 
+			build({ id++, "snowSkippedDays", "", "number of days the snow calculation was skipped, because there was neither snow nor snowfall" },
+				[](const MonicaModel& monica, OId oid)
+			{
+				return monica.soilMoisture().getSnowSkippedDays();
+			});
+
+			build({ id++, "frostSkippedDays", "", "number of days the soil frost calculation was skipped, because the soil was unfrozen and it didn't freeze" },
+				[](const MonicaModel& monica, OId oid)
+			{
+				return monica.soilMoisture().getFrostSkippedDays();
+			});
+
+			build({ id++, "NTransportDev", "kgN ha-1", "max. deviation of a layer's NO3 from the reference transport scheme, needs ValidateNTransportScheme" },
+				[](const MonicaModel& monica, OId oid)
+			{
+				return round(monica.soilTransport().get_NTransportDeviation(), 5);
+			});
+
+			build({ id++, "NLeachDev", "kgN ha-1", "deviation of the N leaching from the reference transport scheme, needs ValidateNTransportScheme" },
+				[](const MonicaModel& monica, OId oid)
+			{
+				return round(monica.soilTransport().get_NLeachingDeviation(), 5);
+			});
+
 			tableBuilt = true;
 		}
 	}
@@ -19,6 +19,7 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 #include <mutex>
 #include <memory>
 #include <tuple>
+#include <unordered_map>
 
 #include "tools/debug.h"
 #include "db/abstract-db-connections.h"
@@ -200,192 +201,300 @@ namespace
 			+ (cropId == -1 ? "" : string("WHERE crop_id = ") + to_string(cropId) + " ")
 			+ "ORDER BY crop_id, organ_id";
 	}
-}
-
-SpeciesParametersPtr Monica::getSpeciesParametersFromMonicaDB(const string& species,
-                                                              std::string abstractDbSchema)
-{
-	SpeciesParametersPtr sps = make_shared<SpeciesParameters>();
 
-	DBPtr con(newConnection(abstractDbSchema));
-	DBRow row;
-	con->select(speciesSelect(species));
-	debug() << speciesSelect(species) << endl;
-	if(!(row = con->getRow()).empty())
+	//! the calling thread's connection to the abstract schema, opened at the first use
+	//! and kept open for the thread's lifetime
+	//! (a query invalidates the result set of the previous one on the same connection)
+	DB& connection(const string& abstractDbSchema)
 	{
-		int i = 0;
-
-		sps->pc_SpeciesId = row[i++];
-		sps->pc_CarboxylationPathway = stoi(row[i++]);
-		sps->pc_MinimumTemperatureForAssimilation = stof(row[i++]);
-		sps->pc_MinimumNConcentration = stof(row[i++]);
-		sps->pc_NConcentrationPN = stof(row[i++]);
-		sps->pc_NConcentrationB0 = stof(row[i++]);
-		sps->pc_NConcentrationAbovegroundBiomass = stof(row[i++]);
-		sps->pc_NConcentrationRoot = stof(row[i++]);
-		sps->pc_InitialKcFactor = stof(row[i++]);
-		sps->pc_DevelopmentAccelerationByNitrogenStress = stoi(row[i++]);
-		sps->pc_PartBiologicalNFixation = stof(row[i++]);
-		sps->pc_LuxuryNCoeff = stof(row[i++]);
-		sps->pc_SamplingDepth = stof(row[i++]);
-		sps->pc_TargetNSamplingDepth = stof(row[i++]);
-		sps->pc_TargetN30 = stof(row[i++]);
-		sps->pc_DefaultRadiationUseEfficiency = stof(row[i++]);
-		sps->pc_StageAtMaxHeight = stof(row[i++]);
-		sps->pc_MaxCropDiameter = stof(row[i++]);
-		sps->pc_StageAtMaxDiameter = stof(row[i++]);
-		sps->pc_MaxNUptakeParam = stof(row[i++]);
-		sps->pc_RootDistributionParam = stof(row[i++]);
-		sps->pc_PlantDensity = (int)stof(row[i++]);
-		sps->pc_RootGrowthLag = stof(row[i++]);
-		sps->pc_MinimumTemperatureRootGrowth = stof(row[i++]);
-		sps->pc_InitialRootingDepth = stof(row[i++]);
-		sps->pc_RootPenetrationRate = stof(row[i++]);
-		sps->pc_RootFormFactor = stof(row[i++]);
-		sps->pc_SpecificRootLength = stof(row[i++]);
-		sps->pc_StageAfterCut = stoi(row[i++]);
-		sps->pc_LimitingTemperatureHeatStress = stof(row[i++]);
-		sps->pc_DroughtImpactOnFertilityFactor = stof(row[i++]);
-		sps->pc_CuttingDelayDays = stoi(row[i++]);
-		sps->pc_FieldConditionModifier = stof(row[i++]);
-		sps->pc_AssimilateReallocation = stof(row[i++]);
+		thread_local map<string, DBPtr> connections;
+		auto& con = connections[abstractDbSchema];
+		if(!con)
+			con.reset(newConnection(abstractDbSchema));
+		return *con;
 	}
 
-	con->select(organSelect(species));
-	debug() << organSelect(species) << endl;
-	while(!(row = con->getRow()).empty())
+	//! all rows of the query, so the connection is free for further queries while they are processed
+	vector<DBRow> selectRows(DB& con, const string& query)
 	{
-		sps->pc_InitialOrganBiomass.push_back(stod(row[2]));
-		sps->pc_OrganMaintenanceRespiration.push_back(stod(row[3]));
-		sps->pc_AbovegroundOrgan.push_back(stob(row[4]));
-		sps->pc_OrganGrowthRespiration.push_back(stod(row[5]));
-		sps->pc_StorageOrgan.push_back(stob(row[6]));
+		vector<DBRow> rows;
+		con.select(query);
+		DBRow row;
+		while(!(row = con.getRow()).empty())
+			rows.push_back(row);
+		return rows;
 	}
 
-	con->select(devStageSpeciesSelect(species));
-	debug() << devStageSpeciesSelect(species) << endl;
+	/**
+	 * Results of parameter queries against the (read only) MONICA database,
+	 * by schema and query arguments. A result is loaded at the first request,
+	 * outside the lock; if another thread was faster, its result wins.
+	 */
+	template<typename T>
+	class QueryCache
+	{
+	public:
+		template<typename Load>
+		shared_ptr<const T> get(const string& key, Load load)
+		{
+			{
+				lock_guard<mutex> lock(_lockable);
+				auto it = _results.find(key);
+				if(it != _results.end())
+					return it->second;
+			}
 
-	while(!(row = con->getRow()).empty())
+			shared_ptr<const T> result = load();
+			lock_guard<mutex> lock(_lockable);
+			return _results.emplace(key, result).first->second;
+		}
+
+		size_t size()
+		{
+			lock_guard<mutex> lock(_lockable);
+			return _results.size();
+		}
+
+		void clear()
+		{
+			lock_guard<mutex> lock(_lockable);
+			_results.clear();
+		}
+
+	private:
+		mutex _lockable;
+		unordered_map<string, shared_ptr<const T>> _results;
+	};
+
+	string cacheKey(const string& abstractDbSchema, const string& a, const string& b = string())
 	{
-		sps->pc_BaseTemperature.push_back(stod(row[2]));
-		sps->pc_CriticalOxygenContent.push_back(stod(row[3]));
-		sps->pc_StageMaxRootNConcentration.push_back(stod(row[4]));
+		return abstractDbSchema + '\n' + a + '\n' + b;
 	}
 
-	return sps;
+	QueryCache<SpeciesParameters>& speciesCache() { static QueryCache<SpeciesParameters> c; return c; }
+	QueryCache<CultivarParameters>& cultivarCache() { static QueryCache<CultivarParameters> c; return c; }
+	QueryCache<CropResidueParameters>& residueCache() { static QueryCache<CropResidueParameters> c; return c; }
+	QueryCache<vector<DBRow>>& userParamsCache() { static QueryCache<vector<DBRow>> c; return c; }
+
+	typedef map<int, pair<SpeciesParametersPtr, CultivarParametersPtr>> CropsMap;
+	typedef map<string, MineralFertiliserParameters> MineralFertilisersMap;
+	typedef map<string, OrganicFertiliserParametersPtr> OrganicFertilisersMap;
+
+	//! whole tables, by schema
+	QueryCache<CropsMap>& cropsCache() { static QueryCache<CropsMap> c; return c; }
+	QueryCache<MineralFertilisersMap>& mineralFertilisersCache() { static QueryCache<MineralFertilisersMap> c; return c; }
+	QueryCache<OrganicFertilisersMap>& organicFertilisersCache() { static QueryCache<OrganicFertilisersMap> c; return c; }
+	QueryCache<map<int, AMCRes>>& availableCropsCache() { static QueryCache<map<int, AMCRes>> c; return c; }
 }
 
-CultivarParametersPtr Monica::getCultivarParametersFromMonicaDB(const string& species,
-                                                                const string& cultivar,
-                                                                std::string abstractDbSchema)
+namespace
 {
-	CultivarParametersPtr cps = make_shared<CultivarParameters>();
+	SpeciesParametersPtr selectSpeciesParameters(DB& con, const string& species)
+	{
+		SpeciesParametersPtr sps = make_shared<SpeciesParameters>();
+
+		DBRow row;
+		con.select(speciesSelect(species));
+		debug() << speciesSelect(species) << endl;
+		if(!(row = con.getRow()).empty())
+		{
+			int i = 0;
+
+			sps->pc_SpeciesId = row[i++];
+			sps->pc_CarboxylationPathway = stoi(row[i++]);
+			sps->pc_MinimumTemperatureForAssimilation = stof(row[i++]);
+			sps->pc_MinimumNConcentration = stof(row[i++]);
+			sps->pc_NConcentrationPN = stof(row[i++]);
+			sps->pc_NConcentrationB0 = stof(row[i++]);
+			sps->pc_NConcentrationAbovegroundBiomass = stof(row[i++]);
+			sps->pc_NConcentrationRoot = stof(row[i++]);
+			sps->pc_InitialKcFactor = stof(row[i++]);
+			sps->pc_DevelopmentAccelerationByNitrogenStress = stoi(row[i++]);
+			sps->pc_PartBiologicalNFixation = stof(row[i++]);
+			sps->pc_LuxuryNCoeff = stof(row[i++]);
+			sps->pc_SamplingDepth = stof(row[i++]);
+			sps->pc_TargetNSamplingDepth = stof(row[i++]);
+			sps->pc_TargetN30 = stof(row[i++]);
+			sps->pc_DefaultRadiationUseEfficiency = stof(row[i++]);
+			sps->pc_StageAtMaxHeight = stof(row[i++]);
+			sps->pc_MaxCropDiameter = stof(row[i++]);
+			sps->pc_StageAtMaxDiameter = stof(row[i++]);
+			sps->pc_MaxNUptakeParam = stof(row[i++]);
+			sps->pc_RootDistributionParam = stof(row[i++]);
+			sps->pc_PlantDensity = (int)stof(row[i++]);
+			sps->pc_RootGrowthLag = stof(row[i++]);
+			sps->pc_MinimumTemperatureRootGrowth = stof(row[i++]);
+			sps->pc_InitialRootingDepth = stof(row[i++]);
+			sps->pc_RootPenetrationRate = stof(row[i++]);
+			sps->pc_RootFormFactor = stof(row[i++]);
+			sps->pc_SpecificRootLength = stof(row[i++]);
+			sps->pc_StageAfterCut = stoi(row[i++]);
+			sps->pc_LimitingTemperatureHeatStress = stof(row[i++]);
+			sps->pc_DroughtImpactOnFertilityFactor = stof(row[i++]);
+			sps->pc_CuttingDelayDays = stoi(row[i++]);
+			sps->pc_FieldConditionModifier = stof(row[i++]);
+			sps->pc_AssimilateReallocation = stof(row[i++]);
+		}
 
-	int cropId = -1;
+		con.select(organSelect(species));
+		debug() << organSelect(species) << endl;
+		while(!(row = con.getRow()).empty())
+		{
+			sps->pc_InitialOrganBiomass.push_back(stod(row[2]));
+			sps->pc_OrganMaintenanceRespiration.push_back(stod(row[3]));
+			sps->pc_AbovegroundOrgan.push_back(stob(row[4]));
+			sps->pc_OrganGrowthRespiration.push_back(stod(row[5]));
+			sps->pc_StorageOrgan.push_back(stob(row[6]));
+		}
 
-	DBPtr con(newConnection(abstractDbSchema));
-	DBRow row;
-	con->select(cultivarSelect(species, cultivar));
-	debug() << cultivarSelect(species, cultivar) << endl;
-	if(!(row = con->getRow()).empty())
-	{
-		int i = 0;
-
-		cropId = stoi(row[i++]);
-		i++;
-		cps->pc_CultivarId = row[i++];
-		cps->pc_Description = row[i++];
-		cps->pc_Perennial = stob(row[i++]);
-		//cps->pc_PermanentCultivarId = row[i++];
-		cps->pc_MaxAssimilationRate = stof(row[i++]);
-		cps->pc_MaxCropHeight = stof(row[i++]);
-		cps->pc_CropHeightP1 = stof(row[i++]);
-		cps->pc_CropHeightP2 = stof(row[i++]);
-		cps->pc_CropSpecificMaxRootingDepth = stof(row[i++]);
-		cps->pc_ResidueNRatio = stof(row[i++]);
-		cps->pc_HeatSumIrrigationStart = stof(row[i++]);
-		cps->pc_HeatSumIrrigationEnd = stof(row[i++]);
-		cps->pc_CriticalTemperatureHeatStress = stof(row[i++]);
-		cps->pc_BeginSensitivePhaseHeatStress = stof(row[i++]);
-		cps->pc_EndSensitivePhaseHeatStress = stof(row[i++]);
-		cps->pc_LT50cultivar = stof(row[i++]);
-		cps->pc_FrostHardening = stof(row[i++]);
-		cps->pc_FrostDehardening = stof(row[i++]);
-		cps->pc_LowTemperatureExposure = stof(row[i++]);
-		cps->pc_RespiratoryStress = stof(row[i++]);
-		cps->pc_LatestHarvestDoy = stoi(row[i++]);
+		con.select(devStageSpeciesSelect(species));
+		debug() << devStageSpeciesSelect(species) << endl;
+
+		while(!(row = con.getRow()).empty())
+		{
+			sps->pc_BaseTemperature.push_back(stod(row[2]));
+			sps->pc_CriticalOxygenContent.push_back(stod(row[3]));
+			sps->pc_StageMaxRootNConcentration.push_back(stod(row[4]));
+		}
+
+		return sps;
 	}
+}
 
-	con->select(devStageCultivarSelect(cropId));
-	debug() << devStageCultivarSelect(cropId) << endl;
-	while(!(row = con->getRow()).empty())
+SpeciesParametersPtr Monica::getSpeciesParametersFromMonicaDB(const string& species,
+                                                              std::string abstractDbSchema)
+{
+	auto sps = speciesCache().get(cacheKey(abstractDbSchema, species), [&]()
 	{
-		int i = 2;
-
-		cps->pc_StageTemperatureSum.push_back(stod(row[i++]));
-		cps->pc_OptimumTemperature.push_back(stod(row[i++]));
-		cps->pc_VernalisationRequirement.push_back(stod(row[i++]));
-		cps->pc_DaylengthRequirement.push_back(stod(row[i++]));
-		cps->pc_BaseDaylength.push_back(stod(row[i++]));
-		cps->pc_DroughtStressThreshold.push_back(stod(row[i++]));
-		cps->pc_SpecificLeafArea.push_back(stod(row[i++]));
-		cps->pc_StageKcFactor.push_back(stod(row[i++]));
-	}
+		return selectSpeciesParameters(connection(abstractDbSchema), species);
+	});
+	return make_shared<SpeciesParameters>(*sps);
+}
 
-	con->select(odsDepParamsSelect(cropId));
-	debug() << odsDepParamsSelect(cropId) << endl;
-	while(!(row = con->getRow()).empty())
+namespace
+{
+	CultivarParametersPtr selectCultivarParameters(DB& con,
+	                                               const string& species,
+	                                               const string& cultivar)
 	{
-		size_t organId = stoi(row[1]);
-		size_t devStageId = stoi(row[2]);
+		CultivarParametersPtr cps = make_shared<CultivarParameters>();
 
-		auto& sov = stoi(row[3]) == 1 ? cps->pc_AssimilatePartitioningCoeff : cps->pc_OrganSenescenceRate;
+		int cropId = -1;
 
-		if(sov.size() < devStageId)
-			sov.resize(devStageId);
-		auto& ds = sov[devStageId - 1];
+		DBRow row;
+		con.select(cultivarSelect(species, cultivar));
+		debug() << cultivarSelect(species, cultivar) << endl;
+		if(!(row = con.getRow()).empty())
+		{
+			int i = 0;
+
+			cropId = stoi(row[i++]);
+			i++;
+			cps->pc_CultivarId = row[i++];
+			cps->pc_Description = row[i++];
+			cps->pc_Perennial = stob(row[i++]);
+			//cps->pc_PermanentCultivarId = row[i++];
+			cps->pc_MaxAssimilationRate = stof(row[i++]);
+			cps->pc_MaxCropHeight = stof(row[i++]);
+			cps->pc_CropHeightP1 = stof(row[i++]);
+			cps->pc_CropHeightP2 = stof(row[i++]);
+			cps->pc_CropSpecificMaxRootingDepth = stof(row[i++]);
+			cps->pc_ResidueNRatio = stof(row[i++]);
+			cps->pc_HeatSumIrrigationStart = stof(row[i++]);
+			cps->pc_HeatSumIrrigationEnd = stof(row[i++]);
+			cps->pc_CriticalTemperatureHeatStress = stof(row[i++]);
+			cps->pc_BeginSensitivePhaseHeatStress = stof(row[i++]);
+			cps->pc_EndSensitivePhaseHeatStress = stof(row[i++]);
+			cps->pc_LT50cultivar = stof(row[i++]);
+			cps->pc_FrostHardening = stof(row[i++]);
+			cps->pc_FrostDehardening = stof(row[i++]);
+			cps->pc_LowTemperatureExposure = stof(row[i++]);
+			cps->pc_RespiratoryStress = stof(row[i++]);
+			cps->pc_LatestHarvestDoy = stoi(row[i++]);
+		}
 
-		if(ds.size() < organId)
-			ds.resize(organId);
+		con.select(devStageCultivarSelect(cropId));
+		debug() << devStageCultivarSelect(cropId) << endl;
+		while(!(row = con.getRow()).empty())
+		{
+			int i = 2;
+
+			cps->pc_StageTemperatureSum.push_back(stod(row[i++]));
+			cps->pc_OptimumTemperature.push_back(stod(row[i++]));
+			cps->pc_VernalisationRequirement.push_back(stod(row[i++]));
+			cps->pc_DaylengthRequirement.push_back(stod(row[i++]));
+			cps->pc_BaseDaylength.push_back(stod(row[i++]));
+			cps->pc_DroughtStressThreshold.push_back(stod(row[i++]));
+			cps->pc_SpecificLeafArea.push_back(stod(row[i++]));
+			cps->pc_StageKcFactor.push_back(stod(row[i++]));
+		}
 
-		ds[organId - 1] = stod(row[4]);
-	}
+		con.select(odsDepParamsSelect(cropId));
+		debug() << odsDepParamsSelect(cropId) << endl;
+		while(!(row = con.getRow()).empty())
+		{
+			size_t organId = stoi(row[1]);
+			size_t devStageId = stoi(row[2]);
 
-	cps->pc_OrganIdsForPrimaryYield.clear();
-	cps->pc_OrganIdsForSecondaryYield.clear();
-	con->select(yieldPartsSelect(cropId));
-	debug() << yieldPartsSelect(cropId) << endl;
-	while(!(row = con->getRow()).empty())
-	{
-		bool isPrimary = stob(row[2]);
+			auto& sov = stoi(row[3]) == 1 ? cps->pc_AssimilatePartitioningCoeff : cps->pc_OrganSenescenceRate;
 
-		YieldComponent yc;
-		yc.organId = stoi(row[1]);
-		yc.yieldPercentage = stod(row[3]) / 100.0;
-		yc.yieldDryMatter = stod(row[4]);
+			if(sov.size() < devStageId)
+				sov.resize(devStageId);
+			auto& ds = sov[devStageId - 1];
 
-		// normal case, uses yield partitioning from crop database
-		if(isPrimary)
-			cps->pc_OrganIdsForPrimaryYield.push_back(yc);
-		else
-			cps->pc_OrganIdsForSecondaryYield.push_back(yc);
-	}
+			if(ds.size() < organId)
+				ds.resize(organId);
 
-	// get cutting parts if there are some data available
-	cps->pc_OrganIdsForCutting.clear();
-	con->select(cuttingPartsSelect(cropId));
-	while(!(row = con->getRow()).empty())
-	{
-		YieldComponent yc;
-		yc.organId = stoi(row[1]);
-		//bool isPrimary = stoi(row[2]) == 1;
-		yc.yieldPercentage = stof(row[3]) / 100.0;
-		yc.yieldDryMatter = stof(row[4]);
+			ds[organId - 1] = stod(row[4]);
+		}
 
-		cps->pc_OrganIdsForCutting.push_back(yc);
+		cps->pc_OrganIdsForPrimaryYield.clear();
+		cps->pc_OrganIdsForSecondaryYield.clear();
+		con.select(yieldPartsSelect(cropId));
+		debug() << yieldPartsSelect(cropId) << endl;
+		while(!(row = con.getRow()).empty())
+		{
+			bool isPrimary = stob(row[2]);
+
+			YieldComponent yc;
+			yc.organId = stoi(row[1]);
+			yc.yieldPercentage = stod(row[3]) / 100.0;
+			yc.yieldDryMatter = stod(row[4]);
+
+			// normal case, uses yield partitioning from crop database
+			if(isPrimary)
+				cps->pc_OrganIdsForPrimaryYield.push_back(yc);
+			else
+				cps->pc_OrganIdsForSecondaryYield.push_back(yc);
+		}
+
+		// get cutting parts if there are some data available
+		cps->pc_OrganIdsForCutting.clear();
+		con.select(cuttingPartsSelect(cropId));
+		while(!(row = con.getRow()).empty())
+		{
+			YieldComponent yc;
+			yc.organId = stoi(row[1]);
+			//bool isPrimary = stoi(row[2]) == 1;
+			yc.yieldPercentage = stof(row[3]) / 100.0;
+			yc.yieldDryMatter = stof(row[4]);
+
+			cps->pc_OrganIdsForCutting.push_back(yc);
+		}
+
+		return cps;
 	}
+}
 
-	return cps;
+CultivarParametersPtr Monica::getCultivarParametersFromMonicaDB(const string& species,
+                                                                const string& cultivar,
+                                                                std::string abstractDbSchema)
+{
+	auto cps = cultivarCache().get(cacheKey(abstractDbSchema, species, cultivar), [&]()
+	{
+		return selectCultivarParameters(connection(abstractDbSchema), species, cultivar);
+	});
+	return make_shared<CultivarParameters>(*cps);
 }
 
 CropParametersPtr Monica::getCropParametersFromMonicaDB(const string& species,
@@ -398,43 +507,26 @@ CropParametersPtr Monica::getCropParametersFromMonicaDB(const string& species,
 	return cps;
 }
 
-const map<int, pair<SpeciesParametersPtr, CultivarParametersPtr>>&
-getAllCropParametersFromMonicaDB(std::string abstractDbSchema = "monica")
+namespace
 {
-	static mutex lockable;
-
-	static bool initialized = false;
-	typedef map<int, pair<SpeciesParametersPtr, CultivarParametersPtr>> CPS;
-
-	static CPS cpss;
-
-	// only initialize once
-	if(!initialized)
+	shared_ptr<const CropsMap> getAllCropParametersFromMonicaDB(std::string abstractDbSchema = "monica")
 	{
-		lock_guard<mutex> lock(lockable);
-
-		//test if after waiting for the lock the other thread
-		//already initialized the whole thing
-		if(!initialized)
+		return cropsCache().get(cacheKey(abstractDbSchema, "crops"), [&]()
 		{
-			DBPtr con(newConnection(abstractDbSchema));
-			DBRow row;
-			con->select("select crop_id, species_id, id from cultivar order by crop_id");
-			while(!(row = con->getRow()).empty())
+			auto cpss = make_shared<CropsMap>();
+			for(const auto& row : selectRows(connection(abstractDbSchema),
+			                                 "select crop_id, species_id, id from cultivar order by crop_id"))
 			{
 				int cropId = stoi(row[0]);
 				string speciesId = row[1];
 				string cultivarId = row[2];
 
-				cpss[cropId] = make_pair(getSpeciesParametersFromMonicaDB(speciesId),
-																 getCultivarParametersFromMonicaDB(speciesId, cultivarId));
+				(*cpss)[cropId] = make_pair(getSpeciesParametersFromMonicaDB(speciesId, abstractDbSchema),
+				                            getCultivarParametersFromMonicaDB(speciesId, cultivarId, abstractDbSchema));
 			}
-
-			initialized = true;
-		}
+			return cpss;
+		});
 	}
-
-	return cpss;
 }
 
 CropParametersPtr Monica::getCropParametersFromMonicaDB(int cropId,
@@ -443,8 +535,8 @@ CropParametersPtr Monica::getCropParametersFromMonicaDB(int cropId,
 	static CropParametersPtr nothing = make_shared<CropParameters>();
 
 	auto m = getAllCropParametersFromMonicaDB(abstractDbSchema);
-	auto ci = m.find(cropId);
-	if(ci != m.end())
+	auto ci = m->find(cropId);
+	if(ci != m->end())
 	{
 		CropParametersPtr cps = make_shared<CropParameters>();
 		cps->speciesParams = *ci->second.first;
@@ -490,23 +582,16 @@ void Monica::writeCropParameters(string path, std::string abstractDbSchema)
 
 //------------------------------------------------------------------------------
 
-const map<string, MineralFertiliserParameters>&
-getAllMineralFertiliserParametersFromMonicaDB(string abstractDbSchema = "monica")
+namespace
 {
-	static mutex lockable;
-	static bool initialized = false;
-	static map<string, MineralFertiliserParameters> m;
-
-	if(!initialized)
+	shared_ptr<const MineralFertilisersMap>
+	getAllMineralFertiliserParametersFromMonicaDB(string abstractDbSchema = "monica")
 	{
-		lock_guard<mutex> lock(lockable);
-
-		if(!initialized)
+		return mineralFertilisersCache().get(cacheKey(abstractDbSchema, "mineral_fertiliser"), [&]()
 		{
-			DBPtr con(newConnection(abstractDbSchema));
-			DBRow row;
-			con->select("select id, name, no3, nh4, carbamid from mineral_fertiliser");
-			while(!(row = con->getRow()).empty())
+			auto m = make_shared<MineralFertilisersMap>();
+			for(const auto& row : selectRows(connection(abstractDbSchema),
+			                                 "select id, name, no3, nh4, carbamid from mineral_fertiliser"))
 			{
 				string id = row[0];
 				string name = row[1];
@@ -514,14 +599,11 @@ getAllMineralFertiliserParametersFromMonicaDB(string abstractDbSchema = "monica"
 				double nh4 = satof(row[3]);
 				double carbamid = satof(row[4]);
 
-				m[id] = MineralFertiliserParameters(id, name, carbamid, no3, nh4);
+				(*m)[id] = MineralFertiliserParameters(id, name, carbamid, no3, nh4);
 			}
-
-			initialized = true;
-		}
+			return m;
+		});
 	}
-
-	return m;
 }
 
 /**
@@ -534,14 +616,15 @@ Monica::getMineralFertiliserParametersFromMonicaDB(const std::string& id,
                                                    string abstractDbSchema)
 {
 	auto m = getAllMineralFertiliserParametersFromMonicaDB(abstractDbSchema);
-	auto ci = m.find(id);
-	return ci != m.end() ? ci->second : MineralFertiliserParameters();
+	auto ci = m->find(id);
+	return ci != m->end() ? ci->second : MineralFertiliserParameters();
 }
 
 void Monica::writeMineralFertilisers(string path,
                                      std::string abstractDbSchema)
 {
-	for(auto p : getAllMineralFertiliserParametersFromMonicaDB(abstractDbSchema))
+	auto mfs = getAllMineralFertiliserParametersFromMonicaDB(abstractDbSchema);
+	for(auto p : *mfs)
 	{
 		auto mf = p.second;
 
@@ -564,40 +647,31 @@ void Monica::writeMineralFertilisers(string path,
 
 //--------------------------------------------------------------------------------------
 
-const map<string, OrganicFertiliserParametersPtr>&
-getAllOrganicFertiliserParametersFromMonicaDB(std::string abstractDbSchema = "monica")
+namespace
 {
-	static mutex lockable;
-	static bool initialized = false;
-	typedef map<string, OrganicFertiliserParametersPtr> Map;
-	static Map m;
-
-	if(!initialized)
+	shared_ptr<const OrganicFertilisersMap>
+	getAllOrganicFertiliserParametersFromMonicaDB(std::string abstractDbSchema = "monica")
 	{
-		lock_guard<mutex> lock(lockable);
-
-		if(!initialized)
+		return organicFertilisersCache().get(cacheKey(abstractDbSchema, "organic_fertiliser"), [&]()
 		{
-			DBPtr con(newConnection(abstractDbSchema));
-			DBRow row;
-			con->select(
-				"select "
-				"id, "
-				"name, "
-				"dm, "
-				"nh4_n, "
-				"no3_n, "
-				"nh2_n, "
-				"k_slow, "
-				"k_fast, "
-				"part_s, "
-				"part_f, "
-				"cn_s, "
-				"cn_f, "
-				"smb_s, "
-				"smb_f "
-				"from organic_fertiliser");
-			while(!(row = con->getRow()).empty())
+			auto m = make_shared<OrganicFertilisersMap>();
+			for(const auto& row : selectRows(connection(abstractDbSchema),
+			                                 "select "
+			                                 "id, "
+			                                 "name, "
+			                                 "dm, "
+			                                 "nh4_n, "
+			                                 "no3_n, "
+			                                 "nh2_n, "
+			                                 "k_slow, "
+			                                 "k_fast, "
+			                                 "part_s, "
+			                                 "part_f, "
+			                                 "cn_s, "
+			                                 "cn_f, "
+			                                 "smb_s, "
+			                                 "smb_f "
+			                                 "from organic_fertiliser"))
 			{
 				OrganicFertiliserParametersPtr omp = make_shared<OrganicFertiliserParameters>();
 
@@ -618,14 +692,11 @@ getAllOrganicFertiliserParametersFromMonicaDB(std::string abstractDbSchema = "mo
 				omp->vo_PartAOM_Slow_to_SMB_Slow = stof(row[i++]);
 				omp->vo_PartAOM_Slow_to_SMB_Fast = stof(row[i++]);
 
-				m[omp->id] = omp;
+				(*m)[omp->id] = omp;
 			}
-
-			initialized = true;
-		}
+			return m;
+		});
 	}
-
-	return m;
 }
 
 /**
@@ -640,13 +711,14 @@ Monica::getOrganicFertiliserParametersFromMonicaDB(const std::string& id,
 	static OrganicFertiliserParametersPtr nothing = make_shared<OrganicFertiliserParameters>();
 
 	auto m = getAllOrganicFertiliserParametersFromMonicaDB(abstractDbSchema);
-	auto ci = m.find(id);
-	return ci != m.end() ? ci->second : nothing;
+	auto ci = m->find(id);
+	return ci != m->end() ? ci->second : nothing;
 }
 
 void Monica::writeOrganicFertilisers(string path, std::string abstractDbSchema)
 {
-	for(auto p : getAllOrganicFertiliserParametersFromMonicaDB(abstractDbSchema))
+	auto ofs = getAllOrganicFertiliserParametersFromMonicaDB(abstractDbSchema);
+	for(auto p : *ofs)
 	{
 		OrganicFertiliserParametersPtr of = p.second;
 
@@ -670,66 +742,82 @@ void Monica::writeOrganicFertilisers(string path, std::string abstractDbSchema)
 
 //--------------------------------------------------------------------------------------
 
+namespace
+{
+	CropResidueParametersPtr selectResidueParameters(DB& con,
+	                                                 const string& species,
+	                                                 const string& residueType)
+	{
+		DBRow row;
+		string query = string() +
+			"select "
+			"species_id, "
+			"residue_type, "
+			"dm, "
+			"nh4, "
+			"no3, "
+			"nh2, "
+			"k_slow, "
+			"k_fast, "
+			"part_s, "
+			"part_f, "
+			"cn_s, "
+			"cn_f, "
+			"smb_s, "
+			"smb_f "
+			"from crop_residue "
+			"where species_id = '"
+			+ species +
+			"' "
+			"and (residue_type = '"
+			+ residueType +
+			"' or residue_type is null) "
+			"order by species_id, residue_type desc";
+
+		//cout << "query: " << query << endl;
+		con.select(query);
+		//take the first (best matching) element
+		//at least there should always be the "default" residue parameters with
+		//type = NULL be available
+		if(!(row = con.getRow()).empty())
+		{
+			CropResidueParametersPtr omp = make_shared<CropResidueParameters>();
+
+			int i = 0;
+
+			omp->species = row[i++];
+			omp->residueType = row[i++];
+			omp->vo_AOM_DryMatterContent = stoi(row[i++]);
+			omp->vo_AOM_NH4Content = stof(row[i++]);
+			omp->vo_AOM_NO3Content = stof(row[i++]);
+			omp->vo_AOM_CarbamidContent = stof(row[i++]);
+			omp->vo_AOM_SlowDecCoeffStandard = stof(row[i++]);
+			omp->vo_AOM_FastDecCoeffStandard = stof(row[i++]);
+			omp->vo_PartAOM_to_AOM_Slow = stof(row[i++]);
+			omp->vo_PartAOM_to_AOM_Fast = stof(row[i++]);
+			omp->vo_CN_Ratio_AOM_Slow = stof(row[i++]);
+			omp->vo_CN_Ratio_AOM_Fast = stof(row[i++]);
+			omp->vo_PartAOM_Slow_to_SMB_Slow = stof(row[i++]);
+			omp->vo_PartAOM_Slow_to_SMB_Fast = stof(row[i++]);
+
+			return omp;
+		}
+
+		return CropResidueParametersPtr();
+	}
+}
+
 CropResidueParametersPtr
 Monica::getResidueParametersFromMonicaDB(const string& species,
 																				 const string& residueType,
 																				 std::string abstractDbSchema)
 {
-	DBPtr con(newConnection(abstractDbSchema));
-	DBRow row;
-	string query = string() +
-		"select "
-		"species_id, "
-		"residue_type, "
-		"dm, "
-		"nh4, "
-		"no3, "
-		"nh2, "
-		"k_slow, "
-		"k_fast, "
-		"part_s, "
-		"part_f, "
-		"cn_s, "
-		"cn_f, "
-		"smb_s, "
-		"smb_f "
-		"from crop_residue "
-		"where species_id = '"
-		+ species +
-		"' "
-		"and (residue_type = '"
-		+ residueType +
-		"' or residue_type is null) "
-		"order by species_id, residue_type desc";
-
-	//cout << "query: " << query << endl;
-	con->select(query);
-	//take the first (best matching) element
-	//at least there should always be the "default" residue parameters with
-	//type = NULL be available
-	if(!(row = con->getRow()).empty())
+	auto rps = residueCache().get(cacheKey(abstractDbSchema, species, residueType), [&]()
 	{
-		CropResidueParametersPtr omp = make_shared<CropResidueParameters>();
-
-		int i = 0;
-
-		omp->species = row[i++];
-		omp->residueType = row[i++];
-		omp->vo_AOM_DryMatterContent = stoi(row[i++]);
-		omp->vo_AOM_NH4Content = stof(row[i++]);
-		omp->vo_AOM_NO3Content = stof(row[i++]);
-		omp->vo_AOM_CarbamidContent = stof(row[i++]);
-		omp->vo_AOM_SlowDecCoeffStandard = stof(row[i++]);
-		omp->vo_AOM_FastDecCoeffStandard = stof(row[i++]);
-		omp->vo_PartAOM_to_AOM_Slow = stof(row[i++]);
-		omp->vo_PartAOM_to_AOM_Fast = stof(row[i++]);
-		omp->vo_CN_Ratio_AOM_Slow = stof(row[i++]);
-		omp->vo_CN_Ratio_AOM_Fast = stof(row[i++]);
-		omp->vo_PartAOM_Slow_to_SMB_Slow = stof(row[i++]);
-		omp->vo_PartAOM_Slow_to_SMB_Fast = stof(row[i++]);
-
-		return omp;
-	}
+		return selectResidueParameters(connection(abstractDbSchema), species, residueType);
+	});
+	if(rps)
+		return make_shared<CropResidueParameters>(*rps);
 
 	static CropResidueParametersPtr nothing = make_shared<CropResidueParameters>();
 	return nothing;
@@ -740,14 +828,12 @@ getAllCropResidueParametersFromMonicaDB(std::string abstractDbSchema = "monica")
 {
 	vector<CropResidueParametersPtr> acrps;
 
-	DBPtr con(newConnection(abstractDbSchema));
-	DBRow row;
-	con->select("select "
-							"species_id, "
-							"residue_type "
-							"from crop_residue "
-							"order by species_id, residue_type");
-	while(!(row = con->getRow()).empty())
+	for(const auto& row : selectRows(connection(abstractDbSchema),
+	                                 "select "
+	                                 "species_id, "
+	                                 "residue_type "
+	                                 "from crop_residue "
+	                                 "order by species_id, residue_type"))
 	{
 		acrps.push_back(getResidueParametersFromMonicaDB(row[0], row[1]));
 	}
@@ -794,21 +880,27 @@ void Monica::writeCropResidues(string path, std::string abstractDbSchema)
 
 //------------------------------------------------------------------------------
 
-DBPtr userParamsSelect(string type, string module, std::string abstractDbSchema = "monica")
+namespace
 {
-	DBPtr con(newConnection(abstractDbSchema));
-
-	map<string, string> type2colName = {
-		{"hermes", "value_hermes"},
-		{"eva2", "value_eva2"},
-		{"macsur", "value_macsur_scaling"}
-	};
-
-	con->select(string("select name, ") + type2colName[type] + " "
-							"from user_parameter " +
-							"where modul = '" + module + "'");
-
-	return con;
+	//! the name/value rows of the user parameters of a module
+	shared_ptr<const vector<DBRow>>
+	userParamsSelect(string type, string module, std::string abstractDbSchema = "monica")
+	{
+		return userParamsCache().get(cacheKey(abstractDbSchema, type, module), [&]()
+		{
+			map<string, string> type2colName = {
+				{"hermes", "value_hermes"},
+				{"eva2", "value_eva2"},
+				{"macsur", "value_macsur_scaling"}
+			};
+
+			return make_shared<const vector<DBRow>>(
+				selectRows(connection(abstractDbSchema),
+				           string("select name, ") + type2colName[type] + " "
+				           "from user_parameter " +
+				           "where modul = '" + module + "'"));
+		});
+	}
 }
 
 UserCropParameters
@@ -817,10 +909,8 @@ Monica::readUserCropParametersFromDatabase(string type,
 {
 	UserCropParameters user_crops;
 	
-	DBPtr con = userParamsSelect(type, "crop", abstractDbSchema);
-
-	DBRow row;
-	while(!(row = con->getRow()).empty())
+	auto rows = userParamsSelect(type, "crop", abstractDbSchema);
+	for(const auto& row : *rows)
 	{
 		std::string name = row[0];
 		if(name == "tortuosity")
@@ -864,10 +954,8 @@ Monica::readUserSimParametersFromDatabase(string type,
 {
 	SimulationParameters sim;
 
-	DBPtr con = userParamsSelect(type, "sim", abstractDbSchema);
-
-	DBRow row;
-	while(!(row = con->getRow()).empty())
+	auto rows = userParamsSelect(type, "sim", abstractDbSchema);
+	for(const auto& row : *rows)
 	{
 		std::string name = row[0];
 		if(name == "use_automatic_irrigation")
@@ -895,10 +983,8 @@ Monica::readUserEnvironmentParametersFromDatabase(string type,
 {
 	UserEnvironmentParameters user_env;
 
-	DBPtr con = userParamsSelect(type, "environment");
-
-	DBRow row;
-	while(!(row = con->getRow()).empty())
+	auto rows = userParamsSelect(type, "environment");
+	for(const auto& row : *rows)
 	{
 		std::string name = row[0];
 		if(name == "albedo")
@@ -931,11 +1017,10 @@ Monica::readUserSoilMoistureParametersFromDatabase(string type,
 	{
 		return Soil::readCapillaryRiseRates().getRate(soilTexture, distance);
 	};
+	user_soil_moisture.capillaryRiseRates = sharedCapillaryRiseRateTable();
 
-	DBPtr con = userParamsSelect(type, "soil_moisture", abstractDbSchema);
-
-	DBRow row;
-	while(!(row = con->getRow()).empty())
+	auto rows = userParamsSelect(type, "soil_moisture", abstractDbSchema);
+	for(const auto& row : *rows)
 	{
 		std::string name = row[0];
 		if(name == "critical_moisture_depth")
@@ -995,10 +1080,8 @@ Monica::readUserSoilTemperatureParametersFromDatabase(string type,
 {
 	UserSoilTemperatureParameters user_soil_temperature;
 
-	DBPtr con = userParamsSelect(type, "soil_temperature", abstractDbSchema);
-
-	DBRow row;
-	while(!(row = con->getRow()).empty())
+	auto rows = userParamsSelect(type, "soil_temperature", abstractDbSchema);
+	for(const auto& row : *rows)
 	{
 		std::string name = row[0];
 		if(name == "ntau")
@@ -1036,10 +1119,8 @@ Monica::readUserSoilTransportParametersFromDatabase(string type,
 {
 	UserSoilTransportParameters user_soil_transport;
 
-	DBPtr con = userParamsSelect(type, "soil_transport", abstractDbSchema);
-
-	DBRow row;
-	while(!(row = con->getRow()).empty())
+	auto rows = userParamsSelect(type, "soil_transport", abstractDbSchema);
+	for(const auto& row : *rows)
 	{
 		std::string name = row[0];
 		if(name == "dispersion_length")
@@ -1059,10 +1140,8 @@ Monica::readUserSoilOrganicParametersFromDatabase(string type,
 {
 	UserSoilOrganicParameters user_soil_organic;
 
-	DBPtr con = userParamsSelect(type, "soil_organic", abstractDbSchema);
-
-	DBRow row;
-	while(!(row = con->getRow()).empty())
+	auto rows = userParamsSelect(type, "soil_organic", abstractDbSchema);
+	for(const auto& row : *rows)
 	{
 		std::string name = row[0];
 		if(name == "SOM_SlowDecCoeffStandard")
@@ -1241,17 +1320,17 @@ void Monica::writeUserParameters(int type, string path, std::string abstractDbSc
 
 vector<AMCRes> Monica::availableMonicaCrops()
 {
-	DBPtr con(newConnection("monica"));
+	DB& con = connection("monica");
 	
-	con->select("select "
-							"species_id, "
-							"id "
-							"from cultivar "
-							"order by species_id, id");
+	con.select("select "
+						 "species_id, "
+						 "id "
+						 "from cultivar "
+						 "order by species_id, id");
 
 	vector<AMCRes> amcs;
 	DBRow row;
-	while(!(row = con->getRow()).empty())
+	while(!(row = con.getRow()).empty())
 	{
 		AMCRes res;
 		res.speciesId = row[0];
@@ -1263,42 +1342,74 @@ vector<AMCRes> Monica::availableMonicaCrops()
 	return amcs;
 }
 
-const map<int, AMCRes>& Monica::availableMonicaCropsM()
+shared_ptr<const map<int, AMCRes>> Monica::availableMonicaCropsM()
 {
-	static mutex lockable;
-	static map<int, AMCRes> m;
-	static bool initialized = false;
-	if(!initialized)
+	return availableCropsCache().get(cacheKey("monica", "crop"), []()
 	{
-		lock_guard<mutex> lock(lockable);
-
-		if(!initialized)
+		auto m = make_shared<map<int, AMCRes>>();
+		for(const auto& row : selectRows(connection("monica"),
+		                                 "select "
+		                                 "id, "
+		                                 "species_id, "
+		                                 "cultivar_id "
+		                                 "from crop "
+		                                 "order by id"))
 		{
-			DBPtr con(newConnection("monica"));
-
-			string query(
-				"select "
-				"id, "
-				"species_id, "
-				"cultivar_id "
-				"from crop "
-				"order by id");
-			con->select(query.c_str());
-
-			DBRow row;
-			while(!(row = con->getRow()).empty())
-			{
-				AMCRes res;
-				res.speciesId = row[1];
-				res.cultivarId = row[2];
-				res.name = capitalize(row[1]) + "/" + capitalize(row[2]);
-				if(!row[0].empty()) 
-					m[stoi(row[0])] = res;
-			}
-
-			initialized = true;
+			AMCRes res;
+			res.speciesId = row[1];
+			res.cultivarId = row[2];
+			res.name = capitalize(row[1]) + "/" + capitalize(row[2]);
+			if(!row[0].empty())
+				(*m)[stoi(row[0])] = res;
 		}
-	}
+		return m;
+	});
+}
+
+//----------------------------------------------------------------------------------
+
+void Monica::preloadMonicaDB(std::string abstractDbSchema)
+{
+	DB& con = connection(abstractDbSchema);
+
+	for(const auto& row : selectRows(con, "select id from species"))
+		getSpeciesParametersFromMonicaDB(row[0], abstractDbSchema);
 
-	return m;
+	for(const auto& row : selectRows(con, "select species_id, id from cultivar"))
+		getCultivarParametersFromMonicaDB(row[0], row[1], abstractDbSchema);
+
+	for(const auto& row : selectRows(con, "select species_id, residue_type from crop_residue"))
+		getResidueParametersFromMonicaDB(row[0], row[1], abstractDbSchema);
+
+	for(string type : {"hermes", "eva2", "macsur"})
+		for(string module : {"crop", "sim", "environment", "soil_moisture", "soil_temperature", "soil_transport", "soil_organic"})
+			userParamsSelect(type, module, abstractDbSchema);
+
+	getAllCropParametersFromMonicaDB(abstractDbSchema);
+	getAllMineralFertiliserParametersFromMonicaDB(abstractDbSchema);
+	getAllOrganicFertiliserParametersFromMonicaDB(abstractDbSchema);
+}
+
+size_t Monica::monicaDBCacheSize()
+{
+	return speciesCache().size()
+		+ cultivarCache().size()
+		+ residueCache().size()
+		+ userParamsCache().size()
+		+ cropsCache().size()
+		+ mineralFertilisersCache().size()
+		+ organicFertilisersCache().size()
+		+ availableCropsCache().size();
+}
+
+void Monica::clearMonicaDBCache()
+{
+	speciesCache().clear();
+	cultivarCache().clear();
+	residueCache().clear();
+	userParamsCache().clear();
+	cropsCache().clear();
+	mineralFertilisersCache().clear();
+	organicFertilisersCache().clear();
+	availableCropsCache().clear();
 }
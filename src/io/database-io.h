@@ -106,8 +106,26 @@ namespace Monica
   {
     std::string speciesId, cultivarId, name;
   };
-  const std::map<int, AMCRes>& availableMonicaCropsM();
+  std::shared_ptr<const std::map<int, AMCRes>> availableMonicaCropsM();
 	std::vector<AMCRes> availableMonicaCrops();
+
+	//-----------------------------------------------------------
+
+	/**
+	 * Reads all crop, residue, fertiliser and user parameters of the schema
+	 * into memory, so that later requests (e.g. workers resolving parameter
+	 * references per job) are answered without database access.
+	 * Species, cultivar, residue and user parameters are otherwise cached at
+	 * their first request.
+	 */
+	void preloadMonicaDB(std::string abstractDbSchema = "monica");
+
+	//! number of cached query results (single parameter sets and whole tables)
+	std::size_t monicaDBCacheSize();
+
+	//! drop all cached query results, e.g. after the database has been changed,
+	//! parameters already handed out stay valid
+	void clearMonicaDBCache();
 }  
 
 #endif 
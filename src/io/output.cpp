@@ -16,6 +16,8 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 #include <fstream>
 #include <algorithm>
 #include <mutex>
+#include <map>
+#include <cmath>
 
 #include "output.h"
 
@@ -188,6 +190,8 @@ Errors Output::merge(json11::Json j)
   errors = toStringVector(j["errors"]);
   warnings = toStringVector(j["warnings"]);
 
+	spinUp = j["spinUp"];
+
 	return es;
 }
 
@@ -216,8 +220,97 @@ json11::Json Output::to_json() const
 	,{"data", ds}
   ,{"errors", toPrimJsonArray(errors)}
   ,{"warnings", toPrimJsonArray(warnings)}
+	,{"spinUp", spinUp}
 	};
 }
 
 //-----------------------------------------------------------------------------
 
+
+//-----------------------------------------------------------------------------
+
+namespace
+{
+	struct Deviation
+	{
+		int values{0};
+		int mismatches{0}; //!< non numbers or arrays of different size
+		double maxAbsError{0.0};
+		double maxRelError{0.0};
+
+		void add(const Json& ref, const Json& cand)
+		{
+			if(ref.is_number() && cand.is_number())
+			{
+				auto r = ref.number_value(), c = cand.number_value();
+				auto abs = std::abs(c - r);
+				values++;
+				maxAbsError = max(maxAbsError, abs);
+				if(r != 0.0)
+					maxRelError = max(maxRelError, abs / std::abs(r));
+			}
+			else if(ref.is_array() && cand.is_array() && ref.array_items().size() == cand.array_items().size())
+			{
+				for(size_t i = 0, size = ref.array_items().size(); i < size; i++)
+					add(ref.array_items()[i], cand.array_items()[i]);
+			}
+			else if(ref != cand)
+				mismatches++;
+		}
+
+		Json to_json() const
+		{
+			return J11Object
+			{{"values", values}
+			,{"mismatches", mismatches}
+			,{"maxAbsError", maxAbsError}
+			,{"maxRelError", maxRelError}
+			};
+		}
+	};
+}
+
+json11::Json Monica::compareOutputs(const Output& reference, const Output& candidate)
+{
+	J11Array sections;
+	for(size_t di = 0, size = min(reference.data.size(), candidate.data.size()); di < size; di++)
+	{
+		const auto& rd = reference.data[di];
+		const auto& cd = candidate.data[di];
+
+		map<string, Deviation> devs;
+		for(size_t i = 0; i < rd.outputIds.size() && i < rd.results.size() && i < cd.results.size(); i++)
+		{
+			auto& dev = devs[rd.outputIds[i].outputName()];
+			const auto& rvs = rd.results[i];
+			const auto& cvs = cd.results[i];
+			for(size_t k = 0; k < rvs.size() && k < cvs.size(); k++)
+				dev.add(rvs[k], cvs[k]);
+			dev.mismatches += int(max(rvs.size(), cvs.size()) - min(rvs.size(), cvs.size()));
+		}
+
+		for(size_t k = 0; k < rd.resultsObj.size() && k < cd.resultsObj.size(); k++)
+		{
+			const auto& cro = cd.resultsObj[k];
+			for(const auto& p : rd.resultsObj[k])
+			{
+				auto ci = cro.find(p.first);
+				if(ci == cro.end())
+					devs[p.first].mismatches++;
+				else
+					devs[p.first].add(p.second, ci->second);
+			}
+		}
+
+		J11Object vars;
+		for(const auto& p : devs)
+			vars[p.first] = p.second.to_json();
+		sections.push_back(J11Object{{"origSpec", rd.origSpec}, {"variables", vars}});
+	}
+
+	return J11Object
+	{{"type", "OutputComparison"}
+	,{"sections", sections}
+	,{"missingSections", int(max(reference.data.size(), candidate.data.size()) - min(reference.data.size(), candidate.data.size()))}
+	};
+}
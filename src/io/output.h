@@ -125,7 +125,17 @@ namespace Monica
 
     std::vector<std::string> errors;
     std::vector<std::string> warnings;
+
+		json11::Json spinUp; //!< report of the soil organic matter spin-up, if there was one
 	};
+
+	/**
+	 * Compares the results of candidate with the ones of reference, e.g. of a
+	 * MONICA_FLOAT_STATE build with those of the double build, both run on the same env.
+	 * Returns per output section and variable the number of compared values
+	 * and the largest absolute and relative deviation.
+	 */
+	DLL_API json11::Json compareOutputs(const Output& reference, const Output& candidate);
 }  
 
 #endif 
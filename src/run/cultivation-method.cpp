@@ -30,6 +30,7 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 #include "tools/algorithms.h"
 #include "../core/monica-parameters.h"
 #include "../core/monica-model.h"
+#include "../core/state-io.h"
 #include "tools/debug.h"
 #include "soil/conversion.h"
 #include "soil/soil.h"
@@ -161,6 +162,24 @@ bool Workstep::reinit(Tools::Date date, bool addYear, bool forceInitYear)
 	return addedYear;
 }
 
+void Workstep::serializeState(std::ostream& out) const
+{
+	using namespace StateIO;
+	write(out, _date);
+	write(out, _absDate);
+	write(out, _daysAfterEventCount);
+	write(out, _isActive);
+}
+
+void Workstep::deserializeState(std::istream& in)
+{
+	using namespace StateIO;
+	read(in, _date);
+	read(in, _absDate);
+	read(in, _daysAfterEventCount);
+	read(in, _isActive);
+}
+
 //------------------------------------------------------------------------------
 
 Sowing::Sowing(const Tools::Date& at, CropPtr crop)
@@ -440,6 +459,26 @@ bool AutomaticSowing::reinit(Tools::Date date, bool addYear, bool forceInitYear)
 	return addedYear1;// || addedYear2;
 }
 
+void AutomaticSowing::serializeState(std::ostream& out) const
+{
+	using namespace StateIO;
+	Sowing::serializeState(out);
+	write(out, _absEarliestDate);
+	write(out, _absLatestDate);
+	write(out, _inSowingRange);
+	write(out, _cropSeeded);
+}
+
+void AutomaticSowing::deserializeState(std::istream& in)
+{
+	using namespace StateIO;
+	Sowing::deserializeState(in);
+	read(in, _absEarliestDate);
+	read(in, _absLatestDate);
+	read(in, _inSowingRange);
+	read(in, _cropSeeded);
+}
+
 
 //------------------------------------------------------------------------------
 
@@ -643,6 +682,22 @@ bool AutomaticHarvest::reinit(Tools::Date date, bool addYear, bool forceInitYear
 	return addedYear;
 }
 
+void AutomaticHarvest::serializeState(std::ostream& out) const
+{
+	using namespace StateIO;
+	Harvest::serializeState(out);
+	write(out, _absLatestDate);
+	write(out, _cropHarvested);
+}
+
+void AutomaticHarvest::deserializeState(std::istream& in)
+{
+	using namespace StateIO;
+	Harvest::deserializeState(in);
+	read(in, _absLatestDate);
+	read(in, _cropHarvested);
+}
+
 
 //------------------------------------------------------------------------------
 
@@ -944,6 +999,18 @@ bool NDemandFertilization::reinit(Tools::Date date, bool addYear, bool forceInit
 	return false;
 }
 
+void NDemandFertilization::serializeState(std::ostream& out) const
+{
+	Workstep::serializeState(out);
+	StateIO::write(out, _appliedFertilizer);
+}
+
+void NDemandFertilization::deserializeState(std::istream& in)
+{
+	Workstep::deserializeState(in);
+	StateIO::read(in, _appliedFertilizer);
+}
+
 //------------------------------------------------------------------------------
 
 OrganicFertilization::
@@ -1297,6 +1364,45 @@ json11::Json CultivationMethod::to_json() const
 	};
 }
 
+CultivationMethod CultivationMethod::clone() const
+{
+	CultivationMethod cm(*this);
+
+	map<const Crop*, CropPtr> crops;
+	auto cloneCrop = [&crops](CropPtr c)
+	{
+		if (!c)
+			return c;
+		auto& cc = crops[c.get()];
+		if (!cc)
+			cc = c->clone();
+		return cc;
+	};
+	cm._crop = cloneCrop(_crop);
+
+	map<const Workstep*, WSPtr> wss;
+	cm._allWorksteps.clear();
+	for (auto ws : _allWorksteps)
+	{
+		WSPtr c(ws->clone());
+		if (Sowing* sowing = dynamic_cast<Sowing*>(c.get()))
+			sowing->setCrop(cloneCrop(sowing->crop()));
+		else if (Harvest* harvest = dynamic_cast<Harvest*>(c.get()))
+			harvest->setCrop(cloneCrop(harvest->crop()));
+		wss[ws.get()] = c;
+		cm._allWorksteps.push_back(c);
+	}
+
+	cm._allAbsWorksteps.clear();
+	for (auto ws : _allAbsWorksteps)
+		cm._allAbsWorksteps.push_back(wss[ws.get()]);
+	cm._unfinishedDynamicWorksteps.clear();
+	for (auto ws : _unfinishedDynamicWorksteps)
+		cm._unfinishedDynamicWorksteps.push_back(wss[ws.get()]);
+
+	return cm;
+}
+
 void CultivationMethod::apply(const Date& date,
 	MonicaModel* model) const
 {
@@ -1626,3 +1732,72 @@ bool CultivationMethod::reinit(Tools::Date date, bool forceInitYear)
 
 	return addedYear;
 }
+
+string CultivationMethod::layout() const
+{
+	string l;
+	for (auto ws : _allWorksteps)
+		l += (l.empty() ? "" : ",") + ws->type();
+	return l;
+}
+
+void CultivationMethod::serializeState(std::ostream& out) const
+{
+	using namespace StateIO;
+
+	//after a reinit the absolute worksteps are all worksteps in the same order
+	write(out, !_allAbsWorksteps.empty());
+
+	vector<uint64_t> unfinished;
+	for (auto ws : _unfinishedDynamicWorksteps)
+		unfinished.push_back(uint64_t(find(_allWorksteps.begin(), _allWorksteps.end(), ws) - _allWorksteps.begin()));
+	write(out, unfinished);
+
+	write(out, bool(_crop));
+	if (_crop)
+	{
+		write(out, _crop->seedDate());
+		write(out, _crop->harvestDate());
+	}
+
+	for (auto ws : _allWorksteps)
+		ws->serializeState(out);
+}
+
+bool CultivationMethod::deserializeState(std::istream& in)
+{
+	using namespace StateIO;
+
+	bool reinitialized = false;
+	read(in, reinitialized);
+	_allAbsWorksteps.clear();
+	if (reinitialized)
+		_allAbsWorksteps = _allWorksteps;
+
+	vector<uint64_t> unfinished;
+	read(in, unfinished);
+	_unfinishedDynamicWorksteps.clear();
+	for (auto i : unfinished)
+	{
+		if (i >= _allWorksteps.size())
+			return false;
+		_unfinishedDynamicWorksteps.push_back(_allWorksteps[size_t(i)]);
+	}
+
+	bool hasCrop = false;
+	read(in, hasCrop);
+	if (hasCrop != bool(_crop))
+		return false;
+	if (_crop)
+	{
+		Date seedDate, harvestDate;
+		read(in, seedDate);
+		read(in, harvestDate);
+		_crop->setSeedAndHarvestDate(seedDate, harvestDate);
+	}
+
+	for (auto ws : _allWorksteps)
+		ws->deserializeState(in);
+
+	return bool(in);
+}
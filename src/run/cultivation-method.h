@@ -101,6 +101,11 @@ namespace Monica
 			return std::function<double(MonicaModel*)>(); 
 		};
 
+		//! write/read the state a workstep changes while it is applied (see state-io.h),
+		//! not its configuration, which is expected to be the same when reading
+		virtual void serializeState(std::ostream& out) const;
+		virtual void deserializeState(std::istream& in);
+
 	protected:
 		Tools::Date _date;
 		Tools::Date _absDate;
@@ -142,6 +147,7 @@ namespace Monica
     }
 
     CropPtr crop() const { return _crop; }
+		void setCrop(CropPtr c) { _crop = c; }
 
   private:
     CropPtr _crop;
@@ -185,6 +191,9 @@ namespace Monica
 
 		virtual std::function<double(MonicaModel*)> registerDailyFunction(std::function<std::vector<double>&()> getDailyValues);
 
+		virtual void serializeState(std::ostream& out) const;
+		virtual void deserializeState(std::istream& in);
+
 	private:
 		Tools::Date _absEarliestDate;
 		Tools::Date _earliestDate;
@@ -306,6 +315,9 @@ namespace Monica
 
 		virtual Tools::Date absLatestDate() const { return _absLatestDate; }
 
+		virtual void serializeState(std::ostream& out) const;
+		virtual void deserializeState(std::istream& in);
+
 	private:
 		std::string _harvestTime; //!< Harvest time parameter
 		Tools::Date _latestDate;
@@ -421,6 +433,9 @@ namespace Monica
 
 		virtual bool reinit(Tools::Date date, bool addYear = false, bool forceInitYear = false);
 
+		virtual void serializeState(std::ostream& out) const;
+		virtual void deserializeState(std::istream& in);
+
 	private:
 		Tools::Date _initialDate;
 		MineralFertiliserParameters _partition;
@@ -570,6 +585,10 @@ namespace Monica
 
     virtual json11::Json to_json() const;
 
+		//! a deep copy, the worksteps (incl. their state) and crops are copied, too,
+		//! a copy of a cultivation method just shares them
+		CultivationMethod clone() const;
+
 		template<class Application>
 		void addApplication(const Application& a)
 		{
@@ -645,6 +664,13 @@ namespace Monica
 
 		bool repeat() const { return _repeat; }
 
+		//! the types of the worksteps, a state can only be read into a cultivation method with the same layout
+		std::string layout() const;
+
+		//! write/read the state of the cultivation method and its worksteps (see state-io.h)
+		void serializeState(std::ostream& out) const;
+		bool deserializeState(std::istream& in);
+
 	private:
 		std::vector<WSPtr> _allWorksteps;
 		std::vector<WSPtr> _allAbsWorksteps;
@@ -35,6 +35,7 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 #include "tools/debug.h"
 
 #include "run-monica-capnp.h"
+#include "../io/database-io.h"
 
 #include "model.capnp.h"
 #include "common.capnp.h"
@@ -161,6 +162,13 @@ int main(int argc, const char* argv[]) {
 
     debug() << "starting Cap'n Proto MONICA server" << endl;
 
+    //the parameter references of the jobs are then resolved from memory
+    try {
+      preloadMonicaDB();
+    } catch (exception& e) {
+      cerr << "Couldn't preload the MONICA database: " << e.what() << endl;
+    }
+
     //create monica server implementation
     auto runMonicaImpl_ = kj::heap<RunMonicaImpl>(startedServerInDebugMode);
     auto& runMonicaImpl = *runMonicaImpl_;
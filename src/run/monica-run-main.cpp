@@ -59,6 +59,7 @@ int main(int argc, char** argv)
 	string pathToOutput;
 	string pathToOutputFile;
 	bool writeOutputFile = false;
+	string pathToJsonOutputFile, pathToReferenceOutput;
 	string pathToSimJson = "./sim.json", crop, site, climate;
 	string dailyOutputs;
 	
@@ -78,6 +79,8 @@ int main(int argc, char** argv)
 			<< " -w   | --write-output-files ... write MONICA output files" << endl
 			<< " -op  | --path-to-output DIRECTORY (default: .) ... path to output directory" << endl
 			<< " -o   | --path-to-output-file FILE ... path to output file" << endl
+			<< " -jo  | --json-output-file FILE ... write the output (as JSON) also to FILE, e.g. as reference for --compare-to" << endl
+			<< " -cmp | --compare-to FILE ... print the per variable deviations of the results from the JSON output in FILE" << endl
 			//<< " -do  | --daily-outputs [LIST] (default: value of key 'sim.json:output.daily') ... list of daily output elements" << endl
 			<< " -c   | --path-to-crop FILE (default: ./crop.json) ... path to crop.json file" << endl
 			<< " -s   | --path-to-site FILE (default: ./site.json) ... path to site.json file" << endl
@@ -103,6 +106,12 @@ int main(int argc, char** argv)
 			else if((arg == "-o" || arg == "--path-to-output-file")
 							&& i + 1 < argc)
 				pathToOutputFile = argv[++i];
+			else if((arg == "-jo" || arg == "--json-output-file")
+							&& i + 1 < argc)
+				pathToJsonOutputFile = argv[++i];
+			else if((arg == "-cmp" || arg == "--compare-to")
+							&& i + 1 < argc)
+				pathToReferenceOutput = argv[++i];
 			//else if((arg == "-do" || arg == "--daily-outputs")
 			//				&& i + 1 < argc)
 			//	dailyOutputs = argv[++i];
@@ -277,6 +286,25 @@ int main(int argc, char** argv)
 		if(writeOutputFile)
 			fout.close();
 
+		if(!pathToJsonOutputFile.empty())
+		{
+			ofstream jout(pathToJsonOutputFile);
+			if(jout.fail())
+				cerr << "Error while opening JSON output file \"" << pathToJsonOutputFile << "\"" << endl;
+			else
+				jout << output.to_json().dump();
+		}
+
+		if(!pathToReferenceOutput.empty())
+		{
+			string err;
+			auto refj = json11::Json::parse(printPossibleErrors(readFile(pathToReferenceOutput), activateDebug), err);
+			if(!err.empty())
+				cerr << "Error while parsing reference output \"" << pathToReferenceOutput << "\": " << err << endl;
+			else
+				cout << compareOutputs(Output(refj), output).dump() << endl;
+		}
+
 		if(activateDebug)
 			cout << "finished MONICA" << endl;
 	}
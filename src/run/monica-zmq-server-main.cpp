@@ -172,6 +172,7 @@ int main(int argc, char** argv)
 
 	SocketOp inputOp = ZmqServer::connect;
 	SocketOp outputOp = ZmqServer::connect;
+	SessionConfig sessionConfig;
 
 	int major, minor, patch;
 	zmq::version(&major, &minor, &patch);
@@ -196,7 +197,10 @@ int main(int argc, char** argv)
 			<< " -co | --connect-output (default) ... connect the output port" << endl
 			<< " -o | --output-address [ADDRESS1[,ADDRESS2,...]] (default: " << outputAddress << ")] ... send results to this address(es)" << endl
 			<< " -or | --router-output-address [ADDRESS1[,ADDRESS2,...]] (default: " << outputAddress << ")] ... send results to this address(es) but use a router socket" << endl
-			<< " -c | --control-address [ADDRESS] (default: " << controlAddress << ")] ... connect MONICA server to this address for control messages" << endl;
+			<< " -c | --control-address [ADDRESS] (default: " << controlAddress << ")] ... connect MONICA server to this address for control messages" << endl
+			<< " -sd | --session-dir DIR ... store the states of idle sessions in this directory (default: sessions stay in memory)" << endl
+			<< " -sm | --max-sessions-in-memory N (default: " << sessionConfig.maxSessionsInMemory << ")] ... keep at most N sessions in memory" << endl
+			<< " -si | --max-session-idle SECONDS (default: " << sessionConfig.maxIdleSeconds << ")] ... evict sessions idle for longer" << endl;
 	};
 
 	zmq::context_t context(1);
@@ -250,6 +254,15 @@ int main(int argc, char** argv)
 				if(i + 1 < argc && argv[i + 1][0] != '-')
 					controlAddress = argv[++i];
 			}
+			else if((arg == "-sd" || arg == "--session-dir")
+							&& i + 1 < argc)
+				sessionConfig.pathToEvictedSessions = argv[++i];
+			else if((arg == "-sm" || arg == "--max-sessions-in-memory")
+							&& i + 1 < argc)
+				sessionConfig.maxSessionsInMemory = stoul(argv[++i]);
+			else if((arg == "-si" || arg == "--max-session-idle")
+							&& i + 1 < argc)
+				sessionConfig.maxIdleSeconds = stoi(argv[++i]);
 			else if(arg == "-h" || arg == "--help")
 				printHelp(), exit(0);
 			else if(arg == "-v" || arg == "--version")
@@ -271,7 +284,7 @@ int main(int argc, char** argv)
 
 		addresses[Control] = {Subscribe, vector<string>{controlAddress}, ZmqServer::connect};
 
-		serveZmqMonicaFull(&context, addresses);
+		serveZmqMonicaFull(&context, addresses, sessionConfig);
 
 		debug() << "stopped ZeroMQ MONICA server" << endl;
 	}
@@ -117,44 +117,86 @@ kj::Promise<void> RunMonicaImpl::run(RunContext context) //override
     std::string err;
     auto rest = envR.getRest();
     if (!rest.getStructure().isJson()) {
-      return Monica::Output(std::string("Error: 'rest' field is not valid JSON!"));
+      return Monica::Output(std::string("Error: 'rest' field is not valid JSON!")).toString();
     }
 
     const Json& envJson = Json::parse(rest.getValue().cStr(), err);
     //cout << "runMonica: " << envJson["customId"].dump() << endl;
 
-    Env env;
-    auto errors = env.merge(envJson);
-
-    EResult<DataAccessor> eda;
-    if (da.isValid()) {
-      eda.result = da;
-    } else if (!env.climateData.isValid()) {
-      if (!env.climateCSV.empty()) {
-        eda = readClimateDataFromCSVStringViaHeaders(env.climateCSV, env.csvViaHeaderOptions);
-      } else if (!env.pathsToClimateCSV.empty()) {
-        eda = readClimateDataFromCSVFilesViaHeaders(env.pathsToClimateCSV, env.csvViaHeaderOptions);
+    auto createEnv = [this](const Json& envJson, DataAccessor da, Monica::Output& out) {
+      Env env;
+      auto errors = env.merge(envJson);
+
+      EResult<DataAccessor> eda;
+      if (da.isValid()) {
+        eda.result = da;
+      } else if (!env.climateData.isValid()) {
+        if (!env.climateCSV.empty()) {
+          eda = readClimateDataFromCSVStringViaHeaders(env.climateCSV, env.csvViaHeaderOptions);
+        } else if (!env.pathsToClimateCSV.empty()) {
+          eda = readClimateDataFromCSVFilesViaHeaders(env.pathsToClimateCSV, env.csvViaHeaderOptions);
+        }
       }
-    }
 
-    Monica::Output out;
-    if (eda.success()) {
-      env.climateData = eda.result;
+      if (eda.success()) {
+        env.climateData = eda.result;
+
+        env.debugMode = _startedServerInDebugMode && env.debugMode;
 
-      env.debugMode = _startedServerInDebugMode && env.debugMode;
+        env.params.userSoilMoistureParameters.getCapillaryRiseRate =
+          [](std::string soilTexture, int distance) {
+          return Soil::readCapillaryRiseRates().getRate(soilTexture, distance);
+        };
+        env.params.userSoilMoistureParameters.capillaryRiseRates = sharedCapillaryRiseRateTable();
+      }
 
-      env.params.userSoilMoistureParameters.getCapillaryRiseRate =
-        [](std::string soilTexture, int distance) {
-        return Soil::readCapillaryRiseRates().getRate(soilTexture, distance);
-      };
+      out.errors = eda.errors;
+      out.warnings = eda.warnings;
+      return env;
+    };
+
+    Monica::Output envOut;
+    Env env = createEnv(envJson, da, envOut);
+
+    //a common prefix run with branches returns an array with one output per branch,
+    //the time series (if any) is the climate of the prefix, so branches have to bring their own
+    if (!envJson["branches"].array_items().empty()) {
+      std::vector<Env> branchEnvs;
+      std::vector<Monica::Output> branchOuts;
+      bool ok = envOut.errors.empty();
+      for (const auto& bj : branchEnvJsons(envJson)) {
+        Monica::Output bout;
+        branchEnvs.push_back(createEnv(bj, DataAccessor(), bout));
+        ok = ok && bout.errors.empty();
+        branchOuts.push_back(bout);
+      }
 
-      out = Monica::runMonica(env);
+      if (ok) {
+        auto outs = Monica::runMonicaBranches(env, branchEnvs);
+        for (size_t i = 0; i < outs.size(); i++)
+          outs[i].warnings.insert(outs[i].warnings.end(), branchOuts[i].warnings.begin(), branchOuts[i].warnings.end());
+        branchOuts = outs;
+      } else {
+        for (size_t i = 0; i < branchOuts.size(); i++) {
+          branchOuts[i].customId = branchEnvs[i].customId;
+          branchOuts[i].errors.insert(branchOuts[i].errors.begin(), envOut.errors.begin(), envOut.errors.end());
+        }
+      }
+
+      J11Array outs;
+      for (const auto& o : branchOuts)
+        outs.push_back(o.to_json());
+      return Json(outs).dump();
     }
 
-    out.errors = eda.errors;
-    out.warnings = eda.warnings;
+    Monica::Output out;
+    if (envOut.errors.empty())
+      out = Monica::runMonica(env);
+
+    out.errors.insert(out.errors.end(), envOut.errors.begin(), envOut.errors.end());
+    out.warnings.insert(out.warnings.end(), envOut.warnings.begin(), envOut.warnings.end());
 
-    return out;
+    return out.toString();
   };
 
   if (envR.hasTimeSeries()) {
@@ -181,13 +223,13 @@ kj::Promise<void> RunMonicaImpl::run(RunContext context) //override
       auto out = runMonica(da);
       auto rs = context.getResults();
       rs.initResult();
-      rs.getResult().setValue(out.toString());
+      rs.getResult().setValue(out);
             });
   } else {
     auto out = runMonica();
     auto rs = context.getResults();
     rs.initResult();
-    rs.getResult().setValue(out.toString());
+    rs.getResult().setValue(out);
     return kj::READY_NOW;
   }
 }
@@ -26,6 +26,9 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 #include <thread>
 #include <tuple>
 #include <limits>
+#include <cmath>
+#include <future>
+#include <fstream>
 
 #include "run-monica.h"
 #include "tools/debug.h"
@@ -35,6 +38,7 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 #include "tools/algorithms.h"
 #include "../io/build-output.h"
 #include "../core/crop-growth.h"
+#include "../core/state-io.h"
 
 using namespace Monica;
 using namespace std;
@@ -85,12 +89,15 @@ json11::Json CropRotation::to_json() const
 	for(const auto& c : cropRotation)
 		cr.push_back(c.to_json());
 
-	return json11::Json::object
+	auto o = json11::Json::object
 	{{"type", "CropRotation"}
 	,{"start", start.toIsoDateString()}
-	,{"end", end.toIsoDateString()}
 	,{"cropRotation", cr}
 	};
+	//an open ended rotation has no end
+	if(end.isValid())
+		o["end"] = end.toIsoDateString();
+	return o;
 }
 
 //-----------------------------------------------------------------------------
@@ -137,6 +144,13 @@ Errors Env::merge(json11::Json j)
 	customId = j["customId"];
 	set_string_value(sharedId, j, "sharedId");
 
+	set_string_value(pathToInitialModelState, j, "pathToInitialModelState");
+	set_string_value(pathToFinalModelState, j, "pathToFinalModelState");
+
+	set_int_value(spinUpMaxCycles, j, "spinUpMaxCycles");
+	set_int_value(spinUpPeriodYears, j, "spinUpPeriodYears");
+	set_double_value(spinUpTolerance, j, "spinUpTolerance");
+
 	return es;
 }
 
@@ -148,18 +162,7 @@ json11::Json Env::to_json() const
 	
 	J11Array crs;
 	for(const auto& c : cropRotations)
-	{
-		J11Array cr;
-		for(const auto& cm : c.cropRotation)
-			cr.push_back(cm.to_json());
-
-		auto cro = J11Object
-		{{"from", c.start.toIsoDateString()}
-		,{"end", c.end.toIsoDateString()}
-    ,{"cropRotation", cr}
-		};
-		crs.push_back(cro);
-	}
+		crs.push_back(c.to_json());
 
 	return J11Object
 	{{"type", "Env"}
@@ -173,6 +176,11 @@ json11::Json Env::to_json() const
 	,{"csvViaHeaderOptions", csvViaHeaderOptions}
 	,{"customId", customId}
 	,{"sharedId", sharedId}
+	,{"pathToInitialModelState", pathToInitialModelState}
+	,{"pathToFinalModelState", pathToFinalModelState}
+	,{"spinUpMaxCycles", spinUpMaxCycles}
+	,{"spinUpPeriodYears", spinUpPeriodYears}
+	,{"spinUpTolerance", spinUpTolerance}
 	,{"events", events}
 	,{"outputs", outputs}
 	};
@@ -639,98 +647,335 @@ void Monica::initPathToDB(const std::string& initialPathToIniFile)
 	Db::dbConnectionParameters(initialPathToIniFile);
 }
 
-Output Monica::runMonica(Env env)
+namespace
 {
-	Output out;
-	bool returnObjOutputs = env.returnObjOutputs();
-	out.customId = env.customId;
+	//! a model can only be continued with climate data starting the day after its current date
+	bool checkContinuation(const MonicaModel& monica, const Env& env, Output& out)
+	{
+		if(monica.currentStepDate().isValid()
+			 && !(monica.currentStepDate() + 1 == env.climateData.startDate()))
+		{
+			out.errors.push_back(string("Model state ends at ") + monica.currentStepDate().toIsoDateString()
+													 + ", but climate data start at " + env.climateData.startDate().toIsoDateString() 
+													 + " instead of the day after!");
+			return false;
+		}
+		return true;
+	}
 
-	activateDebug = env.debugMode;
-	if(activateDebug)
+	//! replace the crop rotation(s) of env by deep copies of the ones of other, incl. the state of their worksteps
+	Env& withCropRotationsOf(Env& env, const Env& other)
 	{
-		writeDebugInputs(env, "inputs.json");
+		env.cropRotation.clear();
+		env.cropRotations.clear();
+		for(const auto& cr : other.cropRotations)
+		{
+			vector<CultivationMethod> cms;
+			for(const auto& cm : cr.cropRotation)
+				cms.push_back(cm.clone());
+			env.cropRotations.push_back(CropRotation(cr.start, cr.end, cms));
+		}
+		return env;
 	}
 
-	//prefer multiple crop rotations, but use a single rotation if there
-	if(env.cropRotations.empty() && !env.cropRotation.empty())
-		env.cropRotations.push_back(CropRotation(env.climateData.startDate(), 
-																						 env.climateData.endDate(), 
-																						 env.cropRotation));
+	/**
+	 * @brief Steps a model through the climate data and crop rotation(s) of an env
+	 * and stores the results in an output.
+	 *
+	 * A day is split into beginDay (worksteps), the model's step and endDay
+	 * (daily functions, results, next cultivation method), so that several
+	 * models can be stepped together (see runMonicaLockstep).
+	 */
+	class Stepper
+	{
+	public:
+		Stepper(Env& env, MonicaModel& monica, Output& out, size_t maxSteps = numeric_limits<size_t>::max());
+
+		//! fork the run context of prefix, i.e. continue its crop rotation(s) with their current state
+		//! and position on the climate data of env, env's own crop rotation(s) are replaced by copies of prefix's ones
+		Stepper(Env& env, MonicaModel& monica, Output& out, const Stepper& prefix);
 
-	debug() << "starting Monica" << endl;
-	debug() << "-----" << endl;
+		//! the daily functions refer to the stepper's members
+		Stepper(const Stepper&) = delete;
+		Stepper& operator=(const Stepper&) = delete;
 
-	MonicaModel monica(env.params);
-	monica.simulationParametersNC().startDate = env.climateData.startDate();
-	monica.simulationParametersNC().endDate = env.climateData.endDate();
+		bool done() const { return _d >= _nods; }
 
-	debug() << "currentDate" << endl;
-	Date currentDate = env.climateData.startDate();
-	
-	// create a way for worksteps to let the runtime calculate at a daily basis things a workstep needs when being executed
-	// e.g. to actually accumulate values from days before the workstep (for calculating a moving window of past values)
-	int dailyFuncId = 0;
-	map<int, vector<double>> dailyValues;
-	vector<function<void()>> applyDailyFuncs;
-
-	//iterate through all the worksteps in the croprotation(s) and check for functions which have to run daily
-	for (auto& cr : env.cropRotations) {
-		for (auto& cm : cr.cropRotation) {
-			for (auto wsptr : cm.getWorksteps()) {
-				auto df = wsptr->registerDailyFunction([&dailyValues, dailyFuncId]() -> vector<double> & {
-					return dailyValues[dailyFuncId];
-					});
-				if (df) {
-					applyDailyFuncs.push_back([&monica, df, dailyFuncId, &dailyValues] {
-						dailyValues[dailyFuncId].push_back(df(&monica));
+		void beginDay();
+
+		void endDay();
+
+		//! aggregate the stored results and add them to the output
+		void finish();
+
+		//! continue with the (replaced) climate data of the env, storing the results to out,
+		//! the position in the crop rotation(s) and the state of the worksteps are kept
+		void continueWith(Output& out, size_t maxSteps = numeric_limits<size_t>::max());
+
+		//! step another model object, e.g. one restored from a checkpoint
+		void rebind(MonicaModel& monica) { _monica = &monica; }
+
+		MonicaModel& monica() { return *_monica; }
+
+		//! write the run state, i.e. the position in the crop rotation(s), the state of the
+		//! cultivation methods and the values collected by the daily functions (see state-io.h)
+		void writeState(ostream& out) const;
+
+		//! continue the crop rotation(s) where a state written by writeState left them,
+		//! if the env's crop rotation(s) are different, they start anew (with a warning)
+		//! @return false if the state is broken
+		bool restore(istream& in, Output& out);
+
+	private:
+		//! the types of the worksteps of every cultivation method in every crop rotation
+		vector<vector<string>> layout() const;
+
+		//! index of the crop rotation and of cm within it, -1 for both if cm is nullptr
+		pair<int64_t, int64_t> positionOf(const CultivationMethod* cm) const;
+
+		bool checkAndInitShadowOfNextCropRotation(Date currentDate);
+
+		pair<CultivationMethod*, Date> findNextCultivationMethod(Date currentDate, bool advanceToNextCM = true);
+
+		Env& _env;
+		MonicaModel* _monica;
+		Output* _out;
+		bool _returnObjOutputs{false};
+		Date _currentDate;
+
+		// create a way for worksteps to let the runtime calculate at a daily basis things a workstep needs when being executed
+		// e.g. to actually accumulate values from days before the workstep (for calculating a moving window of past values)
+		map<int, vector<double>> _dailyValues;
+		vector<function<void()>> _applyDailyFuncs;
+
+		vector<CropRotation>::iterator _crit;
+
+		//cropRotation is a shadow of the env.cropRotation, which will hold pointers to CMs in env.cropRotation, but might shrink
+		//if pure absolute CMs are finished
+		vector<CultivationMethod*> _cropRotation;
+
+		//iterator through the crop rotation
+		vector<CultivationMethod*>::iterator _cmit;
+
+		//direct handle to current cultivation method
+		CultivationMethod* _currentCM{nullptr};
+		Date _nextAbsoluteCMApplicationDate;
+
+		vector<StoreData> _store;
+		size_t _d{0};
+		size_t _nods{0};
+	};
+
+	Stepper::Stepper(Env& env, MonicaModel& monica, Output& out, size_t maxSteps)
+		: _env(env)
+		, _monica(&monica)
+		, _out(&out)
+	{
+		_returnObjOutputs = env.returnObjOutputs();
+
+		//prefer multiple crop rotations, but use a single rotation if there,
+		//it is open ended, so that it can be continued by a later run (see writeState)
+		if(env.cropRotations.empty() && !env.cropRotation.empty())
+			env.cropRotations.push_back(CropRotation(env.climateData.startDate(), Date(), env.cropRotation));
+
+		monica.simulationParametersNC().startDate = env.climateData.startDate();
+		monica.simulationParametersNC().endDate = env.climateData.endDate();
+
+		debug() << "currentDate" << endl;
+		_currentDate = env.climateData.startDate();
+
+		//iterate through all the worksteps in the croprotation(s) and check for functions which have to run daily
+		int dailyFuncId = 0;
+		for (auto& cr : env.cropRotations) {
+			for (auto& cm : cr.cropRotation) {
+				for (auto wsptr : cm.getWorksteps()) {
+					auto df = wsptr->registerDailyFunction([this, dailyFuncId]() -> vector<double> & {
+						return _dailyValues[dailyFuncId];
 						});
+					if (df) {
+						_applyDailyFuncs.push_back([this, df, dailyFuncId] {
+							_dailyValues[dailyFuncId].push_back(df(_monica));
+							});
+					}
+					dailyFuncId++;
 				}
-				dailyFuncId++;
 			}
 		}
+
+		_crit = env.cropRotations.begin();
+		_cmit = _cropRotation.begin();
+		tie(_currentCM, _nextAbsoluteCMApplicationDate) = findNextCultivationMethod(_currentDate, false);
+
+		_store = setupStorage(env.events, env.climateData.startDate(), env.climateData.endDate());
+
+		_nods = min(env.climateData.noOfStepsPossible(), maxSteps);
+	}
+
+	Stepper::Stepper(Env& env, MonicaModel& monica, Output& out, const Stepper& prefix)
+		: Stepper(withCropRotationsOf(env, prefix._env), monica, out)
+	{
+		stringstream state(ios::in | ios::out | ios::binary);
+		prefix.writeState(state);
+		restore(state, out);
+	}
+
+	void Stepper::continueWith(Output& out, size_t maxSteps)
+	{
+		_out = &out;
+
+		_monica->simulationParametersNC().startDate = _env.climateData.startDate();
+		_monica->simulationParametersNC().endDate = _env.climateData.endDate();
+
+		_currentDate = _env.climateData.startDate();
+		_store = setupStorage(_env.events, _env.climateData.startDate(), _env.climateData.endDate());
+		_d = 0;
+		_nods = min(_env.climateData.noOfStepsPossible(), maxSteps);
+	}
+
+	vector<vector<string>> Stepper::layout() const
+	{
+		vector<vector<string>> l;
+		for(const auto& cr : _env.cropRotations)
+		{
+			l.push_back(vector<string>());
+			for(const auto& cm : cr.cropRotation)
+				l.back().push_back(cm.layout());
+		}
+		return l;
+	}
+
+	pair<int64_t, int64_t> Stepper::positionOf(const CultivationMethod* cm) const
+	{
+		for(size_t r = 0; cm && r < _env.cropRotations.size(); r++)
+		{
+			const auto& cms = _env.cropRotations[r].cropRotation;
+			for(size_t i = 0; i < cms.size(); i++)
+				if(&cms[i] == cm)
+					return make_pair(int64_t(r), int64_t(i));
+		}
+		return make_pair(int64_t(-1), int64_t(-1));
 	}
 
-	//auto crit = env.cropRotations.empty() ? env.cropRotations.end() : env.cropRotations.begin();
-	auto crit = env.cropRotations.begin();
+	void Stepper::writeState(ostream& out) const
+	{
+		using namespace StateIO;
+
+		write(out, layout());
+		for(const auto& cr : _env.cropRotations)
+		{
+			write(out, cr.start);
+			write(out, cr.end);
+			for(const auto& cm : cr.cropRotation)
+				cm.serializeState(out);
+		}
+
+		//the shadow of the current crop rotation by the indices of its cultivation methods
+		write(out, int64_t(_crit - _env.cropRotations.begin()));
+		vector<int64_t> shadow;
+		for(auto cm : _cropRotation)
+			shadow.push_back(positionOf(cm).second);
+		write(out, shadow);
+		write(out, int64_t(_cmit - _cropRotation.begin()));
 
-	//cropRotation is a shadow of the env.cropRotation, which will hold pointers to CMs in env.cropRotation, but might shrink
-	//if pure absolute CMs are finished
-	vector<CultivationMethod*> cropRotation;
+		auto currentCM = positionOf(_currentCM);
+		write(out, currentCM.first);
+		write(out, currentCM.second);
+		write(out, _nextAbsoluteCMApplicationDate);
+
+		write(out, _dailyValues);
+	}
 
-	auto checkAndInitShadowOfNextCropRotation = [&](Date currentDate)
+	bool Stepper::restore(istream& in, Output& out)
 	{
-		if(crit != env.cropRotations.end())
+		using namespace StateIO;
+
+		vector<vector<string>> stateLayout;
+		read(in, stateLayout);
+		if(in && stateLayout != layout())
+		{
+			out.warnings.push_back("The crop rotation is not the one the model state has been stored with, it starts anew.");
+			return true;
+		}
+
+		bool ok = bool(in);
+		for(auto& cr : _env.cropRotations)
+		{
+			read(in, cr.start);
+			read(in, cr.end);
+			for(auto& cm : cr.cropRotation)
+				ok = ok && cm.deserializeState(in);
+		}
+
+		int64_t crit = 0, cmit = 0;
+		vector<int64_t> shadow;
+		pair<int64_t, int64_t> currentCM;
+		read(in, crit);
+		read(in, shadow);
+		read(in, cmit);
+		read(in, currentCM.first);
+		read(in, currentCM.second);
+		read(in, _nextAbsoluteCMApplicationDate);
+		read(in, _dailyValues);
+
+		const auto& crs = _env.cropRotations;
+		ok = ok && in && crit >= 0 && crit <= int64_t(crs.size());
+		if(ok)
+		{
+			_crit = _env.cropRotations.begin() + crit;
+			_cropRotation.clear();
+			for(auto i : shadow)
+			{
+				ok = ok && _crit != crs.end() && i >= 0 && i < int64_t(_crit->cropRotation.size());
+				if(ok)
+					_cropRotation.push_back(&_crit->cropRotation[size_t(i)]);
+			}
+		}
+		ok = ok && cmit >= 0 && cmit <= int64_t(_cropRotation.size());
+		if(ok)
+			_cmit = _cropRotation.begin() + cmit;
+		_currentCM = nullptr;
+		if(ok && currentCM.first >= 0)
+		{
+			ok = currentCM.first < int64_t(crs.size())
+				&& currentCM.second >= 0 && currentCM.second < int64_t(crs[size_t(currentCM.first)].cropRotation.size());
+			if(ok)
+				_currentCM = &_env.cropRotations[size_t(currentCM.first)].cropRotation[size_t(currentCM.second)];
+		}
+
+		if(!ok)
+			out.errors.push_back("The position in the crop rotation of the model state is broken!");
+		return ok;
+	}
+
+	bool Stepper::checkAndInitShadowOfNextCropRotation(Date currentDate)
+	{
+		if(_crit != _env.cropRotations.end())
 		{
 			//if current cropRotation is finished, try to move to next
-			if(crit->end.isValid()
-				 && currentDate == crit->end + 1)
+			if(_crit->end.isValid()
+				 && currentDate == _crit->end + 1)
 			{
-				crit++;
-				cropRotation.clear();
+				_crit++;
+				_cropRotation.clear();
 			}
 
 			//check again, because we might have moved to next cropRotation
-			if(crit != env.cropRotations.end())
+			if(_crit != _env.cropRotations.end())
 			{
 				//if a new cropRotation starts, copy the the pointers to the CMs to the shadow CR
-				if(crit->start.isValid() 
-					 && currentDate == crit->start)
+				if(_crit->start.isValid() 
+					 && currentDate == _crit->start)
 				{
-					for(auto& cm : crit->cropRotation)
-						cropRotation.push_back(&cm);
+					for(auto& cm : _crit->cropRotation)
+						_cropRotation.push_back(&cm);
 					return true;
 				}
 			}
 		}
 		return false;
-	};
-
-	//iterator through the crop rotation
-	//auto cmit = cropRotation.empty() ? cropRotation.end() : cropRotation.begin();
-	auto cmit = cropRotation.begin();
+	}
 
-	auto findNextCultivationMethod = [&](Date currentDate,
-																			 bool advanceToNextCM = true)
+	pair<CultivationMethod*, Date> Stepper::findNextCultivationMethod(Date currentDate, bool advanceToNextCM)
 	{
 		CultivationMethod* currentCM = nullptr;
 		Date nextAbsoluteCMApplicationDate;
@@ -743,23 +988,23 @@ Output Monica::runMonica(Env env)
 			{
 				//delete fully cultivation methods with only absolute worksteps,
 				//because they won't participate in a new run when wrapping the crop rotation 
-				if((*cmit)->areOnlyAbsoluteWorksteps() 
-					 || !(*cmit)->repeat())
-					cmit = cropRotation.erase(cmit);
+				if((*_cmit)->areOnlyAbsoluteWorksteps() 
+					 || !(*_cmit)->repeat())
+					_cmit = _cropRotation.erase(_cmit);
 				else
-					cmit++;
+					_cmit++;
 
 				//start anew if we reached the end of the crop rotation
-				if(cmit == cropRotation.end())
-					cmit = cropRotation.begin();
+				if(_cmit == _cropRotation.end())
+					_cmit = _cropRotation.begin();
 			}
 
 			//check if there's at least a cultivation method left in cropRotation
-			if(cmit != cropRotation.end())
+			if(_cmit != _cropRotation.end())
 			{
 				advanceToNextCM = true;
-				currentCM = *cmit;
-				
+				currentCM = *_cmit;
+			
 				//addedYear tells that the start of the cultivation method was before currentDate and thus the whole 
 				//CM had to be moved into the next year
 				//is possible for relative dates
@@ -805,89 +1050,353 @@ Output Monica::runMonica(Env env)
 		}
 
 		return make_pair(currentCM, nextAbsoluteCMApplicationDate);
-	};
-
-	//direct handle to current cultivation method
-	CultivationMethod* currentCM;
-	Date nextAbsoluteCMApplicationDate;
-	tie(currentCM, nextAbsoluteCMApplicationDate) = findNextCultivationMethod(currentDate, false);
+	}
 
-	vector<StoreData> store = setupStorage(env.events, env.climateData.startDate(), env.climateData.endDate());
-	
-	for(size_t d = 0, nods = env.climateData.noOfStepsPossible(); d < nods; ++d, ++currentDate)
+	void Stepper::beginDay()
 	{
-		debug() << "currentDate: " << currentDate.toString() << endl;
+		debug() << "currentDate: " << _currentDate.toString() << endl;
 
-		if(checkAndInitShadowOfNextCropRotation(currentDate))
+		if(checkAndInitShadowOfNextCropRotation(_currentDate))
 		{
-			//cmit = cropRotation.empty() ? cropRotation.end() : cropRotation.begin();
-			cmit = cropRotation.begin();
-			tie(currentCM, nextAbsoluteCMApplicationDate) = findNextCultivationMethod(currentDate, false);
+			_cmit = _cropRotation.begin();
+			tie(_currentCM, _nextAbsoluteCMApplicationDate) = findNextCultivationMethod(_currentDate, false);
 		}
-		
-		monica.dailyReset();
+	
+		_monica->dailyReset();
 
-		monica.setCurrentStepDate(currentDate);
-		monica.setCurrentStepClimateData(env.climateData.allDataForStep(d, env.params.siteParameters.vs_Latitude));
+		_monica->setCurrentStepDate(_currentDate);
+		_monica->setCurrentStepClimateData(_env.climateData.allDataForStep(_d, _env.params.siteParameters.vs_Latitude));
 
 		// test if monica's crop has been dying in previous step
 		// if yes, it will be incorporated into soil
-		if(monica.cropGrowth() && monica.cropGrowth()->isDying())
-			monica.incorporateCurrentCrop();
+		if(_monica->cropGrowth() && _monica->cropGrowth()->isDying())
+			_monica->incorporateCurrentCrop();
 
 		//try to apply dynamic worksteps
-		if(currentCM)
-			currentCM->apply(&monica);
+		if(_currentCM)
+			_currentCM->apply(_monica);
 
 		//apply worksteps and cycle through crop rotation
-		if(currentCM && nextAbsoluteCMApplicationDate == currentDate)
+		if(_currentCM && _nextAbsoluteCMApplicationDate == _currentDate)
 		{
-			debug() << "applying absolute-at: " << nextAbsoluteCMApplicationDate.toString() << endl;
-			currentCM->absApply(nextAbsoluteCMApplicationDate, &monica);
+			debug() << "applying absolute-at: " << _nextAbsoluteCMApplicationDate.toString() << endl;
+			_currentCM->absApply(_nextAbsoluteCMApplicationDate, _monica);
 
-			nextAbsoluteCMApplicationDate = currentCM->nextAbsDate(nextAbsoluteCMApplicationDate);
-						
-			debug() << " next abs app-date: " << nextAbsoluteCMApplicationDate.toString() << endl;
+			_nextAbsoluteCMApplicationDate = _currentCM->nextAbsDate(_nextAbsoluteCMApplicationDate);
+					
+			debug() << " next abs app-date: " << _nextAbsoluteCMApplicationDate.toString() << endl;
 		}
+	}
 
-		//monica main stepping method
-		monica.step();
-
+	void Stepper::endDay()
+	{
 		// call all daily functions, assuming it's better to do this after the steps, than before
 		// so the daily monica calculations will be taken into account
 		// but means also that a workstep which gets executed before the steps, can't take the
 		// values into account by applying a daily function
-		for (auto& f : applyDailyFuncs)
+		for (auto& f : _applyDailyFuncs)
 			f();
 
 		//store results
-		for(auto& s : store)
-			s.storeResultsIfSpecApplies(monica, returnObjOutputs);
+		for(auto& s : _store)
+			s.storeResultsIfSpecApplies(*_monica, _returnObjOutputs);
 
 		//if the next application date is not valid, we're at the end
 		//of the application list of this cultivation method
 		//and go to the next one in the crop rotation
-		if(currentCM 
-			 && currentCM->allDynamicWorkstepsFinished()
-			 && !nextAbsoluteCMApplicationDate.isValid())
+		if(_currentCM 
+			 && _currentCM->allDynamicWorkstepsFinished()
+			 && !_nextAbsoluteCMApplicationDate.isValid())
 		{
 			//to count the applied fertiliser for the next production process
+			_monica->resetFertiliserCounter();
+
+			tie(_currentCM, _nextAbsoluteCMApplicationDate) = findNextCultivationMethod(_currentDate + 1);
+		}
+
+		++_d;
+		++_currentDate;
+	}
+
+	void Stepper::finish()
+	{
+		for(auto& sd : _store)
+		{
+			//aggregate results of while events or unfinished other from/to ranges (where to event didn't happen yet)
+			if(_returnObjOutputs)
+				sd.aggregateResultsObj();
+			else
+				sd.aggregateResults();
+			_out->data.push_back({sd.spec.origSpec.dump(), sd.outputIds, sd.results, sd.resultsObj});
+		}
+	}
+
+	//! has to be increased whenever the layout of the run state (written after the model state) changes
+	const uint32_t runStateVersion = 1;
+
+	string runStateOf(const Stepper& stepper)
+	{
+		ostringstream oss(ios::binary);
+		stepper.writeState(oss);
+		return oss.str();
+	}
+
+	//! the run state is written after the model state
+	void writeRunState(ostream& out, const string& runState)
+	{
+		StateIO::write(out, runStateVersion);
+		StateIO::write(out, runState);
+	}
+
+	bool readRunState(istream& in, string& runState)
+	{
+		runState.clear();
+
+		//a plain model state (written by MonicaModel::serialize) has no run state
+		uint32_t version = 0;
+		StateIO::read(in, version);
+		if(!in)
+			return true;
+		if(version != runStateVersion)
+		{
+			cerr << "Error: The run state after the MONICA model state has version " << version
+				<< ", but only version " << runStateVersion << " (of this build) can be read!" << endl;
+			return false;
+		}
+
+		StateIO::read(in, runState);
+		return bool(in);
+	}
+
+	//! continue the run state read together with the model state (if any) by stepper
+	bool restoreRunState(Stepper& stepper, const string& runState, Output& out)
+	{
+		if(runState.empty())
+			return true;
+
+		istringstream iss(runState, ios::binary);
+		return stepper.restore(iss, out);
+	}
+
+	bool loadInitialModelState(const Env& env, MonicaModel& monica, string& runState, Output& out)
+	{
+		runState.clear();
+		if(env.pathToInitialModelState.empty())
+			return true;
+
+		ifstream ifs(env.pathToInitialModelState, ios::binary);
+		if(!ifs.good() || !monica.deserialize(ifs) || !readRunState(ifs, runState))
+		{
+			out.errors.push_back(string("Couldn't load model state from '") + env.pathToInitialModelState + "'!");
+			return false;
+		}
+		return checkContinuation(monica, env, out);
+	}
+
+	void storeFinalModelState(const Env& env, const MonicaModel& monica, const Stepper& stepper, Output& out)
+	{
+		if(env.pathToFinalModelState.empty())
+			return;
+
+		ofstream ofs(env.pathToFinalModelState, ios::binary);
+		if(ofs.good() && monica.serialize(ofs))
+			writeRunState(ofs, runStateOf(stepper));
+		if(!ofs.good())
+			out.errors.push_back(string("Couldn't store model state to '") + env.pathToFinalModelState + "'!");
+	}
+
+	//! step the stepper's model to the end of its climate data
+	void runStepper(Stepper& stepper)
+	{
+		while(!stepper.done())
+		{
+			stepper.beginDay();
+
+			//monica main stepping method
+			stepper.monica().step();
+
+			stepper.endDay();
+		}
+		stepper.finish();
+	}
+
+	//! step the model through the climate data and crop rotation(s) of env and store the results in out,
+	//! a run state (loaded with the model state) lets the crop rotation(s) continue where they were
+	void runSteps(Env& env, MonicaModel& monica, Output& out, const string& runState = string(),
+	              size_t maxSteps = numeric_limits<size_t>::max())
+	{
+		Stepper stepper(env, monica, out, maxSteps);
+		if(!restoreRunState(stepper, runState, out))
+			return;
+
+		runStepper(stepper);
+		storeFinalModelState(env, monica, stepper, out);
+	}
+}
+
+namespace
+{
+	//! C in the SOM/SMB pools of all layers, in the order SOM slow/fast, SMB slow/fast [kg C m-3]
+	vector<double> somPools(const MonicaModel& monica)
+	{
+		vector<double> ps;
+		for(const auto& sl : monica.soilColumn())
+			ps.insert(ps.end(), {sl.vs_SOM_Slow(), sl.vs_SOM_Fast(), sl.vs_SMB_Slow(), sl.vs_SMB_Fast()});
+		return ps;
+	}
+
+	void setSomPools(MonicaModel& monica, const vector<double>& ps)
+	{
+		size_t i = 0;
+		for(auto& sl : monica.soilColumnNC())
+		{
+			sl.vs_SOM_Slow() = ps[i++];
+			sl.vs_SOM_Fast() = ps[i++];
+			sl.vs_SMB_Slow() = ps[i++];
+			sl.vs_SMB_Fast() = ps[i++];
+		}
+	}
+
+	//! total C in the SOM/SMB pools [kg C m-2]
+	double totalSomC(const MonicaModel& monica, const vector<double>& ps)
+	{
+		double sum = 0.0;
+		for(size_t i = 0; i < ps.size(); i++)
+			sum += ps[i] * monica.soilColumn().at(i / 4).vs_LayerThickness;
+		return sum;
+	}
+
+	/**
+	 * @brief Spins up the soil organic matter pools to equilibrium.
+	 *
+	 * The first env.spinUpPeriodYears of climate and crop rotation are cycled
+	 * until no pool changes relatively more than env.spinUpTolerance during a
+	 * period. After three cycles each pool which converges geometrically is
+	 * extrapolated to its fixpoint (Aitken's delta-squared process), the
+	 * cycles saved this way are estimated from the convergence rate.
+	 *
+	 * @return a report of the spin-up
+	 */
+	Json spinUpSoilOrganicMatter(const Env& env, MonicaModel& monica, Output& out)
+	{
+		const Date start = env.climateData.startDate();
+		size_t periodSteps = 0;
+		for(Date d = start, end = start.withYear(start.year() + max(1, env.spinUpPeriodYears)); d < end; ++d)
+			periodSteps++;
+		periodSteps = min(periodSteps, env.climateData.noOfStepsPossible());
+		const double yearsPerCycle = periodSteps / 365.25;
+
+		debug() << "spinning up SOM pools, period: " << periodSteps << " days" << endl;
+
+		vector<vector<double>> history = {somPools(monica)};
+		int cycles = 0;
+		double skippedCycles = 0.0;
+		double residual = numeric_limits<double>::max();
+		double residualC = 0.0;
+		bool incorporatedCrop = false;
+		Env cycleEnv = env;
+		cycleEnv.events = Json();
+		cycleEnv.pathToFinalModelState.clear();
+		while(cycles < env.spinUpMaxCycles && periodSteps > 0)
+		{
+			cycleEnv.cropRotation = env.cropRotation;
+			cycleEnv.cropRotations = env.cropRotations;
+			Output cycleOut;
+			runSteps(cycleEnv, monica, cycleOut, string(), periodSteps);
+			
+			//the next cycle starts at the beginning of the period again
+			if(monica.cropGrowth())
+			{
+				monica.incorporateCurrentCrop();
+				incorporatedCrop = true;
+			}
 			monica.resetFertiliserCounter();
+			cycles++;
+
+			const auto& prev = history.back();
+			auto cur = somPools(monica);
+			residual = 0.0;
+			for(size_t i = 0; i < cur.size(); i++)
+				residual = max(residual, abs(cur[i] - prev[i]) / max(abs(prev[i]), 1e-9));
+			residualC = totalSomC(monica, cur) - totalSomC(monica, prev);
+			history.push_back(cur);
+
+			if(residual < env.spinUpTolerance)
+				break;
+
+			if(history.size() == 3)
+			{
+				const auto& x0 = history[0];
+				const auto& x1 = history[1];
+				const auto& x2 = history[2];
+				auto x = x2;
+				double maxSkipped = 0.0;
+				for(size_t i = 0; i < x.size(); i++)
+				{
+					double d1 = x1[i] - x0[i];
+					double d2 = x2[i] - x1[i];
+					if(d1 == 0.0 || d2 == 0.0)
+						continue;
 
-			tie(currentCM, nextAbsoluteCMApplicationDate) = findNextCultivationMethod(currentDate + 1);
+					//only geometric, non oscillating convergence can be extrapolated
+					double r = d2 / d1;
+					if(r <= 0.0 || r >= 1.0)
+						continue;
+
+					x[i] = max(0.0, x2[i] + d2 * r / (1.0 - r));
+
+					//cycles it would have taken to get the change per cycle below the tolerance
+					double n = log(env.spinUpTolerance * max(abs(x[i]), 1e-9) / abs(d2)) / log(r);
+					maxSkipped = max(maxSkipped, n);
+				}
+				setSomPools(monica, x);
+				skippedCycles += maxSkipped;
+				history = {x};
+			}
 		}
+
+		bool converged = residual < env.spinUpTolerance;
+		if(!converged)
+			out.warnings.push_back(string("SOM spin-up didn't converge within ") + to_string(cycles) 
+														 + " cycles, max. relative pool change in last cycle: " + to_string(residual));
+		if(incorporatedCrop)
+			out.warnings.push_back("SOM spin-up: crop was still growing at the end of the spin-up period and has been incorporated.");
+
+		return J11Object
+		{{"cycles", cycles}
+		,{"converged", converged}
+		,{"equivalentYears", (cycles + skippedCycles) * yearsPerCycle}
+		,{"yearsSaved", skippedCycles * yearsPerCycle}
+		,{"residualRelativeChange", residual == numeric_limits<double>::max() ? 0.0 : residual}
+		,{"residualCChange", residualC}
+		};
 	}
-	
-	for(auto& sd : store)
+}
+
+Output Monica::runMonica(Env env)
+{
+	Output out;
+	out.customId = env.customId;
+
+	activateDebug = env.debugMode;
+	if(activateDebug)
 	{
-		//aggregate results of while events or unfinished other from/to ranges (where to event didn't happen yet)
-		if(returnObjOutputs)
-			sd.aggregateResultsObj();
-		else
-			sd.aggregateResults();
-		out.data.push_back({sd.spec.origSpec.dump(), sd.outputIds, sd.results, sd.resultsObj});
+		writeDebugInputs(env, "inputs.json");
 	}
 
+	debug() << "starting Monica" << endl;
+	debug() << "-----" << endl;
+
+	MonicaModel monica(env.params);
+	string runState;
+	if(!loadInitialModelState(env, monica, runState, out))
+		return out;
+
+	if(env.spinUpMaxCycles > 0)
+		out.spinUp = spinUpSoilOrganicMatter(env, monica, out);
+
+	runSteps(env, monica, out, runState);
+
 	debug() << "returning from runMonica" << endl;
 
 #ifdef TEST_HOURLY_OUTPUT
@@ -896,3 +1405,316 @@ Output Monica::runMonica(Env env)
 
 	return out;
 }
+
+Output Monica::runMonicaFrom(Env env, MonicaModel& monica)
+{
+	Output out;
+	out.customId = env.customId;
+
+	if(checkContinuation(monica, env, out))
+		runSteps(env, monica, out);
+
+	return out;
+}
+
+struct IncrementalRun::Impl
+{
+	Env env;
+	unique_ptr<MonicaModel> monica;
+	unique_ptr<Stepper> stepper;
+	string runState; //!< read with the model state, continued by the next stepper
+	Output out;
+};
+
+IncrementalRun::IncrementalRun(Env env, unique_ptr<MonicaModel> monica)
+	: _impl(new Impl)
+{
+	_impl->env = env;
+	_impl->monica = move(monica);
+}
+
+IncrementalRun::~IncrementalRun() {}
+
+const Env& IncrementalRun::env() const { return _impl->env; }
+
+MonicaModel* IncrementalRun::model() { return _impl->monica.get(); }
+
+unique_ptr<MonicaModel> IncrementalRun::releaseModel() { return move(_impl->monica); }
+
+void IncrementalRun::setModel(unique_ptr<MonicaModel> monica)
+{
+	_impl->monica = move(monica);
+	if(_impl->stepper && _impl->monica)
+		_impl->stepper->rebind(*_impl->monica);
+}
+
+void IncrementalRun::replaceCropRotation(vector<CultivationMethod> cropRotation)
+{
+	_impl->env.cropRotation = cropRotation;
+	_impl->env.cropRotations.clear();
+	_impl->stepper.reset();
+	_impl->runState.clear();
+}
+
+bool IncrementalRun::serialize(ostream& out) const
+{
+	if(!_impl->monica || !_impl->monica->serialize(out))
+		return false;
+
+	writeRunState(out, _impl->stepper ? runStateOf(*_impl->stepper) : _impl->runState);
+	return bool(out);
+}
+
+bool IncrementalRun::deserialize(istream& in)
+{
+	unique_ptr<MonicaModel> monica(new MonicaModel(_impl->env.params));
+	string runState;
+	if(!monica->deserialize(in) || !readRunState(in, runState))
+		return false;
+
+	_impl->monica = move(monica);
+	_impl->stepper.reset();
+	_impl->runState = runState;
+	return true;
+}
+
+Output IncrementalRun::advance(const Climate::DataAccessor& climateData,
+															 const json11::Json& customId,
+															 const string& pathToFinalModelState)
+{
+	Env& env = _impl->env;
+	MonicaModel& monica = *_impl->monica;
+
+	Output& out = _impl->out;
+	out = Output();
+	out.customId = customId;
+
+	env.climateData = climateData;
+	env.pathToFinalModelState = pathToFinalModelState;
+	if(!checkContinuation(monica, env, out))
+		return out;
+
+	if(!_impl->stepper)
+	{
+		//the crop rotation is open ended, it continues with every advance
+		_impl->stepper.reset(new Stepper(env, monica, out));
+		bool restored = restoreRunState(*_impl->stepper, _impl->runState, out);
+		_impl->runState.clear();
+		if(!restored)
+		{
+			_impl->stepper.reset();
+			return out;
+		}
+	}
+	else
+		_impl->stepper->continueWith(out);
+
+	runStepper(*_impl->stepper);
+	storeFinalModelState(env, monica, *_impl->stepper, out);
+
+	return out;
+}
+
+vector<Output> Monica::runMonicaBranches(Env prefix, vector<Env> branches)
+{
+	Output prefixOut;
+	prefixOut.customId = prefix.customId;
+
+	activateDebug = prefix.debugMode;
+
+	debug() << "starting Monica with " << branches.size() << " branches" << endl;
+	debug() << "-----" << endl;
+
+	//the prefix' stepper is kept, as its crop rotation state is forked into the branches
+	MonicaModel monica(prefix.params);
+	unique_ptr<Stepper> prefixStepper;
+	string runState;
+	if(loadInitialModelState(prefix, monica, runState, prefixOut))
+	{
+		if(prefix.spinUpMaxCycles > 0)
+			prefixOut.spinUp = spinUpSoilOrganicMatter(prefix, monica, prefixOut);
+		prefixStepper.reset(new Stepper(prefix, monica, prefixOut));
+		if(restoreRunState(*prefixStepper, runState, prefixOut))
+		{
+			runStepper(*prefixStepper);
+			storeFinalModelState(prefix, monica, *prefixStepper, prefixOut);
+		}
+	}
+
+	vector<Output> outs;
+	if(!prefixOut.errors.empty())
+	{
+		for(const auto& b : branches)
+		{
+			Output out;
+			out.customId = b.customId;
+			out.errors = prefixOut.errors;
+			out.warnings = prefixOut.warnings;
+			outs.push_back(out);
+		}
+		return outs;
+	}
+
+	//run the branches on at most as many threads as there are cores,
+	//each worker forks the prefix model for the next branch when it starts it,
+	//a branch without crop rotation(s) of its own also forks the prefix' crop rotation state,
+	//so that e.g. a crop growing at the branching date will still be harvested by its cultivation method
+	outs.resize(branches.size());
+	size_t noOfWorkers = min(branches.size(), size_t(max(1u, thread::hardware_concurrency())));
+	size_t nextBranch = 0;
+	mutex lockable;
+	auto worker = [&]()
+	{
+		while(true)
+		{
+			size_t i = 0;
+			unique_ptr<MonicaModel> fork;
+			unique_ptr<Stepper> stepper;
+			{
+				lock_guard<mutex> lock(lockable);
+				if(nextBranch >= branches.size())
+					return;
+				i = nextBranch++;
+				fork.reset(new MonicaModel(monica));
+
+				Env& env = branches[i];
+				Output& out = outs[i];
+				out.customId = env.customId;
+				if(!checkContinuation(*fork, env, out))
+					continue;
+				if(env.cropRotation.empty() && env.cropRotations.empty())
+					stepper.reset(new Stepper(env, *fork, out, *prefixStepper));
+				else
+					stepper.reset(new Stepper(env, *fork, out));
+			}
+			runStepper(*stepper);
+			storeFinalModelState(branches[i], *fork, *stepper, outs[i]);
+		}
+	};
+
+	vector<future<void>> workers;
+	for(size_t w = 0; w < noOfWorkers; w++)
+		workers.push_back(async(launch::async, worker));
+	for(auto& w : workers)
+		w.get();
+
+	for(auto& out : outs)
+	{
+		out.spinUp = prefixOut.spinUp;
+		out.warnings.insert(out.warnings.begin(), prefixOut.warnings.begin(), prefixOut.warnings.end());
+	}
+
+	debug() << "returning from runMonicaBranches" << endl;
+
+	return outs;
+}
+
+vector<Output> Monica::runMonicaLockstep(vector<Env> envs)
+{
+	//the steppers keep references to the envs and outputs, so both must not be resized anymore
+	vector<Output> outs(envs.size());
+	if(envs.empty())
+		return outs;
+
+	activateDebug = envs.front().debugMode;
+
+	debug() << "starting Monica in lockstep with " << envs.size() << " envs" << endl;
+	debug() << "-----" << endl;
+
+	vector<unique_ptr<MonicaModel>> models;
+	vector<unique_ptr<Stepper>> steppers;
+	vector<size_t> envIndices;
+	for(size_t i = 0; i < envs.size(); i++)
+	{
+		Env& env = envs[i];
+		Output& out = outs[i];
+		out.customId = env.customId;
+
+		unique_ptr<MonicaModel> monica(new MonicaModel(env.params));
+		string runState;
+		if(!loadInitialModelState(env, *monica, runState, out))
+			continue;
+
+		if(env.spinUpMaxCycles > 0)
+			out.spinUp = spinUpSoilOrganicMatter(env, *monica, out);
+
+		unique_ptr<Stepper> stepper(new Stepper(env, *monica, out));
+		if(!restoreRunState(*stepper, runState, out))
+			continue;
+
+		steppers.push_back(move(stepper));
+		models.push_back(move(monica));
+		envIndices.push_back(i);
+	}
+
+	//step all models day by day, envs with shorter climate data drop out at their end,
+	//the soil temperature batch is only recreated when that happens
+	vector<Stepper*> active;
+	vector<MonicaModel*> batch;
+	vector<SoilTemperature*> soilTemperatures;
+	unique_ptr<SoilTemperatureBatch> soilTemperatureBatch;
+	while(true)
+	{
+		active.clear();
+		batch.clear();
+		soilTemperatures.clear();
+		for(auto& s : steppers)
+		{
+			if(s->done())
+				continue;
+
+			s->beginDay();
+			active.push_back(s.get());
+			batch.push_back(&s->monica());
+			soilTemperatures.push_back(&s->monica().soilTemperatureNC());
+		}
+
+		if(active.empty())
+			break;
+
+		if(!soilTemperatureBatch || soilTemperatureBatch->soilTemperatures() != soilTemperatures)
+			soilTemperatureBatch.reset(new SoilTemperatureBatch(soilTemperatures));
+
+		MonicaModel::stepWithBatchedSoilTemperature(batch, *soilTemperatureBatch);
+
+		for(auto s : active)
+			s->endDay();
+	}
+
+	for(size_t k = 0; k < steppers.size(); k++)
+	{
+		steppers[k]->finish();
+		storeFinalModelState(envs[envIndices[k]], *models[k], *steppers[k], outs[envIndices[k]]);
+	}
+
+	debug() << "returning from runMonicaLockstep" << endl;
+
+	return outs;
+}
+
+vector<Json> Monica::branchEnvJsons(Json envJson)
+{
+	const set<string> climateKeys = {"climateData", "climateCSV", "pathToClimateCSV", "csvViaHeaderOptions"};
+	const set<string> rotationKeys = {"cropRotation", "cropRotations"};
+
+	vector<Json> bs;
+	for(const auto& b : envJson["branches"].array_items())
+	{
+		auto o = envJson.object_items();
+		o.erase("branches");
+		o.erase("pathToInitialModelState");
+		o.erase("pathToFinalModelState");
+
+		//a branch has to bring its own climate, starting the day after the prefix ended,
+		//and continues the prefix' crop rotation (with its state) if it doesn't bring its own
+		for(const auto& k : climateKeys)
+			o.erase(k);
+		for(const auto& k : rotationKeys)
+			o.erase(k);
+
+		for(const auto& p : b.object_items())
+			o[p.first] = p.second;
+		bs.push_back(o);
+	}
+	return bs;
+}
@@ -100,6 +100,22 @@ namespace Monica
 
     CentralParameterProvider params;
 
+		std::string pathToInitialModelState;
+		// if set, continue from the model state stored there (e.g. by a spin-up run), the climate data are expected to start the day after
+
+		std::string pathToFinalModelState;
+		// if set, store the model state at the end of the run to this path, followed by the position
+		// in the crop rotation, which a run with the same crop rotation continues from
+
+		int spinUpMaxCycles{0};
+		// if > 0, bring the soil organic matter pools into equilibrium first, by cycling the start period of the run at most this many times
+
+		int spinUpPeriodYears{1};
+		// number of years (from the start of the climate data and crop rotation) cycled as representative period during spin-up
+
+		double spinUpTolerance{1e-4};
+		// spin-up is finished if no SOM/SMB pool changes relatively more than this during one period
+
     std::string toString() const;
 
     std::string berestRequestAddress;
@@ -170,6 +186,76 @@ namespace Monica
 	//! @param env the environment completely defining what the model needs and gets
 	//! @return a structure with all the Monica results
   DLL_API Output runMonica(Env env);
+
+	//! continue running an existing model (e.g. a fork or a long-lived session) under env,
+	//! the climate data of env are expected to start the day after the model's current date
+	//! @return the results of the days simulated under env only
+	DLL_API Output runMonicaFrom(Env env, MonicaModel& monica);
+
+	/**
+	 * A model with its env, advanced by successive blocks of climate data
+	 * (e.g. a long-lived session). Unlike repeated calls of runMonicaFrom,
+	 * the position in the crop rotation and the state of the (dynamic)
+	 * worksteps are kept between the blocks.
+	 */
+	class DLL_API IncrementalRun
+	{
+	public:
+		//! env supplies parameters, crop rotation and output events, its climate data are not used
+		IncrementalRun(Env env, std::unique_ptr<MonicaModel> monica);
+		~IncrementalRun();
+
+		IncrementalRun(const IncrementalRun&) = delete;
+		IncrementalRun& operator=(const IncrementalRun&) = delete;
+
+		const Env& env() const;
+
+		//! the model, nullptr while released (e.g. evicted to disk)
+		MonicaModel* model();
+		std::unique_ptr<MonicaModel> releaseModel();
+		void setModel(std::unique_ptr<MonicaModel> monica);
+
+		//! replace the crop rotation from the next advance on,
+		//! the state of the worksteps of the previous rotation is dropped
+		void replaceCropRotation(std::vector<CultivationMethod> cropRotation);
+
+		//! write the model state followed by the position in the crop rotation and the state
+		//! of the worksteps, the same as an advance writes to its pathToFinalModelState
+		bool serialize(std::ostream& out) const;
+
+		//! read a state written by serialize (or an advance) into a new model,
+		//! the crop rotation continues at the next advance where it was, if it is the one of env
+		bool deserialize(std::istream& in);
+
+		//! simulate the days of climateData (expected to start the day after the last advance),
+		//! a model has to be set
+		//! @return the results of these days only
+		Output advance(const Climate::DataAccessor& climateData,
+		               const json11::Json& customId = json11::Json(),
+		               const std::string& pathToFinalModelState = std::string());
+
+	private:
+		struct Impl;
+		std::unique_ptr<Impl> _impl;
+	};
+
+	//! run the common prefix env to its end and then continue forks of the model under every branch env in parallel
+	//! @param prefix the env of the common run up to the branching date
+	//! @param branches the envs of the branches, their climate data have to start the day after the prefix ended,
+	//! a branch without crop rotation(s) continues the prefix' ones where they were at the branching date
+	//! @return one output per branch, each containing the results of the branch only
+	DLL_API std::vector<Output> runMonicaBranches(Env prefix, std::vector<Env> branches);
+
+	//! run independent envs (e.g. the sites of a region) day by day in lockstep, only the soil temperature
+	//! equations of all models with the same number of soil layers are solved together across the models,
+	//! all other processes are stepped model by model
+	//! @return one output per env, in the order of envs, the same as runMonica would return for each
+	DLL_API std::vector<Output> runMonicaLockstep(std::vector<Env> envs);
+
+	//! create the full jsons of the branch envs from the "branches" array in an env json,
+	//! each branch inherits everything it doesn't set itself from the prefix, but the model state paths,
+	//! the climate data and the crop rotation(s) (which are continued from the prefix instead)
+	DLL_API std::vector<json11::Json> branchEnvJsons(json11::Json envJson);
 }
 
 #endif
@@ -22,6 +22,11 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 #include <chrono>
 #include <thread>
 #include <tuple>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cctype>
+#include <cstdio>
 
 #include "zeromq/zmq.hpp"
 #include "zeromq/zhelpers.hpp"
@@ -33,6 +38,7 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 #include "../io/database-io.h"
 #include "run-monica.h"
 #include "../io/output.h"
+#include "../core/state-io.h"
 #include "climate/climate-file-io.h"
 
 using namespace std;
@@ -386,8 +392,168 @@ void Monica::ZmqServer::startZeroMQMonica(zmq::context_t* zmqContext,
 
 //-----------------------------------------------------------------------------
 
+namespace
+{
+	//! create an env from a job message and read its climate data
+	Env createEnv(Json envJson, bool debugModeAllowed, Monica::Output& out)
+	{
+		Env env;
+		auto errors = env.merge(envJson);
+
+		EResult<DataAccessor> eda;
+		if (!env.climateData.isValid()) {
+			if (!env.climateCSV.empty())
+				eda = readClimateDataFromCSVStringViaHeaders(env.climateCSV, env.csvViaHeaderOptions);
+			else if (!env.pathsToClimateCSV.empty())
+				eda = readClimateDataFromCSVFilesViaHeaders(env.pathsToClimateCSV, env.csvViaHeaderOptions);
+		}
+
+		if (eda.success()) {
+			env.climateData = eda.result;
+
+			env.debugMode = debugModeAllowed && env.debugMode;
+
+			env.params.userSoilMoistureParameters.getCapillaryRiseRate =
+				[](string soilTexture, int distance) {
+				return Soil::readCapillaryRiseRates().getRate(soilTexture, distance);
+			};
+			env.params.userSoilMoistureParameters.capillaryRiseRates = sharedCapillaryRiseRateTable();
+		}
+
+		out.errors = eda.errors;
+		out.warnings = eda.warnings;
+		return env;
+	}
+
+	//! a long-lived model, advanced incrementally by "advanceSession" messages
+	struct Session
+	{
+		unique_ptr<IncrementalRun> run; //!< nullptr while the session is evicted to disk
+		chrono::steady_clock::time_point lastUsed;
+	};
+
+	//! a session which is in memory and could be moved to disk
+	bool isEvictable(const Session& session)
+	{
+		return bool(session.run);
+	}
+
+	string pathToSessionState(const SessionConfig& config, const string& sessionId)
+	{
+		//keep the session id usable as file name
+		ostringstream oss;
+		oss << config.pathToEvictedSessions << "/";
+		for(unsigned char c : sessionId)
+		{
+			if(isalnum(c) || c == '-' || c == '_')
+				oss << c;
+			else
+				oss << '%' << hex << setw(2) << setfill('0') << int(c) << dec;
+		}
+		oss << ".state";
+		return oss.str();
+	}
+
+	//! write the session's env (without climate data) followed by the state of its run
+	bool checkpointSession(const IncrementalRun& run, ostream& out)
+	{
+		Env env = run.env();
+		env.climateData = DataAccessor();
+		env.climateCSV.clear();
+		env.pathsToClimateCSV.clear();
+		StateIO::write(out, env.to_json().dump());
+		return run.serialize(out);
+	}
+
+	//! move idle and least recently used sessions to disk, nothing but their id is kept in memory
+	//! @param capExceededReported whether exceeding maxSessionsInMemory has been reported already
+	void evictSessions(map<string, Session>& sessions, const SessionConfig& config, bool& capExceededReported)
+	{
+		if(config.pathToEvictedSessions.empty())
+			return;
+
+		size_t noInMemory = 0;
+		vector<pair<chrono::steady_clock::time_point, string>> evictable;
+		for(const auto& p : sessions)
+		{
+			if(!isEvictable(p.second))
+				continue;
+			noInMemory++;
+			evictable.push_back(make_pair(p.second.lastUsed, p.first));
+		}
+		sort(evictable.begin(), evictable.end());
+
+		auto now = chrono::steady_clock::now();
+		size_t toEvict = noInMemory > config.maxSessionsInMemory ? noInMemory - config.maxSessionsInMemory : 0;
+		for(const auto& p : evictable)
+		{
+			if(toEvict == 0 && now - p.first < chrono::seconds(config.maxIdleSeconds))
+				break;
+
+			auto& session = sessions[p.second];
+			auto path = pathToSessionState(config, p.second);
+			ofstream ofs(path, ios::binary);
+			if(ofs.good() && checkpointSession(*session.run, ofs))
+			{
+				session.run.reset();
+				debug() << "evicted session " << p.second << " to " << path << endl;
+				if(toEvict > 0)
+					toEvict--;
+			}
+			else
+			{
+				ofs.close();
+				remove(path.c_str());
+			}
+		}
+
+		if(toEvict > 0 && !capExceededReported)
+		{
+			cerr << "More than " << config.maxSessionsInMemory << " sessions have to be kept in memory, "
+				"because they couldn't be written to disk!" << endl;
+			capExceededReported = true;
+		}
+		else if(toEvict == 0)
+			capExceededReported = false;
+	}
+
+	//! get the run of a session, restore it from disk if it has been evicted
+	IncrementalRun* sessionRun(Session& session, const SessionConfig& config, const string& sessionId, Monica::Output& out)
+	{
+		if(!session.run)
+		{
+			auto path = pathToSessionState(config, sessionId);
+			ifstream ifs(path, ios::binary);
+			string envJsonStr, err;
+			if(ifs.good())
+				StateIO::read(ifs, envJsonStr);
+			Json envJson = Json::parse(envJsonStr, err);
+			if(!ifs.good() || !err.empty())
+			{
+				out.errors.push_back(string("Couldn't restore session '") + sessionId + "' from '" + path + "'!");
+				return nullptr;
+			}
+
+			//the debug mode has been checked when the session was opened
+			Env env = createEnv(envJson, true, out);
+			if(!out.errors.empty())
+				return nullptr;
+			unique_ptr<IncrementalRun> run(new IncrementalRun(env, unique_ptr<MonicaModel>()));
+			if(!run->deserialize(ifs))
+			{
+				out.errors.push_back(string("Couldn't restore session '") + sessionId + "' from '" + path + "'!");
+				return nullptr;
+			}
+			session.run = move(run);
+		}
+		session.lastUsed = chrono::steady_clock::now();
+		return session.run.get();
+	}
+}
+
 void Monica::ZmqServer::serveZmqMonicaFull(zmq::context_t* zmqContext,
-																					 map<SocketRole, SocketConfig> socketAddresses)
+																					 map<SocketRole, SocketConfig> socketAddresses,
+																					 SessionConfig sessionConfig)
 {
 	bool startedServerInDebugMode = activateDebug;
 
@@ -397,7 +563,16 @@ void Monica::ZmqServer::serveZmqMonicaFull(zmq::context_t* zmqContext,
 		return;
 	}
 
-	
+	//the parameter references of the jobs are then resolved from memory
+	try
+	{
+		preloadMonicaDB();
+	}
+	catch(exception& e)
+	{
+		cerr << "Couldn't preload the MONICA database: " << e.what() << endl;
+	}
+
 	SocketConfig rconfig;
 	auto rci = socketAddresses.find(ReceiveJob);
 	if(rci != socketAddresses.end())
@@ -464,18 +639,50 @@ void Monica::ZmqServer::serveZmqMonicaFull(zmq::context_t* zmqContext,
 					controlSocket.setsockopt(ZMQ_SUBSCRIBE, topic, topicCharCount);
 				}
 
+				auto sendJson = [&](const string& sharedId, const Json& json)
+				{
+					try
+					{
+						if(!sharedId.empty())
+							s_sendmore(distinctSendSocket ? sendSocket : socket, sharedId);
+						s_send(distinctSendSocket ? sendSocket : socket, json.dump());
+					}
+					catch(zmq::error_t e)
+					{
+						cerr << "Exception on trying to reply with result message on zmq socket with address: ";
+						int i = 0;
+						for(auto address : sAddresses)
+							cerr << (i > 0 ? "," : "") << address, ++i;
+						cerr << "! Will continue to receive requests! Error: [" << e.what() << "]" << endl;
+					}
+				};
+
+				map<string, Session> sessions;
+				bool sessionCapExceededReported = false;
+
 				while(true)
 				{
 					try
 					{
+						//wake up regularly to evict idle sessions, as long as there are any which could be evicted
+						bool evictableSessions = !sessionConfig.pathToEvictedSessions.empty()
+							&& any_of(sessions.begin(), sessions.end(), [](const pair<const string, Session>& p){ return isEvictable(p.second); });
+
 						Msg msg;
-						zmq::poll(&items[0], distinctControlSocket ? 2 : 1, -1);
+						zmq::poll(&items[0], distinctControlSocket ? 2 : 1, evictableSessions ? 1000 : -1);
 
+						bool received = false;
 						if(items[0].revents & ZMQ_POLLIN)
-							msg = receiveMsg(socket);
+							msg = receiveMsg(socket), received = true;
 						if(distinctControlSocket
 							 && items[1].revents & ZMQ_POLLIN)
-							msg = receiveMsg(controlSocket, topicCharCount);
+							msg = receiveMsg(controlSocket, topicCharCount), received = true;
+
+						if(!received)
+						{
+							evictSessions(sessions, sessionConfig, sessionCapExceededReported);
+							continue;
+						}
 
 						//auto msg = receiveMsg(socket);
 
@@ -515,48 +722,141 @@ void Monica::ZmqServer::serveZmqMonicaFull(zmq::context_t* zmqContext,
 						{
 							Json& fullMsg = msg.json;
 
-              Env env;
-              auto errors = env.merge(msg.json);
+							auto sendOutput = [&](const Env& env, const Monica::Output& out)
+							{
+								sendJson(env.sharedId, out.to_json());
+							};
 
-              EResult<DataAccessor> eda;
-							if (!env.climateData.isValid()) {
-								if (!env.climateCSV.empty())
-									eda = readClimateDataFromCSVStringViaHeaders(env.climateCSV, env.csvViaHeaderOptions);
-								else if (!env.pathsToClimateCSV.empty())
-									eda = readClimateDataFromCSVFilesViaHeaders(env.pathsToClimateCSV, env.csvViaHeaderOptions);
-							}
+							Monica::Output envOut;
+							Env env = createEnv(fullMsg, startedServerInDebugMode, envOut);
 
-              Monica::Output out;
-              if (eda.success()) {
-                env.climateData = eda.result;
-                
-                env.debugMode = startedServerInDebugMode && env.debugMode;
+							//a common prefix run with branches, reply with one output per branch
+							if(!fullMsg["branches"].array_items().empty())
+							{
+								vector<Env> branchEnvs;
+								vector<Monica::Output> branchOuts;
+								bool ok = envOut.errors.empty();
+								for(auto bj : branchEnvJsons(fullMsg))
+								{
+									Monica::Output bout;
+									branchEnvs.push_back(createEnv(bj, startedServerInDebugMode, bout));
+									ok = ok && bout.errors.empty();
+									branchOuts.push_back(bout);
+								}
 
-                env.params.userSoilMoistureParameters.getCapillaryRiseRate =
-                  [](string soilTexture, int distance) {
-                  return Soil::readCapillaryRiseRates().getRate(soilTexture, distance);
-                };
+								if(ok)
+								{
+									auto outs = runMonicaBranches(env, branchEnvs);
+									for(size_t i = 0; i < outs.size(); i++)
+										outs[i].warnings.insert(outs[i].warnings.end(), branchOuts[i].warnings.begin(), branchOuts[i].warnings.end());
+									branchOuts = outs;
+								}
+								else
+								{
+									for(size_t i = 0; i < branchOuts.size(); i++)
+									{
+										branchOuts[i].customId = branchEnvs[i].customId;
+										branchOuts[i].errors.insert(branchOuts[i].errors.begin(), envOut.errors.begin(), envOut.errors.end());
+									}
+								}
 
-                out = runMonica(env);
-              }
-              
-              out.errors = eda.errors;
-              out.warnings = eda.warnings;
+								for(size_t i = 0; i < branchOuts.size(); i++)
+									sendOutput(branchEnvs[i], branchOuts[i]);
+							}
+							else
+							{
+								Monica::Output out;
+								if(envOut.errors.empty())
+									out = runMonica(env);
 
-							try
+								out.errors.insert(out.errors.end(), envOut.errors.begin(), envOut.errors.end());
+								out.warnings.insert(out.warnings.end(), envOut.warnings.begin(), envOut.warnings.end());
+
+								sendOutput(env, out);
+							}
+						}
+						else if(msgType == "openSession"
+										|| msgType == "advanceSession"
+										|| msgType == "closeSession")
+						{
+							const Json& sessionMsg = msg.json;
+							string sessionId = sessionMsg["sessionId"].string_value();
+
+							Monica::Output out;
+							out.customId = sessionMsg["customId"];
+							auto sit = sessions.find(sessionId);
+							if(sessionId.empty())
+								out.errors.push_back("Session message without 'sessionId'!");
+							else if(msgType == "openSession")
 							{
-								if(!env.sharedId.empty())
-									s_sendmore(distinctSendSocket ? sendSocket : socket, env.sharedId);
-								s_send(distinctSendSocket ? sendSocket : socket, out.to_json().dump());
+								if(sit != sessions.end())
+									out.errors.push_back(string("Session '") + sessionId + "' is already open!");
+								else
+								{
+									Env env = createEnv(sessionMsg, startedServerInDebugMode, out);
+									env.climateData = DataAccessor();
+									unique_ptr<IncrementalRun> run(new IncrementalRun(env, unique_ptr<MonicaModel>(new MonicaModel(env.params))));
+									if(!env.pathToInitialModelState.empty())
+									{
+										//continues the crop rotation, too, if the state has been stored by a run with the same one
+										ifstream ifs(env.pathToInitialModelState, ios::binary);
+										if(!ifs.good() || !run->deserialize(ifs))
+											out.errors.push_back(string("Couldn't load model state from '") + env.pathToInitialModelState + "'!");
+									}
+									if(out.errors.empty())
+									{
+										Session& session = sessions[sessionId];
+										session.run = move(run);
+										session.lastUsed = chrono::steady_clock::now();
+									}
+								}
 							}
-							catch(zmq::error_t e)
+							else if(sit == sessions.end())
+								out.errors.push_back(string("Unknown session '") + sessionId + "'!");
+							else if(msgType == "advanceSession")
 							{
-								cerr << "Exception on trying to reply with result message on zmq socket with address: ";
-								int i = 0;
-								for(auto address : sAddresses)
-									cerr << (i > 0 ? "," : "") << address, ++i;
-								cerr << "! Will continue to receive requests! Error: [" << e.what() << "]" << endl;
+								Session& session = sit->second;
+
+								//climate data (and optionally new worksteps) of the days to advance, everything else comes from the session's env,
+								//without worksteps the session's crop rotation continues where the last advance stopped
+								Json advanceMsg = sessionMsg;
+								bool newWorksteps = !sessionMsg["worksteps"].array_items().empty();
+								if(newWorksteps)
+								{
+									auto o = sessionMsg.object_items();
+									o["cropRotation"] = J11Array{J11Object{{"type", "CultivationMethod"}
+																												, {"worksteps", sessionMsg["worksteps"]}
+																												, {"repeat", false}}};
+									advanceMsg = o;
+								}
+								Env advance = createEnv(advanceMsg, startedServerInDebugMode, out);
+
+								IncrementalRun* run = out.errors.empty() ? sessionRun(session, sessionConfig, sessionId, out) : nullptr;
+								if(run)
+								{
+									if(newWorksteps)
+										run->replaceCropRotation(advance.cropRotation);
+
+									auto errors = out.errors;
+									auto warnings = out.warnings;
+									out = run->advance(advance.climateData, advance.customId, advance.pathToFinalModelState);
+									out.errors.insert(out.errors.begin(), errors.begin(), errors.end());
+									out.warnings.insert(out.warnings.begin(), warnings.begin(), warnings.end());
+								}
+							}
+							else if(msgType == "closeSession")
+							{
+								if(!sessionConfig.pathToEvictedSessions.empty())
+									remove(pathToSessionState(sessionConfig, sessionId).c_str());
+								sessions.erase(sit);
 							}
+
+							auto reply = out.to_json().object_items();
+							reply["sessionId"] = sessionId;
+							reply["request"] = msgType;
+							sendJson(sessionMsg["sharedId"].string_value(), reply);
+
+							evictSessions(sessions, sessionConfig, sessionCapExceededReported);
 						}
 						else
 						{
@@ -49,8 +49,18 @@ namespace Monica
 			std::vector<std::string> addresses;
 			SocketOp op;
 		};
+
+		//! configuration of the long-lived sessions ("openSession", "advanceSession", "closeSession" messages)
+		struct SessionConfig
+		{
+			std::string pathToEvictedSessions; //!< directory for the states of idle sessions, empty = sessions stay in memory
+			std::size_t maxSessionsInMemory{1000}; //!< evict the least recently used sessions beyond this number
+			int maxIdleSeconds{600}; //!< evict sessions not used for this long
+		};
+
 		void serveZmqMonicaFull(zmq::context_t* zmqContext,
-														std::map<SocketRole, SocketConfig> socketAddresses);
+														std::map<SocketRole, SocketConfig> socketAddresses,
+														SessionConfig sessionConfig = SessionConfig());
 	}
 }
 